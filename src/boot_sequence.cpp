@@ -0,0 +1,148 @@
+#include "boot_sequence.h"
+#include "display_manager.h"
+#include "sensor_manager.h"
+#include "wifi_manager.h"
+#include "time_manager.h"
+#include "menu_system.h"
+#include "trend_history.h"
+#include "dashboard.h"
+#include "scheduler.h"
+#include "utils.h"
+
+BootSequence bootSequence;
+
+static bool bootDisplay() {
+    if (!displayManager.begin()) return false;
+    displayManager.showSplashScreen();
+    return true;
+}
+
+static bool bootSensors() {
+    bool ok = sensorManager.begin();
+    sensorManager.readAllSensors();
+    return ok;
+}
+
+static bool bootWiFi() {
+    // WiFiManager connects on its own; this stage marks when it settled
+    return wifiManager.waitForConnection(BOOT_WIFI_WAIT_MS);
+}
+
+static bool bootTime() {
+    // Without a network the NTP request can only time out
+    if (!wifiManager.isConnected()) return false;
+    timeManager.syncTime();
+    return timeManager.waitForSync(NTP_TIMEOUT);
+}
+
+const BootSequence::StageInfo BootSequence::stages[BOOT_STAGE_COUNT] = {
+    {"display", bootDisplay, 0, 0},
+    {"sensors", bootSensors, 0, BOOT_STAGE_STACK},
+    {"wifi", bootWiFi, 0, BOOT_STAGE_STACK},
+    {"time", bootTime, 1 << BOOT_WIFI, BOOT_STAGE_STACK}
+};
+
+BootSequence::BootSequence() :
+    doneBits(nullptr),
+    handled(0),
+    firstReadingMs(0),
+    timelineLogged(false) {
+
+    memset(records, 0, sizeof(records));
+}
+
+void BootSequence::begin() {
+    doneBits = xEventGroupCreate();
+
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+        if (stages[i].stackSize == 0) {
+            runStage((BootStage)i);
+        } else if (xTaskCreate(stageTask, stages[i].name, stages[i].stackSize,
+                               (void*)(uintptr_t)i, 1, nullptr) != pdPASS) {
+            LOG_E("Boot stage task failed, running inline: %s", stages[i].name);
+            runStage((BootStage)i);
+        }
+    }
+}
+
+void BootSequence::stageTask(void* arg) {
+    bootSequence.runStage((BootStage)(uintptr_t)arg);
+    vTaskDelete(nullptr);
+}
+
+void BootSequence::runStage(BootStage stage) {
+    const StageInfo& info = stages[stage];
+    BootStageRecord& record = records[stage];
+
+    if (info.dependsOn) {
+        xEventGroupWaitBits(doneBits, info.dependsOn, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+
+    record.startMs = millis();
+    record.started = true;
+    record.ok = info.run();
+    record.endMs = millis();
+    record.done = true;
+
+    // Publishing the bit also publishes the record to the main task
+    xEventGroupSetBits(doneBits, 1 << stage);
+    Scheduler::wake();
+}
+
+void BootSequence::update() {
+    // Main task side: react to stages that finished since the last call
+    uint8_t done = doneBits ? xEventGroupGetBits(doneBits) : 0;
+    uint8_t fresh = done & ~handled;
+    if (fresh == 0) return;
+    handled = done;
+
+    if (fresh & (1 << BOOT_SENSORS)) {
+        trendHistory.record(sensorManager.getSensorData(), millis());
+        dashboard.publish(sensorManager.getSensorData());
+
+        // Show the first reading unless the user already went somewhere
+        if (menuSystem.getCurrentState() == MENU_MAIN) {
+            menuSystem.openScreen(MENU_SENSOR_DISPLAY);
+        }
+        firstReadingMs = millis();
+    }
+
+    if (isComplete() && !timelineLogged) {
+        timelineLogged = true;
+        logTimeline();
+    }
+}
+
+bool BootSequence::isDone(BootStage stage) {
+    return handled & (1 << stage);
+}
+
+bool BootSequence::isComplete() {
+    return handled == (1 << BOOT_STAGE_COUNT) - 1;
+}
+
+const BootStageRecord& BootSequence::getRecord(BootStage stage) {
+    return records[stage];
+}
+
+const char* BootSequence::getStageName(BootStage stage) {
+    return stages[stage].name;
+}
+
+uint32_t BootSequence::getFirstReadingTime() {
+    return firstReadingMs;
+}
+
+void BootSequence::logTimeline() {
+    LOG_I("Boot timeline (ms since power-on):");
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+        const BootStageRecord& r = records[i];
+        if (!r.done) {
+            LOG_I("  %s: pending", stages[i].name);
+            continue;
+        }
+        LOG_I("  %s: %u -> %u (%u ms) %s", stages[i].name, r.startMs, r.endMs,
+              r.endMs - r.startMs, r.ok ? "OK" : "FAILED");
+    }
+    LOG_I("  first reading on screen: %u", firstReadingMs);
+}
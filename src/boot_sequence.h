@@ -0,0 +1,62 @@
+#ifndef BOOT_SEQUENCE_H
+#define BOOT_SEQUENCE_H
+
+#include <Arduino.h>
+#include <freertos/event_groups.h>
+#include "config.h"
+
+enum BootStage {
+    BOOT_DISPLAY = 0,
+    BOOT_SENSORS,
+    BOOT_WIFI,
+    BOOT_TIME,
+    BOOT_STAGE_COUNT
+};
+
+struct BootStageRecord {
+    uint32_t startMs;       // millis() since power-on
+    uint32_t endMs;
+    bool started;
+    bool done;
+    bool ok;
+};
+
+// Runs start-up work as concurrent stages. Each stage names the stages it
+// waits for; everything else starts at once in its own task, so a slow
+// WiFi join no longer holds back the sensors or the screen.
+class BootSequence {
+private:
+    struct StageInfo {
+        const char* name;
+        bool (*run)();
+        uint8_t dependsOn;      // Bit mask of BootStage
+        uint32_t stackSize;     // 0 runs inline in begin()
+    };
+
+    static const StageInfo stages[BOOT_STAGE_COUNT];
+
+    BootStageRecord records[BOOT_STAGE_COUNT];
+    EventGroupHandle_t doneBits;
+    uint8_t handled;            // Completions already processed by update()
+    uint32_t firstReadingMs;
+    bool timelineLogged;
+
+    static void stageTask(void* arg);
+    void runStage(BootStage stage);
+
+public:
+    BootSequence();
+    void begin();
+    void update();
+
+    bool isDone(BootStage stage);
+    bool isComplete();
+    const BootStageRecord& getRecord(BootStage stage);
+    const char* getStageName(BootStage stage);
+    uint32_t getFirstReadingTime();
+    void logTimeline();
+};
+
+extern BootSequence bootSequence;
+
+#endif
@@ -1,3 +1,4 @@
+#define LOG_MODULE LOG_SENSOR
 #include "calibration_manager.h"
 
 CalibrationManager calibrationManager;
@@ -5,109 +6,157 @@ CalibrationManager calibrationManager;
 CalibrationManager::CalibrationManager() : 
     calibrating(false),
     currentCalibration(CALIB_NONE),
+    channel(SENSOR_PH),
     calibStartTime(0),
     stabilityStartTime(0),
-    initialValue(0),
+    windowCount(0),
+    windowNext(0),
+    sampleCount(0),
+    failedReads(0),
     currentValue(0),
     valueStable(false),
-    progress(0) {
+    progress(0),
+    result(CALIB_RESULT_NONE),
+    sampleJob(JOB_NONE) {
+}
+
+void CalibrationManager::begin() {
+    // One-shot that re-arms itself, so a slow Modbus reply delays the next
+    // sample instead of piling up overruns
+    sampleJob = scheduler.once([](void* self) {
+        static_cast<CalibrationManager*>(self)->sample();
+    }, this, "calibration");
 }
 
 void CalibrationManager::beginCalibration(CalibrationType type) {
     if (calibrating) return;
+    result = CALIB_RESULT_NONE;
     
-    currentCalibration = type;
-    calibrating = true;
-    calibStartTime = millis();
-    stabilityStartTime = 0;
-    valueStable = false;
-    progress = 0;
-    
-    // Get initial value based on calibration type
-    SensorData data = sensorManager.getSensorData();
     switch (type) {
         case CALIB_PH_4_01:
         case CALIB_PH_7_00:
         case CALIB_PH_10_01:
-            initialValue = data.ph_value;
+            channel = SENSOR_PH;
             break;
         case CALIB_DO_ZERO:
         case CALIB_DO_SLOPE:
-            initialValue = data.do_value;
+            channel = SENSOR_DO;
             break;
         case CALIB_EC_1413:
         case CALIB_EC_12880:
-            initialValue = data.ec_value;
+            channel = SENSOR_EC;
             break;
         default:
-            initialValue = 0;
+            return;
     }
-    currentValue = initialValue;
     
-    Serial.println("Calibration started: " + getSensorName(type));
+    currentCalibration = type;
+    calibrating = true;
+    calibStartTime = millis();
+    stabilityStartTime = 0;
+    windowCount = 0;
+    windowNext = 0;
+    sampleCount = 0;
+    failedReads = 0;
+    valueStable = false;
+    progress = 0;
+    
+    // Last regular reading until the first sample is in
+    const SensorData& data = sensorManager.getSensorData();
+    currentValue = channel == SENSOR_PH ? data.ph_value : channel == SENSOR_DO ? data.do_value : data.ec_value;
+    
+    scheduler.start(sampleJob, 0);
+    LOG_I("Calibration started: %s", getSensorName(type));
 }
 
-void CalibrationManager::updateCalibration() {
+void CalibrationManager::sample() {
     if (!calibrating) return;
     
-    // Read current sensor value
-    SensorData data = sensorManager.getSensorData();
-    float newValue = 0;
-    
-    switch (currentCalibration) {
-        case CALIB_PH_4_01:
-        case CALIB_PH_7_00:
-        case CALIB_PH_10_01:
-            newValue = data.ph_value;
-            break;
-        case CALIB_DO_ZERO:
-        case CALIB_DO_SLOPE:
-            newValue = data.do_value;
-            break;
-        case CALIB_EC_1413:
-        case CALIB_EC_12880:
-            newValue = data.ec_value;
-            break;
-        default:
-            newValue = 0;
+    float value;
+    if (sensorManager.readChannel(channel, value)) {
+        failedReads = 0;
+        currentValue = value;
+        addSample(value);
+    } else if (++failedReads >= CALIBRATION_MAX_ERRORS) {
+        LOG_E("Calibration aborted: %s not answering", getSensorName(currentCalibration));
+        stop(CALIB_RESULT_NO_REPLY);
+        return;
     }
     
-    currentValue = newValue;
+    if (millis() - calibStartTime >= CALIBRATION_TIMEOUT_MS) {
+        LOG_E("Calibration aborted: %s did not settle in %u s", getSensorName(currentCalibration),
+              CALIBRATION_TIMEOUT_MS / 1000);
+        stop(CALIB_RESULT_TIMEOUT);
+        return;
+    }
     
-    // Check stability
-    if (checkStability(newValue)) {
+    if (checkStability()) {
         if (!valueStable) {
             valueStable = true;
             stabilityStartTime = millis();
         }
         
-        // Calculate progress based on stable time (30 seconds total)
         unsigned long stableTime = millis() - stabilityStartTime;
-        progress = map(min(stableTime, 30000UL), 0, 30000, 0, 100);
+        progress = map(min(stableTime, (unsigned long)CALIBRATION_STABLE_MS), 0, CALIBRATION_STABLE_MS, 0, 100);
         
-        // If stable for required time, complete calibration
-        if (stableTime >= 30000) {
-            sendCalibrationCommand();
-            calibrating = false;
-            Serial.println("Calibration completed successfully");
+        if (stableTime >= CALIBRATION_STABLE_MS) {
+            finish();
+            return;
         }
     } else {
         valueStable = false;
         stabilityStartTime = 0;
         progress = 0;
     }
+    
+    scheduler.start(sampleJob, CALIBRATION_SAMPLE_INTERVAL);
 }
 
-bool CalibrationManager::checkStability(float newValue) {
-    // Check if value is within 1% of initial value for stability
-    float tolerance = 0.01 * initialValue;
-    return abs(newValue - initialValue) <= tolerance;
+void CalibrationManager::addSample(float value) {
+    window[windowNext] = value;
+    windowNext = (windowNext + 1) % CALIBRATION_WINDOW;
+    if (windowCount < CALIBRATION_WINDOW) windowCount++;
+    sampleCount++;
+}
+
+// Settled when the whole window fits inside the tolerance band; a probe
+// still drifting never does, however slowly it moves
+bool CalibrationManager::checkStability() {
+    if (windowCount < CALIBRATION_WINDOW) return false;
+    
+    float lowest = window[0];
+    float highest = window[0];
+    float sum = 0;
+    for (int i = 0; i < CALIBRATION_WINDOW; i++) {
+        lowest = min(lowest, window[i]);
+        highest = max(highest, window[i]);
+        sum += window[i];
+    }
+    return highest - lowest <= getTolerance(sum / CALIBRATION_WINDOW);
+}
+
+float CalibrationManager::getTolerance(float mean) {
+    switch (channel) {
+        case SENSOR_PH: return CALIBRATION_PH_TOLERANCE;
+        case SENSOR_DO: return CALIBRATION_DO_TOLERANCE;
+        // EC is read in whole uS/cm, so never demand less than one count
+        case SENSOR_EC: return max((float)(CALIBRATION_EC_TOLERANCE * fabsf(mean)), 1.0f);
+        default: return 0;
+    }
+}
+
+void CalibrationManager::finish() {
+    sendCalibrationCommand();
+    calibrating = false;
+    progress = 100;
+    result = CALIB_RESULT_DONE;
+    LOG_I("Calibration completed in %u ms, %u samples", millis() - calibStartTime, sampleCount);
 }
 
 void CalibrationManager::sendCalibrationCommand() {
     // Send Modbus command to calibrate sensor
     // This is a placeholder - implement based on specific sensor protocols
-    Serial.println("Sending calibration command for: " + getSensorName(currentCalibration));
+    LOG_I("Sending calibration command for: %s", getSensorName(currentCalibration));
     
     // Example for pH calibration (would need actual Modbus commands)
     switch (currentCalibration) {
@@ -138,12 +187,18 @@ void CalibrationManager::sendCalibrationCommand() {
 }
 
 void CalibrationManager::cancelCalibration() {
+    stop(CALIB_RESULT_CANCELLED);
+    LOG_I("Calibration cancelled");
+}
+
+// The type is kept so the result can still name the probe
+void CalibrationManager::stop(CalibrationResult reason) {
+    scheduler.cancel(sampleJob);
     calibrating = false;
-    currentCalibration = CALIB_NONE;
-    Serial.println("Calibration cancelled");
+    result = reason;
 }
 
-String CalibrationManager::getCalibrationInstruction(CalibrationType type) {
+const char* CalibrationManager::getCalibrationInstruction(CalibrationType type) {
     switch (type) {
         case CALIB_PH_4_01:
             return "Immerse in pH 4.01 solution and wait for stabilization";
@@ -164,7 +219,7 @@ String CalibrationManager::getCalibrationInstruction(CalibrationType type) {
     }
 }
 
-String CalibrationManager::getSensorName(CalibrationType type) {
+const char* CalibrationManager::getSensorName(CalibrationType type) {
     switch (type) {
         case CALIB_PH_4_01: return "pH 4.01";
         case CALIB_PH_7_00: return "pH 7.00";
@@ -180,7 +235,18 @@ String CalibrationManager::getSensorName(CalibrationType type) {
 // Getters
 bool CalibrationManager::isCalibrating() { return calibrating; }
 CalibrationType CalibrationManager::getCurrentCalibration() { return currentCalibration; }
-String CalibrationManager::getInstruction() { return getCalibrationInstruction(currentCalibration); }
+const char* CalibrationManager::getInstruction() { return getCalibrationInstruction(currentCalibration); }
 float CalibrationManager::getCurrentValue() { return currentValue; }
 int CalibrationManager::getProgress() { return progress; }
-bool CalibrationManager::isStable() { return valueStable; }
\ No newline at end of file
+bool CalibrationManager::isStable() { return valueStable; }
+CalibrationResult CalibrationManager::getResult() { return result; }
+
+const char* CalibrationManager::getResultText() {
+    switch (result) {
+        case CALIB_RESULT_DONE: return "Calibrated";
+        case CALIB_RESULT_CANCELLED: return "Cancelled";
+        case CALIB_RESULT_NO_REPLY: return "Probe not answering";
+        case CALIB_RESULT_TIMEOUT: return "Did not settle";
+        default: return "";
+    }
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include "config.h"
 #include "sensor_manager.h"
+#include "scheduler.h"
 
 enum CalibrationType {
     CALIB_NONE = 0,
@@ -16,35 +17,64 @@ enum CalibrationType {
     CALIB_EC_12880 = 7
 };
 
+// How the last calibration ended
+enum CalibrationResult {
+    CALIB_RESULT_NONE,          // Running, or none run yet
+    CALIB_RESULT_DONE,
+    CALIB_RESULT_CANCELLED,     // Left by the user
+    CALIB_RESULT_NO_REPLY,      // CALIBRATION_MAX_ERRORS failed reads in a row
+    CALIB_RESULT_TIMEOUT        // Never settled within CALIBRATION_TIMEOUT_MS
+};
+
+// While a calibration runs, the regular sensor job is paused and a
+// dedicated job reads only the probe being calibrated every
+// CALIBRATION_SAMPLE_INTERVAL. The probe counts as settled when the spread
+// of the last CALIBRATION_WINDOW samples is within tolerance, and the
+// calibration completes once it has stayed settled for
+// CALIBRATION_STABLE_MS.
 class CalibrationManager {
 private:
     bool calibrating;
     CalibrationType currentCalibration;
+    SensorChannel channel;
     unsigned long calibStartTime;
     unsigned long stabilityStartTime;
-    float initialValue;
+    float window[CALIBRATION_WINDOW];
+    uint8_t windowCount;
+    uint8_t windowNext;
+    uint32_t sampleCount;
+    uint8_t failedReads;        // In a row
     float currentValue;
     bool valueStable;
     int progress;
+    CalibrationResult result;
+    JobId sampleJob;
     
-    String getCalibrationInstruction(CalibrationType type);
-    bool checkStability(float newValue);
+    const char* getCalibrationInstruction(CalibrationType type);
+    void sample();
+    void addSample(float value);
+    bool checkStability();
+    float getTolerance(float mean);
+    void finish();
+    void stop(CalibrationResult reason);
     void sendCalibrationCommand();
     
 public:
     CalibrationManager();
+    void begin();
     void beginCalibration(CalibrationType type);
-    void updateCalibration();
     void cancelCalibration();
     bool isCalibrating();
     CalibrationType getCurrentCalibration();
-    String getInstruction();
+    const char* getInstruction();
     float getCurrentValue();
     int getProgress();
     bool isStable();
+    CalibrationResult getResult();
+    const char* getResultText();
     
     // Ubah ini dari private ke public
-    String getSensorName(CalibrationType type);
+    const char* getSensorName(CalibrationType type);
 };
 
 extern CalibrationManager calibrationManager;
@@ -0,0 +1,223 @@
+#define LOG_MODULE LOG_WEB
+#include "captive_portal.h"
+#include "provisioning_page.h"
+#include <memory>
+#include "metrics.h"
+#include "utils.h"
+
+CaptivePortal captivePortal;
+
+static_assert(PROVISIONING_MAX_SSID == MAX_SSID_LENGTH, "Portal and WiFi SSID limits differ");
+static_assert(PROVISIONING_MAX_PASSWORD == MAX_PASSWORD_LENGTH, "Portal and WiFi password limits differ");
+
+// Connectivity checks of the common phone and desktop OSes; answering
+// them with a redirect is what makes the OS pop up the setup page
+static const char* const PROBE_PATHS[] = {
+    "/generate_204", "/gen_204", "/hotspot-detect.html", "/library/test/success.html",
+    "/connecttest.txt", "/ncsi.txt", "/redirect", "/canonical.html"
+};
+
+CaptivePortal::CaptivePortal() :
+    running(false),
+    pollJob(JOB_NONE),
+    snapshotLock(nullptr),
+    snapshotCount(0),
+    snapshotScanning(false) {
+
+    portalURL[0] = '\0';
+}
+
+void CaptivePortal::begin() {
+    snapshotLock = xSemaphoreCreateMutex();
+    pollJob = scheduler.every(PORTAL_POLL_INTERVAL, [](void* self) {
+        static_cast<CaptivePortal*>(self)->poll();
+    }, this, "portal");
+    scheduler.cancel(pollJob);
+    addRoutes();
+    metrics.addQueue("queue=\"portal_commands\"", commands);
+
+    wifiManager.addListener(onWiFiState, this);
+    if (wifiManager.isAPMode()) {
+        start();
+    }
+}
+
+void CaptivePortal::onWiFiState(WiFiState state, void* context) {
+    CaptivePortal* portal = static_cast<CaptivePortal*>(context);
+    if (wifiManager.isAPMode()) {
+        portal->start();
+    } else {
+        portal->stop();
+    }
+}
+
+void CaptivePortal::start() {
+    if (running) return;
+
+    IPAddress ip = WiFi.softAPIP();
+    snprintf(portalURL, sizeof(portalURL), "http://%s/", ip.toString().c_str());
+
+    dns.setErrorReplyCode(DNSReplyCode::NoError);
+    dns.start(PORTAL_DNS_PORT, "*", ip);
+
+    refreshSnapshot();
+    scheduler.start(pollJob, PORTAL_POLL_INTERVAL);
+    running = true;
+    LOG_I("Setup portal at %s", portalURL);
+}
+
+void CaptivePortal::stop() {
+    if (!running) return;
+
+    scheduler.cancel(pollJob);
+    dns.stop();
+    running = false;
+    LOG_I("Setup portal stopped");
+}
+
+bool CaptivePortal::isRunning() {
+    return running;
+}
+
+void CaptivePortal::poll() {
+    dns.processNextRequest();
+
+    Command command;
+    while (commands.pop(command)) {
+        switch (command.type) {
+            case PORTAL_SCAN:
+                wifiManager.startNetworkScan();
+                break;
+            case PORTAL_SAVE:
+                if (command.form.serverUrl[0] != '\0') {
+                    wifiManager.setServerURL(command.form.serverUrl);
+                }
+                wifiManager.setCredentials(command.form.ssid, command.form.password);
+                break;
+        }
+    }
+
+    refreshSnapshot();
+}
+
+void CaptivePortal::refreshSnapshot() {
+    // Main task side; handlers copy the snapshot under the same lock
+    xSemaphoreTake(snapshotLock, portMAX_DELAY);
+    snapshotCount = wifiManager.getScanCount();
+    snapshotScanning = wifiManager.isScanning();
+    for (int i = 0; i < snapshotCount; i++) {
+        const WiFiScanEntry& entry = wifiManager.getScanResult(i);
+        ProvisioningNetwork& row = snapshot[i];
+        strlcpy(row.ssid, entry.ssid, sizeof(row.ssid));
+        row.rssi = entry.rssi;
+        row.secure = entry.encryption != WIFI_AUTH_OPEN;
+        row.known = wifiManager.isKnownNetwork(entry.ssid);
+    }
+    xSemaphoreGive(snapshotLock);
+}
+
+bool CaptivePortal::servesRequest(AsyncWebServerRequest* request) {
+    // Portal routes only exist on the AP side, and only while it is up
+    return running && ON_AP_FILTER(request);
+}
+
+void CaptivePortal::addRoutes() {
+    AsyncWebServer& server = httpServer.getServer();
+    ArRequestFilterFunction filter = [this](AsyncWebServerRequest* request) {
+        return servesRequest(request);
+    };
+
+    server.on("/", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleRoot(request);
+    }).setFilter(filter);
+    server.on("/scan", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleScan(request);
+    }).setFilter(filter);
+    server.on("/save", HTTP_POST, [this](AsyncWebServerRequest* request) {
+        handleSave(request);
+    }).setFilter(filter);
+    for (const char* path : PROBE_PATHS) {
+        server.on(path, HTTP_ANY, [this](AsyncWebServerRequest* request) {
+            handleRedirect(request);
+        }).setFilter(filter);
+    }
+    server.onNotFound([this](AsyncWebServerRequest* request) {
+        handleNotFound(request);
+    });
+}
+
+// ==================== REQUEST HANDLERS ====================
+void CaptivePortal::handleRoot(AsyncWebServerRequest* request) {
+    AsyncWebServerResponse* response = request->beginResponse(
+        200, "text/html", PROVISIONING_PAGE_GZ, sizeof(PROVISIONING_PAGE_GZ));
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
+
+void CaptivePortal::handleScan(AsyncWebServerRequest* request) {
+    struct ScanList {
+        ProvisioningNetwork networks[WIFI_MAX_SCAN_RESULTS];
+        int count;
+        bool scanning;
+        ChunkCursor cursor;
+    };
+
+    // The response outlives this call, so it streams from its own copy
+    std::shared_ptr<ScanList> list(new ScanList);
+    xSemaphoreTake(snapshotLock, portMAX_DELAY);
+    memcpy(list->networks, snapshot, snapshotCount * sizeof(ProvisioningNetwork));
+    list->count = snapshotCount;
+    list->scanning = snapshotScanning;
+    xSemaphoreGive(snapshotLock);
+
+    if (request->hasParam("refresh") || (list->count == 0 && !list->scanning)) {
+        if (commands.push({PORTAL_SCAN, {}})) {
+            list->scanning = true;
+            Scheduler::wake();
+        }
+    }
+
+    AsyncWebServerResponse* response = request->beginChunkedResponse("application/json",
+        [list](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            return Provisioning::renderScanJson(list->networks, list->count, list->cursor,
+                                                index, buffer, maxLen);
+        });
+    response->addHeader("X-Scanning", list->scanning ? "1" : "0");
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
+
+void CaptivePortal::handleSave(AsyncWebServerRequest* request) {
+    const AsyncWebParameter* ssid = request->getParam("ssid", true);
+    const AsyncWebParameter* password = request->getParam("password", true);
+    const AsyncWebParameter* server = request->getParam("server", true);
+
+    Command command = {PORTAL_SAVE, {}};
+    ProvisioningResult result = Provisioning::parseForm(
+        ssid ? ssid->value().c_str() : nullptr,
+        password ? password->value().c_str() : nullptr,
+        server ? server->value().c_str() : nullptr,
+        command.form);
+
+    if (result == PROVISION_OK && !commands.push(command)) {
+        request->send(503, "text/plain", "Busy, try again");
+        return;
+    }
+    if (result == PROVISION_OK) {
+        Scheduler::wake();
+    }
+    request->send(Provisioning::httpStatus(result), "text/plain", Provisioning::describe(result));
+}
+
+void CaptivePortal::handleRedirect(AsyncWebServerRequest* request) {
+    request->redirect(portalURL);
+}
+
+void CaptivePortal::handleNotFound(AsyncWebServerRequest* request) {
+    if (servesRequest(request)) {
+        handleRedirect(request);
+    } else {
+        request->send(404, "text/plain", "Not found");
+    }
+}
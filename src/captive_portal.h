@@ -0,0 +1,66 @@
+#ifndef CAPTIVE_PORTAL_H
+#define CAPTIVE_PORTAL_H
+
+#include <Arduino.h>
+#include <DNSServer.h>
+#include <freertos/semphr.h>
+#include "config.h"
+#include "scheduler.h"
+#include "spsc_queue.h"
+#include "wifi_manager.h"
+#include "http_server.h"
+#include "provisioning.h"
+
+// Setup portal served on the soft AP while the WiFi manager has it up: every
+// DNS name resolves to us and every unknown URL redirects to the setup page.
+// Requests are handled in the AsyncTCP task; anything touching WiFi or NVS
+// is queued to the main task, so sensor reads never wait on a client.
+class CaptivePortal {
+private:
+    enum CommandType {
+        PORTAL_SAVE,
+        PORTAL_SCAN
+    };
+
+    struct Command {
+        CommandType type;
+        ProvisioningForm form;
+    };
+
+    DNSServer dns;
+    bool running;
+    char portalURL[32];
+    JobId pollJob;
+    SpscQueue<Command, PORTAL_COMMAND_QUEUE_SIZE> commands;
+
+    // Scan list as last seen by the main task, copied out by /scan
+    SemaphoreHandle_t snapshotLock;
+    ProvisioningNetwork snapshot[WIFI_MAX_SCAN_RESULTS];
+    int snapshotCount;
+    bool snapshotScanning;
+
+    static void onWiFiState(WiFiState state, void* context);
+    bool servesRequest(AsyncWebServerRequest* request);
+
+    void start();
+    void stop();
+    void poll();
+    void refreshSnapshot();
+    void addRoutes();
+
+    // AsyncTCP task
+    void handleRoot(AsyncWebServerRequest* request);
+    void handleScan(AsyncWebServerRequest* request);
+    void handleSave(AsyncWebServerRequest* request);
+    void handleRedirect(AsyncWebServerRequest* request);
+    void handleNotFound(AsyncWebServerRequest* request);
+
+public:
+    CaptivePortal();
+    void begin();
+    bool isRunning();
+};
+
+extern CaptivePortal captivePortal;
+
+#endif
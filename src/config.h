@@ -5,7 +5,29 @@
 
 // ==================== DEBUG SETTINGS ====================
 #define DEBUG_MODE true
+// Most verbose level built in per module; anything above compiles out,
+// runtime overrides can only go quieter
+#define LOG_BUILD_LEVEL (DEBUG_MODE ? LOG_LEVEL_DEBUG : LOG_LEVEL_INFO)
+#define LOG_BUILD_LEVEL_CORE LOG_BUILD_LEVEL
+#define LOG_BUILD_LEVEL_SENSOR LOG_BUILD_LEVEL
+#define LOG_BUILD_LEVEL_MODBUS LOG_BUILD_LEVEL
+#define LOG_BUILD_LEVEL_WIFI LOG_BUILD_LEVEL
+#define LOG_BUILD_LEVEL_DISPLAY LOG_BUILD_LEVEL
+#define LOG_BUILD_LEVEL_TIME LOG_BUILD_LEVEL
+#define LOG_BUILD_LEVEL_WEB LOG_BUILD_LEVEL
 #define SERIAL_BAUD 115200
+#define LOG_RING_SIZE 64                // Entries waiting to be printed (power of two)
+#define LOG_MAX_WORDS 8                 // 32-bit argument words per entry
+#define LOG_TEXT_SIZE 48                // Bytes per entry for copied string arguments
+#define LOG_LINE_LENGTH 192             // Longest formatted line
+#define LOG_DRAIN_INTERVAL 20           // ms between drain passes when idle
+#define LOG_TASK_STACK 3072
+#define LOG_TASK_PRIORITY 1             // loopTask's level, time-sliced with it; only idle is lower
+#define PROFILER_ENABLED DEBUG_MODE     // false compiles every zone out
+#define PROFILER_BUCKETS 32             // Power-of-two cycle buckets, covers the 32-bit counter
+#define TRACE_ENABLED DEBUG_MODE        // false compiles every trace point out
+#define TRACE_BUFFER_EVENTS 1024        // 8 bytes each, oldest overwritten (power of two)
+#define TRACE_MAX_TASKS 8               // Tasks with their own timeline row
 
 // ==================== PIN DEFINITIONS ====================
 // RS485 Configuration
@@ -46,29 +68,133 @@
 #define OLED_ADDRESS 0x3C
 
 // ==================== MENU SETTINGS ====================
-#define MENU_ITEMS 8
+#define MENU_ITEMS 9
 #define MAX_VISIBLE_ITEMS 4
+#define WIFI_LIST_ROWS 3        // Scan results shown on the WiFi screen
 #define MAX_SSID_LENGTH 32
 #define MAX_PASSWORD_LENGTH 64
+#define MAX_URL_LENGTH 128
+#define IP_ADDRESS_LENGTH 15    // "255.255.255.255"
 
 // ==================== ENCODER SETTINGS ====================
 #define ENCODER_STEPS 4  // EC11 has 20 pulses per rotation
-#define DEBOUNCE_DELAY 300
+#define ENCODER_ACCELERATION true   // Scale fast turns, see ENCODER_CURVE
+#define ENCODER_DETENT_QUEUE_SIZE 32 // Timestamped detents from the ISR (power of two)
+
+// ==================== BUTTON SETTINGS ====================
+#define BUTTON_DEBOUNCE_MS 20       // Level must hold this long to count
+#define BUTTON_LONG_PRESS_MS 800
+#define BUTTON_DOUBLE_CLICK_MS 250  // Max gap between clicks of a double click
+#define INPUT_EDGE_QUEUE_SIZE 64    // Raw ISR edges (power of two)
+#define INPUT_EVENT_QUEUE_SIZE 16   // Decoded events (power of two)
 
 // ==================== TIMING SETTINGS ====================
 #define SENSOR_READ_INTERVAL 5000     // 5 seconds
 #define DATA_POST_INTERVAL 30000      // 30 seconds
 #define DISPLAY_UPDATE_INTERVAL 500   // 500 ms
-#define WIFI_RECONNECT_INTERVAL 30000 // 30 seconds
+
+// ==================== WIFI SETTINGS ====================
+#define WIFI_CONNECT_TIMEOUT 15000      // Per attempt, until an IP is assigned
+#define WIFI_FAST_CONNECT_TIMEOUT 3000  // Directed join to the cached BSSID/channel
+#define WIFI_REUSE_LEASE false          // Skip DHCP on fast connect with the cached IP
+#define WIFI_LEASE_REUSE_SECONDS 3600   // Cached IP kept this long after DHCP; powered-off
+                                        // time isn't counted, so only with a reservation
+#define WIFI_STATIC_IP ""               // Non-empty: fixed address instead of DHCP
+#define WIFI_STATIC_GATEWAY ""
+#define WIFI_STATIC_SUBNET "255.255.255.0"
+#define WIFI_STATIC_DNS ""
+#define WIFI_BACKOFF_MIN_MS 2000        // First retry delay, doubled per failure
+#define WIFI_BACKOFF_MAX_MS 300000      // 5 minutes
+#define WIFI_AP_FALLBACK_ATTEMPTS 3     // Failures before the setup AP comes up
+#define WIFI_EVENT_QUEUE_SIZE 16        // Driver events to the main task (power of two)
+#define WIFI_MAX_LISTENERS 4
+#define WIFI_MAX_NETWORKS 4             // Stored credentials
+#define WIFI_MAX_SCAN_RESULTS 20
+#define WIFI_MAX_CANDIDATES 4           // Known APs tried per selection round
+#define WIFI_SCAN_TIMEOUT 10000
+#define WIFI_SCAN_CHANNELS 13           // Menu sweep covers channels 1..13
+#define WIFI_SCAN_DWELL_MS 120          // Active scan time per channel
+#define WIFI_MIN_RSSI -88               // Ignore APs weaker than this
+#define WIFI_PRIORITY_STEP_DB 20        // RSSI a backup needs per priority level
+#define WIFI_ROAM_CHECK_INTERVAL 60000
+#define WIFI_ROAM_RSSI_THRESHOLD -75    // Look for a better AP below this
+#define WIFI_ROAM_HYSTERESIS_DB 8       // Required score gain to switch
+
+// ==================== WEB SETTINGS ====================
+#define HTTP_SERVER_PORT 80
+#define PORTAL_DNS_PORT 53
+#define PORTAL_POLL_INTERVAL 20         // DNS replies and queued portal requests
+#define PORTAL_COMMAND_QUEUE_SIZE 4     // Portal requests to the main task (power of two)
+#define DASHBOARD_MAX_CLIENTS 4         // Further WebSocket clients are turned away
+#define DASHBOARD_CLEANUP_INTERVAL 1000 // Reap dead WebSocket clients
+#define DASHBOARD_FRAME_SIZE 192        // Longest JSON frame per reading
+
+// ==================== CONFIG STORE SETTINGS ====================
+#define CONFIG_NAMESPACE "config"
+#define CONFIG_COMMIT_DELAY 2000        // Commit once settings stop changing for this long
+#define CONFIG_COMMIT_MAX_DELAY 10000   // ...but never hold a change longer than this
+#define CONFIG_MAX_LISTENERS 4
+
+// ==================== BOOT SETTINGS ====================
+#define BOOT_STAGE_STACK 6144  // Bytes per boot stage task
+#define BOOT_WIFI_WAIT_MS 60000 // NTP stage stops waiting for WiFi after this
+
+// ==================== SCHEDULER SETTINGS ====================
+#define SCHEDULER_MAX_JOBS 24
+#define SCHEDULER_SPARE_JOBS 4          // Free slots setup() insists on; a full table drops jobs
+#define SCHEDULER_WHEEL_SLOTS 256       // 1 ms per slot
+#define SCHEDULER_STATS_WINDOW_MS 10000 // Idle percentage window
+#define SCHEDULER_REPORT_INTERVAL 60000 // Log jitter and idle time
+
+// ==================== TREND SETTINGS ====================
+#define TREND_COLUMNS SCREEN_WIDTH                       // One column per pixel
+#define TREND_WINDOW_MS 3600000UL                        // Last hour on screen
+#define TREND_BUCKET_MS (TREND_WINDOW_MS / TREND_COLUMNS) // ~28 s per column
 
 // ==================== NTP SETTINGS ====================
 #define NTP_SERVER "pool.ntp.org"
-#define NTP_TIMEOUT 10000
+#define NTP_TIMEOUT 10000 // Boot stage wait for the first reply; SNTP keeps trying
+#define CLOCK_SLEW_PPM 500                // Corrections phase in at up to 0.5 ms/s
+#define CLOCK_STEP_THRESHOLD_MS 30000     // Step forward when further behind than this
+#define CLOCK_MAX_DRIFT_PPM 500           // Clamp for the crystal drift estimate
+#define CLOCK_DRIFT_MIN_SPAN_MS 600000    // Shortest sync span used for drift
+#define CLOCK_DRIFT_WINDOW_MS 86400000    // Span that fully replaces the drift estimate
+#define CLOCK_CHECKPOINT_INTERVAL 30000   // Save time and drift to NVS (store debounces)
+#define CLOCK_CHECKPOINT_LEAD_MS 60000    // Floor after a reboot: saved time plus this
+#define CLOCK_FALLBACK_EPOCH 1704067200   // 2024-01-01, when there is no checkpoint yet
 
 // ==================== API SETTINGS ====================
 #define API_URL "https://aeraseaku.inkubasistartupunhas.id/sensor/"
 #define API_TIMEOUT 10000
 
+// ==================== METRICS SETTINGS ====================
+#define METRICS_MAX_SERIES 96           // Registered series, one per label set
+#define METRICS_MAX_BUCKETS 8           // Upper bounds per histogram, +Inf comes extra
+#define METRICS_IN_UPLOAD false         // Add counters and gauges to every POST
+
+// ==================== HEAP MONITOR SETTINGS ====================
+#define HEAP_SAMPLE_INTERVAL 10000      // Heap, PSRAM and task stack sampling
+#define HEAP_TRACK_ALLOCS DEBUG_MODE    // Count malloc/free per subsystem (--wrap flags in platformio.ini)
+#define HEAP_FREE_WARN 40000            // Log when free internal heap drops below this
+#define HEAP_BLOCK_WARN 20480           // ...or the largest block; a TLS handshake needs ~17 KB in one piece
+#define STACK_FREE_WARN 512             // Log when a task has touched all but this many stack bytes
+#define HEAP_MAX_TASKS 24               // Tasks scanned and tracked (all of them must fit)
+
+// ==================== CALIBRATION SETTINGS ====================
+#define CALIBRATION_SAMPLE_INTERVAL 200 // Only the calibrated probe is read meanwhile
+#define CALIBRATION_WINDOW 16           // Samples whose spread decides stability
+#define CALIBRATION_STABLE_MS 10000     // Window must stay stable this long
+#define CALIBRATION_TIMEOUT_MS 300000   // Give up if the probe never settles
+#define CALIBRATION_MAX_ERRORS 10       // Consecutive failed reads before giving up
+#define CALIBRATION_PH_TOLERANCE 0.02   // pH units, max - min over the window
+#define CALIBRATION_DO_TOLERANCE 0.05   // mg/L
+#define CALIBRATION_EC_TOLERANCE 0.01   // Fraction of the window mean
+
+// ==================== CONSOLE SETTINGS ====================
+#define CONSOLE_POLL_INTERVAL 50        // Serial input and paced dump output
+#define CONSOLE_LINE_LENGTH 160         // Longest command line
+#define CONSOLE_STREAM_MIN_MS 250       // Fastest "stream" period; every tick is one Modbus transaction
+
 // ==================== ERROR CODES ====================
 enum ErrorCode {
     ERROR_NONE = 0,
@@ -0,0 +1,297 @@
+#include "config_store.h"
+#include <Preferences.h>
+#include <stddef.h>
+#include "utils.h"
+
+ConfigStore configStore;
+
+#define CONFIG_FIELD(key, member) {key, offsetof(Data, member), sizeof(((Data*)nullptr)->member)}
+
+// Indexed by ConfigField; NVS keys are at most 15 characters
+const ConfigStore::FieldInfo ConfigStore::fields[CONFIG_FIELD_COUNT] = {
+    CONFIG_FIELD("timezone", timezone),
+    CONFIG_FIELD("serverURL", serverURL),
+    CONFIG_FIELD("networks", networks),
+    CONFIG_FIELD("fast", fastConnect),
+    CONFIG_FIELD("clock", clock)
+};
+
+ConfigStore::ConfigStore() :
+    handle(0),
+    opened(false),
+    dirty(0),
+    changed(0),
+    firstDirtyAt(0),
+    legacyPending(false),
+    commitJob(JOB_NONE),
+    notifyJob(JOB_NONE),
+    listenerCount(0) {
+
+    memset(&stats, 0, sizeof(stats));
+    setDefaults();
+}
+
+void ConfigStore::setDefaults() {
+    data = Data();
+    data.timezone = DEFAULT_TIMEZONE;
+    strlcpy(data.serverURL, API_URL, sizeof(data.serverURL));
+    data.networks.clear();
+}
+
+bool ConfigStore::begin() {
+    commitJob = scheduler.once([](void* self) {
+        static_cast<ConfigStore*>(self)->commit();
+    }, this, "config-commit");
+    notifyJob = scheduler.once([](void* self) {
+        static_cast<ConfigStore*>(self)->notify();
+    }, this, "config-notify");
+
+    if (nvs_open(CONFIG_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        LOG_E("Config store unavailable, running on defaults");
+        return false;
+    }
+    opened = true;
+
+    uint16_t version = 0;
+    nvs_get_u16(handle, "schema", &version);
+    if (version == 0) {
+        migrateLegacy();
+    } else {
+        // Fields that are missing or were saved at another size keep
+        // their defaults
+        for (int i = 0; i < CONFIG_FIELD_COUNT; i++) {
+            loadField((ConfigField)i);
+        }
+        if (version != CONFIG_SCHEMA_VERSION) {
+            LOG_I("Config schema %u -> %u", version, CONFIG_SCHEMA_VERSION);
+            dirty = (1 << CONFIG_FIELD_COUNT) - 1;
+        }
+    }
+
+    if (dirty) {
+        commit();
+    }
+    LOG_I("Config store ready, schema %u", CONFIG_SCHEMA_VERSION);
+    return true;
+}
+
+// nvs_get_blob() refuses a buffer smaller than the stored blob and fills
+// only part of a larger one, so the stored length is read first. A field
+// whose layout changed isn't reinterpreted: it keeps its default and is
+// written back at the current size.
+bool ConfigStore::loadField(ConfigField field) {
+    const FieldInfo& info = fields[field];
+    size_t length = 0;
+    if (nvs_get_blob(handle, info.key, nullptr, &length) != ESP_OK) {
+        return false;
+    }
+    if (length != info.size) {
+        LOG_I("Config %s saved as %u bytes, now %u: using the default", info.key, (unsigned)length, (unsigned)info.size);
+        dirty |= 1 << field;
+        return false;
+    }
+    return nvs_get_blob(handle, info.key, (uint8_t*)&data + info.offset, &length) == ESP_OK;
+}
+
+void ConfigStore::migrateLegacy() {
+    // Before the store, WiFiManager and TimeManager each had a namespace.
+    // They stay until the copy is committed, so a reset before that just
+    // migrates again.
+    Preferences legacy;
+    if (legacy.begin("wifi-config", true)) {
+        data.networks.loadLegacy(legacy);
+        String url = legacy.getString("serverURL", API_URL);
+        strlcpy(data.serverURL, url.c_str(), sizeof(data.serverURL));
+        if (legacy.getBytes("fast", &data.fastConnect, sizeof(data.fastConnect)) != sizeof(data.fastConnect)) {
+            memset(&data.fastConnect, 0, sizeof(data.fastConnect));
+        }
+        legacy.end();
+        legacyPending = true;
+    }
+    if (legacy.begin("time-config", true)) {
+        data.timezone = legacy.getInt("timezone", DEFAULT_TIMEZONE);
+        if (legacy.getBytes("clock", &data.clock, sizeof(data.clock)) != sizeof(data.clock)) {
+            memset(&data.clock, 0, sizeof(data.clock));
+        }
+        legacy.end();
+        legacyPending = true;
+    }
+
+    LOG_I("Config migrated from the old namespaces");
+    dirty = (1 << CONFIG_FIELD_COUNT) - 1;
+}
+
+void ConfigStore::clearLegacy() {
+    static const char* const NAMESPACES[] = {"wifi-config", "time-config"};
+    Preferences legacy;
+    for (const char* name : NAMESPACES) {
+        if (legacy.begin(name, false)) {
+            legacy.clear();
+            legacy.end();
+        }
+    }
+    legacyPending = false;
+    LOG_I("Old config namespaces erased");
+}
+
+void ConfigStore::set(ConfigField field, const void* value) {
+    const FieldInfo& info = fields[field];
+    uint8_t* slot = (uint8_t*)&data + info.offset;
+    if (memcmp(slot, value, info.size) == 0) {
+        stats.unchanged++;
+        return;
+    }
+
+    memcpy(slot, value, info.size);
+    stats.sets++;
+
+    // Debounce: commit once changes stop, but don't hold them forever
+    uint32_t now = millis();
+    if (!dirty) {
+        firstDirtyAt = now;
+    }
+    dirty |= 1 << field;
+    uint32_t pending = now - firstDirtyAt;
+    uint32_t remaining = pending < CONFIG_COMMIT_MAX_DELAY ? CONFIG_COMMIT_MAX_DELAY - pending : 0;
+    scheduler.start(commitJob, min((uint32_t)CONFIG_COMMIT_DELAY, remaining));
+
+    if (!changed) {
+        scheduler.start(notifyJob, 0);
+    }
+    changed |= 1 << field;
+}
+
+void ConfigStore::commit() {
+    scheduler.cancel(commitJob);
+    if (!dirty || !opened) return;
+
+    uint32_t written = 0;
+    uint8_t count = 0;
+    bool ok = true;
+    for (int i = 0; i < CONFIG_FIELD_COUNT; i++) {
+        if (!(dirty & (1 << i))) continue;
+        const FieldInfo& info = fields[i];
+        if (nvs_set_blob(handle, info.key, (const uint8_t*)&data + info.offset, info.size) != ESP_OK) {
+            ok = false;
+            continue;
+        }
+        written += info.size;
+        count++;
+    }
+    ok = nvs_set_u16(handle, "schema", CONFIG_SCHEMA_VERSION) == ESP_OK && ok;
+    ok = nvs_commit(handle) == ESP_OK && ok;
+
+    stats.commits++;
+    stats.fieldWrites += count;
+    stats.bytesWritten += written;
+    if (!ok) {
+        // Left dirty; the next change or commit() retries
+        stats.errors++;
+        LOG_E("Config commit failed");
+        return;
+    }
+
+    LOG_D("Config commit: %u fields, %u bytes, %u ms after the first change",
+          count, written, millis() - firstDirtyAt);
+    dirty = 0;
+    if (legacyPending) {
+        clearLegacy();
+    }
+}
+
+void ConfigStore::notify() {
+    uint32_t fieldsChanged = changed;
+    changed = 0;
+    for (int i = 0; i < CONFIG_FIELD_COUNT; i++) {
+        if (!(fieldsChanged & (1 << i))) continue;
+        for (int l = 0; l < listenerCount; l++) {
+            listeners[l].callback((ConfigField)i, listeners[l].context);
+        }
+    }
+}
+
+void ConfigStore::addListener(ConfigListener callback, void* context) {
+    if (listenerCount >= CONFIG_MAX_LISTENERS) {
+        LOG_E("Too many config listeners");
+        return;
+    }
+    listeners[listenerCount++] = {callback, context};
+}
+
+const ConfigStats& ConfigStore::getStats() {
+    return stats;
+}
+
+bool ConfigStore::isDirty() {
+    return dirty != 0;
+}
+
+void ConfigStore::reset() {
+    setDefaults();
+    if (opened) {
+        nvs_erase_all(handle);
+    }
+    dirty = (1 << CONFIG_FIELD_COUNT) - 1;
+    changed = dirty;
+    commit();
+    notify();
+}
+
+// ==================== TYPED ACCESSORS ====================
+int ConfigStore::getTimezone() {
+    return data.timezone;
+}
+
+void ConfigStore::setTimezone(int timezone) {
+    int8_t value = constrain(timezone, -12, 14);
+    set(CONFIG_TIMEZONE, &value);
+}
+
+const char* ConfigStore::getServerURL() {
+    return data.serverURL;
+}
+
+void ConfigStore::setServerURL(const char* url) {
+    char value[sizeof(data.serverURL)] = {};
+    strlcpy(value, url, sizeof(value));
+    set(CONFIG_SERVER_URL, value);
+}
+
+const WiFiNetworkList& ConfigStore::getNetworks() {
+    return data.networks;
+}
+
+void ConfigStore::setNetworks(const WiFiNetworkList& networks) {
+    set(CONFIG_NETWORKS, &networks);
+}
+
+bool ConfigStore::getFastConnect(WiFiFastConnect& out) {
+    if (data.fastConnect.ssid[0] == '\0') return false;
+    out = data.fastConnect;
+    return true;
+}
+
+void ConfigStore::setFastConnect(const WiFiFastConnect* link) {
+    WiFiFastConnect value;
+    memset(&value, 0, sizeof(value));
+    if (link) {
+        value = *link;
+    }
+    set(CONFIG_FAST_CONNECT, &value);
+}
+
+bool ConfigStore::getClockCheckpoint(ClockCheckpoint& out) {
+    if (data.clock.epochMicros == 0) return false;
+    out = data.clock;
+    return true;
+}
+
+void ConfigStore::setClockCheckpoint(const ClockCheckpoint& checkpoint) {
+    // Copied field by field so padding can't make equal values differ
+    ClockCheckpoint value;
+    memset(&value, 0, sizeof(value));
+    value.epochMicros = checkpoint.epochMicros;
+    value.driftPpb = checkpoint.driftPpb;
+    value.driftValid = checkpoint.driftValid;
+    set(CONFIG_CLOCK, &value);
+}
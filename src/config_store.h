@@ -0,0 +1,107 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <Arduino.h>
+#include <nvs.h>
+#include "config.h"
+#include "scheduler.h"
+#include "wifi_networks.h"
+#include "disciplined_clock.h"
+
+// Bump when a stored field changes layout, and migrate in begin()
+#define CONFIG_SCHEMA_VERSION 2
+
+enum ConfigField {
+    CONFIG_TIMEZONE,
+    CONFIG_SERVER_URL,
+    CONFIG_NETWORKS,
+    CONFIG_FAST_CONNECT,
+    CONFIG_CLOCK,
+    CONFIG_FIELD_COUNT
+};
+
+typedef void (*ConfigListener)(ConfigField field, void* context);
+
+struct ConfigStats {
+    uint32_t sets;              // Setter calls that changed a value
+    uint32_t unchanged;         // Setter calls that stored the same value
+    uint32_t commits;           // NVS transactions
+    uint32_t fieldWrites;       // Blobs written, summed over commits
+    uint32_t bytesWritten;
+    uint32_t errors;
+};
+
+// Every persisted setting in one RAM copy, served by typed getters. A
+// setter only marks its field dirty; dirty fields are written together in
+// a single NVS commit once changes have been quiet for CONFIG_COMMIT_DELAY
+// (or pending for CONFIG_COMMIT_MAX_DELAY). Listeners hear about each
+// changed field once per burst, from the main task.
+class ConfigStore {
+private:
+    struct Data {
+        int8_t timezone;
+        char serverURL[MAX_URL_LENGTH + 1];
+        WiFiNetworkList networks;
+        WiFiFastConnect fastConnect;    // Empty ssid: no cached link
+        ClockCheckpoint clock;          // epochMicros 0: no checkpoint
+    };
+
+    struct FieldInfo {
+        const char* key;
+        size_t offset;
+        size_t size;
+    };
+
+    struct Listener {
+        ConfigListener callback;
+        void* context;
+    };
+
+    static const FieldInfo fields[CONFIG_FIELD_COUNT];
+
+    Data data;
+    nvs_handle_t handle;
+    bool opened;
+    uint32_t dirty;             // Bit per ConfigField not yet in flash
+    uint32_t changed;           // Bit per ConfigField not yet announced
+    uint32_t firstDirtyAt;
+    bool legacyPending;         // Old namespaces to erase once the migration is committed
+    JobId commitJob;
+    JobId notifyJob;
+    Listener listeners[CONFIG_MAX_LISTENERS];
+    uint8_t listenerCount;
+    ConfigStats stats;
+
+    void setDefaults();
+    bool loadField(ConfigField field);
+    void migrateLegacy();
+    void clearLegacy();
+    void set(ConfigField field, const void* value);
+    void notify();
+
+public:
+    ConfigStore();
+    bool begin();
+    void commit();              // Writes pending changes now, e.g. before a restart
+    void addListener(ConfigListener callback, void* context = nullptr);
+    const ConfigStats& getStats();
+    bool isDirty();
+
+    int getTimezone();
+    void setTimezone(int timezone);
+    const char* getServerURL();
+    void setServerURL(const char* url);
+    const WiFiNetworkList& getNetworks();
+    void setNetworks(const WiFiNetworkList& networks);
+    bool getFastConnect(WiFiFastConnect& out);
+    void setFastConnect(const WiFiFastConnect* link);      // nullptr clears
+    bool getClockCheckpoint(ClockCheckpoint& out);
+    void setClockCheckpoint(const ClockCheckpoint& checkpoint);
+
+    // Erases every field back to the defaults
+    void reset();
+};
+
+extern ConfigStore configStore;
+
+#endif
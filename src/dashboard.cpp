@@ -0,0 +1,145 @@
+#define LOG_MODULE LOG_WEB
+#include "dashboard.h"
+#include "dashboard_page.h"
+#include "utils.h"
+#include "profiler.h"
+
+Dashboard dashboard;
+
+// Error bits in the frame, one per probe
+#define DASHBOARD_ERR_TEMP (1 << 0)
+#define DASHBOARD_ERR_PH   (1 << 1)
+#define DASHBOARD_ERR_DO   (1 << 2)
+#define DASHBOARD_ERR_EC   (1 << 3)
+#define DASHBOARD_ERR_NH4  (1 << 4)
+
+Dashboard::Dashboard() :
+    socket("/ws"),
+    frameLock(nullptr),
+    cleanupJob(JOB_NONE) {
+
+    memset(&stats, 0, sizeof(stats));
+}
+
+void Dashboard::begin() {
+    frameLock = xSemaphoreCreateMutex();
+
+    AsyncWebServer& server = httpServer.getServer();
+    socket.onEvent(onSocketEvent);
+    server.addHandler(&socket);
+
+    // Station side gets the dashboard at the root; /live also works on the
+    // setup AP, where the root belongs to the portal
+    server.on("/", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handlePage(request);
+    }).setFilter(ON_STA_FILTER);
+    server.on("/live", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handlePage(request);
+    });
+    server.on("/live/stats", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleStats(request);
+    });
+
+    // Drops clients that went away without a close frame
+    cleanupJob = scheduler.every(DASHBOARD_CLEANUP_INTERVAL, [](void* self) {
+        static_cast<Dashboard*>(self)->socket.cleanupClients(DASHBOARD_MAX_CLIENTS);
+    }, this, "dashboard");
+}
+
+void Dashboard::onSocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client,
+                              AwsEventType type, void* arg, uint8_t* data, size_t length) {
+    // AsyncTCP task
+    if (type != WS_EVT_CONNECT) return;
+
+    if (server->count() > DASHBOARD_MAX_CLIENTS) {
+        dashboard.stats.rejected++;
+        client->close();
+        return;
+    }
+    dashboard.stats.peakClients = max(dashboard.stats.peakClients, (uint8_t)server->count());
+
+    xSemaphoreTake(dashboard.frameLock, portMAX_DELAY);
+    AsyncWebSocketSharedBuffer frame = dashboard.lastFrame;
+    xSemaphoreGive(dashboard.frameLock);
+    if (frame) {
+        client->text(frame);
+    }
+}
+
+void Dashboard::publish(const SensorData& data) {
+    PROFILE_SCOPE(PROFILE_PUBLISH);
+    uint8_t errors = (data.ds18b20_error ? DASHBOARD_ERR_TEMP : 0) |
+                     (data.ph_error ? DASHBOARD_ERR_PH : 0) |
+                     (data.do_error ? DASHBOARD_ERR_DO : 0) |
+                     (data.ec_error ? DASHBOARD_ERR_EC : 0) |
+                     (data.nh4_error ? DASHBOARD_ERR_NH4 : 0);
+
+    char text[DASHBOARD_FRAME_SIZE];
+    int length = snprintf(text, sizeof(text),
+        "{\"T\":%.2f,\"pH\":%.3f,\"do\":%.3f,\"ec\":%.1f,\"tds\":%.1f,\"sal\":%.2f,\"nh4\":%.3f,\"err\":%u,\"ts\":\"%s\"}",
+        data.ds18b20_temp, data.ph_value, data.do_value, data.ec_value, data.tds_value,
+        data.salinitas_value, data.ammonia_value, errors, data.timestamp);
+    if (length <= 0 || length >= (int)sizeof(text)) {
+        LOG_E("Dashboard frame too long: %d", length);
+        return;
+    }
+
+    // Every client's send queue holds a reference to the frame. Once none
+    // does, the last buffer is refilled in place, so publishing to nobody
+    // doesn't allocate; the lock keeps a connecting client from taking a
+    // copy halfway through.
+    AsyncWebSocketSharedBuffer frame;
+    xSemaphoreTake(frameLock, portMAX_DELAY);
+    if (lastFrame && lastFrame.use_count() == 1) {
+        lastFrame->assign(text, text + length);
+    } else {
+        lastFrame = std::make_shared<std::vector<uint8_t>>();
+        lastFrame->reserve(DASHBOARD_FRAME_SIZE);
+        lastFrame->assign(text, text + length);
+    }
+    frame = lastFrame;
+    xSemaphoreGive(frameLock);
+
+    stats.frames++;
+    stats.lastFrameBytes = length;
+
+    size_t clients = socket.count();
+    if (clients == 0) return;
+
+    uint32_t start = micros();
+    AsyncWebSocket::SendStatus status = socket.textAll(frame);
+    stats.lastFanoutMicros = micros() - start;
+    stats.maxFanoutMicros = max(stats.maxFanoutMicros, stats.lastFanoutMicros);
+
+    stats.bytes += length * clients;
+    if (status != AsyncWebSocket::ENQUEUED) {
+        stats.partial++;
+    }
+}
+
+const DashboardStats& Dashboard::getStats() {
+    stats.clients = socket.count();
+    return stats;
+}
+
+// ==================== REQUEST HANDLERS ====================
+void Dashboard::handlePage(AsyncWebServerRequest* request) {
+    AsyncWebServerResponse* response = request->beginResponse(
+        200, "text/html", DASHBOARD_PAGE_GZ, sizeof(DASHBOARD_PAGE_GZ));
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("Cache-Control", "max-age=86400");
+    request->send(response);
+}
+
+void Dashboard::handleStats(AsyncWebServerRequest* request) {
+    // Read from the AsyncTCP task; a torn counter only skews one sample
+    char text[256];
+    snprintf(text, sizeof(text),
+        "{\"clients\":%u,\"peakClients\":%u,\"rejected\":%lu,\"frames\":%lu,\"bytes\":%lu,"
+        "\"partial\":%lu,\"frameBytes\":%u,\"fanoutUs\":%lu,\"maxFanoutUs\":%lu,\"freeHeap\":%lu}",
+        (unsigned)socket.count(), stats.peakClients, (unsigned long)stats.rejected,
+        (unsigned long)stats.frames, (unsigned long)stats.bytes, (unsigned long)stats.partial,
+        stats.lastFrameBytes, (unsigned long)stats.lastFanoutMicros,
+        (unsigned long)stats.maxFanoutMicros, (unsigned long)ESP.getFreeHeap());
+    request->send(200, "application/json", text);
+}
@@ -0,0 +1,51 @@
+#ifndef DASHBOARD_H
+#define DASHBOARD_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <freertos/semphr.h>
+#include "config.h"
+#include "sensor_manager.h"
+#include "scheduler.h"
+#include "http_server.h"
+
+struct DashboardStats {
+    uint32_t frames;            // Readings published
+    uint32_t bytes;             // Frame bytes queued, summed over clients
+    uint32_t partial;           // Readings some client's full queue skipped
+    uint32_t lastFanoutMicros;  // Time to queue one reading to every client
+    uint32_t maxFanoutMicros;
+    uint16_t lastFrameBytes;
+    uint8_t clients;
+    uint8_t peakClients;
+    uint32_t rejected;          // Connections over DASHBOARD_MAX_CLIENTS
+};
+
+// Live readings for a phone on the local network: a gzipped page from
+// flash plus a WebSocket that gets one small JSON frame per reading. The
+// frame is serialised once and the same buffer is queued to every client;
+// each client's queue is capped (WS_MAX_QUEUED_MESSAGES), so a slow phone
+// loses frames instead of growing the heap.
+class Dashboard {
+private:
+    AsyncWebSocket socket;
+    SemaphoreHandle_t frameLock;
+    AsyncWebSocketSharedBuffer lastFrame;   // Sent to clients as they connect
+    DashboardStats stats;
+    JobId cleanupJob;
+
+    static void onSocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client,
+                              AwsEventType type, void* arg, uint8_t* data, size_t length);
+    void handlePage(AsyncWebServerRequest* request);
+    void handleStats(AsyncWebServerRequest* request);
+
+public:
+    Dashboard();
+    void begin();
+    void publish(const SensorData& data);
+    const DashboardStats& getStats();
+};
+
+extern Dashboard dashboard;
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef DASHBOARD_PAGE_H
+#define DASHBOARD_PAGE_H
+
+#include <Arduino.h>
+
+// web/dashboard.html, gzip -9 (1564 bytes uncompressed). Regenerate after
+// editing the page: gzip -9nc web/dashboard.html | xxd -i
+static const uint8_t DASHBOARD_PAGE_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x7d, 0x55, 0x6d, 0x6f, 0xdb, 0x36,
+    0x10, 0xfe, 0xae, 0x5f, 0xa1, 0xb9, 0x40, 0x69, 0x21, 0xb2, 0x6c, 0x39, 0x59, 0x66, 0xe8, 0xc5,
+    0xc3, 0x96, 0x17, 0x74, 0x43, 0xd6, 0x6c, 0x70, 0x80, 0x62, 0x30, 0x8c, 0x81, 0x16, 0x4f, 0x12,
+    0x51, 0x91, 0x14, 0x48, 0xca, 0x8e, 0x6b, 0xf8, 0xbf, 0xef, 0x28, 0x3b, 0x71, 0x3b, 0x2c, 0xfd,
+    0x60, 0x89, 0xf7, 0xdc, 0xdb, 0xc3, 0x3b, 0xdd, 0x39, 0xfb, 0xe1, 0xf6, 0xf1, 0xe6, 0xe9, 0xef,
+    0x3f, 0xef, 0xfc, 0xda, 0x8a, 0x66, 0xee, 0x65, 0xfd, 0x2b, 0xab, 0x81, 0xb2, 0x79, 0x26, 0xc0,
+    0x52, 0xbf, 0xa8, 0xa9, 0x36, 0x60, 0xf3, 0x41, 0x67, 0xcb, 0xd1, 0x6c, 0x70, 0x42, 0x25, 0x15,
+    0x90, 0x0f, 0x36, 0x1c, 0xb6, 0xad, 0xd2, 0x76, 0xe0, 0x17, 0x4a, 0x5a, 0x90, 0x68, 0xb5, 0xe5,
+    0xcc, 0xd6, 0x39, 0x83, 0x0d, 0x2f, 0x60, 0xd4, 0x0b, 0x21, 0x97, 0xdc, 0x72, 0xda, 0x8c, 0x4c,
+    0x41, 0x1b, 0xc8, 0xe3, 0x01, 0x66, 0xb1, 0xdc, 0x36, 0x30, 0xff, 0x44, 0x2d, 0x68, 0x7f, 0x01,
+    0xd2, 0x28, 0xed, 0x3f, 0xf0, 0x0d, 0x64, 0xe3, 0xa3, 0xc2, 0xcb, 0x8c, 0xdd, 0xb9, 0xf7, 0x5a,
+    0xb1, 0xdd, 0xbe, 0xc4, 0xd8, 0xa3, 0x92, 0x0a, 0xde, 0xec, 0x12, 0x43, 0xa5, 0x19, 0x19, 0xd0,
+    0xbc, 0x4c, 0x05, 0x7d, 0x3e, 0x26, 0x48, 0x2e, 0x27, 0x20, 0x50, 0xd4, 0x15, 0x97, 0x49, 0x0c,
+    0xc2, 0xa7, 0x9d, 0x55, 0x69, 0x4b, 0x19, 0xe3, 0xb2, 0x4a, 0x26, 0x3e, 0x42, 0x69, 0xa1, 0x1a,
+    0xa5, 0x93, 0x77, 0xf1, 0xf4, 0xf2, 0xe0, 0xd5, 0xf1, 0x31, 0xa4, 0xe1, 0x5f, 0x20, 0x89, 0xa3,
+    0x4b, 0x10, 0x87, 0x77, 0xc6, 0xee, 0xcb, 0x46, 0x51, 0x9b, 0x68, 0x5e, 0xd5, 0x36, 0x3d, 0xeb,
+    0xa3, 0xd9, 0xd9, 0x7b, 0x36, 0x9b, 0x1d, 0xbc, 0xa8, 0xda, 0x33, 0x6e, 0xda, 0x86, 0xee, 0x92,
+    0x4a, 0x73, 0x96, 0xba, 0xc7, 0xc8, 0x82, 0x40, 0xc4, 0xc2, 0x08, 0x2d, 0x3b, 0x21, 0x4d, 0x12,
+    0x97, 0xda, 0xc7, 0x5f, 0x5a, 0xd1, 0x36, 0x89, 0xae, 0x31, 0x83, 0x17, 0x15, 0xfb, 0x35, 0x2d,
+    0x3e, 0x57, 0x5a, 0x75, 0x92, 0x25, 0xef, 0x00, 0xca, 0x1f, 0xcb, 0x59, 0xba, 0x56, 0x9a, 0x81,
+    0x1e, 0x69, 0xca, 0x78, 0x67, 0x92, 0xeb, 0xf6, 0xf9, 0x95, 0xf7, 0x8b, 0x97, 0xbf, 0x7e, 0xcd,
+    0xb7, 0x6e, 0x54, 0xf1, 0x39, 0xfd, 0x9a, 0xbb, 0xb3, 0x89, 0x8a, 0x08, 0xbe, 0x09, 0x5d, 0x32,
+    0x38, 0x78, 0x46, 0xd0, 0xa6, 0xd9, 0x9f, 0x88, 0x5f, 0xff, 0x84, 0xc4, 0xb3, 0xf1, 0xb1, 0xa8,
+    0xd9, 0xf8, 0xd8, 0x5d, 0x57, 0x5b, 0xd7, 0xf0, 0xf8, 0xd4, 0x87, 0xbf, 0x3a, 0xda, 0x70, 0xbb,
+    0xf3, 0x33, 0xd3, 0x52, 0xe9, 0x73, 0x96, 0x0f, 0x8c, 0x1d, 0xcc, 0xb1, 0xb1, 0x12, 0x0a, 0x8b,
+    0x8c, 0xd0, 0x1f, 0x15, 0xce, 0x3d, 0x46, 0x37, 0xc6, 0x37, 0x7e, 0xd1, 0x50, 0x63, 0xf2, 0x41,
+    0x35, 0xe8, 0xad, 0x2b, 0xfc, 0x36, 0xc6, 0x08, 0xa3, 0xb2, 0x9d, 0x67, 0x7d, 0xfe, 0x1e, 0xb7,
+    0xc6, 0x29, 0x7a, 0x19, 0xdf, 0xad, 0x6b, 0x6e, 0xa1, 0x79, 0x6b, 0xe7, 0xde, 0x86, 0x6a, 0xff,
+    0x3e, 0x5f, 0x2e, 0xc9, 0x13, 0x09, 0xc9, 0x13, 0x96, 0x10, 0x34, 0xb5, 0x9d, 0x06, 0x94, 0xde,
+    0x33, 0xa8, 0xd2, 0x1b, 0x12, 0xc6, 0x61, 0xbc, 0x0a, 0x97, 0xa4, 0xfd, 0x80, 0x58, 0xff, 0x20,
+    0xe1, 0x34, 0x9c, 0x3a, 0x88, 0x29, 0x94, 0x6e, 0xb9, 0x31, 0xaa, 0xd9, 0x00, 0xf3, 0x1f, 0xa7,
+    0x28, 0x8a, 0x6a, 0xfc, 0xe0, 0x0c, 0xae, 0x56, 0xa1, 0xb7, 0x24, 0x50, 0x20, 0x74, 0xa3, 0x24,
+    0xeb, 0x90, 0xff, 0x06, 0xaf, 0xe6, 0xe2, 0x0a, 0x5e, 0x68, 0x95, 0x2e, 0xc6, 0x85, 0x20, 0xe1,
+    0x24, 0x9c, 0xb9, 0x48, 0x96, 0x19, 0x97, 0xff, 0x76, 0xe1, 0x72, 0xb4, 0x67, 0xdc, 0xd0, 0x06,
+    0x91, 0x05, 0x56, 0x45, 0x1e, 0x9d, 0xdb, 0xd6, 0x3a, 0x46, 0xbd, 0x52, 0xd6, 0x57, 0x88, 0xfc,
+    0x22, 0x84, 0x92, 0x9c, 0xbe, 0x38, 0x4e, 0xc3, 0xf8, 0x7a, 0xb5, 0x4a, 0xfb, 0x8b, 0x55, 0x39,
+    0x53, 0x45, 0x27, 0x70, 0x28, 0xa2, 0x0a, 0xec, 0x5d, 0x03, 0xee, 0xf8, 0xeb, 0xee, 0x37, 0x36,
+    0x24, 0x15, 0x09, 0xc2, 0x3a, 0x27, 0x24, 0xf5, 0xee, 0xa3, 0x52, 0xe9, 0x3b, 0x5a, 0xd4, 0xc3,
+    0xb2, 0x93, 0xc8, 0x52, 0xc9, 0x61, 0x19, 0xec, 0xeb, 0x8b, 0x9c, 0x7c, 0x5d, 0xe0, 0xe2, 0x58,
+    0xe0, 0x82, 0x5c, 0x94, 0xcb, 0xc9, 0xea, 0x82, 0x0c, 0xe6, 0xee, 0x14, 0xe3, 0x29, 0x5b, 0xf7,
+    0x9a, 0xcd, 0x59, 0x33, 0xca, 0xc6, 0xeb, 0x53, 0xf5, 0x7b, 0xab, 0xa9, 0xb3, 0x7a, 0xad, 0xbe,
+    0x6b, 0x0f, 0x39, 0x04, 0xa9, 0x57, 0x45, 0x1c, 0xfb, 0xaa, 0x3f, 0x3c, 0xfd, 0xf1, 0x90, 0xd7,
+    0xa9, 0xf7, 0x92, 0xdd, 0x37, 0xb5, 0xda, 0x0e, 0x59, 0xb0, 0xff, 0x7f, 0x62, 0xde, 0x9b, 0x57,
+    0x3a, 0x31, 0x08, 0x22, 0x0b, 0xcf, 0xf6, 0xe6, 0xb4, 0x0c, 0xd8, 0xd2, 0x61, 0xab, 0xc8, 0xaa,
+    0x7b, 0xfe, 0x0c, 0x6c, 0x58, 0x2e, 0x2f, 0x57, 0x98, 0xfb, 0xcd, 0x20, 0xc5, 0x4b, 0x90, 0xfe,
+    0xde, 0x1f, 0xdd, 0x8a, 0x71, 0xd8, 0x90, 0x45, 0xa0, 0xf5, 0xfb, 0x72, 0x79, 0xb5, 0xfa, 0x99,
+    0xf8, 0x40, 0x12, 0x42, 0x82, 0xc3, 0xf7, 0xe2, 0x58, 0x43, 0xfe, 0x43, 0x24, 0xb2, 0xe6, 0x70,
+    0xbe, 0xa4, 0x6a, 0x41, 0xfe, 0x33, 0x0c, 0xf6, 0xae, 0x4d, 0xdb, 0x5c, 0xc2, 0xd6, 0xff, 0x04,
+    0xeb, 0x05, 0xce, 0x16, 0xd8, 0x21, 0xd9, 0x9a, 0x64, 0x3c, 0x26, 0x17, 0x38, 0x6a, 0xd4, 0x19,
+    0x47, 0xb5, 0x32, 0xf6, 0x82, 0x8c, 0xb7, 0x18, 0x33, 0x34, 0xf6, 0xed, 0xa6, 0x1a, 0x4b, 0x90,
+    0xd3, 0x36, 0x52, 0xd2, 0x85, 0xcf, 0x5f, 0xcb, 0x16, 0xec, 0x8d, 0xfd, 0x86, 0x0c, 0x69, 0x70,
+    0xd3, 0x91, 0xc3, 0xd1, 0x56, 0x80, 0x31, 0xb4, 0x82, 0xb3, 0xb9, 0x40, 0x7b, 0xd7, 0x83, 0xdf,
+    0x17, 0x8f, 0x1f, 0xa3, 0xd6, 0xad, 0xde, 0xa1, 0x88, 0x18, 0xb5, 0x34, 0x08, 0x4e, 0x2e, 0x45,
+    0xa3, 0x0c, 0x7c, 0x2f, 0xbe, 0x86, 0xf3, 0xd0, 0x92, 0x14, 0x77, 0xf7, 0x13, 0x17, 0xa0, 0x3a,
+    0x3b, 0xec, 0xef, 0x1d, 0x4e, 0x27, 0x93, 0x49, 0x70, 0x38, 0x78, 0xa7, 0x2a, 0xa4, 0x6e, 0x31,
+    0x1c, 0x07, 0x12, 0x3f, 0x1d, 0xb7, 0x13, 0x70, 0xc2, 0xfb, 0xff, 0x82, 0x7f, 0x01, 0x84, 0x51,
+    0x8d, 0xb3, 0x1c, 0x06, 0x00, 0x00
+};
+
+#endif
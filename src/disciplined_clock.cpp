@@ -0,0 +1,121 @@
+#include "disciplined_clock.h"
+
+static int64_t clampValue(int64_t value, int64_t low, int64_t high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+DisciplinedClock::DisciplinedClock(const ClockTuning& tuning) :
+    tuning(tuning),
+    baseLocal(0),
+    baseEpoch(0),
+    slewTotal(0),
+    driftPpb(0),
+    driftValid(false),
+    refLocal(0),
+    refEpoch(0),
+    hasReference(false),
+    lastReturned(0),
+    stats() {
+}
+
+void DisciplinedClock::start(int64_t local, int64_t epochMicros, int32_t savedDriftPpb, bool savedDriftValid,
+                             int64_t floorMicros) {
+    baseLocal = local;
+    baseEpoch = epochMicros;
+    slewTotal = 0;
+    driftPpb = savedDriftValid ? clampValue(savedDriftPpb, -tuning.maxDriftPpm * 1000LL, tuning.maxDriftPpm * 1000LL) : 0;
+    driftValid = savedDriftValid;
+    hasReference = false;
+    lastReturned = floorMicros > epochMicros ? floorMicros : epochMicros;
+}
+
+int64_t DisciplinedClock::estimate(int64_t local) const {
+    int64_t elapsed = local - baseLocal;
+    int64_t epoch = baseEpoch + elapsed + elapsed * driftPpb / 1000000000LL;
+
+    // The pending correction comes in no faster than slewPpm
+    int64_t maxSlew = elapsed * tuning.slewPpm / 1000000LL;
+    return epoch + clampValue(slewTotal, -maxSlew, maxSlew);
+}
+
+void DisciplinedClock::sync(int64_t local, int64_t epochMicros) {
+    int64_t predicted = estimate(local);
+    int64_t error = epochMicros - predicted;
+    bool first = !hasReference;
+    stats.syncs++;
+    stats.lastErrorMicros = error;
+
+    // Drift is measured between replies, so the estimate's own error
+    // doesn't feed back. Reply jitter divided by the span is the noise, so
+    // the reference stays put for a whole window and longer spans weigh more.
+    int64_t span = local - refLocal;
+    if (!hasReference) {
+        refLocal = local;
+        refEpoch = epochMicros;
+        hasReference = true;
+    } else if (span >= tuning.minDriftSpanMicros) {
+        int64_t gained = (epochMicros - refEpoch) - span;
+        int64_t limit = tuning.maxDriftPpm * 1000LL;
+        int64_t measured = clampValue(gained * 1000000000LL / span, -limit, limit);
+        int64_t weight = driftValid ? clampValue(span * 1024 / tuning.driftWindowMicros, 64, 1024) : 1024;
+        driftPpb += (measured - driftPpb) * weight / 1024;
+        driftValid = true;
+        stats.driftUpdates++;
+        if (span >= tuning.driftWindowMicros) {
+            refLocal = local;
+            refEpoch = epochMicros;
+        }
+    }
+
+    baseLocal = local;
+    if (error > tuning.stepThresholdMicros || (first && error > 0)) {
+        // Far behind (long outage), or behind at all on the first reply
+        // after start(), which was only a guess: jump forward
+        baseEpoch = epochMicros;
+        slewTotal = 0;
+        stats.steps++;
+    } else {
+        // Ahead or slightly behind: phase the difference in, never step back
+        baseEpoch = predicted;
+        slewTotal = error;
+    }
+}
+
+void DisciplinedClock::rebase(int64_t local) {
+    int64_t elapsed = local - baseLocal;
+    int64_t maxSlew = elapsed * tuning.slewPpm / 1000000LL;
+    int64_t applied = clampValue(slewTotal, -maxSlew, maxSlew);
+
+    baseEpoch = estimate(local);
+    baseLocal = local;
+    slewTotal -= applied;
+}
+
+int64_t DisciplinedClock::now(int64_t local) {
+    int64_t epoch = estimate(local);
+    if (epoch < lastReturned) {
+        epoch = lastReturned;
+    }
+    lastReturned = epoch;
+    return epoch;
+}
+
+int64_t DisciplinedClock::peek(int64_t local) const {
+    return estimate(local);
+}
+
+int32_t DisciplinedClock::getDriftPpb() const {
+    return driftPpb;
+}
+
+bool DisciplinedClock::isDriftValid() const {
+    return driftValid;
+}
+
+bool DisciplinedClock::isSynced() const {
+    return hasReference;
+}
+
+const ClockStats& DisciplinedClock::getStats() const {
+    return stats;
+}
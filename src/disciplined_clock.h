@@ -0,0 +1,71 @@
+#ifndef DISCIPLINED_CLOCK_H
+#define DISCIPLINED_CLOCK_H
+
+// Maps the local microsecond counter to epoch time between NTP replies.
+// Successive syncs give the crystal's drift rate, which is applied while
+// offline; the residual error of each sync is slewed in at a bounded rate
+// rather than stepped, and now() never goes backwards. Plain integer
+// maths with the local clock passed in, so it runs on the host against a
+// simulated crystal.
+
+#include <stdint.h>
+
+struct ClockTuning {
+    int32_t slewPpm;            // Max rate a correction is applied at
+    int64_t stepThresholdMicros;// Forward errors beyond this are stepped
+    int32_t maxDriftPpm;        // Drift estimates are clamped to this
+    int64_t minDriftSpanMicros; // Shortest sync interval used for drift
+    int64_t driftWindowMicros;  // Span whose estimate replaces the old one fully
+};
+
+// Saved so a reboot without network resumes near the right time
+struct ClockCheckpoint {
+    int64_t epochMicros;
+    int32_t driftPpb;
+    uint8_t driftValid;
+};
+
+struct ClockStats {
+    uint32_t syncs;
+    uint32_t steps;
+    uint32_t driftUpdates;
+    int64_t lastErrorMicros;    // Reply minus our estimate at the last sync
+};
+
+class DisciplinedClock {
+private:
+    ClockTuning tuning;
+    int64_t baseLocal;          // Estimate is linear from this point...
+    int64_t baseEpoch;          // ...where it read this
+    int64_t slewTotal;          // Correction being phased in since baseLocal
+    int32_t driftPpb;           // Positive: the local clock runs slow
+    bool driftValid;
+    int64_t refLocal;           // Sync the next drift measurement spans from
+    int64_t refEpoch;
+    bool hasReference;
+    int64_t lastReturned;
+    ClockStats stats;
+
+    int64_t estimate(int64_t local) const;
+
+public:
+    explicit DisciplinedClock(const ClockTuning& tuning);
+
+    // Starts from a saved checkpoint (or a fallback epoch) before any sync.
+    // now() holds at floorMicros until the estimate passes it, so nothing
+    // handed out before a reboot is repeated after it.
+    void start(int64_t local, int64_t epochMicros, int32_t savedDriftPpb, bool savedDriftValid,
+               int64_t floorMicros = 0);
+    void sync(int64_t local, int64_t epochMicros);
+    // Moves the base forward; call now and then so products stay small
+    void rebase(int64_t local);
+
+    int64_t now(int64_t local);  // Epoch micros, monotonic
+    int64_t peek(int64_t local) const;  // The estimate itself, without the hold
+    int32_t getDriftPpb() const;
+    bool isDriftValid() const;
+    bool isSynced() const;
+    const ClockStats& getStats() const;
+};
+
+#endif
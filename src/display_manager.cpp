@@ -1,4 +1,7 @@
+#define LOG_MODULE LOG_DISPLAY
 #include "display_manager.h"
+#include "profiler.h"
+#include "heap_monitor.h"
 #include <ArduinoJson.h>
 
 DisplayManager displayManager;
@@ -6,14 +9,21 @@ DisplayManager displayManager;
 DisplayManager::DisplayManager() : 
     display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RST),
     displayAvailable(false),
-    lastUpdate(0) {
+    lastUpdate(0),
+    trendPlotValid(false),
+    trendRevision(0),
+    trendLastRead(0) {
+    for (int ch = 0; ch < TREND_CHANNEL_COUNT; ch++) {
+        trendScaleMin[ch] = 0;
+        trendScaleMax[ch] = 0;
+    }
 }
 
 bool DisplayManager::begin() {
     Wire.begin(OLED_SDA, OLED_SCL);
     
     if (!display.begin(OLED_ADDRESS, true)) {
-        Serial.println("❌ SH1106 display not found");
+        LOG_E("❌ SH1106 display not found");
         return false;
     }
     
@@ -23,22 +33,24 @@ bool DisplayManager::begin() {
     display.setTextSize(1);
     display.setCursor(0, 0);
     
-    Serial.println("✅ OLED Display initialized");
+    LOG_I("✅ OLED Display initialized");
     return true;
 }
 
 void DisplayManager::clear() {
     if (!displayAvailable) return;
+    trendPlotValid = false;
     display.clearDisplay();
     display.setCursor(0, 0);
 }
 
 void DisplayManager::update() {
     if (!displayAvailable) return;
+    PROFILE_SCOPE(PROFILE_FLUSH);
     display.display();
 }
 
-void DisplayManager::drawHeader(const String& title, bool showStatus) {
+void DisplayManager::drawHeader(const char* title, bool showStatus) {
     display.setTextSize(1);
     display.setCursor(0, 0);
     display.print(title);
@@ -56,12 +68,12 @@ void DisplayManager::drawHeader(const String& title, bool showStatus) {
     drawHorizontalLine(9);
 }
 
-void DisplayManager::drawFooter(const String& line1, const String& line2) {
+void DisplayManager::drawFooter(const char* line1, const char* line2) {
     drawHorizontalLine(54);
     display.setCursor(2, 56);
     display.print(line1);
     
-    if (line2.length() > 0) {
+    if (line2[0] != '\0') {
         display.setCursor(2, 58);
         display.print(line2);
     }
@@ -93,6 +105,7 @@ void DisplayManager::showSplashScreen() {
 
 void DisplayManager::showSensorData(const SensorData& data) {
     if (!displayAvailable) return;
+    PROFILE_SCOPE(PROFILE_SCREEN_SENSORS);
     
     clear();
     drawHeader("📊 SENSOR DATA", true);
@@ -137,15 +150,22 @@ void DisplayManager::showSensorData(const SensorData& data) {
         display.print("⚠");
     }
     
-    drawFooter("A:Refresh B:Menu", data.timestamp.substring(11, 16));
+    drawFooter("A:Refresh B:Menu");
+    
+    // HH:MM straight out of the fixed-width timestamp
+    if (data.timestamp[0] != '\0') {
+        display.setCursor(2, 58);
+        display.write(data.timestamp + 11, 5);
+    }
     update();
 }
 
-void DisplayManager::showMainMenu(const String menuItems[], int itemCount, int selectedIndex, int scrollOffset) {
+void DisplayManager::showMenuList(const char* title, const MenuItem items[], int itemCount, int selectedIndex, int scrollOffset, const char* hint) {
     if (!displayAvailable) return;
+    PROFILE_SCOPE(PROFILE_SCREEN_MENU);
     
     clear();
-    drawHeader("🌊 MAIN MENU", false);
+    drawHeader(title, false);
     
     for (int i = 0; i < MAX_VISIBLE_ITEMS; i++) {
         int itemIndex = i + scrollOffset;
@@ -159,7 +179,7 @@ void DisplayManager::showMainMenu(const String menuItems[], int itemCount, int s
             display.print(" ");
         }
         
-        display.println(menuItems[itemIndex]);
+        display.println(items[itemIndex].label);
     }
     
     // Scroll indicators
@@ -172,17 +192,20 @@ void DisplayManager::showMainMenu(const String menuItems[], int itemCount, int s
         display.print("↓");
     }
     
-    drawFooter("A:Select B:Back", "Enc:Navigate");
+    drawFooter(hint, "Enc:Navigate");
     update();
 }
 
 void DisplayManager::showSensorDetail(const SensorData& data, int selectedSensor) {
     if (!displayAvailable) return;
+    PROFILE_SCOPE(PROFILE_SCREEN_DETAIL);
     
     clear();
     
-    String sensorNames[] = {"TEMPERATURE", "pH VALUE", "DISSOLVED OXYGEN", "CONDUCTIVITY", "AMMONIA", "SALINITY"};
-    String sensorIcons[] = {"🌡", "🧪", "💧", "⚡", "🔬", "🧂"};
+    static const char* const sensorNames[] = {"TEMPERATURE", "pH VALUE", "DISSOLVED OXYGEN", "CONDUCTIVITY", "AMMONIA", "SALINITY"};
+    static const char* const sensorIcons[] = {"🌡", "🧪", "💧", "⚡", "🔬", "🧂"};
+    
+    if (selectedSensor < 0 || selectedSensor >= Utils::countOf(sensorNames)) return;
     
     display.setCursor(0, 0);
     display.print(sensorIcons[selectedSensor]);
@@ -257,62 +280,60 @@ void DisplayManager::showSensorDetail(const SensorData& data, int selectedSensor
     update();
 }
 
-void DisplayManager::showWiFiConfig(const String& ssid, const String& status, const String& ip, int rssi, bool apMode) {
+void DisplayManager::showWiFiConfig(const char* ssid, const char* status, const char* ip, int rssi, bool apMode,
+                                    const WiFiScanEntry* results, int resultCount, int selectedIndex, int scrollOffset,
+                                    int scanChannel) {
     if (!displayAvailable) return;
+    PROFILE_SCOPE(PROFILE_SCREEN_WIFI);
     
     clear();
     drawHeader("📶 WIFI CONFIG", false);
     
     display.setCursor(0, 12);
-    display.print("SSID: ");
-    display.println(ssid.length() > 0 ? ssid : "Not Set");
-    
-    display.print("Status: ");
-    display.println(status);
-    
-    display.print("IP: ");
-    display.println(ip);
+    display.print(apMode ? "AP " : "");
+    display.print(status);
+    display.print(": ");
+    display.print(ssid[0] ? ssid : "Not Set");
     
+    display.setCursor(0, 20);
+    display.print(ip);
     if (!apMode && rssi != 0) {
-        display.print("RSSI: ");
+        display.print(" ");
         display.print(rssi);
-        display.println(" dBm");
+        display.print("dBm");
     }
     
-    display.print("Mode: ");
-    display.println(apMode ? "Access Point" : "Client");
-    
-    drawFooter("A:Scan B:Back", "Enc:Change SSID");
-    update();
-}
-
-void DisplayManager::showCalibrationMenu(const String menuItems[], int itemCount, int selectedIndex, int scrollOffset) {
-    if (!displayAvailable) return;
-    
-    clear();
-    drawHeader("⚙️ CALIBRATION", false);
-    
-    for (int i = 0; i < MAX_VISIBLE_ITEMS; i++) {
-        int itemIndex = i + scrollOffset;
-        if (itemIndex >= itemCount) break;
-        
-        display.setCursor(2, 12 + i * 12);
-        
-        if (itemIndex == selectedIndex) {
-            display.print(">");
-        } else {
-            display.print(" ");
-        }
+    // Scan results, strongest first
+    if (resultCount == 0) {
+        display.setCursor(2, 34);
+        display.print(scanChannel ? "Scanning..." : "No networks, A to scan");
+    }
+    for (int i = 0; i < WIFI_LIST_ROWS; i++) {
+        int index = i + scrollOffset;
+        if (index >= resultCount) break;
         
-        display.println(menuItems[itemIndex]);
+        int y = 30 + i * 8;
+        display.setCursor(2, y);
+        display.print(index == selectedIndex ? ">" : " ");
+        const char* name = results[index].ssid;
+        display.write((const uint8_t*)name, min(strlen(name), (size_t)16));
+        display.setCursor(104, y);
+        display.print(results[index].rssi);
     }
     
-    drawFooter("A:Start Calib B:Back", "Enc:Select Point");
+    drawFooter("A:Scan Enc:Join");
+    if (scanChannel) {
+        display.setCursor(98, 56);
+        display.print(scanChannel);
+        display.print("/");
+        display.print(WIFI_SCAN_CHANNELS);
+    }
     update();
 }
 
-void DisplayManager::showCalibrationProgress(const String& sensorName, const String& instruction, float currentValue, int progress) {
+void DisplayManager::showCalibrationProgress(const char* sensorName, const char* instruction, float currentValue, int progress) {
     if (!displayAvailable) return;
+    PROFILE_SCOPE(PROFILE_SCREEN_CALIBRATION);
     
     clear();
     drawHeader("🔧 CALIBRATING", false);
@@ -338,8 +359,9 @@ void DisplayManager::showCalibrationProgress(const String& sensorName, const Str
     update();
 }
 
-void DisplayManager::showTimeConfig(int timezone, const String& currentTime, bool timeSynced) {
+void DisplayManager::showTimeConfig(int timezone, const char* currentTime, bool timeSynced) {
     if (!displayAvailable) return;
+    PROFILE_SCOPE(PROFILE_SCREEN_TIME);
     
     clear();
     drawHeader("🕐 TIME CONFIG", false);
@@ -363,8 +385,9 @@ void DisplayManager::showTimeConfig(int timezone, const String& currentTime, boo
     update();
 }
 
-void DisplayManager::showSystemInfo(const SensorData& data, const String& uptime, int workingSensors) {
+void DisplayManager::showSystemInfo(const SensorData& data, const char* uptime, int workingSensors) {
     if (!displayAvailable) return;
+    PROFILE_SCOPE(PROFILE_SCREEN_SYSTEM);
     
     clear();
     drawHeader("ℹ️ SYSTEM INFO", false);
@@ -388,41 +411,24 @@ void DisplayManager::showSystemInfo(const SensorData& data, const String& uptime
     display.print(secondsAgo);
     display.println("s ago");
     
-    display.print("Memory: ");
-    display.print(ESP.getFreeHeap() / 1024);
-    display.println(" KB free");
-    
-    drawFooter("B:Back to Menu", "");
-    update();
-}
-
-void DisplayManager::showSettingsMenu(const String menuItems[], int itemCount, int selectedIndex) {
-    if (!displayAvailable) return;
-    
-    clear();
-    drawHeader("⚡ SETTINGS", false);
-    
-    for (int i = 0; i < itemCount; i++) {
-        display.setCursor(2, 12 + i * 12);
-        
-        if (i == selectedIndex) {
-            display.print(">");
-        } else {
-            display.print(" ");
-        }
-        
-        display.println(menuItems[i]);
-    }
+    // Free heap and the largest block in it; the gap is fragmentation
+    const HeapSample& heap = heapMonitor.getSample();
+    display.print("Heap: ");
+    display.print(heap.freeBytes / 1024);
+    display.print("K blk ");
+    display.print(heap.largestBlock / 1024);
+    display.println("K");
     
-    drawFooter("A:Execute B:Back", "Enc:Navigate");
+    drawFooter("B:Back to Menu");
     update();
 }
 
 void DisplayManager::showMessage(const String& title, const String& message, bool success) {
     if (!displayAvailable) return;
+    PROFILE_SCOPE(PROFILE_SCREEN_MESSAGE);
     
     clear();
-    drawHeader(title, false);
+    drawHeader(title.c_str(), false);
     
     display.setCursor(0, 15);
     display.println(message);
@@ -440,6 +446,7 @@ void DisplayManager::showError(const String& title, const String& message) {
 
 void DisplayManager::showScanningAnimation(const String& message) {
     if (!displayAvailable) return;
+    PROFILE_SCOPE(PROFILE_SCREEN_SCANNING);
     
     clear();
     drawHeader("🔍 SCANNING", false);
@@ -460,6 +467,142 @@ void DisplayManager::showScanningAnimation(const String& message) {
     update();
 }
 
+// Trend layout: each channel gets one text page followed by three plot pages.
+// Plots are page aligned so scrolling is a per-page memmove of the buffer.
+#define TREND_LABEL_PAGE_DO 0
+#define TREND_LABEL_PAGE_TEMP 4
+#define TREND_PLOT_PAGES 3
+#define TREND_PLOT_HEIGHT (TREND_PLOT_PAGES * 8)
+#define TREND_SCALE_STEP 0.5f
+#define TREND_MIN_SPAN 1.0f
+
+static int trendLabelPage(TrendChannel channel) {
+    return channel == TREND_DO ? TREND_LABEL_PAGE_DO : TREND_LABEL_PAGE_TEMP;
+}
+
+void DisplayManager::showTrendGraph(const TrendHistory& history, const SensorData& data) {
+    if (!displayAvailable) return;
+    PROFILE_SCOPE(PROFILE_SCREEN_TREND);
+    
+    uint32_t revision = history.getRevision();
+    
+    // Nothing new to show: keep the panel as it is and spare the I2C bus
+    if (trendPlotValid && revision == trendRevision && data.lastRead == trendLastRead) {
+        return;
+    }
+    
+    bool replotAll = !trendPlotValid || (revision - trendRevision) >= TREND_COLUMNS;
+    int newColumns = replotAll ? 0 : (int)(revision - trendRevision);
+    
+    if (!trendPlotValid) {
+        display.clearDisplay();
+    }
+    
+    for (int ch = 0; ch < TREND_CHANNEL_COUNT; ch++) {
+        TrendChannel channel = (TrendChannel)ch;
+        float minValue, maxValue;
+        computeTrendScale(history, channel, minValue, maxValue);
+        
+        // Auto-scale only forces a replot when the rounded range moves
+        bool scaleChanged = (minValue != trendScaleMin[ch] || maxValue != trendScaleMax[ch]);
+        trendScaleMin[ch] = minValue;
+        trendScaleMax[ch] = maxValue;
+        
+        if (replotAll || scaleChanged) {
+            replotTrendChannel(history, channel);
+        } else if (newColumns > 0) {
+            scrollTrendChannel(history, channel, newColumns);
+        }
+    }
+    
+    // Labels span the full width, so the dirty window also covers the
+    // columns scrolled directly in the buffer
+    drawTrendLabel(TREND_DO, data.do_value, data.do_error);
+    drawTrendLabel(TREND_TEMPERATURE, data.ds18b20_temp, data.ds18b20_error);
+    
+    trendPlotValid = true;
+    trendRevision = revision;
+    trendLastRead = data.lastRead;
+    update();
+}
+
+void DisplayManager::computeTrendScale(const TrendHistory& history, TrendChannel channel, float& minValue, float& maxValue) {
+    float lo, hi;
+    if (!history.getRange(channel, lo, hi)) {
+        minValue = 0;
+        maxValue = TREND_MIN_SPAN;
+        return;
+    }
+    
+    // Round outwards to the scale step so small wiggles keep the same scale
+    minValue = floorf(lo / TREND_SCALE_STEP) * TREND_SCALE_STEP;
+    maxValue = ceilf(hi / TREND_SCALE_STEP) * TREND_SCALE_STEP;
+    if (maxValue - minValue < TREND_MIN_SPAN) {
+        maxValue = minValue + TREND_MIN_SPAN;
+    }
+}
+
+void DisplayManager::plotTrendColumn(TrendChannel channel, int x, const TrendColumn& column) {
+    if (!column.valid) return;
+    
+    int top = (trendLabelPage(channel) + 1) * 8;
+    float span = trendScaleMax[channel] - trendScaleMin[channel];
+    int yMax = top + (TREND_PLOT_HEIGHT - 1) -
+               (int)((column.maxValue - trendScaleMin[channel]) * (TREND_PLOT_HEIGHT - 1) / span + 0.5f);
+    int yMin = top + (TREND_PLOT_HEIGHT - 1) -
+               (int)((column.minValue - trendScaleMin[channel]) * (TREND_PLOT_HEIGHT - 1) / span + 0.5f);
+    
+    yMax = constrain(yMax, top, top + TREND_PLOT_HEIGHT - 1);
+    yMin = constrain(yMin, top, top + TREND_PLOT_HEIGHT - 1);
+    display.drawFastVLine(x, yMax, yMin - yMax + 1, SH110X_WHITE);
+}
+
+void DisplayManager::replotTrendChannel(const TrendHistory& history, TrendChannel channel) {
+    int top = (trendLabelPage(channel) + 1) * 8;
+    display.fillRect(0, top, SCREEN_WIDTH, TREND_PLOT_HEIGHT, SH110X_BLACK);
+    
+    for (int x = 0; x < TREND_COLUMNS; x++) {
+        plotTrendColumn(channel, x, history.getColumn(channel, x));
+    }
+}
+
+void DisplayManager::scrollTrendChannel(const TrendHistory& history, TrendChannel channel, int columns) {
+    uint8_t* buffer = display.getBuffer();
+    int firstPage = trendLabelPage(channel) + 1;
+    
+    // SH1106 pages are 8 pixel rows stored column by column, so shifting
+    // the plot left is one memmove per page
+    for (int page = firstPage; page < firstPage + TREND_PLOT_PAGES; page++) {
+        uint8_t* row = buffer + page * SCREEN_WIDTH;
+        memmove(row, row + columns, SCREEN_WIDTH - columns);
+        memset(row + SCREEN_WIDTH - columns, 0, columns);
+    }
+    
+    for (int x = TREND_COLUMNS - columns; x < TREND_COLUMNS; x++) {
+        plotTrendColumn(channel, x, history.getColumn(channel, x));
+    }
+}
+
+void DisplayManager::drawTrendLabel(TrendChannel channel, float value, bool error) {
+    int y = trendLabelPage(channel) * 8;
+    display.fillRect(0, y, SCREEN_WIDTH, 8, SH110X_BLACK);
+    display.setTextSize(1);
+    display.setCursor(0, y);
+    
+    char label[24];
+    const char* name = channel == TREND_DO ? "DO" : "T ";
+    if (error) {
+        snprintf(label, sizeof(label), "%s --", name);
+    } else {
+        snprintf(label, sizeof(label), "%s %.2f", name, value);
+    }
+    display.print(label);
+    
+    snprintf(label, sizeof(label), "%.1f-%.1f", trendScaleMin[channel], trendScaleMax[channel]);
+    display.setCursor(SCREEN_WIDTH - strlen(label) * 6, y);
+    display.print(label);
+}
+
 // Utility functions
 void DisplayManager::setCursor(int x, int y) {
     if (!displayAvailable) return;
@@ -517,4 +660,4 @@ void DisplayManager::drawWiFiIcon(int x, int y, bool connected, int rssi) {
 void DisplayManager::drawClockIcon(int x, int y, bool synced) {
     if (!displayAvailable) return;
     display.print(synced ? "🕐" : "⏰");
-}
\ No newline at end of file
+}
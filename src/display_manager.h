@@ -9,6 +9,8 @@
 #include "sensor_manager.h"
 #include "wifi_manager.h"
 #include "time_manager.h"
+#include "trend_history.h"
+#include "menu_types.h"
 
 class DisplayManager {
 private:
@@ -16,9 +18,22 @@ private:
     bool displayAvailable;
     unsigned long lastUpdate;
     
-    void drawHeader(const String& title, bool showStatus = true);
-    void drawFooter(const String& line1, const String& line2 = "");
+    // Trend screen state. The plot area is kept in the frame buffer between
+    // frames so new columns can be scrolled in instead of replotting.
+    bool trendPlotValid;
+    uint32_t trendRevision;
+    unsigned long trendLastRead;
+    float trendScaleMin[TREND_CHANNEL_COUNT];
+    float trendScaleMax[TREND_CHANNEL_COUNT];
+    
+    void drawHeader(const char* title, bool showStatus = true);
+    void drawFooter(const char* line1, const char* line2 = "");
     void drawProgressBar(int x, int y, int width, int height, int progress);
+    void computeTrendScale(const TrendHistory& history, TrendChannel channel, float& minValue, float& maxValue);
+    void plotTrendColumn(TrendChannel channel, int x, const TrendColumn& column);
+    void replotTrendChannel(const TrendHistory& history, TrendChannel channel);
+    void scrollTrendChannel(const TrendHistory& history, TrendChannel channel, int columns);
+    void drawTrendLabel(TrendChannel channel, float value, bool error);
     
 public:
     DisplayManager();
@@ -29,17 +44,18 @@ public:
     // Main display functions
     void showSplashScreen();
     void showSensorData(const SensorData& data);
-    void showMainMenu(const String menuItems[], int itemCount, int selectedIndex, int scrollOffset);
+    void showMenuList(const char* title, const MenuItem items[], int itemCount, int selectedIndex, int scrollOffset, const char* hint);
     void showSensorDetail(const SensorData& data, int selectedSensor);
-    void showWiFiConfig(const String& ssid, const String& status, const String& ip, int rssi, bool apMode);
-    void showCalibrationMenu(const String menuItems[], int itemCount, int selectedIndex, int scrollOffset);
-    void showCalibrationProgress(const String& sensorName, const String& instruction, float currentValue, int progress);
-    void showTimeConfig(int timezone, const String& currentTime, bool timeSynced);
-    void showSystemInfo(const SensorData& data, const String& uptime, int workingSensors);
-    void showSettingsMenu(const String menuItems[], int itemCount, int selectedIndex);
+    void showWiFiConfig(const char* ssid, const char* status, const char* ip, int rssi, bool apMode,
+                        const WiFiScanEntry* results, int resultCount, int selectedIndex, int scrollOffset,
+                        int scanChannel);
+    void showCalibrationProgress(const char* sensorName, const char* instruction, float currentValue, int progress);
+    void showTimeConfig(int timezone, const char* currentTime, bool timeSynced);
+    void showSystemInfo(const SensorData& data, const char* uptime, int workingSensors);
     void showMessage(const String& title, const String& message, bool success = true);
     void showError(const String& title, const String& message);
     void showScanningAnimation(const String& message);
+    void showTrendGraph(const TrendHistory& history, const SensorData& data);
     
     // Utility functions
     void setCursor(int x, int y);
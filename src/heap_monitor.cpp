@@ -0,0 +1,280 @@
+#include "heap_monitor.h"
+#include <atomic>
+#include "boot_sequence.h"
+#include "utils.h"
+
+HeapMonitor heapMonitor;
+
+#define HEAP_WARN_FREE (1 << 0)
+#define HEAP_WARN_BLOCK (1 << 1)
+
+// Indexed by AllocSubsystem
+static const char* const SUBSYSTEM_LABELS[ALLOC_SUBSYSTEM_COUNT] = {
+    "subsystem=\"loop\"", "subsystem=\"sensors\"", "subsystem=\"post\"", "subsystem=\"ui\"",
+    "subsystem=\"wifi\"", "subsystem=\"web\"", "subsystem=\"other\""
+};
+
+// ==================== ALLOCATOR HOOKS ====================
+// Plain statics, zero before any constructor runs: globals allocate
+// before setup() and land in ALLOC_OTHER
+static std::atomic<uint32_t> allocCounts[ALLOC_SUBSYSTEM_COUNT];
+static std::atomic<uint32_t> freeCount;
+static TaskHandle_t mainTask;
+static TaskHandle_t webTask;
+static AllocSubsystem mainSubsystem;    // Main task only
+
+static inline void countAllocation() {
+#if HEAP_TRACK_ALLOCS
+    TaskHandle_t current = xTaskGetCurrentTaskHandle();
+    AllocSubsystem subsystem = ALLOC_OTHER;
+    if (current && current == mainTask) {
+        subsystem = mainSubsystem;
+    } else if (current && current == webTask) {
+        subsystem = ALLOC_WEB;
+    }
+    allocCounts[subsystem].fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+// Linked in with -Wl,--wrap=malloc etc., see platformio.ini
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size) {
+    countAllocation();
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    countAllocation();
+    return __real_calloc(count, size);
+}
+
+// String growth goes through here, so a resize counts as an allocation
+void* __wrap_realloc(void* ptr, size_t size) {
+    if (size) countAllocation();
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void* ptr) {
+#if HEAP_TRACK_ALLOCS
+    if (ptr) freeCount.fetch_add(1, std::memory_order_relaxed);
+#endif
+    __real_free(ptr);
+}
+}
+
+AllocSubsystem HeapMonitor::enter(AllocSubsystem subsystem) {
+    AllocSubsystem previous = mainSubsystem;
+    mainSubsystem = subsystem;
+    return previous;
+}
+
+void HeapMonitor::leave(AllocSubsystem previous) {
+    mainSubsystem = previous;
+}
+
+// ==================== SAMPLING ====================
+HeapMonitor::HeapMonitor() :
+    taskCount(0),
+    warnings(0),
+    worstLoopAllocs(0),
+    sampleJob(JOB_NONE) {
+
+    memset(&last, 0, sizeof(last));
+    memset(tasks, 0, sizeof(tasks));
+    memset(lastAllocs, 0, sizeof(lastAllocs));
+}
+
+void HeapMonitor::begin() {
+    mainTask = xTaskGetCurrentTaskHandle();
+    mainSubsystem = ALLOC_LOOP;
+
+    addMetrics();
+    sampleJob = scheduler.every(HEAP_SAMPLE_INTERVAL, [](void* self) {
+        static_cast<HeapMonitor*>(self)->sample();
+    }, this, "heap");
+    sample();
+}
+
+void HeapMonitor::addMetrics() {
+    metrics.addGauge("heap_fragmentation_percent", "Free heap outside the largest block", [](const void*) -> uint32_t {
+        return heapMonitor.last.fragmentation;
+    });
+    metrics.addGauge("psram_free_bytes", "Free PSRAM, 0 without PSRAM", [](const void*) -> uint32_t {
+        return heapMonitor.last.psramFree;
+    });
+    metrics.addCounter("heap_warnings_total", "Heap or stack thresholds crossed", warningCount);
+
+#if HEAP_TRACK_ALLOCS
+    for (int i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+        metrics.addCounter("heap_allocations_total", "malloc, calloc and growing realloc calls",
+            [](const void* source) -> uint32_t {
+                return static_cast<const std::atomic<uint32_t>*>(source)->load(std::memory_order_relaxed);
+            }, &allocCounts[i], SUBSYSTEM_LABELS[i]);
+    }
+    metrics.addCounter("heap_frees_total", "free calls", [](const void*) -> uint32_t {
+        return freeCount.load(std::memory_order_relaxed);
+    }, nullptr);
+#endif
+}
+
+void HeapMonitor::sample() {
+    last.freeBytes = ESP.getFreeHeap();
+    last.largestBlock = ESP.getMaxAllocHeap();
+    last.minFree = ESP.getMinFreeHeap();
+    last.psramTotal = ESP.getPsramSize();
+    last.psramFree = ESP.getFreePsram();
+    last.fragmentation = last.freeBytes ? 100 - (uint64_t)last.largestBlock * 100 / last.freeBytes : 0;
+
+    sampleTasks();
+    checkThresholds();
+#if HEAP_TRACK_ALLOCS
+    checkAllocations();
+#endif
+}
+
+void HeapMonitor::sampleTasks() {
+    // Static: the monitor must not allocate to look at the heap
+    static TaskStatus_t status[HEAP_MAX_TASKS];
+
+    if (!webTask) {
+        webTask = xTaskGetHandle("async_tcp");
+    }
+
+#if configUSE_TRACE_FACILITY
+    UBaseType_t count = uxTaskGetSystemState(status, HEAP_MAX_TASKS, nullptr);
+    if (count == 0) {
+        LOG_E("Heap: more than %d tasks, stacks not sampled", HEAP_MAX_TASKS);
+        return;
+    }
+#else
+    // Without the trace facility only the main task is visible
+    UBaseType_t count = 1;
+    status[0].pcTaskName = pcTaskGetName(mainTask);
+    status[0].usStackHighWaterMark = uxTaskGetStackHighWaterMark(mainTask);
+#endif
+
+    for (int i = 0; i < taskCount; i++) {
+        tasks[i].alive = false;
+    }
+    for (UBaseType_t i = 0; i < count; i++) {
+        TaskStackInfo* info = findTask(status[i].pcTaskName);
+        if (!info) continue;
+        info->alive = true;
+        info->freeBytes = status[i].usStackHighWaterMark;      // Bytes on ESP-IDF
+
+        if (info->freeBytes < STACK_FREE_WARN && !info->warned) {
+            info->warned = true;
+            warningCount.inc();
+            LOG_E("Heap: task %s has %u stack bytes left", info->name, info->freeBytes);
+        }
+    }
+}
+
+// Tasks keep their slot (and metric series) after they end; boot stages
+// show their final high-water mark
+TaskStackInfo* HeapMonitor::findTask(const char* name) {
+    for (int i = 0; i < taskCount; i++) {
+        if (strncmp(tasks[i].name, name, TASK_NAME_LENGTH - 1) == 0) return &tasks[i];
+    }
+    if (taskCount >= HEAP_MAX_TASKS) return nullptr;
+
+    TaskStackInfo& info = tasks[taskCount++];
+    strlcpy(info.name, name, sizeof(info.name));
+    snprintf(info.labels, sizeof(info.labels), "task=\"%.*s\"", TASK_NAME_LENGTH - 1, name);
+    metrics.addGauge("task_stack_free_bytes", "Stack a task has never touched", [](const void* source) -> uint32_t {
+        return static_cast<const TaskStackInfo*>(source)->freeBytes;
+    }, &info, info.labels);
+    return &info;
+}
+
+// Logs when a threshold is first crossed; re-armed once the value is
+// an eighth clear of it again
+bool HeapMonitor::crossed(uint8_t bit, bool below, bool recovered) {
+    if (below && !(warnings & bit)) {
+        warnings |= bit;
+        warningCount.inc();
+        return true;
+    }
+    if (recovered) {
+        warnings &= ~bit;
+    }
+    return false;
+}
+
+void HeapMonitor::checkThresholds() {
+    if (crossed(HEAP_WARN_FREE, last.freeBytes < HEAP_FREE_WARN,
+                last.freeBytes > HEAP_FREE_WARN + HEAP_FREE_WARN / 8)) {
+        LOG_E("Heap low: %u bytes free, %u at worst", last.freeBytes, last.minFree);
+    }
+    if (crossed(HEAP_WARN_BLOCK, last.largestBlock < HEAP_BLOCK_WARN,
+                last.largestBlock > HEAP_BLOCK_WARN + HEAP_BLOCK_WARN / 8)) {
+        LOG_E("Heap fragmented: largest block %u of %u free (%u%%), TLS may fail",
+              last.largestBlock, last.freeBytes, last.fragmentation);
+    }
+}
+
+void HeapMonitor::checkAllocations() {
+    uint32_t delta[ALLOC_SUBSYSTEM_COUNT];
+    for (int i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+        uint32_t now = allocCounts[i].load(std::memory_order_relaxed);
+        delta[i] = now - lastAllocs[i];
+        lastAllocs[i] = now;
+    }
+
+    // Untagged main-loop work should not allocate once the boot stages are
+    // over; each new worst interval is reported
+    if (bootSequence.isComplete() && delta[ALLOC_LOOP] > worstLoopAllocs) {
+        worstLoopAllocs = delta[ALLOC_LOOP];
+        warningCount.inc();
+        LOG_I("Heap: main loop allocated %u times in %u ms outside a tagged subsystem",
+              delta[ALLOC_LOOP], HEAP_SAMPLE_INTERVAL);
+    }
+}
+
+void HeapMonitor::report() {
+    LOG_D("Heap: %u free, largest %u (%u%% fragmented), min %u, PSRAM %u free",
+          last.freeBytes, last.largestBlock, last.fragmentation, last.minFree, last.psramFree);
+#if HEAP_TRACK_ALLOCS
+    LOG_D("Heap allocs: loop %u sensors %u post %u ui %u wifi %u web %u other %u",
+          getAllocations(ALLOC_LOOP), getAllocations(ALLOC_SENSORS), getAllocations(ALLOC_POST),
+          getAllocations(ALLOC_UI), getAllocations(ALLOC_WIFI), getAllocations(ALLOC_WEB),
+          getAllocations(ALLOC_OTHER));
+#endif
+
+    // Least headroom first is what matters; one line per task would flood
+    const TaskStackInfo* tightest = nullptr;
+    for (int i = 0; i < taskCount; i++) {
+        if (tasks[i].alive && (!tightest || tasks[i].freeBytes < tightest->freeBytes)) {
+            tightest = &tasks[i];
+        }
+    }
+    if (tightest) {
+        LOG_D("Stacks: %u tasks, least headroom %s with %u bytes", taskCount, tightest->name,
+              tightest->freeBytes);
+    }
+}
+
+const HeapSample& HeapMonitor::getSample() {
+    return last;
+}
+
+int HeapMonitor::getTaskCount() {
+    return taskCount;
+}
+
+const TaskStackInfo& HeapMonitor::getTask(int index) {
+    return tasks[index];
+}
+
+uint32_t HeapMonitor::getAllocations(AllocSubsystem subsystem) {
+    return allocCounts[subsystem].load(std::memory_order_relaxed);
+}
+
+uint32_t HeapMonitor::getFrees() {
+    return freeCount.load(std::memory_order_relaxed);
+}
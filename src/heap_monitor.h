@@ -0,0 +1,102 @@
+#ifndef HEAP_MONITOR_H
+#define HEAP_MONITOR_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "scheduler.h"
+#include "metrics.h"
+
+#define TASK_NAME_LENGTH 16
+
+// Who an allocation is charged to. Main-task code names its subsystem
+// with ALLOC_SCOPE; other tasks are told apart by handle.
+enum AllocSubsystem : uint8_t {
+    ALLOC_LOOP,         // Main task outside any ALLOC_SCOPE, should stay at 0
+    ALLOC_SENSORS,
+    ALLOC_POST,
+    ALLOC_UI,           // Menu, input and display
+    ALLOC_WIFI,
+    ALLOC_WEB,          // async_tcp task: portal, dashboard, /metrics
+    ALLOC_OTHER,        // Any other task
+    ALLOC_SUBSYSTEM_COUNT
+};
+
+struct HeapSample {
+    uint32_t freeBytes;         // Internal RAM
+    uint32_t largestBlock;
+    uint32_t minFree;           // Lowest since boot
+    uint32_t psramFree;
+    uint32_t psramTotal;        // 0 without PSRAM
+    uint8_t fragmentation;      // % of free heap outside the largest block
+};
+
+struct TaskStackInfo {
+    char name[TASK_NAME_LENGTH];
+    char labels[TASK_NAME_LENGTH + 8];  // task="name"
+    uint32_t freeBytes;         // Stack never touched since the task started
+    bool alive;                 // Seen in the last sample
+    bool warned;
+};
+
+// Samples the heap, PSRAM and every task's stack high-water mark on a
+// scheduler job, logs once when a threshold is crossed (and again after
+// it recovered) and exports it all through metrics. With
+// HEAP_TRACK_ALLOCS, malloc/calloc/realloc/free are wrapped at link time
+// and counted per subsystem; heap_caps_* calls inside ESP-IDF are not seen.
+class HeapMonitor {
+private:
+    HeapSample last;
+    TaskStackInfo tasks[HEAP_MAX_TASKS];
+    uint8_t taskCount;
+    uint8_t warnings;           // Bit per threshold currently crossed
+    Counter warningCount;
+    uint32_t lastAllocs[ALLOC_SUBSYSTEM_COUNT];
+    uint32_t worstLoopAllocs;   // Most main-loop allocations in one interval
+    JobId sampleJob;
+
+    void sample();
+    void sampleTasks();
+    void checkThresholds();
+    void checkAllocations();
+    bool crossed(uint8_t bit, bool below, bool recovered);
+    TaskStackInfo* findTask(const char* name);
+    void addMetrics();
+
+public:
+    HeapMonitor();
+    void begin();
+    void report();              // Heap, allocation totals and the tightest stack
+    const HeapSample& getSample();
+    int getTaskCount();
+    const TaskStackInfo& getTask(int index);
+    uint32_t getAllocations(AllocSubsystem subsystem);
+    uint32_t getFrees();
+
+    // Charges the main task's allocations to a subsystem, returns the
+    // previous one for leave()
+    static AllocSubsystem enter(AllocSubsystem subsystem);
+    static void leave(AllocSubsystem previous);
+};
+
+extern HeapMonitor heapMonitor;
+
+#if HEAP_TRACK_ALLOCS
+
+class AllocScope {
+private:
+    AllocSubsystem previous;
+
+public:
+    explicit AllocScope(AllocSubsystem subsystem) : previous(HeapMonitor::enter(subsystem)) {}
+    ~AllocScope() { HeapMonitor::leave(previous); }
+};
+
+#define ALLOC_SCOPE(subsystem) AllocScope allocScope(subsystem)
+
+#else
+
+#define ALLOC_SCOPE(subsystem)
+
+#endif
+
+#endif
@@ -0,0 +1,22 @@
+#define LOG_MODULE LOG_WEB
+#include "http_server.h"
+#include "utils.h"
+
+HttpServer httpServer;
+
+HttpServer::HttpServer() :
+    server(HTTP_SERVER_PORT),
+    started(false) {
+}
+
+void HttpServer::begin() {
+    // Called once the WiFi stack is up; routes can still be added later
+    if (started) return;
+    server.begin();
+    started = true;
+    LOG_I("HTTP server listening on port %u", HTTP_SERVER_PORT);
+}
+
+AsyncWebServer& HttpServer::getServer() {
+    return server;
+}
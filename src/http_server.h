@@ -0,0 +1,24 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "config.h"
+
+// The one AsyncWebServer on the device. The setup portal and the dashboard
+// register their routes on it; request filters decide which interface
+// (soft AP or station) each route answers on.
+class HttpServer {
+private:
+    AsyncWebServer server;
+    bool started;
+
+public:
+    HttpServer();
+    void begin();
+    AsyncWebServer& getServer();
+};
+
+extern HttpServer httpServer;
+
+#endif
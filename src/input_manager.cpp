@@ -0,0 +1,279 @@
+#include "input_manager.h"
+#include "utils.h"
+#include "metrics.h"
+
+InputManager inputManager;
+
+// Pin and gesture options per button. Double click delays the single click
+// by BUTTON_DOUBLE_CLICK_MS, so it is only enabled where it is used.
+static const struct {
+    uint8_t pin;
+    bool doubleClick;
+} BUTTON_CONFIG[BUTTON_COUNT] = {
+    {ENCODER_SW, false},
+    {BUTTON_A, false},
+    {BUTTON_B, true}
+};
+
+// Quadrature transitions indexed by (old CLK/DT) | (new CLK/DT) << 2.
+// Same decoding and direction as the Encoder library it replaces; +-2
+// covers one missed transition at high speed.
+static const int8_t QUADRATURE_STEP[16] = {
+    0, 1, -1, 2,
+    -1, 0, -2, 1,
+    1, -2, 0, -1,
+    2, -1, 1, 0
+};
+
+// Acceleration curve: detents arriving faster than maxInterval after the
+// previous one count as multiplier steps. Slower turns stay at one step.
+static const struct {
+    uint16_t maxInterval;   // ms since the previous detent
+    uint8_t multiplier;
+} ENCODER_CURVE[] = {
+    {25, 10},
+    {50, 5},
+    {100, 2}
+};
+
+InputManager::InputManager() {
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        ButtonState& b = buttons[i];
+        b.pin = BUTTON_CONFIG[i].pin;
+        b.doubleClickEnabled = BUTTON_CONFIG[i].doubleClick;
+        b.stablePressed = false;
+        b.candidatePending = false;
+        b.candidatePressed = false;
+        b.candidateTime = 0;
+        b.pressTime = 0;
+        b.longPressSent = false;
+        b.clickPending = false;
+        b.lastReleaseTime = 0;
+    }
+
+    quadratureState = 0;
+    quadratureCount = 0;
+    lastDirection = 0;
+    lastDetentTime = 0;
+    rotation = 0;
+}
+
+void InputManager::begin() {
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        pinMode(buttons[i].pin, INPUT_PULLUP);
+        buttons[i].stablePressed = !digitalRead(buttons[i].pin);
+        attachInterruptArg(digitalPinToInterrupt(buttons[i].pin), onButtonEdge,
+                           (void*)(uintptr_t)i, CHANGE);
+    }
+
+    pinMode(ENCODER_CLK, INPUT_PULLUP);
+    pinMode(ENCODER_DT, INPUT_PULLUP);
+    quadratureState = digitalRead(ENCODER_CLK) | (digitalRead(ENCODER_DT) << 1);
+    attachInterrupt(digitalPinToInterrupt(ENCODER_CLK), onEncoderEdge, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(ENCODER_DT), onEncoderEdge, CHANGE);
+
+    metrics.addQueue("queue=\"input_edges\"", edges);
+    metrics.addQueue("queue=\"input_events\"", events);
+}
+
+void IRAM_ATTR InputManager::onButtonEdge(void* arg) {
+    uint8_t id = (uint8_t)(uintptr_t)arg;
+    ButtonEdge edge = {id, !digitalRead(inputManager.buttons[id].pin), (uint32_t)millis()};
+    inputManager.edges.push(edge);
+    Scheduler::wakeFromISR();
+}
+
+void IRAM_ATTR InputManager::onEncoderEdge() {
+    InputManager& m = inputManager;
+    uint8_t state = digitalRead(ENCODER_CLK) | (digitalRead(ENCODER_DT) << 1);
+    m.quadratureCount += QUADRATURE_STEP[m.quadratureState | (state << 2)];
+    m.quadratureState = state;
+
+    if (m.quadratureCount >= ENCODER_STEPS || m.quadratureCount <= -ENCODER_STEPS) {
+        EncoderDetent detent = {(int8_t)(m.quadratureCount > 0 ? 1 : -1), (uint32_t)millis()};
+        m.quadratureCount = 0;
+        m.detents.push(detent);
+        Scheduler::wakeFromISR();
+    }
+}
+
+void InputManager::poll() {
+    // Edges are consumed in capture order; timing comes from the ISR
+    // timestamps, so a slow loop delays events but never loses them
+    ButtonEdge edge;
+    while (edges.pop(edge)) {
+        processEdge((ButtonId)edge.button, edge.pressed, edge.timestamp);
+    }
+
+    EncoderDetent detent;
+    while (detents.pop(detent)) {
+        processDetent(detent);
+    }
+
+    uint32_t now = millis();
+    settle(now);
+
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        checkTimers((ButtonId)i, now);
+    }
+}
+
+void InputManager::processEdge(ButtonId id, bool pressed, uint32_t timestamp) {
+    ButtonState& b = buttons[id];
+
+    // The previous level held until this edge; if that was long enough it
+    // was a real transition rather than contact bounce
+    if (b.candidatePending && timestamp - b.candidateTime >= BUTTON_DEBOUNCE_MS) {
+        commit(id, b.candidatePressed, b.candidateTime);
+    }
+
+    b.candidatePending = (pressed != b.stablePressed);
+    b.candidatePressed = pressed;
+    b.candidateTime = timestamp;
+}
+
+void InputManager::settle(uint32_t now) {
+    // Commit levels that have been quiet for the debounce time, oldest
+    // first so events from different buttons keep their real order
+    while (true) {
+        int oldest = -1;
+        for (int i = 0; i < BUTTON_COUNT; i++) {
+            const ButtonState& b = buttons[i];
+            if (!b.candidatePending || now - b.candidateTime < BUTTON_DEBOUNCE_MS) continue;
+            if (oldest < 0 || (int32_t)(b.candidateTime - buttons[oldest].candidateTime) < 0) {
+                oldest = i;
+            }
+        }
+        if (oldest < 0) break;
+
+        ButtonState& b = buttons[oldest];
+        commit((ButtonId)oldest, b.candidatePressed, b.candidateTime);
+    }
+}
+
+void InputManager::commit(ButtonId id, bool pressed, uint32_t timestamp) {
+    ButtonState& b = buttons[id];
+    b.candidatePending = false;
+    if (pressed == b.stablePressed) return;
+    b.stablePressed = pressed;
+
+    if (pressed) {
+        b.pressTime = timestamp;
+        b.longPressSent = false;
+        return;
+    }
+
+    // Release: classify the gesture from the recorded timestamps
+    if (b.longPressSent) return;
+
+    if (timestamp - b.pressTime >= BUTTON_LONG_PRESS_MS) {
+        b.longPressSent = true;
+        b.clickPending = false;
+        emit(EVENT_LONG_PRESS, id, timestamp);
+    } else if (!b.doubleClickEnabled) {
+        emit(EVENT_CLICK, id, timestamp);
+    } else if (b.clickPending && timestamp - b.lastReleaseTime <= BUTTON_DOUBLE_CLICK_MS) {
+        b.clickPending = false;
+        emit(EVENT_DOUBLE_CLICK, id, timestamp);
+    } else {
+        if (b.clickPending) {
+            emit(EVENT_CLICK, id, b.lastReleaseTime);
+        }
+        b.clickPending = true;
+        b.lastReleaseTime = timestamp;
+    }
+}
+
+void InputManager::checkTimers(ButtonId id, uint32_t now) {
+    ButtonState& b = buttons[id];
+
+    // A release still inside its debounce window ends the hold
+    if (b.stablePressed && !b.longPressSent && !b.candidatePending &&
+        now - b.pressTime >= BUTTON_LONG_PRESS_MS) {
+        b.longPressSent = true;
+        b.clickPending = false;
+        emit(EVENT_LONG_PRESS, id, b.pressTime + BUTTON_LONG_PRESS_MS);
+    }
+
+    // No second click arrived in time: it was a single click
+    if (b.clickPending && !b.candidatePending && now - b.lastReleaseTime > BUTTON_DOUBLE_CLICK_MS) {
+        b.clickPending = false;
+        emit(EVENT_CLICK, id, b.lastReleaseTime);
+    }
+}
+
+uint32_t InputManager::timeUntilNextTimer(uint32_t now, uint32_t limit) {
+    // Debounce, long press and double click resolve without a new edge,
+    // so the main task must wake up for them
+    uint32_t wait = limit;
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        const ButtonState& b = buttons[i];
+        uint32_t deadline;
+
+        if (b.candidatePending) {
+            deadline = b.candidateTime + BUTTON_DEBOUNCE_MS;
+        } else if (b.stablePressed && !b.longPressSent) {
+            deadline = b.pressTime + BUTTON_LONG_PRESS_MS;
+        } else if (b.clickPending) {
+            deadline = b.lastReleaseTime + BUTTON_DOUBLE_CLICK_MS + 1;
+        } else {
+            continue;
+        }
+
+        int32_t remaining = (int32_t)(deadline - now);
+        if (remaining <= 0) return 0;
+        if ((uint32_t)remaining < wait) {
+            wait = remaining;
+        }
+    }
+    return wait;
+}
+
+void InputManager::emit(InputEventType type, ButtonId id, uint32_t timestamp) {
+    InputEvent event = {type, id, timestamp};
+    events.push(event);
+}
+
+void InputManager::processDetent(const EncoderDetent& detent) {
+    // The speed comes from the ISR timestamps, so a stalled loop replays
+    // the turn as it happened. A reversal always starts with a single step.
+    int steps = 1;
+    if (ENCODER_ACCELERATION && detent.direction == lastDirection) {
+        steps = accelerate(detent.timestamp - lastDetentTime);
+    }
+
+    lastDirection = detent.direction;
+    lastDetentTime = detent.timestamp;
+    rotation += detent.direction * steps;
+}
+
+int InputManager::accelerate(uint32_t interval) {
+    for (int i = 0; i < Utils::countOf(ENCODER_CURVE); i++) {
+        if (interval < ENCODER_CURVE[i].maxInterval) {
+            return ENCODER_CURVE[i].multiplier;
+        }
+    }
+    return 1;
+}
+
+bool InputManager::getEvent(InputEvent& event) {
+    return events.pop(event);
+}
+
+int InputManager::takeRotation() {
+    int steps = rotation;
+    rotation = 0;
+    return steps;
+}
+
+uint32_t InputManager::getDroppedEdges() {
+    return edges.getDropped();
+}
+
+uint32_t InputManager::getDroppedEvents() {
+    return events.getDropped();
+}
+
+uint32_t InputManager::getDroppedDetents() {
+    return detents.getDropped();
+}
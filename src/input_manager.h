@@ -0,0 +1,93 @@
+#ifndef INPUT_MANAGER_H
+#define INPUT_MANAGER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "spsc_queue.h"
+#include "scheduler.h"
+
+enum ButtonId {
+    BUTTON_ID_ENCODER = 0,
+    BUTTON_ID_A = 1,
+    BUTTON_ID_B = 2,
+    BUTTON_COUNT
+};
+
+enum InputEventType {
+    EVENT_CLICK,
+    EVENT_LONG_PRESS,
+    EVENT_DOUBLE_CLICK
+};
+
+struct InputEvent {
+    InputEventType type;
+    ButtonId button;
+    uint32_t timestamp;     // millis() of the edge that completed the gesture
+};
+
+// Captured by the GPIO interrupt; decoded later in task context
+struct ButtonEdge {
+    uint8_t button;
+    bool pressed;
+    uint32_t timestamp;
+};
+
+// One full encoder detent, produced by the quadrature interrupt
+struct EncoderDetent {
+    int8_t direction;       // +1 clockwise, -1 counter-clockwise
+    uint32_t timestamp;
+};
+
+class InputManager {
+private:
+    struct ButtonState {
+        uint8_t pin;
+        bool doubleClickEnabled;
+        bool stablePressed;
+        bool candidatePending;      // Level changed, waiting out the bounce
+        bool candidatePressed;
+        uint32_t candidateTime;
+        uint32_t pressTime;
+        bool longPressSent;
+        bool clickPending;          // First click of a possible double click
+        uint32_t lastReleaseTime;
+    };
+
+    ButtonState buttons[BUTTON_COUNT];
+    SpscQueue<ButtonEdge, INPUT_EDGE_QUEUE_SIZE> edges;
+    SpscQueue<InputEvent, INPUT_EVENT_QUEUE_SIZE> events;
+
+    // Encoder: quadrature state is only touched by the ISR
+    uint8_t quadratureState;
+    int8_t quadratureCount;
+    SpscQueue<EncoderDetent, ENCODER_DETENT_QUEUE_SIZE> detents;
+    int8_t lastDirection;
+    uint32_t lastDetentTime;
+    int rotation;               // Accelerated steps not yet taken
+
+    static void IRAM_ATTR onButtonEdge(void* arg);
+    static void IRAM_ATTR onEncoderEdge();
+
+    void processEdge(ButtonId id, bool pressed, uint32_t timestamp);
+    void commit(ButtonId id, bool pressed, uint32_t timestamp);
+    void settle(uint32_t now);
+    void checkTimers(ButtonId id, uint32_t now);
+    void emit(InputEventType type, ButtonId id, uint32_t timestamp);
+    void processDetent(const EncoderDetent& detent);
+
+public:
+    InputManager();
+    void begin();
+    void poll();
+    bool getEvent(InputEvent& event);
+    int takeRotation();
+    uint32_t timeUntilNextTimer(uint32_t now, uint32_t limit);
+    static int accelerate(uint32_t interval);
+    uint32_t getDroppedEdges();
+    uint32_t getDroppedEvents();
+    uint32_t getDroppedDetents();
+};
+
+extern InputManager inputManager;
+
+#endif
@@ -0,0 +1,311 @@
+#include "logger.h"
+
+Logger logger;
+
+// Indexed by LogLevel and LogModule
+static const char* const LEVEL_NAMES[] = {"OFF", "ERROR", "INFO", "DEBUG"};
+static const char* const MODULE_NAMES[] = {"core", "sensor", "modbus", "wifi", "display", "time", "web"};
+
+// ==================== PACKING ====================
+void LogPacker::put(LogArgType type, uint32_t word) {
+    if (words >= LOG_MAX_WORDS) {
+        overflow = true;
+        return;
+    }
+    entry.types[entry.argCount++] = type;
+    entry.words[words++] = word;
+}
+
+void LogPacker::add(long long value) {
+    if (words + 2 > LOG_MAX_WORDS) {
+        overflow = true;
+        return;
+    }
+    put(LOG_ARG_INT64, (uint32_t)value);
+    entry.words[words++] = (uint32_t)((uint64_t)value >> 32);
+}
+
+void LogPacker::add(unsigned long long value) {
+    if (words + 2 > LOG_MAX_WORDS) {
+        overflow = true;
+        return;
+    }
+    put(LOG_ARG_UINT64, (uint32_t)value);
+    entry.words[words++] = (uint32_t)(value >> 32);
+}
+
+void LogPacker::add(double value) {
+    float narrow = value;
+    uint32_t word;
+    memcpy(&word, &narrow, sizeof(word));
+    put(LOG_ARG_FLOAT, word);
+}
+
+void LogPacker::add(const char* value) {
+    if (!value) value = "(null)";
+
+    uint8_t offset = entry.textUsed;
+    size_t room = LOG_TEXT_SIZE - offset;
+    if (room == 0) {
+        overflow = true;
+        put(LOG_ARG_TEXT, LOG_TEXT_SIZE);
+        return;
+    }
+
+    size_t length = strlen(value);
+    if (length >= room) {
+        length = room - 1;
+        overflow = true;
+    }
+    memcpy(entry.text + offset, value, length);
+    entry.text[offset + length] = '\0';
+    entry.textUsed = offset + length + 1;
+    put(LOG_ARG_TEXT, offset);
+}
+
+// ==================== RING ====================
+void Logger::begin() {
+    drainLock = xSemaphoreCreateMutex();
+    if (xTaskCreate(drainTask, "log", LOG_TASK_STACK, nullptr, LOG_TASK_PRIORITY, &task) != pdPASS) {
+        task = nullptr;
+        write(LOG_LEVEL_ERROR, LOG_CORE, "Log task failed, logging inline");
+        flush();
+    }
+}
+
+LogEntry* Logger::claim() {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t waiting;
+    do {
+        waiting = h - tail.load(std::memory_order_acquire);
+        if (waiting >= LOG_RING_SIZE) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    } while (!head.compare_exchange_weak(h, h + 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    uint32_t peak = highWater.load(std::memory_order_relaxed);
+    while (waiting + 1 > peak &&
+           !highWater.compare_exchange_weak(peak, waiting + 1, std::memory_order_relaxed)) {
+    }
+
+    // Only the first entry of a burst wakes the drain task; it picks up
+    // the rest in the same pass
+    if (waiting == 0 && task) {
+        xTaskNotifyGive(task);
+    }
+
+    LogEntry* entry = &ring[h & (LOG_RING_SIZE - 1)];
+    entry->timestamp = millis();
+    entry->argCount = 0;
+    entry->textUsed = 0;
+    return entry;
+}
+
+void Logger::publish(LogEntry* entry, bool overflowed) {
+    if (overflowed) {
+        truncated.fetch_add(1, std::memory_order_relaxed);
+    }
+    written.fetch_add(1, std::memory_order_relaxed);
+    entry->ready.store(1, std::memory_order_release);
+}
+
+void Logger::drainTask(void* arg) {
+    for (;;) {
+        logger.drain();
+
+        // An entry still being written keeps its slot; look again shortly
+        bool pending = logger.head.load(std::memory_order_acquire) != logger.tail.load(std::memory_order_relaxed);
+        ulTaskNotifyTake(pdTRUE, pending ? pdMS_TO_TICKS(LOG_DRAIN_INTERVAL) : portMAX_DELAY);
+    }
+}
+
+void Logger::flush() {
+    drain();
+}
+
+void Logger::drain() {
+    if (drainLock) {
+        xSemaphoreTake(drainLock, portMAX_DELAY);
+    }
+
+    char line[LOG_LINE_LENGTH];
+    for (;;) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) break;
+
+        LogEntry& entry = ring[t & (LOG_RING_SIZE - 1)];
+        if (!entry.ready.load(std::memory_order_acquire)) break;
+
+        // Raw entries go out byte for byte
+        size_t length = entry.textUsed;
+        if (entry.format) {
+            length = format(entry, line, sizeof(line));
+        } else {
+            memcpy(line, entry.text, length);
+        }
+        entry.ready.store(0, std::memory_order_relaxed);
+        tail.store(t + 1, std::memory_order_release);
+
+        // Slot is free again before the slow part
+        Serial.write((const uint8_t*)line, length);
+    }
+
+    uint32_t lost = dropped.load(std::memory_order_relaxed);
+    if (lost != droppedReported) {
+        int length = snprintf(line, sizeof(line), "[ERROR] core: Log ring full, %lu entries dropped\r\n",
+                              (unsigned long)(lost - droppedReported));
+        droppedReported = lost;
+        Serial.write((const uint8_t*)line, min(length, (int)sizeof(line) - 1));
+    }
+
+    if (drainLock) {
+        xSemaphoreGive(drainLock);
+    }
+}
+
+// ==================== FORMATTING ====================
+// printf subset: flags, width and precision are honoured, length
+// modifiers are ignored and the conversion is applied to the captured
+// type, so "%d" works for any integer width and "%f" for any number.
+size_t Logger::format(const LogEntry& entry, char* out, size_t size) {
+    size_t limit = size - 2;    // Room for "\r\n"
+    int written = 0;
+    if (entry.level != LOG_LEVEL_OFF) {
+        written = snprintf(out, limit + 1, "%lu.%03lu [%s] %s: ",
+                           (unsigned long)(entry.timestamp / 1000), (unsigned long)(entry.timestamp % 1000),
+                           LEVEL_NAMES[entry.level], MODULE_NAMES[entry.module]);
+    }
+    size_t pos = min((size_t)max(written, 0), limit);
+
+    uint8_t arg = 0;
+    uint8_t word = 0;
+    const char* p = entry.format;
+    while (*p && pos < limit) {
+        if (*p != '%') {
+            out[pos++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[pos++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Spec without length modifiers: %[flags][width][.precision]
+        char spec[16];
+        uint8_t specLength = 0;
+        spec[specLength++] = *p++;
+        while (*p && strchr("-+ #0123456789.", *p)) {
+            if (specLength < sizeof(spec) - 4) spec[specLength++] = *p;
+            p++;
+        }
+        while (*p && strchr("hlLqjzt", *p)) p++;
+        char conversion = *p;
+        if (!conversion) break;
+        p++;
+
+        if (arg >= entry.argCount) {
+            out[pos++] = '?';
+            continue;
+        }
+        LogArgType type = (LogArgType)entry.types[arg++];
+        uint32_t low = entry.words[word++];
+        uint64_t wide = low;
+        if (type == LOG_ARG_INT64 || type == LOG_ARG_UINT64) {
+            wide |= (uint64_t)entry.words[word++] << 32;
+        }
+
+        long long value;
+        float number;
+        memcpy(&number, &low, sizeof(number));
+        switch (type) {
+            case LOG_ARG_INT:   value = (int32_t)low; break;
+            case LOG_ARG_FLOAT: value = (long long)number; break;
+            case LOG_ARG_TEXT:  value = 0; break;
+            default:            value = (long long)wide; break;
+        }
+
+        size_t room = size - 2 - pos + 1;
+        if (type == LOG_ARG_TEXT) {
+            const char* text = low < LOG_TEXT_SIZE ? entry.text + low : "";
+            if (conversion != 's') {
+                spec[1] = '\0';     // Drop the spec, print the text as is
+                specLength = 1;
+            }
+            strcpy(spec + specLength, "s");
+            written = snprintf(out + pos, room, spec, text);
+        } else if (strchr("fFeEgGaA", conversion)) {
+            spec[specLength] = conversion;
+            spec[specLength + 1] = '\0';
+            written = snprintf(out + pos, room, spec, type == LOG_ARG_FLOAT ? (double)number : (double)value);
+        } else if (conversion == 'c') {
+            strcpy(spec + specLength, "c");
+            written = snprintf(out + pos, room, spec, (int)value);
+        } else if (conversion == 's' && type == LOG_ARG_FLOAT) {
+            written = snprintf(out + pos, room, "%g", (double)number);
+        } else {
+            bool isSigned = type == LOG_ARG_INT || type == LOG_ARG_INT64 || type == LOG_ARG_FLOAT;
+            if (!strchr("diuxXo", conversion)) {
+                conversion = isSigned ? 'd' : 'u';
+            }
+            spec[specLength] = 'l';
+            spec[specLength + 1] = 'l';
+            spec[specLength + 2] = conversion;
+            spec[specLength + 3] = '\0';
+            if (conversion == 'd' || conversion == 'i') {
+                written = snprintf(out + pos, room, spec, value);
+            } else {
+                // Hex of a negative int shows its 32-bit pattern
+                unsigned long long bits = type == LOG_ARG_INT ? (unsigned long long)low : (unsigned long long)value;
+                written = snprintf(out + pos, room, spec, bits);
+            }
+        }
+        pos = min(pos + (size_t)max(written, 0), limit);
+    }
+
+    out[pos++] = '\r';
+    out[pos++] = '\n';
+    return pos;
+}
+
+void Logger::setLevel(LogModule module, LogLevel level) {
+    overrides[module] = min(level, LOG_BUILD_LEVELS[module]) + 1;
+}
+
+LogLevel Logger::getLevel(LogModule module) {
+    return overrides[module] ? (LogLevel)(overrides[module] - 1) : LOG_BUILD_LEVELS[module];
+}
+
+const char* Logger::getModuleName(LogModule module) {
+    return MODULE_NAMES[module];
+}
+
+const char* Logger::getLevelName(LogLevel level) {
+    return LEVEL_NAMES[level];
+}
+
+const LoggerStats& Logger::getStats() {
+    stats.written = written.load(std::memory_order_relaxed);
+    stats.dropped = dropped.load(std::memory_order_relaxed);
+    stats.truncated = truncated.load(std::memory_order_relaxed);
+    stats.highWater = highWater.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool Logger::writeRaw(const uint8_t* data, size_t length) {
+    LogEntry* entry = claim();
+    if (!entry) return false;
+
+    entry->level = LOG_LEVEL_OFF;
+    entry->module = LOG_CORE;
+    entry->format = nullptr;
+    entry->textUsed = min(length, (size_t)LOG_TEXT_SIZE);
+    memcpy(entry->text, data, entry->textUsed);
+    publish(entry, length > LOG_TEXT_SIZE);
+    return true;
+}
+
+uint32_t Logger::getPending() {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+}
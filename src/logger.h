@@ -0,0 +1,198 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/semphr.h>
+#include "config.h"
+
+enum LogLevel : uint8_t {
+    LOG_LEVEL_OFF,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG
+};
+
+enum LogModule : uint8_t {
+    LOG_CORE,
+    LOG_SENSOR,
+    LOG_MODBUS,
+    LOG_WIFI,
+    LOG_DISPLAY,
+    LOG_TIME,
+    LOG_WEB,
+    LOG_MODULE_COUNT
+};
+
+// Indexed by LogModule; a constant, so disabled call sites fold away
+static constexpr LogLevel LOG_BUILD_LEVELS[LOG_MODULE_COUNT] = {
+    LOG_BUILD_LEVEL_CORE,
+    LOG_BUILD_LEVEL_SENSOR,
+    LOG_BUILD_LEVEL_MODBUS,
+    LOG_BUILD_LEVEL_WIFI,
+    LOG_BUILD_LEVEL_DISPLAY,
+    LOG_BUILD_LEVEL_TIME,
+    LOG_BUILD_LEVEL_WEB
+};
+
+// A source file picks its module by defining LOG_MODULE before includes
+#ifndef LOG_MODULE
+#define LOG_MODULE LOG_CORE
+#endif
+
+// The level test comes first and is a constant, so a level above the
+// module's build level compiles to nothing, arguments included
+#define LOG_TO(module, level, ...) do { \
+    if ((level) <= LOG_BUILD_LEVELS[module] && logger.isEnabled(module, level)) { \
+        logger.write(level, module, __VA_ARGS__); \
+    } \
+} while (0)
+
+#define LOG_E(...) LOG_TO(LOG_MODULE, LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_I(...) LOG_TO(LOG_MODULE, LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_D(...) LOG_TO(LOG_MODULE, LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+enum LogArgType : uint8_t {
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_INT64,      // Two words, low first
+    LOG_ARG_UINT64,
+    LOG_ARG_FLOAT,
+    LOG_ARG_TEXT        // Word is an offset into the entry's text
+};
+
+struct LoggerStats {
+    uint32_t written;
+    uint32_t dropped;       // Ring full, entry discarded
+    uint32_t truncated;     // Arguments or text that didn't fit an entry
+    uint32_t highWater;     // Most entries waiting at once
+};
+
+// One printf-style call, captured without formatting: the format string
+// pointer (must outlive the entry, i.e. a literal), a type tag per
+// argument and the raw argument words. Strings are copied into text.
+struct LogEntry {
+    std::atomic<uint8_t> ready;     // Set by the producer once complete
+    LogLevel level;
+    LogModule module;
+    uint8_t argCount;
+    uint8_t textUsed;
+    uint32_t timestamp;
+    const char* format;             // nullptr: text holds raw bytes
+    uint8_t types[LOG_MAX_WORDS];
+    uint32_t words[LOG_MAX_WORDS];
+    char text[LOG_TEXT_SIZE];
+};
+
+// Fills one claimed entry; each overload takes one argument type
+class LogPacker {
+private:
+    LogEntry& entry;
+    uint8_t words;
+    bool overflow;
+
+    void put(LogArgType type, uint32_t word);
+
+public:
+    explicit LogPacker(LogEntry& target) : entry(target), words(0), overflow(false) {}
+    bool overflowed() const { return overflow; }
+
+    void add(int value) { put(LOG_ARG_INT, (uint32_t)value); }
+    void add(long value) {
+        if (sizeof(long) > 4) add((long long)value); else put(LOG_ARG_INT, (uint32_t)value);
+    }
+    void add(unsigned int value) { put(LOG_ARG_UINT, value); }
+    void add(unsigned long value) {
+        if (sizeof(long) > 4) add((unsigned long long)value); else put(LOG_ARG_UINT, (uint32_t)value);
+    }
+    void add(long long value);
+    void add(unsigned long long value);
+    void add(double value);
+    void add(const char* value);
+    void add(const String& value) { add(value.c_str()); }
+};
+
+// Multi-producer ring of LogEntry slots drained by a low-priority task.
+// write() never blocks and never allocates: it claims a slot with a CAS,
+// copies the arguments in and marks it ready; if the ring is full the
+// entry is counted as dropped. Formatting and the UART happen in the
+// drain task. Zero-initialised as a global, so it has no constructor and
+// other globals can log before setup().
+class Logger {
+private:
+    LogEntry ring[LOG_RING_SIZE];
+    std::atomic<uint32_t> head;         // Next slot to claim
+    std::atomic<uint32_t> tail;         // Next slot to print
+    std::atomic<uint32_t> written;
+    std::atomic<uint32_t> dropped;
+    std::atomic<uint32_t> truncated;
+    std::atomic<uint32_t> highWater;
+    uint32_t droppedReported;
+    uint8_t overrides[LOG_MODULE_COUNT];    // Runtime level + 1, 0 for none
+    TaskHandle_t task;
+    SemaphoreHandle_t drainLock;        // drain task vs. flush()
+    LoggerStats stats;
+
+    static_assert((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0, "LOG_RING_SIZE must be a power of two");
+
+    static void drainTask(void* arg);
+
+    LogEntry* claim();
+    void publish(LogEntry* entry, bool overflowed);
+    void drain();
+    size_t format(const LogEntry& entry, char* out, size_t size);
+
+    template <typename T, typename... Rest>
+    static void pack(LogPacker& packer, const T& first, const Rest&... rest) {
+        packer.add(first);
+        pack(packer, rest...);
+    }
+    static void pack(LogPacker&) {}
+
+public:
+    void begin();
+    void flush();               // Print everything now, e.g. before a restart
+    const LoggerStats& getStats();
+    uint32_t getPending();      // Entries claimed but not printed yet
+
+    // Runtime level per module, capped at its build level
+    void setLevel(LogModule module, LogLevel level);
+    LogLevel getLevel(LogModule module);
+    static const char* getModuleName(LogModule module);
+    static const char* getLevelName(LogLevel level);
+
+    bool isEnabled(LogModule module, LogLevel level) {
+        uint8_t override = overrides[module];
+        return override == 0 || level < override;
+    }
+
+    // Use the LOG_E/LOG_I/LOG_D macros, which filter before the arguments
+    // are evaluated
+    template <typename... Args>
+    void write(LogLevel level, LogModule module, const char* format, const Args&... args) {
+        LogEntry* entry = claim();
+        if (!entry) return;
+
+        entry->level = level;
+        entry->module = module;
+        entry->format = format;
+        LogPacker packer(*entry);
+        pack(packer, args...);
+        publish(entry, packer.overflowed());
+    }
+
+    // Console output: a line without the timestamp/level prefix, never
+    // filtered
+    template <typename... Args>
+    void print(const char* format, const Args&... args) {
+        write(LOG_LEVEL_OFF, LOG_CORE, format, args...);
+    }
+
+    // Up to LOG_TEXT_SIZE bytes sent as they are, e.g. binary frames;
+    // false when the ring is full
+    bool writeRaw(const uint8_t* data, size_t length);
+};
+
+extern Logger logger;
+
+#endif
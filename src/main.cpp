@@ -6,90 +6,142 @@
 #include "menu_system.h"
 #include "time_manager.h"
 #include "calibration_manager.h"
+#include "trend_history.h"
+#include "scheduler.h"
+#include "boot_sequence.h"
+#include "config_store.h"
+#include "http_server.h"
+#include "captive_portal.h"
+#include "dashboard.h"
+#include "profiler.h"
+#include "metrics.h"
+#include "heap_monitor.h"
+#include "serial_console.h"
 #include <ArduinoJson.h>
 
-// ==================== GLOBAL VARIABLES ====================
-unsigned long lastSensorRead = 0;
-unsigned long lastDataPost = 0;
-unsigned long lastWiFiCheck = 0;
-unsigned long lastDisplayUpdate = 0;
+// ==================== JOBS ====================
+void readSensorsJob(void*) {
+  // Sensor reads wait for the boot stage and pause while a calibration
+  // owns the probes
+  if (!bootSequence.isDone(BOOT_SENSORS) ||
+      calibrationManager.isCalibrating() ||
+      menuSystem.getCurrentState() == MENU_CALIBRATION_PROGRESS) {
+    return;
+  }
+  
+  ALLOC_SCOPE(ALLOC_SENSORS);
+  sensorManager.readAllSensors();
+  trendHistory.record(sensorManager.getSensorData(), millis());
+  dashboard.publish(sensorManager.getSensorData());
+}
 
-bool systemInitialized = false;
-String systemStatus = "Booting...";
+void trendJob(void*) {
+  // Keep trend buckets rolling even while sensor reads are paused
+  trendHistory.update(millis());
+}
 
-// ==================== SETUP ====================
-void setup() {
-  Serial.begin(SERIAL_BAUD);
-  delay(1000);
+void postDataJob(void*) {
+  if (!wifiManager.isConnected() || calibrationManager.isCalibrating()) {
+    return;
+  }
   
-  Utils::info("=== ESP32-S3 Water Quality Monitor ===");
-  Utils::info("Device: " + String(DEVICE_NAME));
-  Utils::info("UID: " + String(DEVICE_UID));
-  Utils::info("Chip ID: " + Utils::getChipID());
+  ALLOC_SCOPE(ALLOC_POST);
+  String jsonPayload = sensorManager.getJSONPayload();
+  if (wifiManager.sendDataToServer(jsonPayload)) {
+    LOG_I("Data sent to server successfully");
+  }
+}
+
+void schedulerReportJob(void*) {
+  const SchedulerStats& stats = scheduler.getStats();
+  LOG_D("Scheduler: idle %u%%, jitter last %u ms max %u ms, overruns %u",
+        stats.idlePercent, stats.lastJitter, stats.maxJitter, stats.overruns);
   
-  // Initialize display first for user feedback
-  if (displayManager.begin()) {
-    displayManager.showSplashScreen();
-    delay(2000);
+  const DashboardStats& live = dashboard.getStats();
+  if (live.clients > 0) {
+    LOG_D("Dashboard: %u clients, %u frames, fan-out %u us, partial %u",
+          live.clients, live.frames, live.lastFanoutMicros, live.partial);
   }
   
-  // Initialize components
-  bool timeOK = timeManager.begin();
-  bool sensorsOK = sensorManager.begin();
-  bool wifiOK = wifiManager.begin();
+  heapMonitor.report();
+  menuSystem.report();
+#if PROFILER_ENABLED
+  profiler.report();
+#endif
+}
+
+// ==================== SETUP ====================
+void setup() {
+  Serial.begin(SERIAL_BAUD);
+  logger.begin();
   
-  // Build status message
-  systemStatus = "";
-  if (timeOK) systemStatus += "Time✓ ";
-  if (sensorsOK) systemStatus += "Sensors✓ ";
-  if (wifiOK) systemStatus += "WiFi✓ ";
+  scheduler.begin();
   
-  // Initialize menu system
+  LOG_I("=== ESP32-S3 Water Quality Monitor ===");
+  LOG_I("Device: %s", DEVICE_NAME);
+  LOG_I("UID: %s", DEVICE_UID);
+  LOG_I("Chip ID: %s", Utils::getChipID());
+  
+  // Settings only; the slow parts run as boot stages or in the background
+  configStore.begin();
+  timeManager.begin();
+  wifiManager.begin();
+  captivePortal.begin();
+  dashboard.begin();
+  metrics.begin();
+  heapMonitor.begin();
+#if PROFILER_ENABLED
+  profiler.begin();
+#endif
+#if TRACE_ENABLED
+  trace.begin();
+#endif
+  httpServer.begin();
   menuSystem.begin();
+  calibrationManager.begin();
+  serialConsole.begin();
+  
+  // Display comes up inline, sensors/WiFi/NTP continue in the background
+  bootSequence.begin();
   
-  systemInitialized = true;
+  scheduler.every(SENSOR_READ_INTERVAL, readSensorsJob, nullptr, "sensors");
+  scheduler.every(TREND_BUCKET_MS, trendJob, nullptr, "trend");
+  scheduler.every(DATA_POST_INTERVAL, postDataJob, nullptr, "post");
+  scheduler.every(SCHEDULER_REPORT_INTERVAL, schedulerReportJob, nullptr, "report");
   
-  if (displayManager.begin()) {
-    displayManager.showMessage("System Ready", systemStatus, true);
-    delay(2000);
+  // Every job is registered by now; warn while there is still room rather
+  // than when a new one silently fails to register
+  if (scheduler.getJobCount() > SCHEDULER_MAX_JOBS - SCHEDULER_SPARE_JOBS) {
+    LOG_E("Scheduler: %u of %u job slots used, raise SCHEDULER_MAX_JOBS",
+          scheduler.getJobCount(), SCHEDULER_MAX_JOBS);
   }
   
-  Utils::info("Setup completed: " + systemStatus);
+  LOG_I("Setup completed in %u ms, boot stages running", millis());
 }
 
 // ==================== MAIN LOOP ====================
 void loop() {
-  unsigned long currentMillis = millis();
-  
-  // Always update menu system (handles encoder and buttons)
-  menuSystem.update();
+  uint32_t wokeAt = micros();
+  bootSequence.update();
   
-  // Read sensors periodically (when not in calibration)
-  if (currentMillis - lastSensorRead >= SENSOR_READ_INTERVAL && 
-      !calibrationManager.isCalibrating() &&
-      menuSystem.getCurrentState() != MENU_CALIBRATION_PROGRESS) {
-    if (sensorManager.readAllSensors()) {
-      lastSensorRead = currentMillis;
-    }
+  {
+    ALLOC_SCOPE(ALLOC_WIFI);
+    wifiManager.update();
   }
+  timeManager.update();
   
-  // Send data to server periodically
-  if (currentMillis - lastDataPost >= DATA_POST_INTERVAL && 
-      wifiManager.isConnected() && 
-      !calibrationManager.isCalibrating()) {
-    String jsonPayload = sensorManager.getJSONPayload();
-    if (wifiManager.sendDataToServer(jsonPayload)) {
-      lastDataPost = currentMillis;
-      Utils::info("Data sent to server successfully");
-    }
+  // Input is handled on every wake-up, the screen only after a change
+  // or once DISPLAY_UPDATE_INTERVAL has passed
+  {
+    ALLOC_SCOPE(ALLOC_UI);
+    menuSystem.update();
   }
   
-  // Handle WiFi reconnection
-  if (currentMillis - lastWiFiCheck >= 10000) {
-    wifiManager.handleReconnection();
-    lastWiFiCheck = currentMillis;
-  }
+  scheduler.run();
+  metrics.loopLatency.observe(micros() - wokeAt);
   
-  // Small delay for stability
-  delay(10);
-}
\ No newline at end of file
+  // Sleep until the next job, a button/encoder interrupt, a pending
+  // gesture timeout or the next display refresh, whichever comes first
+  uint32_t now = millis();
+  scheduler.idle(inputManager.timeUntilNextTimer(now, menuSystem.timeUntilRedraw(now)));
+}
@@ -1,309 +1,526 @@
+#define LOG_MODULE LOG_DISPLAY
 #include "menu_system.h"
 #include <ArduinoJson.h>
+#include "metrics.h"
+#include "boot_sequence.h"
 
 MenuSystem menuSystem;
 
-MenuSystem::MenuSystem() : 
-    encoder(ENCODER_CLK, ENCODER_DT),
-    currentState(MENU_MAIN),
-    previousState(MENU_MAIN),
-    encoderPosition(0),
-    lastEncoderPosition(0),
-    selectedItem(0),
-    scrollOffset(0),
-    lastButtonPress(0) {
+// Indexed by MenuState
+static const char* const SCREEN_LABELS[MENU_STATE_COUNT] = {
+    "screen=\"main\"", "screen=\"sensors\"", "screen=\"sensor_detail\"", "screen=\"trend\"",
+    "screen=\"wifi\"", "screen=\"calibration\"", "screen=\"calibration_progress\"",
+    "screen=\"time\"", "screen=\"system\"", "screen=\"settings\"", "screen=\"message\""
+};
+
+// Menu tables are constant data in flash; item counts come from the array
+// sizes so adding an entry cannot get out of step with the navigation limits
+static const MenuItem MAIN_MENU[] = {
+    {"📊 Sensor Overview", MENU_SENSOR_DISPLAY, ACTION_NONE},
+    {"🔍 Sensor Details", MENU_SENSOR_DETAIL, ACTION_NONE},
+    {"📈 Trends (1h)", MENU_TREND, ACTION_NONE},
+    {"📶 WiFi Settings", MENU_WIFI_CONFIG, ACTION_NONE},
+    {"⚙️ Calibration", MENU_CALIBRATION, ACTION_NONE},
+    {"🕐 Time Settings", MENU_TIME_CONFIG, ACTION_NONE},
+    {"ℹ️ System Info", MENU_SYSTEM_INFO, ACTION_NONE},
+    {"⚡ Settings", MENU_SETTINGS, ACTION_NONE},
+    {"🔃 Refresh Data", MENU_NONE, ACTION_REFRESH_DATA}
+};
+
+// Rotating picks the sensor shown; selecting does nothing
+static const MenuItem SENSOR_DETAIL_MENU[] = {
+    {"🌡️ Temperature", MENU_NONE, ACTION_NONE},
+    {"🧪 pH Value", MENU_NONE, ACTION_NONE},
+    {"💧 Dissolved Oxygen", MENU_NONE, ACTION_NONE},
+    {"⚡ Conductivity", MENU_NONE, ACTION_NONE},
+    {"🔬 Ammonia", MENU_NONE, ACTION_NONE},
+    {"🧂 Salinity", MENU_NONE, ACTION_NONE}
+};
+
+// Item index + 1 is the CalibrationType
+static const MenuItem CALIBRATION_MENU[] = {
+    {"🧪 pH 4.01 Point", MENU_CALIBRATION_PROGRESS, ACTION_START_CALIBRATION},
+    {"🧪 pH 7.00 Point", MENU_CALIBRATION_PROGRESS, ACTION_START_CALIBRATION},
+    {"🧪 pH 10.01 Point", MENU_CALIBRATION_PROGRESS, ACTION_START_CALIBRATION},
+    {"💧 DO Zero Point", MENU_CALIBRATION_PROGRESS, ACTION_START_CALIBRATION},
+    {"💧 DO Slope Point", MENU_CALIBRATION_PROGRESS, ACTION_START_CALIBRATION},
+    {"⚡ EC 1413µS/cm", MENU_CALIBRATION_PROGRESS, ACTION_START_CALIBRATION},
+    {"⚡ EC 12880µS/cm", MENU_CALIBRATION_PROGRESS, ACTION_START_CALIBRATION}
+};
+
+static const MenuItem SETTINGS_MENU[] = {
+    {"🔧 Factory Reset", MENU_NONE, ACTION_FACTORY_RESET},
+    {"🔄 Reboot System", MENU_NONE, ACTION_REBOOT},
+    {"📊 Data Interval", MENU_NONE, ACTION_DATA_INTERVAL},
+    {"🔒 Device Lock", MENU_NONE, ACTION_DEVICE_LOCK}
+};
+
+static_assert(Utils::countOf(CALIBRATION_MENU) == CALIB_EC_12880,
+              "Calibration menu must list every CalibrationType in order");
+
+#define MENU_LIST(items) items, Utils::countOf(items)
+
+// Indexed by MenuState; begin() checks the order
+const MenuSystem::MenuNode MenuSystem::nodes[MENU_STATE_COUNT] = {
+    {MENU_MAIN, "🌊 MAIN MENU", MENU_LIST(MAIN_MENU), "A:Select B:Back",
+        nullptr, &MenuSystem::renderList, nullptr, nullptr, nullptr, nullptr},
+    {MENU_SENSOR_DISPLAY, "Sensor Overview", nullptr, 0, nullptr,
+        nullptr, &MenuSystem::renderSensorDisplay, nullptr, &MenuSystem::refreshSensors, nullptr, nullptr},
+    {MENU_SENSOR_DETAIL, "Sensor Details", MENU_LIST(SENSOR_DETAIL_MENU), nullptr,
+        nullptr, &MenuSystem::renderSensorDetail, nullptr, &MenuSystem::refreshSensors, nullptr, nullptr},
+    {MENU_TREND, "Trends", nullptr, 0, nullptr,
+        nullptr, &MenuSystem::renderTrend, nullptr, nullptr, nullptr, nullptr},
+    {MENU_WIFI_CONFIG, "WiFi Settings", nullptr, 0, nullptr,
+        &MenuSystem::scanWiFi, &MenuSystem::renderWiFiConfig, &MenuSystem::joinWiFi, &MenuSystem::scanWiFi,
+        nullptr, &MenuSystem::rotateWiFiList},
+    {MENU_CALIBRATION, "⚙️ CALIBRATION", MENU_LIST(CALIBRATION_MENU), "A:Start Calib B:Back",
+        nullptr, &MenuSystem::renderList, nullptr, nullptr, nullptr, nullptr},
+    {MENU_CALIBRATION_PROGRESS, "Calibrating", nullptr, 0, nullptr,
+        nullptr, &MenuSystem::renderCalibrationProgress, nullptr, &MenuSystem::cancelCalibration, nullptr, nullptr},
+    {MENU_TIME_CONFIG, "Time Settings", nullptr, 0, nullptr,
+        nullptr, &MenuSystem::renderTimeConfig, nullptr, nullptr, &MenuSystem::resyncTime, &MenuSystem::rotateTimezone},
+    {MENU_SYSTEM_INFO, "System Info", nullptr, 0, nullptr,
+        nullptr, &MenuSystem::renderSystemInfo, nullptr, nullptr, nullptr, nullptr},
+    {MENU_SETTINGS, "⚡ SETTINGS", MENU_LIST(SETTINGS_MENU), "A:Execute B:Back",
+        nullptr, &MenuSystem::renderList, nullptr, nullptr, nullptr, nullptr},
+    {MENU_MESSAGE, "Message", nullptr, 0, nullptr,
+        nullptr, &MenuSystem::renderNothing, nullptr, nullptr, nullptr, nullptr}
+};
+
+// Indexed by MenuAction
+const MenuSystem::ActionHandler MenuSystem::actions[MENU_ACTION_COUNT] = {
+    nullptr,
+    &MenuSystem::actionRefreshData,
+    &MenuSystem::actionStartCalibration,
+    &MenuSystem::actionFactoryReset,
+    &MenuSystem::actionReboot,
+    &MenuSystem::actionDataInterval,
+    &MenuSystem::actionDeviceLock
+};
+
+MenuSystem::MenuSystem() :
+    stackDepth(1),
+    redrawPending(true),
+    lastRender(0) {
+
+    stack[0] = {MENU_MAIN, 0, 0};
+    memset(renderStats, 0, sizeof(renderStats));
 }
 
 void MenuSystem::begin() {
-    pinMode(ENCODER_SW, INPUT_PULLUP);
-    pinMode(BUTTON_A, INPUT_PULLUP);
-    pinMode(BUTTON_B, INPUT_PULLUP);
-    
-    Serial.println("Menu System Initialized");
-    Serial.println("Controls: Encoder + 3 buttons");
+    inputManager.begin();
+
+    for (int i = 0; i < MENU_STATE_COUNT; i++) {
+        if (nodes[i].id != i) {
+            LOG_E("Menu node table out of order at %d", i);
+        }
+    }
+
+    addMetrics();
+    LOG_I("Menu System Initialized");
+    LOG_I("Controls: Encoder + 3 buttons");
+}
+
+void MenuSystem::addMetrics() {
+    for (int i = 0; i < MENU_STATE_COUNT; i++) {
+        metrics.addCounter("menu_frames_total", "Frames rendered per screen", [](const void* source) -> uint32_t {
+            return static_cast<const MenuRenderStats*>(source)->frames;
+        }, &renderStats[i], SCREEN_LABELS[i]);
+    }
+    for (int i = 0; i < MENU_STATE_COUNT; i++) {
+        metrics.addCounter("menu_render_us_total", "Time spent rendering and flushing per screen",
+            [](const void* source) -> uint32_t {
+                return static_cast<const MenuRenderStats*>(source)->totalMicros;
+            }, &renderStats[i], SCREEN_LABELS[i]);
+    }
 }
 
 void MenuSystem::update() {
-    handleEncoder();
-    handleButtons();
-    
-    // Update display based on current state
-    switch (currentState) {
-        case MENU_MAIN:
-            handleMainMenu();
-            break;
-        case MENU_SENSOR_DISPLAY:
-            handleSensorDisplay();
-            break;
-        case MENU_SENSOR_DETAIL:
-            handleSensorDetail();
-            break;
-        case MENU_WIFI_CONFIG:
-            handleWiFiConfig();
-            break;
-        case MENU_CALIBRATION:
-            handleCalibration();
+    handleInputEvents();
+
+    // Input and navigation redraw at once, otherwise the screen only
+    // refreshes for changing readings every DISPLAY_UPDATE_INTERVAL
+    uint32_t now = millis();
+    if (!redrawPending && now - lastRender < DISPLAY_UPDATE_INTERVAL) {
+        return;
+    }
+    redrawPending = false;
+    lastRender = now;
+
+    MenuState state = top().state;
+    uint32_t start = micros();
+    (this->*nodes[state].render)();
+    uint32_t elapsed = micros() - start;
+
+    MenuRenderStats& stats = renderStats[state];
+    stats.frames++;
+    stats.lastMicros = elapsed;
+    stats.totalMicros += elapsed;
+    if (elapsed > stats.maxMicros) {
+        stats.maxMicros = elapsed;
+    }
+}
+
+void MenuSystem::handleInput(const MenuInput& input) {
+    const MenuNode& node = currentNode();
+    redrawPending = true;
+
+    switch (input.type) {
+        case INPUT_ROTATE:
+            if (node.onRotate) {
+                (this->*node.onRotate)(input.delta);
+            } else {
+                moveCursor(input.delta, node.itemCount, MAX_VISIBLE_ITEMS);
+            }
             break;
-        case MENU_CALIBRATION_PROGRESS:
-            handleCalibrationProgress();
+
+        case INPUT_SELECT:
+            if (node.onSelect) {
+                (this->*node.onSelect)();
+            } else {
+                selectItem();
+            }
             break;
-        case MENU_TIME_CONFIG:
-            handleTimeConfig();
+
+        case INPUT_ACTION:
+            if (node.onAction) {
+                (this->*node.onAction)();
+            } else {
+                selectItem();
+            }
             break;
-        case MENU_SYSTEM_INFO:
-            handleSystemInfo();
+
+        case INPUT_LONG_ACTION:
+            if (node.onLongAction) {
+                (this->*node.onLongAction)();
+            } else {
+                handleInput({INPUT_ACTION, 0});
+            }
             break;
-        case MENU_SETTINGS:
-            handleSettings();
+
+        case INPUT_BACK:
+            goBack();
             break;
-        case MENU_MESSAGE:
-            handleMessage();
+
+        case INPUT_HOME:
+            goHome();
             break;
     }
 }
 
-void MenuSystem::handleEncoder() {
-    long newPosition = encoder.read() / ENCODER_STEPS;
-    
-    if (newPosition != lastEncoderPosition) {
-        int direction = (newPosition > lastEncoderPosition) ? 1 : -1;
-        
-        switch (currentState) {
-            case MENU_MAIN:
-            case MENU_SENSOR_DETAIL:
-            case MENU_CALIBRATION:
-            case MENU_SETTINGS:
-                selectedItem = constrain(selectedItem + direction, 0, 
-                    currentState == MENU_MAIN ? 7 : 
-                    currentState == MENU_SENSOR_DETAIL ? 5 :
-                    currentState == MENU_CALIBRATION ? 6 : 3);
-                
-                // Adjust scroll offset
-                if (selectedItem < scrollOffset) {
-                    scrollOffset = selectedItem;
-                } else if (selectedItem >= scrollOffset + MAX_VISIBLE_ITEMS) {
-                    scrollOffset = selectedItem - MAX_VISIBLE_ITEMS + 1;
-                }
+void MenuSystem::handleInputEvents() {
+    inputManager.poll();
+
+    int rotation = inputManager.takeRotation();
+    if (rotation != 0) {
+        handleInput({INPUT_ROTATE, rotation});
+    }
+
+    InputEvent event;
+    while (inputManager.getEvent(event)) {
+        switch (event.button) {
+            case BUTTON_ID_ENCODER:
+                handleInput({INPUT_SELECT, 0});
+                break;
+            case BUTTON_ID_A:
+                handleInput({event.type == EVENT_LONG_PRESS ? INPUT_LONG_ACTION : INPUT_ACTION, 0});
                 break;
-                
-            case MENU_TIME_CONFIG:
-                timeManager.setTimezone(constrain(timeManager.getTimezone() + direction, 0, 14));
+            case BUTTON_ID_B:
+                handleInput({event.type == EVENT_CLICK ? INPUT_BACK : INPUT_HOME, 0});
+                break;
+            default:
                 break;
         }
-        
-        lastEncoderPosition = newPosition;
     }
 }
 
-void MenuSystem::handleButtons() {
-    // Read current button states
-    bool currentEncoderBtn = !digitalRead(ENCODER_SW);
-    bool currentButtonA = !digitalRead(BUTTON_A);
-    bool currentButtonB = !digitalRead(BUTTON_B);
-    
-    unsigned long currentTime = millis();
-    
-    // Check for button presses (with debounce)
-    if (currentTime - lastButtonPress > DEBOUNCE_DELAY) {
-        if (currentEncoderBtn && !lastEncoderButtonState) {
-            handleButtonAction(0); // Encoder button
-        } else if (currentButtonA && !lastButtonAState) {
-            handleButtonAction(1); // Button A
-        } else if (currentButtonB && !lastButtonBState) {
-            handleButtonAction(2); // Button B
-        }
-        
-        if (currentEncoderBtn || currentButtonA || currentButtonB) {
-            lastButtonPress = currentTime;
-        }
+MenuSystem::MenuFrame& MenuSystem::top() {
+    return stack[stackDepth - 1];
+}
+
+const MenuSystem::MenuNode& MenuSystem::currentNode() {
+    return nodes[top().state];
+}
+
+void MenuSystem::moveCursor(int delta, int itemCount, int visibleRows) {
+    if (itemCount == 0) return;
+
+    MenuFrame& frame = top();
+    frame.selectedItem = constrain((int)frame.selectedItem + delta, 0, itemCount - 1);
+
+    // Adjust scroll offset
+    if (frame.selectedItem < frame.scrollOffset) {
+        frame.scrollOffset = frame.selectedItem;
+    } else if (frame.selectedItem >= frame.scrollOffset + visibleRows) {
+        frame.scrollOffset = frame.selectedItem - visibleRows + 1;
     }
-    
-    // Update last states
-    lastEncoderButtonState = currentEncoderBtn;
-    lastButtonAState = currentButtonA;
-    lastButtonBState = currentButtonB;
 }
 
-void MenuSystem::handleButtonAction(int button) {
-    switch (button) {
-        case 0: // Encoder button - Select/OK
-            executeMenuItem();
-            break;
-            
-        case 1: // Button A - Action/Context
-            switch (currentState) {
-                case MENU_SENSOR_DISPLAY:
-                    sensorManager.readAllSensors(); // Manual refresh
-                    break;
-                case MENU_WIFI_CONFIG:
-                    wifiManager.scanNetworks();
-                    break;
-                case MENU_TIME_CONFIG:
-                    timeManager.forceResync();
-                    break;
-                case MENU_CALIBRATION_PROGRESS:
-                    calibrationManager.cancelCalibration();
-                    navigateTo(MENU_CALIBRATION);
-                    break;
-            }
-            break;
-            
-        case 2: // Button B - Back/Cancel
-            goBack();
-            break;
+void MenuSystem::selectItem() {
+    const MenuNode& node = currentNode();
+
+    // Any button dismisses a message
+    if (node.id == MENU_MESSAGE) {
+        goBack();
+        return;
+    }
+
+    int index = top().selectedItem;
+    if (node.itemCount == 0 || index >= node.itemCount) return;
+
+    const MenuItem& item = node.items[index];
+    if (item.action != ACTION_NONE) {
+        (this->*actions[item.action])(index);
+    }
+    // An action that opened a screen of its own (a refusal message)
+    // replaces the item's target
+    if (item.target != MENU_NONE && top().state == node.id) {
+        navigateTo(item.target);
     }
 }
 
-void MenuSystem::executeMenuItem() {
-    switch (currentState) {
-        case MENU_MAIN:
-            switch (selectedItem) {
-                case 0: navigateTo(MENU_SENSOR_DISPLAY); break;
-                case 1: navigateTo(MENU_SENSOR_DETAIL); break;
-                case 2: navigateTo(MENU_WIFI_CONFIG); break;
-                case 3: navigateTo(MENU_CALIBRATION); break;
-                case 4: navigateTo(MENU_TIME_CONFIG); break;
-                case 5: navigateTo(MENU_SYSTEM_INFO); break;
-                case 6: navigateTo(MENU_SETTINGS); break;
-                case 7: 
-                    sensorManager.readAllSensors();
-                    showMessage("Data Refresh", "Sensor data updated", true);
-                    break;
-            }
-            break;
-            
-        case MENU_SENSOR_DETAIL:
-            // Stay in detail view, just show selected sensor
-            break;
-            
-        case MENU_CALIBRATION:
-            if (selectedItem >= 0 && selectedItem <= 6) {
-                CalibrationType calibType = static_cast<CalibrationType>(selectedItem + 1);
-                calibrationManager.beginCalibration(calibType);
-                navigateTo(MENU_CALIBRATION_PROGRESS);
-            }
-            break;
-            
-        case MENU_SETTINGS:
-            switch (selectedItem) {
-                case 0: // Factory Reset
-                    showMessage("Factory Reset", "All settings will be erased", false);
-                    // Implementation would go here
-                    break;
-                case 1: // Reboot
-                    ESP.restart();
-                    break;
-                case 2: // Data Interval
-                    showMessage("Data Interval", "Adjust data logging interval", true);
-                    break;
-                case 3: // Device Lock
-                    showMessage("Device Lock", "Device locked", true);
-                    break;
-            }
-            break;
+void MenuSystem::navigateTo(MenuState newState) {
+    if (stackDepth >= MENU_STACK_DEPTH) {
+        // Out of depth: replace the top level rather than overflow
+        stackDepth--;
+    }
+
+    stack[stackDepth++] = {newState, 0, 0};
+    redrawPending = true;
+
+    const MenuNode& node = nodes[newState];
+    if (node.onEnter) {
+        (this->*node.onEnter)();
     }
 }
 
 void MenuSystem::goBack() {
-    if (currentState == MENU_MAIN) {
+    if (stackDepth <= 1) {
         // Can't go back from main menu
         return;
     }
-    
-    if (calibrationManager.isCalibrating()) {
+
+    if (top().state == MENU_CALIBRATION_PROGRESS && calibrationManager.isCalibrating()) {
         calibrationManager.cancelCalibration();
     }
-    
-    navigateTo(MENU_MAIN);
+
+    stackDepth--;
+    redrawPending = true;
+}
+
+void MenuSystem::goHome() {
+    while (stackDepth > 1) {
+        goBack();
+    }
 }
 
-void MenuSystem::navigateTo(MenuState newState) {
-    previousState = currentState;
-    currentState = newState;
-    selectedItem = 0;
-    scrollOffset = 0;
+// ==================== RENDER HANDLERS ====================
+void MenuSystem::renderList() {
+    const MenuNode& node = currentNode();
+    const MenuFrame& frame = top();
+    displayManager.showMenuList(node.title, node.items, node.itemCount,
+                                frame.selectedItem, frame.scrollOffset, node.hint);
 }
 
-// State handler implementations
-void MenuSystem::handleMainMenu() {
-    displayManager.showMainMenu(mainMenu, 8, selectedItem, scrollOffset);
+void MenuSystem::renderSensorDisplay() {
+    displayManager.showSensorData(sensorManager.getSensorData());
 }
 
-void MenuSystem::handleSensorDisplay() {
-    SensorData data = sensorManager.getSensorData();
-    displayManager.showSensorData(data);
+void MenuSystem::renderSensorDetail() {
+    displayManager.showSensorDetail(sensorManager.getSensorData(), top().selectedItem);
 }
 
-void MenuSystem::handleSensorDetail() {
-    SensorData data = sensorManager.getSensorData();
-    displayManager.showSensorDetail(data, selectedItem);
+void MenuSystem::renderTrend() {
+    displayManager.showTrendGraph(trendHistory, sensorManager.getSensorData());
 }
 
-void MenuSystem::handleWiFiConfig() {
+void MenuSystem::renderWiFiConfig() {
+    // The list can shrink or reorder under the cursor while a sweep runs
+    MenuFrame& frame = top();
+    int count = wifiManager.getScanCount();
+    if (frame.selectedItem >= count) {
+        frame.selectedItem = count > 0 ? count - 1 : 0;
+    }
+    if (frame.scrollOffset > frame.selectedItem) {
+        frame.scrollOffset = frame.selectedItem;
+    }
+
+    char ip[IP_ADDRESS_LENGTH + 1];
+    wifiManager.getIPAddress(ip);
     displayManager.showWiFiConfig(
         wifiManager.getSSID(),
-        wifiManager.isConnected() ? "Connected" : "Disconnected",
-        wifiManager.getIPAddress(),
+        wifiManager.getStateName(),
+        ip,
         wifiManager.getRSSI(),
-        wifiManager.isAPMode()
+        wifiManager.isAPMode(),
+        count > 0 ? &wifiManager.getScanResult(0) : nullptr,
+        count,
+        frame.selectedItem,
+        frame.scrollOffset,
+        wifiManager.getScanChannel()
     );
 }
 
-void MenuSystem::handleCalibration() {
-    displayManager.showCalibrationMenu(calibrationMenu, 7, selectedItem, scrollOffset);
-}
-
-void MenuSystem::handleCalibrationProgress() {
+void MenuSystem::renderCalibrationProgress() {
+    // Finished or aborted by the sampler: say how before leaving
     if (!calibrationManager.isCalibrating()) {
-        navigateTo(MENU_CALIBRATION);
+        goBack();
+        CalibrationResult result = calibrationManager.getResult();
+        if (result != CALIB_RESULT_NONE) {
+            showMessage(calibrationManager.getSensorName(calibrationManager.getCurrentCalibration()),
+                        calibrationManager.getResultText(), result == CALIB_RESULT_DONE);
+        }
         return;
     }
-    
-    // Sekarang bisa mengakses getSensorName karena sudah public
+
     displayManager.showCalibrationProgress(
         calibrationManager.getSensorName(calibrationManager.getCurrentCalibration()),
         calibrationManager.getInstruction(),
         calibrationManager.getCurrentValue(),
         calibrationManager.getProgress()
     );
-    
-    calibrationManager.updateCalibration();
 }
 
-void MenuSystem::handleTimeConfig() {
+void MenuSystem::renderTimeConfig() {
+    char currentTime[LONG_TIME_LENGTH + 1];
+    timeManager.getFormattedTime(currentTime);
     displayManager.showTimeConfig(
         timeManager.getTimezone(),
-        timeManager.getFormattedTime(),
+        currentTime,
         timeManager.isTimeSynced()
     );
 }
 
-void MenuSystem::handleSystemInfo() {
-    SensorData data = sensorManager.getSensorData();
+void MenuSystem::renderSystemInfo() {
+    const SensorData& data = sensorManager.getSensorData();
     int workingSensors = 6;
     if (data.ds18b20_error) workingSensors--;
     if (data.ph_error) workingSensors--;
     if (data.do_error) workingSensors--;
     if (data.ec_error) workingSensors--;
     if (data.nh4_error) workingSensors--;
-    
-    displayManager.showSystemInfo(data, timeManager.getUptime(), workingSensors);
+
+    char uptime[UPTIME_LENGTH + 1];
+    timeManager.getUptime(uptime);
+    displayManager.showSystemInfo(data, uptime, workingSensors);
 }
 
-void MenuSystem::handleSettings() {
-    displayManager.showSettingsMenu(settingsMenu, 4, selectedItem);
+void MenuSystem::renderNothing() {
+    // Message screen is drawn once by showMessage
 }
 
-void MenuSystem::handleMessage() {
-    // Message screen is handled by showMessage method
+// ==================== BUTTON A HANDLERS ====================
+bool MenuSystem::sensorsReady() {
+    // The sensors boot stage owns the RS485 and OneWire buses until it is
+    // done, the same gate the sensor job and the console use
+    if (bootSequence.isDone(BOOT_SENSORS)) return true;
+    showMessage("Sensors", "Sensors starting", false);
+    return false;
+}
+
+void MenuSystem::refreshSensors() {
+    if (!sensorsReady()) return;
+    sensorManager.readAllSensors(); // Manual refresh
+}
+
+void MenuSystem::scanWiFi() {
+    // Results come in one channel at a time; render picks them up
+    wifiManager.startNetworkScan();
+}
+
+void MenuSystem::joinWiFi() {
+    int index = top().selectedItem;
+    if (index >= wifiManager.getScanCount()) return;
+
+    const char* ssid = wifiManager.getScanResult(index).ssid;
+    if (wifiManager.connectTo(ssid)) {
+        showMessage("WiFi", "Joining " + String(ssid), true);
+    } else {
+        showMessage("WiFi", "Not saved, add it via setup AP", false);
+    }
+}
+
+void MenuSystem::resyncTime() {
+    timeManager.forceResync();
+}
+
+void MenuSystem::cancelCalibration() {
+    goBack();
+}
+
+// ==================== ROTATE HANDLERS ====================
+void MenuSystem::rotateTimezone(int delta) {
+    timeManager.setTimezone(constrain(timeManager.getTimezone() + delta, 0, 14));
+}
+
+void MenuSystem::rotateWiFiList(int delta) {
+    moveCursor(delta, wifiManager.getScanCount(), WIFI_LIST_ROWS);
+}
+
+// ==================== ITEM ACTIONS ====================
+void MenuSystem::actionRefreshData(int itemIndex) {
+    if (!sensorsReady()) return;
+    sensorManager.readAllSensors();
+    showMessage("Data Refresh", "Sensor data updated", true);
+}
+
+void MenuSystem::actionStartCalibration(int itemIndex) {
+    if (!sensorsReady()) return;
+    calibrationManager.beginCalibration(static_cast<CalibrationType>(itemIndex + 1));
+}
+
+void MenuSystem::actionFactoryReset(int itemIndex) {
+    showMessage("Factory Reset", "All settings will be erased", false);
+    // Implementation would go here
+}
+
+void MenuSystem::actionReboot(int itemIndex) {
+    configStore.commit();   // Don't lose settings still waiting for the debounce
+    logger.flush();
+    ESP.restart();
+}
+
+void MenuSystem::actionDataInterval(int itemIndex) {
+    showMessage("Data Interval", "Adjust data logging interval", true);
+}
+
+void MenuSystem::actionDeviceLock(int itemIndex) {
+    showMessage("Device Lock", "Device locked", true);
 }
 
 void MenuSystem::showMessage(const String& title, const String& message, bool success) {
-    previousState = currentState;
-    currentState = MENU_MESSAGE;
+    navigateTo(MENU_MESSAGE);
     displayManager.showMessage(title, message, success);
 }
 
 MenuState MenuSystem::getCurrentState() {
-    return currentState;
-}
\ No newline at end of file
+    return top().state;
+}
+
+void MenuSystem::openScreen(MenuState state) {
+    navigateTo(state);
+}
+
+const MenuRenderStats& MenuSystem::getRenderStats(MenuState state) {
+    return renderStats[state];
+}
+
+uint32_t MenuSystem::timeUntilRedraw(uint32_t now) {
+    if (redrawPending) return 0;
+    uint32_t elapsed = now - lastRender;
+    return elapsed < DISPLAY_UPDATE_INTERVAL ? DISPLAY_UPDATE_INTERVAL - elapsed : 0;
+}
+
+void MenuSystem::report() {
+    int slowest = -1;
+    for (int i = 0; i < MENU_STATE_COUNT; i++) {
+        if (renderStats[i].frames && (slowest < 0 || renderStats[i].maxMicros > renderStats[slowest].maxMicros)) {
+            slowest = i;
+        }
+    }
+    if (slowest < 0) return;
+
+    const MenuRenderStats& stats = renderStats[slowest];
+    LOG_D("Menu: slowest %s, %u frames, avg %u us, max %u us", nodes[slowest].title,
+          stats.frames, stats.totalMicros / stats.frames, stats.maxMicros);
+}
@@ -2,116 +2,111 @@
 #define MENU_SYSTEM_H
 
 #include <Arduino.h>
-#include <Encoder.h>
 #include "config.h"
+#include "menu_types.h"
 #include "display_manager.h"
 #include "sensor_manager.h"
 #include "wifi_manager.h"
 #include "time_manager.h"
 #include "calibration_manager.h"
+#include "input_manager.h"
 
-enum MenuState {
-    MENU_MAIN,
-    MENU_SENSOR_DISPLAY,
-    MENU_SENSOR_DETAIL,
-    MENU_WIFI_CONFIG,
-    MENU_CALIBRATION,
-    MENU_CALIBRATION_PROGRESS,
-    MENU_TIME_CONFIG,
-    MENU_SYSTEM_INFO,
-    MENU_SETTINGS,
-    MENU_MESSAGE
-};
+#define MENU_STACK_DEPTH 6
 
 class MenuSystem {
 private:
-    Encoder encoder;
-    MenuState currentState;
-    MenuState previousState;
-    
-    // Navigation variables
-    long encoderPosition;
-    long lastEncoderPosition;
-    int selectedItem;
-    int scrollOffset;
-    
-    // Button states
-    bool buttonAState;
-    bool buttonBState;
-    bool encoderButtonState;
-    bool lastButtonAState;
-    bool lastButtonBState;
-    bool lastEncoderButtonState;
-    unsigned long lastButtonPress;
-    
-    // Menu content
-    String mainMenu[8] = {
-        "📊 Sensor Overview",
-        "🔍 Sensor Details", 
-        "📶 WiFi Settings",
-        "⚙️ Calibration",
-        "🕐 Time Settings",
-        "ℹ️ System Info",
-        "⚡ Settings",
-        "🔃 Refresh Data"
-    };
-    
-    String sensorDetailMenu[6] = {
-        "🌡️ Temperature",
-        "🧪 pH Value", 
-        "💧 Dissolved Oxygen",
-        "⚡ Conductivity",
-        "🔬 Ammonia",
-        "🧂 Salinity"
-    };
-    
-    String calibrationMenu[7] = {
-        "🧪 pH 4.01 Point",
-        "🧪 pH 7.00 Point", 
-        "🧪 pH 10.01 Point",
-        "💧 DO Zero Point",
-        "💧 DO Slope Point", 
-        "⚡ EC 1413µS/cm",
-        "⚡ EC 12880µS/cm"
+    typedef void (MenuSystem::*MenuHandler)();
+    typedef void (MenuSystem::*RotateHandler)(int delta);
+    typedef void (MenuSystem::*ActionHandler)(int itemIndex);
+
+    // Static description of one screen, indexed by MenuState
+    struct MenuNode {
+        MenuState id;
+        const char* title;
+        const MenuItem* items;      // nullptr for screens without a list
+        uint8_t itemCount;
+        const char* hint;           // Footer for list screens
+        MenuHandler onEnter;        // Called when pushed onto the stack
+        MenuHandler render;
+        MenuHandler onSelect;       // Encoder press; lists default to select
+        MenuHandler onAction;       // Button A; lists default to select
+        MenuHandler onLongAction;   // Button A held; defaults to onAction
+        RotateHandler onRotate;     // nullptr moves the list cursor
     };
-    
-    String settingsMenu[4] = {
-        "🔧 Factory Reset",
-        "🔄 Reboot System",
-        "📊 Data Interval",
-        "🔒 Device Lock"
+
+    // One navigation level; the cursor is restored when returning to it
+    struct MenuFrame {
+        MenuState state;
+        uint8_t selectedItem;
+        uint8_t scrollOffset;
     };
-    
+
+    static const MenuNode nodes[MENU_STATE_COUNT];
+    static const ActionHandler actions[MENU_ACTION_COUNT];
+
+    MenuFrame stack[MENU_STACK_DEPTH];
+    uint8_t stackDepth;
+    MenuRenderStats renderStats[MENU_STATE_COUNT];
+    bool redrawPending;         // Input or navigation since the last frame
+    uint32_t lastRender;
+
     // Input handling
-    void handleEncoder();
-    void handleButtons();
-    void handleButtonAction(int button);
-    
+    void handleInputEvents();
+    void addMetrics();
+    bool sensorsReady();
+
     // Navigation
+    MenuFrame& top();
+    const MenuNode& currentNode();
     void navigateTo(MenuState newState);
     void goBack();
-    void executeMenuItem();
-    
-    // State handlers
-    void handleMainMenu();
-    void handleSensorDisplay();
-    void handleSensorDetail();
-    void handleWiFiConfig();
-    void handleCalibration();
-    void handleCalibrationProgress();
-    void handleTimeConfig();
-    void handleSystemInfo();
-    void handleSettings();
-    void handleMessage();
-    
+    void goHome();
+    void selectItem();
+    void moveCursor(int delta, int itemCount, int visibleRows);
+
+    // Render handlers
+    void renderList();
+    void renderSensorDisplay();
+    void renderSensorDetail();
+    void renderTrend();
+    void renderWiFiConfig();
+    void renderCalibrationProgress();
+    void renderTimeConfig();
+    void renderSystemInfo();
+    void renderNothing();
+
+    // Button A handlers
+    void refreshSensors();
+    void scanWiFi();
+    void joinWiFi();
+    void resyncTime();
+    void cancelCalibration();
+
+    // Rotate handlers
+    void rotateTimezone(int delta);
+    void rotateWiFiList(int delta);
+
+    // Item actions
+    void actionRefreshData(int itemIndex);
+    void actionStartCalibration(int itemIndex);
+    void actionFactoryReset(int itemIndex);
+    void actionReboot(int itemIndex);
+    void actionDataInterval(int itemIndex);
+    void actionDeviceLock(int itemIndex);
+
 public:
     MenuSystem();
     void begin();
     void update();
+    void handleInput(const MenuInput& input);
     MenuState getCurrentState();
+    void openScreen(MenuState state);
+    const MenuRenderStats& getRenderStats(MenuState state);
+    uint32_t timeUntilRedraw(uint32_t now);
+    void report();              // Slowest screen so far
     void showMessage(const String& title, const String& message, bool success = true);
 };
 
 extern MenuSystem menuSystem;
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,63 @@
+#ifndef MENU_TYPES_H
+#define MENU_TYPES_H
+
+#include <Arduino.h>
+
+// Node ids double as indexes into the menu node table
+enum MenuState {
+    MENU_MAIN,
+    MENU_SENSOR_DISPLAY,
+    MENU_SENSOR_DETAIL,
+    MENU_TREND,
+    MENU_WIFI_CONFIG,
+    MENU_CALIBRATION,
+    MENU_CALIBRATION_PROGRESS,
+    MENU_TIME_CONFIG,
+    MENU_SYSTEM_INFO,
+    MENU_SETTINGS,
+    MENU_MESSAGE,
+    MENU_STATE_COUNT,
+    MENU_NONE = MENU_STATE_COUNT
+};
+
+// Item actions double as indexes into the action handler table
+enum MenuAction {
+    ACTION_NONE,
+    ACTION_REFRESH_DATA,
+    ACTION_START_CALIBRATION,
+    ACTION_FACTORY_RESET,
+    ACTION_REBOOT,
+    ACTION_DATA_INTERVAL,
+    ACTION_DEVICE_LOCK,
+    MENU_ACTION_COUNT
+};
+
+// A list entry: run the action (if any), then open the target (if any)
+struct MenuItem {
+    const char* label;
+    MenuState target;
+    MenuAction action;
+};
+
+enum MenuInputType {
+    INPUT_ROTATE,
+    INPUT_SELECT,   // Encoder push
+    INPUT_ACTION,       // Button A
+    INPUT_LONG_ACTION,  // Button A held
+    INPUT_BACK,         // Button B
+    INPUT_HOME          // Button B double click
+};
+
+struct MenuInput {
+    MenuInputType type;
+    int delta;      // Detents for INPUT_ROTATE
+};
+
+struct MenuRenderStats {
+    uint32_t frames;
+    uint32_t lastMicros;
+    uint32_t maxMicros;
+    uint32_t totalMicros;
+};
+
+#endif
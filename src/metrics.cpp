@@ -0,0 +1,259 @@
+#define LOG_MODULE LOG_WEB
+#include "metrics.h"
+#include <nvs.h>
+#include <ESPAsyncWebServer.h>
+#include "http_server.h"
+#include "utils.h"
+
+Metrics metrics;
+
+#define METRICS_LINE_LENGTH 192
+
+static const uint32_t LOOP_LATENCY_BOUNDS[] = {100, 500, 1000, 5000, 10000, 50000, 100000, 500000};
+
+// Partition-wide, the config store's namespace included
+static uint32_t readNvsEntries(bool used) {
+    nvs_stats_t stats;
+    if (nvs_get_stats(nullptr, &stats) != ESP_OK) return 0;
+    return used ? stats.used_entries : stats.total_entries;
+}
+
+Metrics::Metrics() :
+    seriesCount(0),
+    valueCount(0),
+    lock(portMUX_INITIALIZER_UNLOCKED),
+    loopLatency(LOOP_LATENCY_BOUNDS) {
+
+    memset(series, 0, sizeof(series));
+}
+
+void Metrics::begin() {
+    httpServer.getServer().on("/metrics", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleMetrics(request);
+    });
+
+    addGauge("uptime_seconds", "Time since boot", [](const void*) -> uint32_t {
+        return millis() / 1000;
+    });
+    addGauge("heap_free_bytes", "Free internal heap", [](const void*) -> uint32_t {
+        return ESP.getFreeHeap();
+    });
+    addGauge("heap_min_free_bytes", "Lowest free heap since boot", [](const void*) -> uint32_t {
+        return ESP.getMinFreeHeap();
+    });
+    addGauge("heap_largest_free_block_bytes", "Largest allocation that can succeed", [](const void*) -> uint32_t {
+        return ESP.getMaxAllocHeap();
+    });
+    addGauge("nvs_used_entries", "NVS entries in use", [](const void*) -> uint32_t {
+        return readNvsEntries(true);
+    });
+    addGauge("nvs_total_entries", "NVS entries in the partition", [](const void*) -> uint32_t {
+        return readNvsEntries(false);
+    });
+    addGauge("queue_depth", "Items waiting in an inter-task queue", [](const void*) -> uint32_t {
+        return logger.getPending();
+    }, nullptr, "queue=\"log\"");
+    addHistogram("loop_latency_us", "Main loop work per wake-up", loopLatency);
+}
+
+void Metrics::add(const char* name, const char* help, const char* labels, MetricType type,
+                  MetricReader read, const void* source, uint16_t width) {
+    portENTER_CRITICAL(&lock);
+    uint8_t count = seriesCount.load(std::memory_order_relaxed);
+    bool full = count >= METRICS_MAX_SERIES;
+    if (!full) {
+        series[count] = {name, help, labels, type, read, source, valueCount};
+        valueCount += width;
+        // Published last: a scrape only sees complete series
+        seriesCount.store(count + 1, std::memory_order_release);
+    }
+    portEXIT_CRITICAL(&lock);
+
+    if (full) {
+        LOG_E("Metrics: no room for %s, raise METRICS_MAX_SERIES", name);
+    }
+}
+
+void Metrics::addCounter(const char* name, const char* help, const Counter& counter, const char* labels) {
+    add(name, help, labels, METRIC_COUNTER, [](const void* source) -> uint32_t {
+        return static_cast<const Counter*>(source)->get();
+    }, &counter, 1);
+}
+
+void Metrics::addCounter(const char* name, const char* help, MetricReader read, const void* source,
+                         const char* labels) {
+    add(name, help, labels, METRIC_COUNTER, read, source, 1);
+}
+
+void Metrics::addGauge(const char* name, const char* help, MetricReader read, const void* source,
+                       const char* labels) {
+    add(name, help, labels, METRIC_GAUGE, read, source, 1);
+}
+
+void Metrics::addHistogram(const char* name, const char* help, const Histogram& histogram,
+                           const char* labels) {
+    add(name, help, labels, METRIC_HISTOGRAM, nullptr, &histogram, histogram.boundCount + 2);
+}
+
+// Buckets including +Inf, then the sum
+uint16_t Metrics::widthOf(const Series& entry) {
+    if (entry.type != METRIC_HISTOGRAM) return 1;
+    return static_cast<const Histogram*>(entry.source)->boundCount + 2;
+}
+
+// The text format wants all series of a name together, but they may be
+// registered from different modules: a family is rendered in full where
+// its first series is
+bool Metrics::isFamilyStart(int index) {
+    for (int i = 0; i < index; i++) {
+        if (strcmp(series[i].name, series[index].name) == 0) return false;
+    }
+    return true;
+}
+
+void Metrics::takeSnapshot(Snapshot& snapshot) {
+    uint8_t count = seriesCount.load(std::memory_order_acquire);
+    uint16_t values = count ? series[count - 1].firstValue + widthOf(series[count - 1]) : 0;
+    snapshot.seriesCount = count;
+    snapshot.values.reset(new uint32_t[max(values, (uint16_t)1)]);
+    snapshot.order.reset(new uint8_t[max(count, (uint8_t)1)]);
+
+    int ordered = 0;
+    for (int first = 0; first < count; first++) {
+        if (!isFamilyStart(first)) continue;
+        for (int i = first; i < count; i++) {
+            if (strcmp(series[i].name, series[first].name) == 0) {
+                snapshot.order[ordered++] = i;
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        const Series& entry = series[i];
+        uint32_t* out = snapshot.values.get() + entry.firstValue;
+        if (entry.type != METRIC_HISTOGRAM) {
+            out[0] = entry.read(entry.source);
+            continue;
+        }
+        const Histogram& histogram = *static_cast<const Histogram*>(entry.source);
+        for (int b = 0; b <= histogram.boundCount; b++) {
+            out[b] = histogram.buckets[b].load(std::memory_order_relaxed);
+        }
+        out[histogram.boundCount + 1] = histogram.sum.load(std::memory_order_relaxed);
+    }
+}
+
+#if METRICS_IN_UPLOAD
+void Metrics::addTo(JsonObject out) {
+    Snapshot snapshot;
+    takeSnapshot(snapshot);
+
+    char key[64];
+    for (int i = 0; i < snapshot.seriesCount; i++) {
+        const Series& entry = series[i];
+        const uint32_t* values = snapshot.values.get() + entry.firstValue;
+        const char* open = entry.labels ? "{" : "";
+        const char* close = entry.labels ? "}" : "";
+        const char* labels = entry.labels ? entry.labels : "";
+
+        if (entry.type == METRIC_COUNTER) {
+            snprintf(key, sizeof(key), "%s%s%s%s", entry.name, open, labels, close);
+            out[key] = values[0];
+        } else if (entry.type == METRIC_GAUGE) {
+            snprintf(key, sizeof(key), "%s%s%s%s", entry.name, open, labels, close);
+            out[key] = (int32_t)values[0];
+        } else {
+            uint8_t bounds = static_cast<const Histogram*>(entry.source)->boundCount;
+            uint32_t count = 0;
+            for (int b = 0; b <= bounds; b++) count += values[b];
+            snprintf(key, sizeof(key), "%s_count%s%s%s", entry.name, open, labels, close);
+            out[key] = count;
+            snprintf(key, sizeof(key), "%s_sum%s%s%s", entry.name, open, labels, close);
+            out[key] = values[bounds + 1];
+        }
+    }
+}
+#endif
+
+// ==================== HTTP ====================
+std::function<size_t(uint8_t*, size_t, size_t)> Metrics::textFiller() {
+    // The consumer outlives this call, so it reads from its own copy
+    std::shared_ptr<Snapshot> snapshot(new Snapshot);
+    takeSnapshot(*snapshot);
+    return [this, snapshot](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+        return renderText(*snapshot, index, buffer, maxLen);
+    };
+}
+
+void Metrics::handleMetrics(AsyncWebServerRequest* request) {
+    AsyncWebServerResponse* response = request->beginChunkedResponse("text/plain; version=0.0.4", textFiller());
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
+
+// One sample line of a series, 0 past its last line
+size_t Metrics::renderLine(const Snapshot& snapshot, int index, int line, char* out, size_t size) {
+    const Series& entry = series[index];
+    const uint32_t* values = snapshot.values.get() + entry.firstValue;
+    const char* labels = entry.labels ? entry.labels : "";
+    const char* open = entry.labels ? "{" : "";
+    const char* close = entry.labels ? "}" : "";
+    int length = 0;
+
+    if (entry.type != METRIC_HISTOGRAM) {
+        if (line > 0) return 0;
+        if (entry.type == METRIC_COUNTER) {
+            length = snprintf(out, size, "%s%s%s%s %lu\n", entry.name, open, labels, close,
+                              (unsigned long)values[0]);
+        } else {
+            length = snprintf(out, size, "%s%s%s%s %ld\n", entry.name, open, labels, close,
+                              (long)(int32_t)values[0]);
+        }
+        return min((size_t)max(length, 0), size - 1);
+    }
+
+    // Buckets are cumulative in the text format
+    const Histogram& histogram = *static_cast<const Histogram*>(entry.source);
+    uint8_t bounds = histogram.boundCount;
+    uint32_t cumulative = 0;
+    for (int b = 0; b <= min(line, (int)bounds); b++) cumulative += values[b];
+    const char* separator = entry.labels ? "," : "";
+
+    if (line < bounds) {
+        length = snprintf(out, size, "%s_bucket{%s%sle=\"%lu\"} %lu\n", entry.name, labels, separator,
+                          (unsigned long)histogram.bounds[line], (unsigned long)cumulative);
+    } else if (line == bounds) {
+        length = snprintf(out, size, "%s_bucket{%s%sle=\"+Inf\"} %lu\n", entry.name, labels, separator,
+                          (unsigned long)cumulative);
+    } else if (line == bounds + 1) {
+        length = snprintf(out, size, "%s_sum%s%s%s %lu\n", entry.name, open, labels, close,
+                          (unsigned long)values[bounds + 1]);
+    } else if (line == bounds + 2) {
+        length = snprintf(out, size, "%s_count%s%s%s %lu\n", entry.name, open, labels, close,
+                          (unsigned long)cumulative);
+    } else {
+        return 0;
+    }
+    return min((size_t)max(length, 0), size - 1);
+}
+
+size_t Metrics::renderText(Snapshot& snapshot, size_t index, uint8_t* buffer, size_t maxLen) {
+    char piece[METRICS_LINE_LENGTH];
+
+    // One item per series; the first of a family leads with HELP and TYPE
+    return Utils::fillChunk(snapshot.cursor, snapshot.seriesCount, index, buffer, maxLen, piece, sizeof(piece),
+        [this, &snapshot](int item, int part, char* out, size_t size) -> size_t {
+            int i = snapshot.order[item];
+            const Series& entry = series[i];
+            if (item == 0 || strcmp(series[snapshot.order[item - 1]].name, entry.name) != 0) {
+                if (part == 0) {
+                    static const char* const TYPE_NAMES[] = {"counter", "gauge", "histogram"};
+                    int length = snprintf(out, size, "# HELP %s %s\n# TYPE %s %s\n",
+                                          entry.name, entry.help, entry.name, TYPE_NAMES[entry.type]);
+                    return min((size_t)max(length, 0), size - 1);
+                }
+                part--;
+            }
+            return renderLine(snapshot, i, part, out, size);
+        });
+}
@@ -0,0 +1,141 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include "config.h"
+#include "utils.h"
+
+class AsyncWebServerRequest;
+
+enum MetricType : uint8_t {
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+};
+
+// Current value of a counter or gauge; gauges are read back as int32_t.
+// Called from the web server task while a scrape takes its snapshot.
+typedef uint32_t (*MetricReader)(const void* source);
+
+// Monotonic count. inc() is one relaxed atomic add, safe from any task.
+class Counter {
+private:
+    std::atomic<uint32_t> value;
+
+public:
+    Counter() : value(0) {}
+    void inc(uint32_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint32_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+// Counts per fixed upper bound (inclusive) plus the running sum.
+// observe() is a short scan of the bounds and two relaxed atomic adds.
+class Histogram {
+private:
+    const uint32_t* bounds;
+    uint8_t boundCount;
+    std::atomic<uint32_t> buckets[METRICS_MAX_BUCKETS + 1];    // Last one is +Inf
+    std::atomic<uint32_t> sum;      // Wraps at 2^32, which rate() treats as a reset
+
+    friend class Metrics;
+
+public:
+    template <size_t N>
+    explicit Histogram(const uint32_t (&upperBounds)[N]) :
+        bounds(upperBounds),
+        boundCount(N),
+        sum(0) {
+
+        static_assert(N <= METRICS_MAX_BUCKETS, "Histogram has more than METRICS_MAX_BUCKETS bounds");
+        for (int i = 0; i <= METRICS_MAX_BUCKETS; i++) {
+            buckets[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void observe(uint32_t value) {
+        uint8_t i = 0;
+        while (i < boundCount && value > bounds[i]) i++;
+        buckets[i].fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+    }
+};
+
+// Registry of counters, gauges and histograms, served at GET /metrics in
+// the Prometheus text format. Modules own their Counter and Histogram
+// objects and register them in begin(); sampled values such as heap or
+// queue depth are gauges with a reader. Series are never removed. A
+// scrape copies every value into a snapshot and streams text rendered
+// from it line by line, so no document is built in memory.
+class Metrics {
+private:
+    struct Series {
+        const char* name;
+        const char* help;
+        const char* labels;     // e.g. slave="1", nullptr for none
+        MetricType type;
+        MetricReader read;      // Counters and gauges
+        const void* source;
+        uint16_t firstValue;    // Position in a snapshot
+    };
+
+    struct Snapshot {
+        uint8_t seriesCount;
+        std::unique_ptr<uint32_t[]> values;
+        std::unique_ptr<uint8_t[]> order;   // Series indices, each family together
+        ChunkCursor cursor;
+    };
+
+    Series series[METRICS_MAX_SERIES];
+    std::atomic<uint8_t> seriesCount;
+    uint16_t valueCount;
+    portMUX_TYPE lock;
+
+    void add(const char* name, const char* help, const char* labels, MetricType type,
+             MetricReader read, const void* source, uint16_t width);
+    static uint16_t widthOf(const Series& entry);
+    bool isFamilyStart(int index);
+    void takeSnapshot(Snapshot& snapshot);
+    void handleMetrics(AsyncWebServerRequest* request);
+    size_t renderLine(const Snapshot& snapshot, int index, int line, char* out, size_t size);
+    size_t renderText(Snapshot& snapshot, size_t index, uint8_t* buffer, size_t maxLen);
+
+public:
+    Histogram loopLatency;      // us from a loop() wake-up until it sleeps again
+
+    Metrics();
+    void begin();
+
+    // Prometheus text of a snapshot taken now, filled in pieces the way a
+    // chunked response asks for them
+    std::function<size_t(uint8_t*, size_t, size_t)> textFiller();
+
+    // Registration is safe from any task, but belongs in begin()
+    void addCounter(const char* name, const char* help, const Counter& counter, const char* labels = nullptr);
+    void addCounter(const char* name, const char* help, MetricReader read, const void* source,
+                    const char* labels = nullptr);
+    void addGauge(const char* name, const char* help, MetricReader read, const void* source = nullptr,
+                  const char* labels = nullptr);
+    void addHistogram(const char* name, const char* help, const Histogram& histogram,
+                      const char* labels = nullptr);
+
+    // Items waiting in a queue with size(), as queue_depth{queue="..."}
+    template <typename Queue>
+    void addQueue(const char* labels, const Queue& queue) {
+        addGauge("queue_depth", "Items waiting in an inter-task queue", [](const void* source) -> uint32_t {
+            return static_cast<const Queue*>(source)->size();
+        }, &queue, labels);
+    }
+
+#if METRICS_IN_UPLOAD
+    // Counters and gauges by series name; histograms as _count and _sum
+    void addTo(JsonObject out);
+#endif
+};
+
+extern Metrics metrics;
+
+#endif
@@ -0,0 +1,170 @@
+#include "profiler.h"
+#include <memory>
+#include <ESPAsyncWebServer.h>
+#include "http_server.h"
+#include "utils.h"
+
+// Indexed by ProfileZone
+static const char* const ZONE_NAMES[PROFILE_ZONE_COUNT] = {
+    "sensors", "modbus", "json", "post",
+    "screen.sensors", "screen.detail", "screen.menu", "screen.wifi", "screen.calibration",
+    "screen.time", "screen.system", "screen.message", "screen.scanning", "screen.trend",
+    "display.flush", "dashboard.publish"
+};
+
+const char* getProfileZoneName(ProfileZone zone) {
+    return ZONE_NAMES[zone];
+}
+
+#if PROFILER_ENABLED
+
+Profiler profiler;
+
+Profiler::Profiler() :
+    migrated(0),
+    cyclesPerMicro(240),
+    lock(portMUX_INITIALIZER_UNLOCKED) {
+
+    reset();
+}
+
+void Profiler::begin() {
+    cyclesPerMicro = ESP.getCpuFreqMHz();
+
+    // ?reset clears the zones after this response
+    httpServer.getServer().on("/profile", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleProfile(request);
+    });
+}
+
+void Profiler::record(ProfileZone zone, uint32_t cycles) {
+    int bucket = 31 - __builtin_clz(cycles | 1);
+
+    portENTER_CRITICAL(&lock);
+    ProfileStats& stats = zones[zone];
+    stats.count++;
+    stats.totalCycles += cycles;
+    stats.minCycles = min(stats.minCycles, cycles);
+    stats.maxCycles = max(stats.maxCycles, cycles);
+    stats.buckets[min(bucket, PROFILER_BUCKETS - 1)]++;
+    portEXIT_CRITICAL(&lock);
+}
+
+void Profiler::recordMigrated() {
+    portENTER_CRITICAL(&lock);
+    migrated++;
+    portEXIT_CRITICAL(&lock);
+}
+
+void Profiler::reset() {
+    portENTER_CRITICAL(&lock);
+    memset(zones, 0, sizeof(zones));
+    for (int i = 0; i < PROFILE_ZONE_COUNT; i++) {
+        zones[i].minCycles = UINT32_MAX;
+    }
+    migrated = 0;
+    portEXIT_CRITICAL(&lock);
+}
+
+// Upper bound of the bucket holding the given fraction of runs
+uint32_t Profiler::percentile(const ProfileStats& stats, uint32_t permille) {
+    uint32_t target = ((uint64_t)stats.count * permille + 999) / 1000;
+    uint32_t seen = 0;
+    for (int i = 0; i < PROFILER_BUCKETS; i++) {
+        seen += stats.buckets[i];
+        if (seen >= target) {
+            return i >= 31 ? UINT32_MAX : (2u << i) - 1;
+        }
+    }
+    return stats.maxCycles;
+}
+
+void Profiler::report() {
+    for (int i = 0; i < PROFILE_ZONE_COUNT; i++) {
+        // One zone at a time keeps the copy small
+        ProfileStats stats;
+        portENTER_CRITICAL(&lock);
+        stats = zones[i];
+        portEXIT_CRITICAL(&lock);
+        if (stats.count == 0) continue;
+
+        LOG_D("Profile %s: %u runs, min %u avg %u max %u us, p50 <%u p90 <%u p99 <%u us",
+              ZONE_NAMES[i], stats.count, stats.minCycles / cyclesPerMicro,
+              (uint32_t)(stats.totalCycles / stats.count / cyclesPerMicro), stats.maxCycles / cyclesPerMicro,
+              percentile(stats, 500) / cyclesPerMicro + 1, percentile(stats, 900) / cyclesPerMicro + 1,
+              percentile(stats, 990) / cyclesPerMicro + 1);
+    }
+    if (migrated) {
+        LOG_D("Profile: %u runs discarded after a core switch", migrated);
+    }
+}
+
+// ==================== HTTP ====================
+std::function<size_t(uint8_t*, size_t, size_t)> Profiler::jsonFiller() {
+    // The consumer outlives this call, so it reads from its own copy
+    std::shared_ptr<Snapshot> snapshot(new Snapshot);
+    portENTER_CRITICAL(&lock);
+    memcpy(snapshot->zones, zones, sizeof(zones));
+    snapshot->migrated = migrated;
+    portEXIT_CRITICAL(&lock);
+    snapshot->cyclesPerMicro = cyclesPerMicro;
+
+    return [snapshot](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+        return renderJson(*snapshot, index, buffer, maxLen);
+    };
+}
+
+void Profiler::handleProfile(AsyncWebServerRequest* request) {
+    AwsResponseFiller filler = jsonFiller();
+    if (request->hasParam("reset")) {
+        reset();
+    }
+
+    AsyncWebServerResponse* response = request->beginChunkedResponse("application/json", filler);
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
+
+size_t Profiler::renderZone(const Snapshot& snapshot, int zone, char* out, size_t size) {
+    const ProfileStats& stats = snapshot.zones[zone];
+    uint32_t perMicro = snapshot.cyclesPerMicro;
+    int length = snprintf(out, size,
+        "%s{\"name\":\"%s\",\"count\":%lu,\"minUs\":%lu,\"avgUs\":%lu,\"maxUs\":%lu,\"buckets\":[",
+        zone == 0 ? "" : ",", ZONE_NAMES[zone], (unsigned long)stats.count,
+        (unsigned long)(stats.count ? stats.minCycles / perMicro : 0),
+        (unsigned long)(stats.count ? stats.totalCycles / stats.count / perMicro : 0),
+        (unsigned long)(stats.maxCycles / perMicro));
+
+    // Trailing empty buckets are left off
+    int last = PROFILER_BUCKETS - 1;
+    while (last >= 0 && stats.buckets[last] == 0) last--;
+    for (int i = 0; i <= last && length < (int)size; i++) {
+        length += snprintf(out + length, size - length, "%s%lu", i == 0 ? "" : ",",
+                           (unsigned long)stats.buckets[i]);
+    }
+    if (length < (int)size) {
+        length += snprintf(out + length, size - length, "]}");
+    }
+    return min((size_t)length, size - 1);
+}
+
+size_t Profiler::renderJson(Snapshot& snapshot, size_t index, uint8_t* buffer, size_t maxLen) {
+    char piece[PROFILER_BUCKETS * 11 + 160];
+
+    // Item 0 is the header, item PROFILE_ZONE_COUNT + 1 the closing brackets
+    return Utils::fillChunk(snapshot.cursor, PROFILE_ZONE_COUNT + 2, index, buffer, maxLen, piece, sizeof(piece),
+        [&snapshot](int item, int part, char* out, size_t size) -> size_t {
+            if (part > 0) return 0;
+            if (item == 0) {
+                int length = snprintf(out, size, "{\"cpuMHz\":%lu,\"migrated\":%lu,\"zones\":[",
+                                      (unsigned long)snapshot.cyclesPerMicro, (unsigned long)snapshot.migrated);
+                return min((size_t)max(length, 0), size - 1);
+            }
+            if (item == PROFILE_ZONE_COUNT + 1) {
+                return snprintf(out, size, "]}");
+            }
+            return renderZone(snapshot, item - 1, out, size);
+        });
+}
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+#include <functional>
+#include "config.h"
+#include "trace.h"
+#include "utils.h"
+
+class AsyncWebServerRequest;
+
+enum ProfileZone {
+    PROFILE_SENSORS,            // readAllSensors()
+    PROFILE_MODBUS,             // One Modbus request/response
+    PROFILE_JSON,               // getJSONPayload()
+    PROFILE_POST,               // sendDataToServer()
+    PROFILE_SCREEN_SENSORS,
+    PROFILE_SCREEN_DETAIL,
+    PROFILE_SCREEN_MENU,
+    PROFILE_SCREEN_WIFI,
+    PROFILE_SCREEN_CALIBRATION,
+    PROFILE_SCREEN_TIME,
+    PROFILE_SCREEN_SYSTEM,
+    PROFILE_SCREEN_MESSAGE,
+    PROFILE_SCREEN_SCANNING,
+    PROFILE_SCREEN_TREND,
+    PROFILE_FLUSH,              // Frame buffer to the display
+    PROFILE_PUBLISH,            // Dashboard fan-out of one reading
+    PROFILE_ZONE_COUNT
+};
+
+const char* getProfileZoneName(ProfileZone zone);
+
+#if PROFILER_ENABLED
+
+struct ProfileStats {
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+    uint32_t buckets[PROFILER_BUCKETS];    // Bucket i: 2^i to 2^(i+1)-1 cycles
+};
+
+// Per-zone cycle statistics in static storage. Durations come from the
+// CPU cycle counter, so a zone must finish within one counter wrap
+// (~17 s at 240 MHz) and on the core it started on; runs that moved to
+// the other core are counted and discarded.
+class Profiler {
+private:
+    ProfileStats zones[PROFILE_ZONE_COUNT];
+    uint32_t migrated;
+    uint32_t cyclesPerMicro;
+    portMUX_TYPE lock;
+
+    struct Snapshot {
+        ProfileStats zones[PROFILE_ZONE_COUNT];
+        uint32_t migrated;
+        uint32_t cyclesPerMicro;
+        ChunkCursor cursor;
+    };
+
+    void handleProfile(AsyncWebServerRequest* request);
+    static size_t renderZone(const Snapshot& snapshot, int zone, char* out, size_t size);
+    static size_t renderJson(Snapshot& snapshot, size_t index, uint8_t* buffer, size_t maxLen);
+    static uint32_t percentile(const ProfileStats& stats, uint32_t permille);
+
+public:
+    Profiler();
+    void begin();
+    void record(ProfileZone zone, uint32_t cycles);
+    void recordMigrated();
+    void reset();
+    void report();              // One log line per zone that ran
+
+    // /profile JSON of a snapshot taken now, filled in pieces
+    std::function<size_t(uint8_t*, size_t, size_t)> jsonFiller();
+};
+
+extern Profiler profiler;
+
+// Times the enclosing block into a zone
+class ProfileScope {
+private:
+    ProfileZone zone;
+    uint32_t start;
+    BaseType_t core;
+
+public:
+    explicit ProfileScope(ProfileZone zone) :
+        zone(zone),
+        start(ESP.getCycleCount()),
+        core(xPortGetCoreID()) {}
+
+    ~ProfileScope() {
+        uint32_t cycles = ESP.getCycleCount() - start;
+        if (xPortGetCoreID() == core) {
+            profiler.record(zone, cycles);
+        } else {
+            profiler.recordMigrated();
+        }
+    }
+};
+
+#define PROFILE_TIMER(zone) ProfileScope profileScope(zone)
+
+#else
+
+#define PROFILE_TIMER(zone)
+
+#endif
+
+// Zones feed the profiler and the trace, whichever are built in
+#define PROFILE_SCOPE(zone) PROFILE_TIMER(zone); TRACE_SCOPE(zone)
+
+#endif
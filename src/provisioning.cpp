@@ -0,0 +1,97 @@
+#include "provisioning.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+static bool isHexKey(const char* password, size_t length) {
+    if (length != PROVISIONING_MAX_PASSWORD) return false;
+    for (size_t i = 0; i < length; i++) {
+        if (!isxdigit((unsigned char)password[i])) return false;
+    }
+    return true;
+}
+
+ProvisioningResult Provisioning::parseForm(const char* ssid, const char* password,
+                                           const char* serverUrl, ProvisioningForm& out) {
+    if (!ssid) ssid = "";
+    if (!password) password = "";
+    if (!serverUrl) serverUrl = "";
+    memset(&out, 0, sizeof(out));
+
+    size_t ssidLength = strlen(ssid);
+    if (ssidLength == 0) return PROVISION_MISSING_SSID;
+    if (ssidLength > PROVISIONING_MAX_SSID) return PROVISION_SSID_TOO_LONG;
+
+    // Empty is an open network
+    size_t passwordLength = strlen(password);
+    if (passwordLength > 0 && (passwordLength < 8 || passwordLength > PROVISIONING_MAX_PASSWORD ||
+                               (passwordLength == PROVISIONING_MAX_PASSWORD && !isHexKey(password, passwordLength)))) {
+        return PROVISION_BAD_PASSWORD;
+    }
+
+    size_t urlLength = strlen(serverUrl);
+    if (urlLength > PROVISIONING_MAX_URL) return PROVISION_BAD_URL;
+    if (urlLength > 0 && strncmp(serverUrl, "http://", 7) != 0 && strncmp(serverUrl, "https://", 8) != 0) {
+        return PROVISION_BAD_URL;
+    }
+
+    memcpy(out.ssid, ssid, ssidLength);
+    memcpy(out.password, password, passwordLength);
+    memcpy(out.serverUrl, serverUrl, urlLength);
+    return PROVISION_OK;
+}
+
+int Provisioning::httpStatus(ProvisioningResult result) {
+    return result == PROVISION_OK ? 200 : 400;
+}
+
+const char* Provisioning::describe(ProvisioningResult result) {
+    switch (result) {
+        case PROVISION_OK:            return "Saved, connecting...";
+        case PROVISION_MISSING_SSID:  return "Network name is required";
+        case PROVISION_SSID_TOO_LONG: return "Network name is longer than 32 characters";
+        case PROVISION_BAD_PASSWORD:  return "Password must be 8-63 characters, or empty for an open network";
+        case PROVISION_BAD_URL:       return "Server URL must start with http:// or https://";
+    }
+    return "Invalid request";
+}
+
+size_t Provisioning::renderEntry(const ProvisioningNetwork& network, bool first, char* out, size_t size) {
+    // Worst case every SSID byte becomes \u00XX
+    char ssid[PROVISIONING_MAX_SSID * 6 + 1];
+    size_t length = 0;
+    for (const char* c = network.ssid; *c && length + 7 <= sizeof(ssid); c++) {
+        unsigned char ch = *c;
+        if (ch == '"' || ch == '\\') {
+            ssid[length++] = '\\';
+            ssid[length++] = ch;
+        } else if (ch < 0x20) {
+            length += snprintf(ssid + length, sizeof(ssid) - length, "\\u%04x", ch);
+        } else {
+            ssid[length++] = ch;
+        }
+    }
+    ssid[length] = '\0';
+
+    int written = snprintf(out, size, "%s{\"ssid\":\"%s\",\"rssi\":%d,\"secure\":%s,\"known\":%s}",
+                           first ? "" : ",", ssid, network.rssi,
+                           network.secure ? "true" : "false", network.known ? "true" : "false");
+    return written < 0 ? 0 : ((size_t)written < size ? written : size - 1);
+}
+
+size_t Provisioning::renderScanJson(const ProvisioningNetwork* networks, int count, ChunkCursor& cursor,
+                                    size_t index, uint8_t* buffer, size_t maxLen) {
+    char piece[PROVISIONING_MAX_SSID * 6 + 64];
+
+    // Item 0 is the opening bracket, item count + 1 the closing one
+    return Utils::fillChunk(cursor, count + 2, index, buffer, maxLen, piece, sizeof(piece),
+        [networks, count](int item, int part, char* out, size_t size) -> size_t {
+            if (part > 0) return 0;
+            if (item == 0 || item == count + 1) {
+                out[0] = item == 0 ? '[' : ']';
+                return 1;
+            }
+            return renderEntry(networks[item - 1], item == 1, out, size);
+        });
+}
@@ -0,0 +1,60 @@
+#ifndef PROVISIONING_H
+#define PROVISIONING_H
+
+// Request handling for the setup portal. No Arduino or web server types in
+// here, so the handlers can be fed canned form fields and scan lists in the
+// native tests (test/test_portal).
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct ChunkCursor;
+
+#define PROVISIONING_MAX_SSID 32
+#define PROVISIONING_MAX_PASSWORD 64
+#define PROVISIONING_MAX_URL 128
+
+struct ProvisioningForm {
+    char ssid[PROVISIONING_MAX_SSID + 1];
+    char password[PROVISIONING_MAX_PASSWORD + 1];
+    char serverUrl[PROVISIONING_MAX_URL + 1];  // Empty: keep the current one
+};
+
+// One row of the portal's network list
+struct ProvisioningNetwork {
+    char ssid[PROVISIONING_MAX_SSID + 1];
+    int8_t rssi;
+    bool secure;
+    bool known;                 // Credentials already stored
+};
+
+enum ProvisioningResult {
+    PROVISION_OK,
+    PROVISION_MISSING_SSID,
+    PROVISION_SSID_TOO_LONG,
+    PROVISION_BAD_PASSWORD,     // WPA wants 8..63 characters or a 64 digit key
+    PROVISION_BAD_URL
+};
+
+class Provisioning {
+public:
+    // Checks the submitted fields and copies them into out; nullptr is
+    // treated as an empty field
+    static ProvisioningResult parseForm(const char* ssid, const char* password,
+                                        const char* serverUrl, ProvisioningForm& out);
+    static int httpStatus(ProvisioningResult result);
+    static const char* describe(ProvisioningResult result);
+
+    // Copies bytes [index, index + maxLen) of the network list as a JSON
+    // array into buffer and returns the count, 0 at the end. Entries are
+    // rendered on the fly, so a chunked response needs no buffer for the
+    // whole document; cursor belongs to the response and picks up where
+    // its previous chunk stopped.
+    static size_t renderScanJson(const ProvisioningNetwork* networks, int count, ChunkCursor& cursor,
+                                 size_t index, uint8_t* buffer, size_t maxLen);
+
+private:
+    static size_t renderEntry(const ProvisioningNetwork& network, bool first, char* out, size_t size);
+};
+
+#endif
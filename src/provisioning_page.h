@@ -0,0 +1,81 @@
+#ifndef PROVISIONING_PAGE_H
+#define PROVISIONING_PAGE_H
+
+#include <Arduino.h>
+
+// web/provision.html, gzip -9 (2033 bytes uncompressed). Regenerate after
+// editing the page: gzip -9nc web/provision.html | xxd -i
+static const uint8_t PROVISIONING_PAGE_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x7d, 0x55, 0x6b, 0x6f, 0xdb, 0x36,
+    0x14, 0xfd, 0xae, 0x5f, 0xc1, 0x29, 0x58, 0x29, 0xc1, 0xb6, 0x6c, 0x27, 0x59, 0x9a, 0xe9, 0xe1,
+    0x00, 0x6d, 0x3a, 0x6c, 0x40, 0xd7, 0x06, 0x4d, 0x86, 0x6d, 0x28, 0xfa, 0x81, 0x16, 0xaf, 0x2c,
+    0x2e, 0x12, 0xa9, 0x92, 0x94, 0x13, 0xcf, 0xf5, 0x7f, 0xdf, 0xa5, 0x24, 0x3b, 0xee, 0x6b, 0x30,
+    0x60, 0x91, 0x57, 0x97, 0xe7, 0x3e, 0xce, 0xb9, 0x54, 0xfa, 0xc3, 0xf5, 0xdb, 0x97, 0x77, 0x7f,
+    0xdf, 0xbc, 0x22, 0xa5, 0xad, 0xab, 0x85, 0x97, 0x76, 0x8f, 0xb4, 0x04, 0xc6, 0x17, 0x69, 0x0d,
+    0x96, 0x91, 0xbc, 0x64, 0xda, 0x80, 0xcd, 0xfc, 0xd6, 0x16, 0x93, 0x4b, 0x7f, 0xb0, 0x4a, 0x56,
+    0x43, 0xe6, 0xaf, 0x05, 0x3c, 0x34, 0x4a, 0x5b, 0x9f, 0xe4, 0x4a, 0x5a, 0x90, 0xe8, 0xf5, 0x20,
+    0xb8, 0x2d, 0x33, 0x0e, 0x6b, 0x91, 0xc3, 0xa4, 0xdb, 0x8c, 0x85, 0x14, 0x56, 0xb0, 0x6a, 0x62,
+    0x72, 0x56, 0x41, 0x36, 0xf7, 0x31, 0x8a, 0x15, 0xb6, 0x82, 0xc5, 0x9f, 0xcc, 0x82, 0x26, 0xb7,
+    0x20, 0x8d, 0x72, 0x0f, 0xdb, 0x36, 0xe9, 0xb4, 0x7f, 0xe3, 0xa5, 0xc6, 0x6e, 0xdc, 0x73, 0xa9,
+    0xf8, 0x66, 0x5b, 0x20, 0xf8, 0xa4, 0x60, 0xb5, 0xa8, 0x36, 0xb1, 0x61, 0xd2, 0x4c, 0x0c, 0x68,
+    0x51, 0x24, 0x35, 0x7b, 0xec, 0x23, 0xc4, 0xa7, 0x17, 0x50, 0xe3, 0x56, 0xaf, 0x84, 0x8c, 0xe7,
+    0x50, 0x13, 0xd6, 0x5a, 0x95, 0x34, 0x8c, 0x73, 0x21, 0x57, 0xf1, 0x8c, 0xa0, 0x29, 0xc9, 0x55,
+    0xa5, 0x74, 0x7c, 0x32, 0x3f, 0x3d, 0xdb, 0x79, 0xe5, 0xbc, 0x87, 0x34, 0xe2, 0x5f, 0x88, 0xe7,
+    0xd1, 0x19, 0xd4, 0xbb, 0x8a, 0x2d, 0xa1, 0xda, 0x72, 0x61, 0x9a, 0x8a, 0x6d, 0xe2, 0x65, 0xa5,
+    0xf2, 0xfb, 0x01, 0x70, 0x62, 0x55, 0x13, 0x47, 0x97, 0xe8, 0xe3, 0x09, 0xd9, 0xb4, 0x76, 0xbc,
+    0x6c, 0xad, 0x55, 0x72, 0xdb, 0x47, 0x9e, 0xcf, 0x66, 0x3f, 0x26, 0x4b, 0xf5, 0xe8, 0xb0, 0x5c,
+    0xb0, 0xa5, 0xd2, 0x1c, 0xf4, 0x04, 0x2d, 0x87, 0xf8, 0xd1, 0x4f, 0x18, 0xfe, 0x28, 0x9e, 0x43,
+    0x1a, 0x30, 0x8e, 0x22, 0xb8, 0x1c, 0x97, 0x2c, 0xbf, 0x5f, 0x69, 0xd5, 0x4a, 0x1e, 0x9f, 0xcc,
+    0xd8, 0xc5, 0x3e, 0xe7, 0xa2, 0x28, 0x92, 0x1e, 0x37, 0x9e, 0x0d, 0x8b, 0x89, 0x66, 0x5c, 0xb4,
+    0x26, 0x3e, 0x6f, 0x1e, 0x77, 0xde, 0x89, 0x04, 0x6b, 0x08, 0x17, 0xeb, 0xed, 0x21, 0xe4, 0xb9,
+    0x43, 0xdb, 0xa7, 0x82, 0xa1, 0xea, 0x78, 0xde, 0x3c, 0x12, 0xa3, 0x2a, 0xc1, 0xc9, 0x09, 0xe7,
+    0x3c, 0xc9, 0x5b, 0x8d, 0x4d, 0x8f, 0x1b, 0x25, 0x90, 0x37, 0xbd, 0xc7, 0x30, 0x0d, 0x93, 0xdb,
+    0xa2, 0x52, 0xcc, 0xc6, 0x5a, 0xac, 0x4a, 0xbb, 0xcf, 0xe0, 0xe2, 0xf9, 0xe5, 0xee, 0xa4, 0x36,
+    0xab, 0x2f, 0x12, 0xde, 0x79, 0xe9, 0xb4, 0xe7, 0x29, 0x9d, 0xf6, 0x8a, 0x71, 0x74, 0x39, 0x11,
+    0xcd, 0xbf, 0xc9, 0x2d, 0x9a, 0xbd, 0x14, 0xf3, 0x24, 0x82, 0x67, 0xbe, 0x0b, 0xe8, 0x2f, 0x6e,
+    0x73, 0x26, 0x25, 0xa6, 0x1c, 0x45, 0x51, 0x3a, 0xc5, 0x57, 0xe8, 0xd0, 0xf7, 0x86, 0xd8, 0x4d,
+    0x83, 0x0a, 0xeb, 0x37, 0x3e, 0x51, 0x32, 0xaf, 0x44, 0x7e, 0x9f, 0xf9, 0x28, 0x22, 0x19, 0xcc,
+    0x43, 0x7f, 0xf1, 0x0e, 0xdc, 0x32, 0x9d, 0xf6, 0x1e, 0x78, 0xae, 0x50, 0xba, 0xee, 0x90, 0x0b,
+    0x9f, 0xa0, 0x46, 0x4b, 0x85, 0xcb, 0x46, 0x19, 0x14, 0x27, 0xcb, 0xad, 0x50, 0x32, 0xf3, 0xa7,
+    0x86, 0xad, 0xc1, 0xc9, 0xaf, 0x63, 0x7b, 0xf1, 0x06, 0xec, 0x83, 0xd2, 0xf7, 0x24, 0xed, 0x78,
+    0x1d, 0x24, 0x6d, 0x8c, 0xe0, 0x7e, 0x07, 0xd3, 0xaf, 0x50, 0x64, 0x15, 0xc8, 0x15, 0x6a, 0xda,
+    0x3f, 0x3b, 0xf5, 0x89, 0x86, 0x8f, 0xad, 0xd0, 0x80, 0xa5, 0x4e, 0x7b, 0x90, 0x3d, 0xd8, 0x0d,
+    0x33, 0x06, 0xd1, 0xf8, 0xe7, 0x68, 0xcd, 0x60, 0xf5, 0x87, 0x72, 0x9e, 0xf6, 0x47, 0xb8, 0x17,
+    0xe7, 0xfe, 0x57, 0x70, 0xb7, 0xa0, 0xd7, 0xd8, 0xbf, 0x3f, 0xde, 0xbd, 0xfe, 0x22, 0xbd, 0xce,
+    0xee, 0x13, 0x94, 0x69, 0x0e, 0xa5, 0xaa, 0x90, 0xe1, 0xcc, 0xbf, 0x07, 0x68, 0x08, 0x32, 0xaa,
+    0x71, 0x02, 0x3f, 0x43, 0x9e, 0x9f, 0x5e, 0x1e, 0x43, 0x0f, 0xad, 0xba, 0xc5, 0x2e, 0x10, 0x26,
+    0xb9, 0x1b, 0x5a, 0x09, 0xb9, 0x3d, 0xea, 0xe1, 0xd4, 0x35, 0xf1, 0x88, 0x24, 0xe4, 0xdc, 0x01,
+    0xf4, 0xc4, 0x98, 0x5c, 0x8b, 0xc6, 0x2e, 0xbc, 0x35, 0xd3, 0xc4, 0x6a, 0x01, 0x26, 0x9b, 0x8d,
+    0x1d, 0x8b, 0xd9, 0xfb, 0x0f, 0x89, 0x57, 0xb4, 0xb2, 0xeb, 0x32, 0x41, 0x5a, 0x02, 0x13, 0x6e,
+    0x9d, 0x13, 0xcf, 0xb8, 0xca, 0xdb, 0x1a, 0xb3, 0x8a, 0x72, 0x0d, 0x28, 0x88, 0x57, 0x15, 0xb8,
+    0x5d, 0x40, 0x11, 0x90, 0x86, 0x09, 0x8f, 0x2c, 0x3c, 0xda, 0x97, 0xc3, 0xd5, 0x61, 0x12, 0x8d,
+    0x32, 0xd1, 0x92, 0xf0, 0x48, 0x60, 0x5e, 0xfa, 0xd7, 0xbb, 0xdf, 0x5f, 0xef, 0x9e, 0x70, 0x3b,
+    0xe2, 0x35, 0x14, 0x1a, 0x4c, 0x19, 0x6e, 0xbd, 0x02, 0x6c, 0x5e, 0x06, 0x74, 0xea, 0xcc, 0x74,
+    0xb4, 0x7f, 0x71, 0x45, 0xaf, 0x86, 0x55, 0x36, 0xa7, 0x31, 0xa5, 0x61, 0x18, 0xd9, 0x12, 0x64,
+    0xb0, 0x47, 0x09, 0x34, 0x1e, 0x75, 0xa9, 0x2d, 0x5b, 0xb3, 0xc9, 0x74, 0xe4, 0x54, 0x0b, 0xda,
+    0x44, 0x2b, 0xc0, 0xa4, 0xfe, 0x9a, 0xec, 0xd5, 0x48, 0xc3, 0x2c, 0xa3, 0x73, 0x9a, 0x78, 0x43,
+    0x46, 0x3a, 0xfa, 0xc7, 0xe0, 0xe1, 0x2f, 0xc1, 0x2a, 0x61, 0xec, 0x80, 0x57, 0x66, 0x94, 0x26,
+    0x5d, 0x33, 0x9c, 0x31, 0x71, 0x7f, 0x11, 0xf6, 0xf2, 0x15, 0xc3, 0x24, 0x0f, 0xfe, 0x72, 0x2c,
+    0xd0, 0xbd, 0x1c, 0x65, 0xb4, 0x6b, 0xf0, 0x41, 0xd3, 0x0d, 0xfe, 0x07, 0x74, 0x24, 0x46, 0x14,
+    0x75, 0x8d, 0xc5, 0xc8, 0xe8, 0x5e, 0xaa, 0x07, 0x79, 0x45, 0x9f, 0x9d, 0xfc, 0xfc, 0xfc, 0xec,
+    0x2c, 0x21, 0x5d, 0x29, 0x23, 0xd7, 0x59, 0x19, 0x39, 0x59, 0x86, 0x23, 0x8f, 0xa6, 0x6e, 0x58,
+    0x7b, 0x6f, 0x03, 0x48, 0x3e, 0x38, 0x77, 0x24, 0xfc, 0xf4, 0xf9, 0xf9, 0xfe, 0x80, 0x8c, 0x34,
+    0x7a, 0x8f, 0x28, 0xe1, 0x2f, 0x6a, 0x9c, 0x54, 0xe7, 0xdf, 0x73, 0x49, 0x77, 0x61, 0xe2, 0x1d,
+    0xb8, 0xc1, 0xe2, 0x07, 0x62, 0x5e, 0x6c, 0x7e, 0xe3, 0x01, 0x75, 0x65, 0xd0, 0xf0, 0x89, 0x84,
+    0xac, 0xfc, 0xf4, 0x29, 0x70, 0x0d, 0xbb, 0xa2, 0x47, 0xe3, 0x8a, 0x21, 0xde, 0x28, 0x22, 0xfb,
+    0x19, 0x32, 0xa4, 0x70, 0xd7, 0x16, 0x72, 0xea, 0x89, 0xa2, 0xf3, 0x7d, 0xf6, 0xac, 0x93, 0xc8,
+    0x68, 0x94, 0x9e, 0xce, 0x42, 0xfc, 0x7e, 0xdc, 0x89, 0x1a, 0x54, 0x6b, 0x03, 0xc7, 0xd7, 0x18,
+    0x6f, 0xcd, 0x59, 0x98, 0x40, 0x65, 0x60, 0x2f, 0xa4, 0xc4, 0xdb, 0x85, 0xf8, 0x7b, 0xa2, 0xbb,
+    0xeb, 0x09, 0xb6, 0xeb, 0xbb, 0x59, 0xba, 0x3e, 0x60, 0x96, 0x6b, 0x56, 0xb5, 0x90, 0xb9, 0x94,
+    0xdf, 0x8b, 0x0f, 0x5d, 0x73, 0x76, 0xdf, 0xaf, 0xac, 0xc0, 0x03, 0x4a, 0x9a, 0x76, 0x59, 0x0b,
+    0x9b, 0x1d, 0x68, 0x81, 0x35, 0xb2, 0x02, 0xeb, 0xa8, 0xd1, 0xb0, 0x46, 0xd7, 0x6b, 0x28, 0x58,
+    0x5b, 0xd9, 0x00, 0x6b, 0x39, 0x88, 0x0c, 0x27, 0x86, 0x8e, 0xb7, 0xfd, 0xad, 0x12, 0xd3, 0x9b,
+    0xb7, 0xb7, 0x77, 0x74, 0xec, 0xee, 0xba, 0x58, 0xc2, 0x83, 0x1b, 0xd2, 0x5b, 0x60, 0x3a, 0x2f,
+    0x6f, 0x98, 0x66, 0xb5, 0x09, 0x9c, 0xed, 0x17, 0x9c, 0xa3, 0x6b, 0x66, 0x59, 0x60, 0x4b, 0x61,
+    0x42, 0x2c, 0xed, 0x1b, 0x3a, 0x3c, 0x88, 0xcb, 0x4d, 0xc1, 0x57, 0xe2, 0xb2, 0xff, 0x53, 0x3b,
+    0x8e, 0x25, 0x56, 0x72, 0x3c, 0x3c, 0xb6, 0x6b, 0x5f, 0xe2, 0x75, 0x53, 0x82, 0xbd, 0x75, 0x37,
+    0x73, 0x3f, 0xae, 0x38, 0xdd, 0xee, 0x52, 0xc6, 0xdb, 0xb7, 0xfb, 0xc0, 0xff, 0x07, 0xe1, 0x2c,
+    0x5d, 0xbc, 0xf1, 0x07, 0x00, 0x00
+};
+
+#endif
@@ -0,0 +1,227 @@
+#include "scheduler.h"
+#include "utils.h"
+#include "trace.h"
+
+Scheduler scheduler;
+
+static uint32_t millisClock() {
+    return millis();
+}
+
+Scheduler::Scheduler() :
+    lastTick(0),
+    clock(millisClock),
+    task(nullptr),
+    windowStart(0),
+    windowIdle(0) {
+
+    memset(jobs, 0, sizeof(jobs));
+    memset(&stats, 0, sizeof(stats));
+    for (int i = 0; i < SCHEDULER_WHEEL_SLOTS; i++) {
+        wheel[i] = JOB_NONE;
+    }
+}
+
+void Scheduler::begin() {
+    // Only the task that runs loop() sleeps in idle()
+    task = xTaskGetCurrentTaskHandle();
+    lastTick = now();
+    windowStart = micros();
+}
+
+JobId Scheduler::allocate(JobCallback callback, void* context, const char* name, uint32_t period) {
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        if (!jobs[i].allocated) {
+            jobs[i] = {callback, context, name, 0, period, JOB_NONE, JOB_NONE, true, false};
+            return i;
+        }
+    }
+
+    LOG_E("Scheduler job table full, dropping %s", name);
+    return JOB_NONE;
+}
+
+JobId Scheduler::every(uint32_t period, JobCallback callback, void* context, const char* name) {
+    JobId id = allocate(callback, context, name, max(period, (uint32_t)1));
+    if (id != JOB_NONE) {
+        start(id, period);
+    }
+    return id;
+}
+
+JobId Scheduler::once(JobCallback callback, void* context, const char* name) {
+    return allocate(callback, context, name, 0);
+}
+
+void Scheduler::start(JobId id, uint32_t delay) {
+    if (id == JOB_NONE) return;
+
+    if (jobs[id].armed) {
+        unlink(id);
+    }
+    jobs[id].deadline = now() + delay;
+    link(id);
+}
+
+void Scheduler::cancel(JobId id) {
+    if (id != JOB_NONE && jobs[id].armed) {
+        unlink(id);
+    }
+}
+
+bool Scheduler::isArmed(JobId id) {
+    return id != JOB_NONE && jobs[id].armed;
+}
+
+void Scheduler::link(JobId id) {
+    Job& job = jobs[id];
+    int8_t& head = wheel[job.deadline % SCHEDULER_WHEEL_SLOTS];
+
+    job.prev = JOB_NONE;
+    job.next = head;
+    if (head != JOB_NONE) {
+        jobs[head].prev = id;
+    }
+    head = id;
+    job.armed = true;
+}
+
+void Scheduler::unlink(JobId id) {
+    Job& job = jobs[id];
+
+    if (job.prev != JOB_NONE) {
+        jobs[job.prev].next = job.next;
+    } else {
+        wheel[job.deadline % SCHEDULER_WHEEL_SLOTS] = job.next;
+    }
+    if (job.next != JOB_NONE) {
+        jobs[job.next].prev = job.prev;
+    }
+    job.prev = JOB_NONE;
+    job.next = JOB_NONE;
+    job.armed = false;
+}
+
+bool Scheduler::fireDue(uint32_t slot, uint32_t now) {
+    // A slot also holds jobs for later turns of the wheel; skip those
+    JobId id = wheel[slot];
+    while (id != JOB_NONE && (int32_t)(now - jobs[id].deadline) < 0) {
+        id = jobs[id].next;
+    }
+    if (id == JOB_NONE) return false;
+
+    Job& job = jobs[id];
+    uint32_t late = now - job.deadline;
+    unlink(id);
+
+    // Periodic jobs keep their phase; deadlines missed during a stall are
+    // dropped instead of firing back to back
+    if (job.period > 0) {
+        uint32_t missed = late / job.period;
+        stats.overruns += missed;
+        job.deadline += (missed + 1) * job.period;
+        link(id);
+    }
+
+    stats.fired++;
+    stats.lastJitter = late;
+    if (late > stats.maxJitter) {
+        stats.maxJitter = late;
+    }
+
+    // The callback may re-arm or cancel any job, including this one
+    TRACE_SCOPE(TRACE_JOB_BASE + id);
+    job.callback(job.context);
+    return true;
+}
+
+void Scheduler::run() {
+    uint32_t current = now();
+
+    // Expire every tick since the last run, including the current one,
+    // which is scanned again next time for jobs due later in this tick
+    uint32_t ticks = current - lastTick + 1;
+    if (ticks > SCHEDULER_WHEEL_SLOTS) {
+        ticks = SCHEDULER_WHEEL_SLOTS;
+    }
+
+    for (uint32_t tick = current - ticks + 1; tick != current + 1; tick++) {
+        while (fireDue(tick % SCHEDULER_WHEEL_SLOTS, current)) {
+        }
+    }
+    lastTick = current;
+}
+
+void Scheduler::idle(uint32_t maxWait) {
+    uint32_t wait = timeUntilNext(maxWait);
+
+    if (wait > 0) {
+        uint32_t start = micros();
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+        windowIdle += micros() - start;
+    }
+    stats.wakeups++;
+
+    uint32_t elapsed = micros() - windowStart;
+    if (elapsed >= SCHEDULER_STATS_WINDOW_MS * 1000UL) {
+        stats.idlePercent = (uint64_t)windowIdle * 100 / elapsed;
+        windowStart += elapsed;
+        windowIdle = 0;
+    }
+}
+
+void IRAM_ATTR Scheduler::wakeFromISR() {
+    if (scheduler.task == nullptr) return;
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(scheduler.task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+void Scheduler::wake() {
+    if (scheduler.task != nullptr) {
+        xTaskNotifyGive(scheduler.task);
+    }
+}
+
+uint32_t Scheduler::now() {
+    return clock();
+}
+
+uint32_t Scheduler::timeUntilNext(uint32_t limit) {
+    uint32_t current = now();
+    uint32_t wait = limit;
+
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        if (!jobs[i].armed) continue;
+
+        int32_t remaining = (int32_t)(jobs[i].deadline - current);
+        if (remaining <= 0) return 0;
+        if ((uint32_t)remaining < wait) {
+            wait = remaining;
+        }
+    }
+    return wait;
+}
+
+void Scheduler::setClock(SchedulerClock newClock) {
+    // Pending deadlines are kept as absolute times on the new clock
+    clock = newClock ? newClock : millisClock;
+    lastTick = now();
+}
+
+const char* Scheduler::getJobName(JobId id) {
+    return jobs[id].allocated ? jobs[id].name : nullptr;
+}
+
+uint8_t Scheduler::getJobCount() {
+    uint8_t count = 0;
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        if (jobs[i].allocated) count++;
+    }
+    return count;
+}
+
+const SchedulerStats& Scheduler::getStats() {
+    return stats;
+}
@@ -0,0 +1,80 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+typedef void (*JobCallback)(void* context);
+typedef uint32_t (*SchedulerClock)();
+typedef int8_t JobId;
+
+#define JOB_NONE -1
+
+struct SchedulerStats {
+    uint32_t fired;
+    uint32_t overruns;          // Periodic deadlines skipped after a stall
+    uint32_t lastJitter;        // ms between deadline and actual run
+    uint32_t maxJitter;
+    uint32_t wakeups;
+    uint8_t idlePercent;        // Time spent asleep over the last window
+};
+
+// Hashed timer wheel: one slot per millisecond tick, jobs hash to
+// deadline % SCHEDULER_WHEEL_SLOTS and carry their full deadline, so
+// insertion and removal are O(1) and expiry only looks at elapsed slots.
+class Scheduler {
+private:
+    struct Job {
+        JobCallback callback;
+        void* context;
+        const char* name;
+        uint32_t deadline;
+        uint32_t period;        // 0 for one-shot jobs
+        int8_t prev;
+        int8_t next;
+        bool allocated;
+        bool armed;
+    };
+
+    Job jobs[SCHEDULER_MAX_JOBS];
+    int8_t wheel[SCHEDULER_WHEEL_SLOTS];
+    uint32_t lastTick;          // Slots before this tick have been expired
+    SchedulerClock clock;
+    TaskHandle_t task;
+    SchedulerStats stats;
+    uint32_t windowStart;
+    uint32_t windowIdle;
+
+    JobId allocate(JobCallback callback, void* context, const char* name, uint32_t period);
+    void link(JobId id);
+    void unlink(JobId id);
+    bool fireDue(uint32_t slot, uint32_t now);
+
+public:
+    Scheduler();
+    void begin();
+
+    // Jobs are registered once and then armed/disarmed as needed
+    JobId every(uint32_t period, JobCallback callback, void* context = nullptr, const char* name = "");
+    JobId once(JobCallback callback, void* context = nullptr, const char* name = "");
+    void start(JobId id, uint32_t delay);
+    void cancel(JobId id);
+    bool isArmed(JobId id);
+
+    void run();
+    // Sleep until the next deadline, an ISR notification or maxWait
+    void idle(uint32_t maxWait);
+    static void IRAM_ATTR wakeFromISR();
+    static void wake();         // Same, from another task
+
+    uint32_t now();
+    uint32_t timeUntilNext(uint32_t limit);
+    const char* getJobName(JobId id);   // nullptr for a free slot
+    uint8_t getJobCount();              // Registered jobs, armed or not
+    void setClock(SchedulerClock newClock);
+    const SchedulerStats& getStats();
+};
+
+extern Scheduler scheduler;
+
+#endif
@@ -1,5 +1,7 @@
+#define LOG_MODULE LOG_SENSOR
 #include "sensor_manager.h"
 #include "time_manager.h"
+#include "profiler.h"
 #include <ArduinoJson.h>
 
 SensorManager sensorManager;
@@ -7,16 +9,25 @@ SensorManager sensorManager;
 SensorManager::SensorManager() : 
     SerialRS485(1), 
     oneWire(ONE_WIRE_BUS), 
-    ds18b20(&oneWire) {
+    ds18b20(&oneWire),
+    modbusSlaveCount(0) {
     
     // Initialize sensor data structure
     memset(&currentData, 0, sizeof(currentData));
-    currentData.timestamp = "2024-01-01 00:00:00";
+    strlcpy(currentData.timestamp, "2024-01-01 00:00:00", sizeof(currentData.timestamp));
     currentData.lastRead = 0;
+    
+    const uint8_t slaveIDs[] = {PH_SENSOR_ID, DO_SENSOR_ID, EC_SENSOR_ID, NH4_SENSOR_ID};
+    for (uint8_t id : slaveIDs) {
+        if (findSlave(id)) continue;
+        ModbusSlaveMetrics& slave = modbusSlaves[modbusSlaveCount++];
+        slave.slaveID = id;
+        snprintf(slave.labels, sizeof(slave.labels), "slave=\"%u\"", id);
+    }
 }
 
 bool SensorManager::begin() {
-    Utils::info("Initializing Sensor Manager...");
+    LOG_I("Initializing Sensor Manager...");
     
     // Initialize RS485
     SerialRS485.begin(9600, SERIAL_8N1, RS485_RX_PIN, RS485_TX_PIN);
@@ -26,17 +37,20 @@ bool SensorManager::begin() {
     // Initialize DS18B20
     ds18b20.begin();
     
+    addMetrics();
+    
     // Test sensor communication
     bool sensorsOK = discoverSensors();
     
-    Utils::info(sensorsOK ? "✅ Sensors initialized successfully" : "❌ Sensor initialization failed");
+    LOG_I(sensorsOK ? "✅ Sensors initialized successfully" : "❌ Sensor initialization failed");
     return sensorsOK;
 }
 
 bool SensorManager::readAllSensors() {
+    PROFILE_SCOPE(PROFILE_SENSORS);
     bool allSuccess = true;
     
-    Utils::debug("Reading all sensors...");
+    LOG_D("Reading all sensors...");
     
     allSuccess &= readDS18B20();
     allSuccess &= readPHSensor();
@@ -45,13 +59,36 @@ bool SensorManager::readAllSensors() {
     allSuccess &= readNH4_Sensor();
     
     // Update timestamp
-    currentData.timestamp = timeManager.getCurrentTimestamp();
+    timeManager.getCurrentTimestamp(currentData.timestamp);
     currentData.lastRead = millis();
     
-    Utils::debug("Sensor read completed: " + String(allSuccess ? "SUCCESS" : "SOME ERRORS"));
+    LOG_D("Sensor read completed: %s", allSuccess ? "SUCCESS" : "SOME ERRORS");
     return allSuccess;
 }
 
+// Reads a single probe and leaves the others untouched. Only its value in
+// currentData changes: lastRead still dates the last full read, which the
+// display's age and trend cache go by.
+bool SensorManager::readChannel(SensorChannel channel, float& value) {
+    switch (channel) {
+        case SENSOR_PH:
+            if (!readPHSensor()) return false;
+            value = currentData.ph_value;
+            break;
+        case SENSOR_DO:
+            if (!readDOSensor()) return false;
+            value = currentData.do_value;
+            break;
+        case SENSOR_EC:
+            if (!readECSensor()) return false;
+            value = currentData.ec_value;
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
 bool SensorManager::readDS18B20() {
     ds18b20.requestTemperatures();
     float temp = ds18b20.getTempCByIndex(0);
@@ -59,11 +96,11 @@ bool SensorManager::readDS18B20() {
     if (temp != DEVICE_DISCONNECTED_C && temp > -50 && temp < 150) {
         currentData.ds18b20_temp = temp;
         currentData.ds18b20_error = false;
-        Utils::debug("DS18B20: " + String(temp, 2) + "°C");
+        LOG_D("DS18B20: %.2f°C", temp);
         return true;
     } else {
         currentData.ds18b20_error = true;
-        Utils::error("DS18B20 read error");
+        LOG_E("DS18B20 read error");
         return false;
     }
 }
@@ -77,13 +114,13 @@ bool SensorManager::readPHSensor() {
             uint16_t phRaw = (response[3] << 8) | response[4];
             currentData.ph_value = phRaw / 100.0;
             currentData.ph_error = false;
-            Utils::debug("pH: " + String(currentData.ph_value, 2));
+            LOG_D("pH: %.2f", currentData.ph_value);
             return true;
         }
     }
     
     currentData.ph_error = true;
-    Utils::error("pH Sensor read error");
+    LOG_E("pH Sensor read error");
     return false;
 }
 
@@ -96,39 +133,43 @@ bool SensorManager::readDOSensor() {
             uint16_t doRaw = (response[3] << 8) | response[4];
             currentData.do_value = doRaw / 100.0;
             currentData.do_error = false;
-            Utils::debug("DO: " + String(currentData.do_value, 2) + " mg/L");
+            LOG_D("DO: %.2f mg/L", currentData.do_value);
             return true;
         }
     }
     
     currentData.do_error = true;
-    Utils::error("DO Sensor read error");
+    LOG_E("DO Sensor read error");
     return false;
 }
 
-bool SensorManager::readECTDS_Salinity_Sensor() {
+bool SensorManager::readECSensor() {
     uint8_t response[32];
     uint8_t respLen = 0;
-    bool success = true;
     
-    // Read EC value
     if (sendModbusRequest(EC_SENSOR_ID, 0x04, 0x0002, 0x0001, response, &respLen, 500)) {
         if (respLen >= 5 && response[0] == EC_SENSOR_ID && response[1] == 0x04) {
             currentData.ec_value = (response[3] << 8) | response[4];
             currentData.ec_error = false;
-            Utils::debug("EC: " + String(currentData.ec_value) + " uS/cm");
+            LOG_D("EC: %.2f uS/cm", currentData.ec_value);
+            return true;
         }
-    } else {
-        currentData.ec_error = true;
-        success = false;
     }
     
+    currentData.ec_error = true;
+    return false;
+}
+
+bool SensorManager::readECTDS_Salinity_Sensor() {
+    uint8_t response[32];
+    uint8_t respLen = 0;
+    bool success = readECSensor();
+    
     // Read TDS value
-    respLen = 0;
     if (sendModbusRequest(EC_SENSOR_ID, 0x04, 0x0004, 0x0001, response, &respLen, 500)) {
         if (respLen >= 5 && response[0] == EC_SENSOR_ID && response[1] == 0x04) {
             currentData.tds_value = (response[3] << 8) | response[4];
-            Utils::debug("TDS: " + String(currentData.tds_value) + " ppm");
+            LOG_D("TDS: %.2f ppm", currentData.tds_value);
         }
     }
     
@@ -137,12 +178,12 @@ bool SensorManager::readECTDS_Salinity_Sensor() {
     if (sendModbusRequest(EC_SENSOR_ID, 0x04, 0x0003, 0x0001, response, &respLen, 500)) {
         if (respLen >= 5 && response[0] == EC_SENSOR_ID && response[1] == 0x04) {
             currentData.salinitas_value = (response[3] << 8) | response[4];
-            Utils::debug("Salinity: " + String(currentData.salinitas_value) + " mg/L");
+            LOG_D("Salinity: %.2f mg/L", currentData.salinitas_value);
         }
     }
     
     if (!success) {
-        Utils::error("EC/TDS Sensor read error");
+        LOG_E("EC/TDS Sensor read error");
     }
     
     return success;
@@ -157,18 +198,18 @@ bool SensorManager::readNH4_Sensor() {
             uint32_t rawValue = (response[3] << 24) | (response[4] << 16) | (response[5] << 8) | response[6];
             memcpy(&currentData.ammonia_value, &rawValue, sizeof(currentData.ammonia_value));
             currentData.nh4_error = false;
-            Utils::debug("NH4: " + String(currentData.ammonia_value, 4) + " ppm");
+            LOG_D("NH4: %.4f ppm", currentData.ammonia_value);
             return true;
         }
     }
     
     currentData.nh4_error = true;
-    Utils::error("NH4 Sensor read error");
+    LOG_E("NH4 Sensor read error");
     return false;
 }
 
 bool SensorManager::discoverSensors() {
-    Utils::info("Discovering sensors...");
+    LOG_I("Discovering sensors...");
     bool foundAny = false;
     
     int sensorIDs[] = {PH_SENSOR_ID, DO_SENSOR_ID, EC_SENSOR_ID, NH4_SENSOR_ID};
@@ -179,10 +220,10 @@ bool SensorManager::discoverSensors() {
         uint8_t respLen = 0;
         
         if (sendModbusRequest(sensorIDs[i], 0x04, 0x0000, 0x0001, response, &respLen, 300)) {
-            Utils::info("✅ Found " + String(sensorNames[i]) + " sensor at ID: " + String(sensorIDs[i]));
+            LOG_I("✅ Found %s sensor at ID: %d", sensorNames[i], sensorIDs[i]);
             foundAny = true;
         } else {
-            Utils::error("❌ " + String(sensorNames[i]) + " sensor not found at ID: " + String(sensorIDs[i]));
+            LOG_E("❌ %s sensor not found at ID: %d", sensorNames[i], sensorIDs[i]);
         }
         delay(100);
     }
@@ -190,16 +231,57 @@ bool SensorManager::discoverSensors() {
     // Test DS18B20
     ds18b20.requestTemperatures();
     if (ds18b20.getTempCByIndex(0) != DEVICE_DISCONNECTED_C) {
-        Utils::info("✅ Found DS18B20 temperature sensor");
+        LOG_I("✅ Found DS18B20 temperature sensor");
         foundAny = true;
     } else {
-        Utils::error("❌ DS18B20 not found");
+        LOG_E("❌ DS18B20 not found");
     }
     
     return foundAny;
 }
 
-uint16_t SensorManager::calculateCRC(uint8_t *data, uint8_t length) {
+void SensorManager::addMetrics() {
+    // One family at a time keeps each family's series together
+    for (int i = 0; i < modbusSlaveCount; i++) {
+        metrics.addCounter("modbus_requests_total", "Modbus requests sent",
+                           modbusSlaves[i].requests, modbusSlaves[i].labels);
+    }
+    for (int i = 0; i < modbusSlaveCount; i++) {
+        metrics.addCounter("modbus_timeouts_total", "Modbus requests without a complete response",
+                           modbusSlaves[i].timeouts, modbusSlaves[i].labels);
+    }
+    for (int i = 0; i < modbusSlaveCount; i++) {
+        metrics.addCounter("modbus_crc_errors_total", "Modbus responses with a bad CRC",
+                           modbusSlaves[i].crcErrors, modbusSlaves[i].labels);
+    }
+}
+
+bool SensorManager::readRegisters(uint8_t slaveID, uint8_t functionCode, uint16_t startAddr, uint8_t count,
+                                  uint16_t* out) {
+    if (count == 0 || count > MODBUS_MAX_REGISTERS) return false;
+    
+    uint8_t response[32];
+    uint8_t respLen = 0;
+    if (!sendModbusRequest(slaveID, functionCode, startAddr, count, response, &respLen, 500)) {
+        return false;
+    }
+    if (response[0] != slaveID || response[1] != functionCode || response[2] != count * 2) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        out[i] = (response[3 + i * 2] << 8) | response[4 + i * 2];
+    }
+    return true;
+}
+
+ModbusSlaveMetrics* SensorManager::findSlave(uint8_t slaveID) {
+    for (int i = 0; i < modbusSlaveCount; i++) {
+        if (modbusSlaves[i].slaveID == slaveID) return &modbusSlaves[i];
+    }
+    return nullptr;
+}
+
+uint16_t SensorManager::calculateCRC(const uint8_t *data, uint8_t length) {
     uint16_t crc = 0xFFFF;
     for (int i = 0; i < length; i++) {
         crc ^= data[i];
@@ -217,6 +299,10 @@ uint16_t SensorManager::calculateCRC(uint8_t *data, uint8_t length) {
 bool SensorManager::sendModbusRequest(uint8_t slaveID, uint8_t functionCode, uint16_t startAddr, 
                                      uint16_t numRegisters, uint8_t *response, uint8_t *respLen, 
                                      uint32_t timeout) {
+    PROFILE_SCOPE(PROFILE_MODBUS);
+    ModbusSlaveMetrics* slave = findSlave(slaveID);
+    if (slave) slave->requests.inc();
+    
     // Build request
     uint8_t request[8];
     request[0] = slaveID;
@@ -263,10 +349,11 @@ bool SensorManager::sendModbusRequest(uint8_t slaveID, uint8_t functionCode, uin
                 uint16_t calculatedCRC = calculateCRC(response, expectedLength-2);
                 
                 if (receivedCRC == calculatedCRC) {
-                    Utils::debug("Modbus request successful");
+                    LOG_TO(LOG_MODBUS, LOG_LEVEL_DEBUG, "Modbus request successful");
                     return true;
                 } else {
-                    Utils::error("CRC Error in Modbus response");
+                    if (slave) slave->crcErrors.inc();
+                    LOG_TO(LOG_MODBUS, LOG_LEVEL_ERROR, "CRC Error in Modbus response");
                     return false;
                 }
             }
@@ -275,15 +362,17 @@ bool SensorManager::sendModbusRequest(uint8_t slaveID, uint8_t functionCode, uin
     }
     
     *respLen = index;
-    Utils::error("Modbus request timeout");
+    if (slave) slave->timeouts.inc();
+    LOG_TO(LOG_MODBUS, LOG_LEVEL_ERROR, "Modbus request timeout");
     return false;
 }
 
-SensorData SensorManager::getSensorData() {
+const SensorData& SensorManager::getSensorData() {
     return currentData;
 }
 
 String SensorManager::getJSONPayload() {
+    PROFILE_SCOPE(PROFILE_JSON);
     DynamicJsonDocument doc(512);
     doc["uid"] = DEVICE_UID;
     doc["suhu"] = round(currentData.ds18b20_temp * 100.0) / 100.0;
@@ -293,6 +382,9 @@ String SensorManager::getJSONPayload() {
     doc["ammonia"] = round(currentData.ammonia_value * 1000.0) / 1000.0;
     doc["salinitas"] = round(currentData.salinitas_value * 100.0) / 100.0;
     doc["timestamp"] = currentData.timestamp;
+#if METRICS_IN_UPLOAD
+    metrics.addTo(doc.createNestedObject("metrics"));
+#endif
     
     String jsonString;
     serializeJson(doc, jsonString);
@@ -309,7 +401,7 @@ void SensorManager::resetErrors() {
 
 bool SensorManager::calibrateSensor(uint8_t sensorType, float referenceValue) {
     // Implementation for sensor calibration
-    Utils::info("Calibrating sensor type: " + String(sensorType));
+    LOG_I("Calibrating sensor type: %d", sensorType);
     return true;
 }
 
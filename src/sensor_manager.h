@@ -7,6 +7,18 @@
 #include <DallasTemperature.h>
 #include "config.h"
 #include "utils.h"
+#include "time_format.h"
+#include "metrics.h"
+
+#define MODBUS_MAX_SLAVES 4     // One per Modbus probe at most
+#define MODBUS_MAX_REGISTERS 13 // Largest reply that fits the 32-byte response buffer
+
+// Probes that can be read on their own, e.g. the one being calibrated
+enum SensorChannel : uint8_t {
+    SENSOR_PH,
+    SENSOR_DO,
+    SENSOR_EC
+};
 
 struct SensorData {
     float ds18b20_temp;
@@ -16,7 +28,7 @@ struct SensorData {
     float ammonia_value;
     float salinitas_value;
     float ec_value;
-    String timestamp;
+    char timestamp[TIMESTAMP_LENGTH + 1];
     bool ds18b20_error;
     bool ph_error;
     bool do_error;
@@ -25,14 +37,27 @@ struct SensorData {
     unsigned long lastRead;
 };
 
+// Transaction counters for one Modbus address; probes that share an
+// address share the counters
+struct ModbusSlaveMetrics {
+    uint8_t slaveID;
+    char labels[16];            // slave="N"
+    Counter requests;
+    Counter timeouts;
+    Counter crcErrors;
+};
+
 class SensorManager {
 private:
     HardwareSerial SerialRS485;
     OneWire oneWire;
     DallasTemperature ds18b20;
     SensorData currentData;
+    ModbusSlaveMetrics modbusSlaves[MODBUS_MAX_SLAVES];
+    uint8_t modbusSlaveCount;
     
-    uint16_t calculateCRC(uint8_t *data, uint8_t length);
+    ModbusSlaveMetrics* findSlave(uint8_t slaveID);
+    void addMetrics();
     bool sendModbusRequest(uint8_t slaveID, uint8_t functionCode, uint16_t startAddr, 
                           uint16_t numRegisters, uint8_t *response, uint8_t *respLen, 
                           uint32_t timeout = 1000);
@@ -40,6 +65,7 @@ private:
     bool readDS18B20();
     bool readPHSensor();
     bool readDOSensor();
+    bool readECSensor();
     bool readECTDS_Salinity_Sensor();
     bool readNH4_Sensor();
     
@@ -47,9 +73,13 @@ public:
     SensorManager();
     bool begin();
     bool readAllSensors();
-    SensorData getSensorData();
+    bool readChannel(SensorChannel channel, float& value);     // One Modbus transaction
+    const SensorData& getSensorData();
     String getJSONPayload();
     bool discoverSensors();
+    bool readRegisters(uint8_t slaveID, uint8_t functionCode, uint16_t startAddr, uint8_t count,
+                       uint16_t* out);     // Raw holding/input registers, at most MODBUS_MAX_REGISTERS
+    static uint16_t calculateCRC(const uint8_t *data, uint8_t length);     // CRC-16/MODBUS
     void resetErrors();
     bool calibrateSensor(uint8_t sensorType, float referenceValue);
     String getSensorStatus();
@@ -0,0 +1,369 @@
+#include "serial_console.h"
+#include "logger.h"
+#include "sensor_manager.h"
+#include "metrics.h"
+#include "profiler.h"
+#include "config_store.h"
+#include "time_manager.h"
+#include "boot_sequence.h"
+#include "calibration_manager.h"
+#include "menu_system.h"
+
+SerialConsole serialConsole;
+
+#define CONSOLE_READ_BUDGET 64      // Input bytes handled per poll
+
+// Stream frame: sync, type, payload length, payload, CRC-16/MODBUS over
+// type..payload. All fields little-endian.
+#define STREAM_SYNC_0 0xA5
+#define STREAM_SYNC_1 0x5A
+#define STREAM_TYPE_READING 1
+#define STREAM_PAYLOAD_SIZE 33      // u32 millis, 7 floats, u8 error bits
+#define STREAM_FRAME_SIZE (4 + STREAM_PAYLOAD_SIZE + 2)
+
+static_assert(STREAM_FRAME_SIZE <= LOG_TEXT_SIZE, "Stream frame must fit one raw log entry");
+
+const SerialConsole::Command SerialConsole::commands[CONSOLE_COMMAND_COUNT] = {
+    {"help",    "",                             &SerialConsole::cmdHelp},
+    {"read",    "<slave> <fn 3|4> <addr> [n]",  &SerialConsole::cmdRead},
+    {"metrics", "",                             &SerialConsole::cmdMetrics},
+    {"profile", "",                             &SerialConsole::cmdProfile},
+    {"queues",  "",                             &SerialConsole::cmdQueues},
+    {"config",  "[tz <hours> | url <url>]",     &SerialConsole::cmdConfig},
+    {"log",     "[<module> <off|error|info|debug>]", &SerialConsole::cmdLog},
+    {"rescan",  "",                             &SerialConsole::cmdRescan},
+    {"stream",  "<ms> | off",                   &SerialConsole::cmdStream},
+};
+
+// Whole-string number in any base strtol accepts (0x.. for hex)
+static bool parseNumber(const char* text, long& out) {
+    char* end;
+    out = strtol(text, &end, 0);
+    return end != text && *end == '\0';
+}
+
+static void put16(uint8_t* out, uint16_t value) {
+    out[0] = value & 0xFF;
+    out[1] = value >> 8;
+}
+
+static void put32(uint8_t* out, uint32_t value) {
+    put16(out, value & 0xFFFF);
+    put16(out + 2, value >> 16);
+}
+
+static void putFloat(uint8_t* out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put32(out, bits);
+}
+
+SerialConsole::SerialConsole() :
+    lineLength(0),
+    overflow(false),
+    dumpIndex(0),
+    pollJob(JOB_NONE),
+    streamJob(JOB_NONE),
+    streamPeriod(0),
+    streamFrames(0),
+    streamChannel(SENSOR_PH) {
+
+    line[0] = '\0';
+}
+
+void SerialConsole::begin() {
+    pollJob = scheduler.every(CONSOLE_POLL_INTERVAL, [](void* self) {
+        static_cast<SerialConsole*>(self)->poll();
+    }, this, "console");
+
+    // One-shot that re-arms itself, so a slow read pushes the next frame
+    // back instead of queueing overruns
+    streamJob = scheduler.once([](void* self) {
+        static_cast<SerialConsole*>(self)->streamReading();
+    }, this, "stream");
+}
+
+bool SerialConsole::isStreaming() {
+    return streamPeriod != 0;
+}
+
+// ==================== INPUT ====================
+void SerialConsole::poll() {
+    readInput();
+    pumpDump();
+}
+
+void SerialConsole::readInput() {
+    // available() and read() never wait; whatever is left stays in the
+    // UART buffer for the next poll
+    for (int budget = CONSOLE_READ_BUDGET; budget > 0 && Serial.available() > 0; budget--) {
+        int c = Serial.read();
+        if (c < 0) break;
+
+        if (c == '\r' || c == '\n') {
+            if (overflow) {
+                logger.print("Line longer than %d characters ignored", CONSOLE_LINE_LENGTH - 1);
+            } else if (lineLength > 0) {
+                line[lineLength] = '\0';
+                execute(line);
+            }
+            lineLength = 0;
+            overflow = false;
+        } else if (c == '\b' || c == 0x7F) {
+            if (lineLength > 0) lineLength--;
+        } else if (lineLength < CONSOLE_LINE_LENGTH - 1) {
+            line[lineLength++] = (char)c;
+        } else {
+            overflow = true;
+        }
+    }
+}
+
+void SerialConsole::execute(char* text) {
+    char* argv[CONSOLE_MAX_ARGS];
+    int argc = 0;
+    char* state;
+    for (char* token = strtok_r(text, " \t", &state); token && argc < CONSOLE_MAX_ARGS;
+         token = strtok_r(nullptr, " \t", &state)) {
+        argv[argc++] = token;
+    }
+    if (argc == 0) return;
+
+    for (int i = 0; i < CONSOLE_COMMAND_COUNT; i++) {
+        if (strcmp(argv[0], commands[i].name) == 0) {
+            (this->*commands[i].run)(argc, argv);
+            return;
+        }
+    }
+    logger.print("Unknown command, try help");
+}
+
+// ==================== OUTPUT ====================
+bool SerialConsole::startDump(ConsoleFiller filler) {
+    if (dump) {
+        logger.print("Previous dump still running");
+        return false;
+    }
+    dump = filler;
+    dumpIndex = 0;
+    return true;
+}
+
+// Up to half the ring per poll, so log lines keep their room while a
+// long document goes out; a full ring retries the same piece next poll
+void SerialConsole::pumpDump() {
+    uint8_t piece[LOG_TEXT_SIZE];
+    while (dump && logger.getPending() < LOG_RING_SIZE / 2) {
+        size_t length = dump(piece, sizeof(piece), dumpIndex);
+        if (length == 0) {
+            dump = nullptr;     // Releases the snapshot
+            logger.print("");
+            break;
+        }
+        if (!logger.writeRaw(piece, length)) break;
+        dumpIndex += length;
+    }
+}
+
+// Text longer than an entry's string space goes out as raw pieces
+void SerialConsole::printLong(const char* label, const char* text) {
+    logger.writeRaw((const uint8_t*)label, strlen(label));
+    size_t length = strlen(text);
+    for (size_t offset = 0; offset < length; offset += LOG_TEXT_SIZE) {
+        size_t piece = length - offset < LOG_TEXT_SIZE ? length - offset : LOG_TEXT_SIZE;
+        logger.writeRaw((const uint8_t*)text + offset, piece);
+    }
+    logger.print("");
+}
+
+// Same rule as the sensor job: the bus belongs to a calibration while one
+// runs, and to nobody before the sensor boot stage
+bool SerialConsole::sensorsAvailable() {
+    if (!bootSequence.isDone(BOOT_SENSORS)) {
+        logger.print("Sensors not started yet");
+        return false;
+    }
+    if (calibrationManager.isCalibrating() ||
+        menuSystem.getCurrentState() == MENU_CALIBRATION_PROGRESS) {
+        logger.print("Calibration in progress");
+        return false;
+    }
+    return true;
+}
+
+// ==================== COMMANDS ====================
+void SerialConsole::cmdHelp(int, char**) {
+    for (int i = 0; i < CONSOLE_COMMAND_COUNT; i++) {
+        logger.print("  %s %s", commands[i].name, commands[i].usage);
+    }
+}
+
+void SerialConsole::cmdRead(int argc, char** argv) {
+    long slave, function, address, count = 1;
+    if (argc < 4 || !parseNumber(argv[1], slave) || !parseNumber(argv[2], function) ||
+        !parseNumber(argv[3], address) || (argc > 4 && !parseNumber(argv[4], count))) {
+        logger.print("Usage: read <slave> <fn 3|4> <addr> [n]");
+        return;
+    }
+    if (slave < 1 || slave > 247 || (function != 3 && function != 4) ||
+        address < 0 || address > 0xFFFF || count < 1 || count > MODBUS_MAX_REGISTERS) {
+        logger.print("Slave 1-247, function 3 or 4, at most %d registers", MODBUS_MAX_REGISTERS);
+        return;
+    }
+    if (!sensorsAvailable()) return;
+
+    uint16_t values[MODBUS_MAX_REGISTERS];
+    if (!sensorManager.readRegisters(slave, function, address, count, values)) {
+        logger.print("No valid reply from slave %d", (int)slave);
+        return;
+    }
+    for (long i = 0; i < count; i++) {
+        logger.print("  %u: 0x%04X %u", (unsigned)(address + i), values[i], values[i]);
+    }
+}
+
+void SerialConsole::cmdMetrics(int, char**) {
+    startDump(metrics.textFiller());
+}
+
+void SerialConsole::cmdProfile(int, char**) {
+#if PROFILER_ENABLED
+    startDump(profiler.jsonFiller());
+#else
+    logger.print("Profiler not built in (PROFILER_ENABLED)");
+#endif
+}
+
+// The log ring, the console's own dump and the config store's pending
+// NVS commit, which is the only deferred flash write in the firmware
+void SerialConsole::cmdQueues(int, char**) {
+    const LoggerStats& log = logger.getStats();
+    logger.print("Log ring: %u/%d pending, high water %u, dropped %u",
+                 logger.getPending(), LOG_RING_SIZE, log.highWater, log.dropped);
+    logger.print("Console dump: %s, %u bytes sent", dump ? "running" : "idle", (uint32_t)dumpIndex);
+
+    const ConfigStats& config = configStore.getStats();
+    logger.print("Flash: commit %s, %u commits, %u fields, %u errors",
+                 configStore.isDirty() ? "pending" : "idle", config.commits, config.fieldWrites,
+                 config.errors);
+}
+
+void SerialConsole::cmdConfig(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "tz") == 0) {
+        long hours;
+        if (!parseNumber(argv[2], hours) || hours < -12 || hours > 14) {
+            logger.print("Timezone is -12 to 14 hours");
+            return;
+        }
+        timeManager.setTimezone(hours);
+    } else if (argc >= 3 && strcmp(argv[1], "url") == 0) {
+        if (strncmp(argv[2], "http://", 7) != 0 && strncmp(argv[2], "https://", 8) != 0) {
+            logger.print("URL must start with http:// or https://");
+            return;
+        }
+        configStore.setServerURL(argv[2]);
+    } else if (argc != 1) {
+        logger.print("Usage: config [tz <hours> | url <url>]");
+        return;
+    }
+
+    logger.print("Timezone: UTC%+d", configStore.getTimezone());
+    printLong("Server URL: ", configStore.getServerURL());
+    const WiFiNetworkList& networks = configStore.getNetworks();
+    for (int i = 0; i < networks.getCount(); i++) {
+        logger.print("Network %d: %s (priority %u)", i, networks.get(i).ssid, networks.get(i).priority);
+    }
+}
+
+void SerialConsole::cmdLog(int argc, char** argv) {
+    if (argc == 3) {
+        int module = -1;
+        int level = -1;
+        for (int i = 0; i < LOG_MODULE_COUNT; i++) {
+            if (strcasecmp(argv[1], Logger::getModuleName((LogModule)i)) == 0) module = i;
+        }
+        for (int i = LOG_LEVEL_OFF; i <= LOG_LEVEL_DEBUG; i++) {
+            if (strcasecmp(argv[2], Logger::getLevelName((LogLevel)i)) == 0) level = i;
+        }
+        if (module < 0 || level < 0) {
+            logger.print("Unknown module or level");
+            return;
+        }
+        logger.setLevel((LogModule)module, (LogLevel)level);
+    } else if (argc != 1) {
+        logger.print("Usage: log [<module> <off|error|info|debug>]");
+        return;
+    }
+
+    for (int i = 0; i < LOG_MODULE_COUNT; i++) {
+        logger.print("  %s: %s", Logger::getModuleName((LogModule)i),
+                     Logger::getLevelName(logger.getLevel((LogModule)i)));
+    }
+}
+
+void SerialConsole::cmdRescan(int, char**) {
+    if (!sensorsAvailable()) return;
+    logger.print(sensorManager.discoverSensors() ? "Rescan: sensors found" : "Rescan: no sensors answered");
+}
+
+void SerialConsole::cmdStream(int argc, char** argv) {
+    long period;
+    if (argc == 2 && strcmp(argv[1], "off") == 0) {
+        scheduler.cancel(streamJob);
+        streamPeriod = 0;
+        logger.print("Stream off after %u frames", streamFrames);
+        return;
+    }
+    if (argc != 2 || !parseNumber(argv[1], period) || period < CONSOLE_STREAM_MIN_MS) {
+        logger.print("Usage: stream <ms, at least %d> | off", CONSOLE_STREAM_MIN_MS);
+        return;
+    }
+    if (!sensorsAvailable()) return;
+
+    streamPeriod = period;
+    streamFrames = 0;
+    logger.print("Streaming %d-byte frames every %u ms, 'stream off' stops", STREAM_FRAME_SIZE, streamPeriod);
+    scheduler.start(streamJob, 0);
+}
+
+// ==================== STREAM ====================
+void SerialConsole::streamReading() {
+    if (!streamPeriod) return;
+
+    // A calibration pauses the stream rather than ending it
+    if (bootSequence.isDone(BOOT_SENSORS) && !calibrationManager.isCalibrating() &&
+        menuSystem.getCurrentState() != MENU_CALIBRATION_PROGRESS) {
+        // One Modbus transaction per tick, taking the probes in turn; the
+        // DS18B20 conversion and the derived values come from the last
+        // full read by the sensors job
+        float value;
+        sensorManager.readChannel((SensorChannel)streamChannel, value);
+        streamChannel = (streamChannel + 1) % (SENSOR_EC + 1);
+        const SensorData& data = sensorManager.getSensorData();
+
+        uint8_t frame[STREAM_FRAME_SIZE];
+        uint8_t* payload = frame + 4;
+        frame[0] = STREAM_SYNC_0;
+        frame[1] = STREAM_SYNC_1;
+        frame[2] = STREAM_TYPE_READING;
+        frame[3] = STREAM_PAYLOAD_SIZE;
+        put32(payload, millis());
+        putFloat(payload + 4, data.ds18b20_temp);
+        putFloat(payload + 8, data.ph_value);
+        putFloat(payload + 12, data.do_value);
+        putFloat(payload + 16, data.ec_value);
+        putFloat(payload + 20, data.tds_value);
+        putFloat(payload + 24, data.salinitas_value);
+        putFloat(payload + 28, data.ammonia_value);
+        payload[32] = (data.ds18b20_error ? 1 << 0 : 0) | (data.ph_error ? 1 << 1 : 0) |
+                      (data.do_error ? 1 << 2 : 0) | (data.ec_error ? 1 << 3 : 0) |
+                      (data.nh4_error ? 1 << 4 : 0);
+        put16(frame + 4 + STREAM_PAYLOAD_SIZE, SensorManager::calculateCRC(frame + 2, 2 + STREAM_PAYLOAD_SIZE));
+
+        if (logger.writeRaw(frame, sizeof(frame))) {
+            streamFrames++;
+        }
+    }
+
+    scheduler.start(streamJob, streamPeriod);
+}
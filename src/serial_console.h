@@ -0,0 +1,71 @@
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include <Arduino.h>
+#include <functional>
+#include "config.h"
+#include "scheduler.h"
+
+#define CONSOLE_MAX_ARGS 6
+#define CONSOLE_COMMAND_COUNT 9
+
+// Fills buffer with up to maxLen bytes of a document from index on; 0 at
+// the end. Same contract as a chunked HTTP response.
+typedef std::function<size_t(uint8_t* buffer, size_t maxLen, size_t index)> ConsoleFiller;
+
+// Line-oriented commands on the USB serial port, for the field. A
+// scheduler job drains whatever input has arrived, so nothing ever waits
+// on the port; all output goes through the logger ring, and long dumps
+// are paced so they never crowd log lines out of it. "help" lists the
+// commands.
+class SerialConsole {
+private:
+    typedef void (SerialConsole::*CommandHandler)(int argc, char** argv);
+
+    struct Command {
+        const char* name;
+        const char* usage;
+        CommandHandler run;
+    };
+
+    static const Command commands[CONSOLE_COMMAND_COUNT];
+
+    char line[CONSOLE_LINE_LENGTH];
+    uint8_t lineLength;
+    bool overflow;              // Current line too long, dropped at its end
+    ConsoleFiller dump;         // Document being written out, if any
+    size_t dumpIndex;
+    JobId pollJob;
+    JobId streamJob;
+    uint32_t streamPeriod;
+    uint32_t streamFrames;
+    uint8_t streamChannel;      // Probe the next stream tick reads
+
+    void poll();
+    void readInput();
+    void pumpDump();
+    void execute(char* text);
+    bool startDump(ConsoleFiller filler);
+    void printLong(const char* label, const char* text);
+    bool sensorsAvailable();
+    void streamReading();
+
+    void cmdHelp(int argc, char** argv);
+    void cmdRead(int argc, char** argv);
+    void cmdMetrics(int argc, char** argv);
+    void cmdProfile(int argc, char** argv);
+    void cmdQueues(int argc, char** argv);
+    void cmdConfig(int argc, char** argv);
+    void cmdLog(int argc, char** argv);
+    void cmdRescan(int argc, char** argv);
+    void cmdStream(int argc, char** argv);
+
+public:
+    SerialConsole();
+    void begin();
+    bool isStreaming();
+};
+
+extern SerialConsole serialConsole;
+
+#endif
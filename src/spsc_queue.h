@@ -0,0 +1,52 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Bounded lock-free queue for exactly one producer and one consumer, e.g.
+// an ISR handing events to the main task. Capacity must be a power of two.
+// push()/pop() are forced inline so ISR callers keep the code in IRAM.
+template <typename T, uint32_t N>
+class SpscQueue {
+private:
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+    T items[N];
+    std::atomic<uint32_t> head;     // Next slot to write (producer only)
+    std::atomic<uint32_t> tail;     // Next slot to read (consumer only)
+    std::atomic<uint32_t> dropped;  // Pushes rejected because the queue was full
+
+public:
+    SpscQueue() : head(0), tail(0), dropped(0) {}
+
+    inline __attribute__((always_inline)) bool push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= N) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        items[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    inline __attribute__((always_inline)) bool pop(T& item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint32_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    uint32_t capacity() const { return N; }
+    uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+#endif
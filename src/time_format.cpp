@@ -0,0 +1,110 @@
+#include "time_format.h"
+
+static const char DAY_NAMES[] = "SunMonTueWedThuFriSat";
+static const char MONTH_NAMES[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+static inline char* put2(char* out, uint8_t value) {
+    out[0] = '0' + value / 10;
+    out[1] = '0' + value % 10;
+    return out + 2;
+}
+
+static inline char* put4(char* out, int32_t value) {
+    out[3] = '0' + value % 10; value /= 10;
+    out[2] = '0' + value % 10; value /= 10;
+    out[1] = '0' + value % 10; value /= 10;
+    out[0] = '0' + value % 10;
+    return out + 4;
+}
+
+static inline char* put3(char* out, const char* names, int index) {
+    out[0] = names[index * 3];
+    out[1] = names[index * 3 + 1];
+    out[2] = names[index * 3 + 2];
+    return out + 3;
+}
+
+void TimeFormat::toCivil(int64_t epochSeconds, CivilTime& out) {
+    int64_t days = epochSeconds / 86400;
+    int32_t seconds = epochSeconds % 86400;
+    if (seconds < 0) {
+        seconds += 86400;
+        days--;
+    }
+    out.hour = seconds / 3600;
+    out.minute = seconds / 60 % 60;
+    out.second = seconds % 60;
+    out.weekday = (days % 7 + 11) % 7;          // 1970-01-01 was a Thursday
+
+    // Days to civil date, eras of 400 years starting on 0000-03-01
+    // (H. Hinnant, "chrono-compatible low-level date algorithms")
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    uint32_t dayOfEra = days - era * 146097;
+    uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    uint32_t shiftedMonth = (5 * dayOfYear + 2) / 153;                    // 0 = March
+    out.day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    out.month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    out.year = yearOfEra + era * 400 + (out.month <= 2);
+}
+
+void TimeFormat::iso(int64_t epochSeconds, char* out) {
+    CivilTime t;
+    toCivil(epochSeconds, t);
+
+    char* p = put4(out, t.year);
+    *p++ = '-';
+    p = put2(p, t.month);
+    *p++ = '-';
+    p = put2(p, t.day);
+    *p++ = ' ';
+    p = put2(p, t.hour);
+    *p++ = ':';
+    p = put2(p, t.minute);
+    *p++ = ':';
+    p = put2(p, t.second);
+    *p = '\0';
+}
+
+void TimeFormat::longForm(int64_t epochSeconds, char* out) {
+    CivilTime t;
+    toCivil(epochSeconds, t);
+
+    char* p = put3(out, DAY_NAMES, t.weekday);
+    *p++ = ' ';
+    p = put3(p, MONTH_NAMES, t.month - 1);
+    *p++ = ' ';
+    p = put2(p, t.day);
+    *p++ = ' ';
+    p = put2(p, t.hour);
+    *p++ = ':';
+    p = put2(p, t.minute);
+    *p++ = ':';
+    p = put2(p, t.second);
+    *p++ = ' ';
+    p = put4(p, t.year);
+    *p = '\0';
+}
+
+void TimeFormat::uptime(uint32_t seconds, char* out) {
+    uint32_t days = seconds / 86400;
+    char digits[5];
+    int count = 0;
+    do {
+        digits[count++] = '0' + days % 10;
+        days /= 10;
+    } while (days);
+
+    char* p = out;
+    while (count) *p++ = digits[--count];
+    *p++ = 'd';
+    *p++ = ' ';
+    seconds %= 86400;
+    p = put2(p, seconds / 3600);
+    *p++ = ':';
+    p = put2(p, seconds / 60 % 60);
+    *p++ = ':';
+    p = put2(p, seconds % 60);
+    *p = '\0';
+}
@@ -0,0 +1,36 @@
+#ifndef TIME_FORMAT_H
+#define TIME_FORMAT_H
+
+// Integer calendar maths and fixed-width formatting for epoch seconds, in
+// place of gmtime()/strftime(). No Arduino or libc time calls, so it can
+// be checked and benchmarked on the host (test/test_time_format).
+
+#include <stdint.h>
+
+#define TIMESTAMP_LENGTH 19         // "YYYY-MM-DD HH:MM:SS"
+#define LONG_TIME_LENGTH 24         // "Www Mmm DD HH:MM:SS YYYY"
+#define UPTIME_LENGTH 15            // "DDDDDd HH:MM:SS" at most
+
+struct CivilTime {
+    int32_t year;
+    uint8_t month;                  // 1..12
+    uint8_t day;                    // 1..31
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t weekday;                // 0 = Sunday
+};
+
+class TimeFormat {
+public:
+    static void toCivil(int64_t epochSeconds, CivilTime& out);
+
+    // Both write exactly their LENGTH characters plus a terminating NUL
+    static void iso(int64_t epochSeconds, char* out);
+    static void longForm(int64_t epochSeconds, char* out);
+
+    // Day count without padding, so up to UPTIME_LENGTH plus the NUL
+    static void uptime(uint32_t seconds, char* out);
+};
+
+#endif
@@ -1,102 +1,203 @@
+#define LOG_MODULE LOG_TIME
 #include "time_manager.h"
+#include <esp_sntp.h>
+#include <esp_timer.h>
 
 TimeManager timeManager;
 
+#define TIME_BIT_SYNCED (1 << 0)
+
+// A reset can come before the next checkpoint reaches flash
+static_assert(CLOCK_CHECKPOINT_LEAD_MS > CLOCK_CHECKPOINT_INTERVAL + CONFIG_COMMIT_MAX_DELAY,
+              "Checkpoint lead must cover a checkpoint interval and a store commit");
+
+static const ClockTuning CLOCK_TUNING = {
+    CLOCK_SLEW_PPM,
+    CLOCK_STEP_THRESHOLD_MS * 1000LL,
+    CLOCK_MAX_DRIFT_PPM,
+    CLOCK_DRIFT_MIN_SPAN_MS * 1000LL,
+    CLOCK_DRIFT_WINDOW_MS * 1000LL
+};
+
 TimeManager::TimeManager() : 
-    timezone(DEFAULT_TIMEZONE), 
     timeSynced(false),
-    lastSyncAttempt(0) {
+    sntpStarted(false),
+    syncCount(0),
+    clock(CLOCK_TUNING),
+    clockLock(portMUX_INITIALIZER_UNLOCKED),
+    syncBits(nullptr),
+    checkpointJob(JOB_NONE) {
+    
+    clock.start(0, CLOCK_FALLBACK_EPOCH * 1000000LL, 0, false);
 }
 
 bool TimeManager::begin() {
-    preferences.begin("time-config", false);
+    LOG_I("Time Manager Started - Timezone: GMT+%d", getTimezone());
     
-    // Load saved timezone
-    timezone = preferences.getInt("timezone", DEFAULT_TIMEZONE);
+    // Until NTP answers, carry on from the last checkpoint with its drift.
+    // Timestamps handed out since it was saved may be up to the lead
+    // later, so they are the floor; the clock itself starts at the
+    // saved time and the first reply steps it forward.
+    ClockCheckpoint checkpoint;
+    if (configStore.getClockCheckpoint(checkpoint)) {
+        clock.start(esp_timer_get_time(), checkpoint.epochMicros, checkpoint.driftPpb, checkpoint.driftValid,
+                    checkpoint.epochMicros + CLOCK_CHECKPOINT_LEAD_MS * 1000LL);
+        LOG_I("Clock resumed from checkpoint, drift %.3f ppm", checkpoint.driftPpb / 1000.0f);
+    } else {
+        clock.start(esp_timer_get_time(), CLOCK_FALLBACK_EPOCH * 1000000LL, 0, false);
+    }
     
-    Utils::info("Time Manager Started - Timezone: GMT+" + String(timezone));
+    checkpointJob = scheduler.every(CLOCK_CHECKPOINT_INTERVAL, [](void* self) {
+        static_cast<TimeManager*>(self)->saveCheckpoint();
+    }, this, "clock");
     
-    // Initial time sync
-    return syncTime();
+    // SNTP starts once WiFi is up; the boot sequence waits for the first sync
+    syncBits = xEventGroupCreate();
+    sntp_set_time_sync_notification_cb(onTimeSync);
+    wifiManager.addListener(onWiFiState, this);
+    configStore.addListener(onConfigChange, this);
+    return true;
 }
 
-bool TimeManager::syncTime() {
-    if (millis() - lastSyncAttempt < 60000) { // Don't sync more than once per minute
-        return timeSynced;
+void TimeManager::onWiFiState(WiFiState state, void* context) {
+    if (state == WIFI_CONNECTED) {
+        static_cast<TimeManager*>(context)->syncTime();
     }
-    
-    lastSyncAttempt = millis();
-    
-    Utils::info("Syncing time with NTP server...");
-    
-    configTime(timezone * 3600, 0, NTP_SERVER);
-    
-    struct tm timeinfo;
-    if (!getLocalTime(&timeinfo, NTP_TIMEOUT)) {
-        Utils::error("Failed to obtain time from NTP");
-        timeSynced = false;
-        return false;
+}
+
+void TimeManager::onConfigChange(ConfigField field, void* context) {
+    // Once per burst of encoder detents, not once per detent
+    if (field == CONFIG_TIMEZONE) {
+        LOG_I("Timezone updated to GMT+%d", configStore.getTimezone());
     }
-    
-    timeSynced = true;
-    Utils::info("Time synchronized: " + getFormattedTime());
-    return true;
 }
 
-String TimeManager::getCurrentTimestamp() {
-    struct tm timeinfo;
-    if (!getLocalTime(&timeinfo)) {
-        return "2024-01-01 00:00:00";
+void TimeManager::onTimeSync(struct timeval* tv) {
+    // lwIP task: pair the reply with the local clock and let the main
+    // task do the rest
+    TimeSyncSample sample = {esp_timer_get_time(), (int64_t)tv->tv_sec * 1000000 + tv->tv_usec};
+    timeManager.samples.push(sample);
+    Scheduler::wake();
+}
+
+void TimeManager::update() {
+    TimeSyncSample sample;
+    while (samples.pop(sample)) {
+        uint32_t steps = clock.getStats().steps;
+        portENTER_CRITICAL(&clockLock);
+        clock.sync(sample.local, sample.epochMicros);
+        portEXIT_CRITICAL(&clockLock);
+        
+        const ClockStats& stats = clock.getStats();
+        LOG_I("NTP sync: error %d ms, drift %.3f ppm%s", (int32_t)(stats.lastErrorMicros / 1000),
+              clock.getDriftPpb() / 1000.0f, clock.isDriftValid() ? "" : " (not measured yet)");
+        
+        timeSynced = true;
+        syncCount++;
+        saveCheckpoint();
+        if (stats.steps != steps) {
+            // The clock jumped past the checkpoint in flash; don't leave
+            // that to the store's debounce
+            configStore.commit();
+        }
+        xEventGroupSetBits(syncBits, TIME_BIT_SYNCED);
     }
+}
+
+void TimeManager::saveCheckpoint() {
+    // The estimate itself, not the held now(): begin() adds the lead back
+    // as a floor, so a reboot resumes at the right time but never before
+    // a timestamp already handed out. Also keeps the clock's base recent
+    // so its products stay small.
+    int64_t local = esp_timer_get_time();
+    portENTER_CRITICAL(&clockLock);
+    clock.rebase(local);
+    ClockCheckpoint checkpoint = {clock.peek(local), clock.getDriftPpb(), clock.isDriftValid()};
+    portEXIT_CRITICAL(&clockLock);
     
-    char timestamp[25];
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &timeinfo);
-    return String(timestamp);
+    configStore.setClockCheckpoint(checkpoint);
 }
 
-String TimeManager::getFormattedTime() {
-    struct tm timeinfo;
-    if (!getLocalTime(&timeinfo)) {
-        return "Time Sync Failed";
+bool TimeManager::syncTime() {
+    // Starting SNTP returns at once; it retries and refreshes on its own.
+    // Only the caller that flips the flag starts it.
+    bool expected = false;
+    if (sntpStarted.compare_exchange_strong(expected, true)) {
+        LOG_I("Starting SNTP with %s", NTP_SERVER);
+        configTime(0, 0, NTP_SERVER);
     }
+    return timeSynced;
+}
+
+bool TimeManager::waitForSync(uint32_t timeoutMs) {
+    // For boot stage tasks; never called on the main task
+    EventBits_t bits = xEventGroupWaitBits(syncBits, TIME_BIT_SYNCED, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeoutMs));
+    if (bits & TIME_BIT_SYNCED) return true;
     
-    char timeString[25];
-    strftime(timeString, sizeof(timeString), "%a %b %d %H:%M:%S %Y", &timeinfo);
-    return String(timeString);
+    LOG_E("No NTP reply within %u ms, still trying", timeoutMs);
+    return false;
+}
+
+int64_t TimeManager::nowMicros() {
+    int64_t local = esp_timer_get_time();
+    portENTER_CRITICAL(&clockLock);
+    int64_t epoch = clock.now(local);
+    portEXIT_CRITICAL(&clockLock);
+    return epoch;
+}
+
+int64_t TimeManager::getEpoch() {
+    return nowMicros() / 1000000;
+}
+
+void TimeManager::getCurrentTimestamp(char* out) {
+    // Extrapolated before the first sync too, so readings stay in order
+    TimeFormat::iso(getEpoch() + getTimezone() * 3600, out);
+}
+
+void TimeManager::getFormattedTime(char* out) {
+    TimeFormat::longForm(getEpoch() + getTimezone() * 3600, out);
 }
 
 void TimeManager::setTimezone(int newTimezone) {
+    // RAM only until the store commits; applied when formatting, the
+    // clock itself is UTC
     if (newTimezone >= -12 && newTimezone <= 14) {
-        timezone = newTimezone;
-        preferences.putInt("timezone", timezone);
-        Utils::info("Timezone updated to GMT+" + String(timezone));
-        
-        // Resync time with new timezone
-        syncTime();
+        configStore.setTimezone(newTimezone);
     }
 }
 
 int TimeManager::getTimezone() {
-    return timezone;
+    return configStore.getTimezone();
 }
 
 bool TimeManager::isTimeSynced() {
     return timeSynced;
 }
 
-String TimeManager::getUptime() {
-    unsigned long seconds = millis() / 1000;
-    unsigned long minutes = seconds / 60;
-    unsigned long hours = minutes / 60;
-    unsigned long days = hours / 24;
-    
-    char uptime[20];
-    snprintf(uptime, sizeof(uptime), "%lud %02lu:%02lu:%02lu", 
-             days, hours % 24, minutes % 60, seconds % 60);
-    return String(uptime);
+uint32_t TimeManager::getSyncCount() {
+    return syncCount;
+}
+
+int32_t TimeManager::getDriftPpb() {
+    return clock.getDriftPpb();
+}
+
+const ClockStats& TimeManager::getClockStats() {
+    return clock.getStats();
+}
+
+void TimeManager::getUptime(char* out) {
+    TimeFormat::uptime(millis() / 1000, out);
 }
 
 void TimeManager::forceResync() {
-    timeSynced = false;
-    syncTime();
-}
\ No newline at end of file
+    // The clock keeps running on its estimate until the reply arrives
+    if (!sntpStarted) {
+        syncTime();
+        return;
+    }
+    LOG_I("Requesting NTP resync");
+    sntp_restart();
+}
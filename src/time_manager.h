@@ -3,32 +3,63 @@
 
 #include <Arduino.h>
 #include <time.h>
-#include <Preferences.h>
+#include <atomic>
+#include <freertos/event_groups.h>
 #include "config.h"
 #include "utils.h"
+#include "time_format.h"
+#include "wifi_manager.h"
+#include "scheduler.h"
+#include "spsc_queue.h"
+#include "disciplined_clock.h"
+#include "config_store.h"
 
+// NTP reply as seen by the SNTP callback
+struct TimeSyncSample {
+    int64_t local;              // esp_timer micros
+    int64_t epochMicros;
+};
+
+// SNTP runs in the background inside lwIP and hands each reply to the
+// main task, which feeds it to a disciplined clock over esp_timer. Reading
+// the time is integer arithmetic with no libc time calls, it never goes
+// backwards, and it keeps extrapolating with the measured drift offline.
 class TimeManager {
 private:
-    Preferences preferences;
-    int timezone;
     bool timeSynced;
-    unsigned long lastSyncAttempt;
+    std::atomic<bool> sntpStarted;  // Boot tasks and the main task may both start it
+    uint32_t syncCount;
+    DisciplinedClock clock;
+    portMUX_TYPE clockLock;
+    SpscQueue<TimeSyncSample, 4> samples;
+    EventGroupHandle_t syncBits;
+    JobId checkpointJob;
     
-    bool syncWithNTP();
+    static void onTimeSync(struct timeval* tv);
+    static void onWiFiState(WiFiState state, void* context);
+    static void onConfigChange(ConfigField field, void* context);
+    int64_t nowMicros();
+    void saveCheckpoint();
     
 public:
     TimeManager();
     bool begin();
-    String getCurrentTimestamp();
-    String getFormattedTime();
+    void update();
+    int64_t getEpoch();             // UTC seconds
+    void getCurrentTimestamp(char* out);
+    void getFormattedTime(char* out);   // LONG_TIME_LENGTH + 1
     void setTimezone(int newTimezone);
     int getTimezone();
     bool syncTime();
+    bool waitForSync(uint32_t timeoutMs);
     bool isTimeSynced();
-    String getUptime();
+    uint32_t getSyncCount();
+    int32_t getDriftPpb();
+    const ClockStats& getClockStats();
+    void getUptime(char* out);          // UPTIME_LENGTH + 1
     void forceResync();
 };
 
 extern TimeManager timeManager;
 
-#endif
\ No newline at end of file
+#endif
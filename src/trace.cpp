@@ -0,0 +1,167 @@
+#include "trace.h"
+
+#if TRACE_ENABLED
+
+#include <memory>
+#include <new>
+#include <ESPAsyncWebServer.h>
+#include "http_server.h"
+#include "profiler.h"
+#include "scheduler.h"
+
+Trace trace;
+
+#define TRACE_MAGIC "WQTR"
+#define TRACE_VERSION 1
+#define TRACE_TASK_OTHER 0xFF
+
+Trace::Trace() :
+    head(0),
+    recording(false),
+    taskCount(0),
+    taskLock(portMUX_INITIALIZER_UNLOCKED) {
+
+    memset(events, 0, sizeof(events));
+    memset(tasks, 0, sizeof(tasks));
+    memset(taskNames, 0, sizeof(taskNames));
+}
+
+void Trace::begin() {
+    httpServer.getServer().on("/trace", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleTrace(request);
+    });
+    recording = true;
+}
+
+uint8_t Trace::taskIndex() {
+    TaskHandle_t current = xTaskGetCurrentTaskHandle();
+    uint8_t count = taskCount.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < count; i++) {
+        if (tasks[i] == current) return i;
+    }
+
+    // First event from this task; the name is copied now because boot
+    // stage tasks are gone by the time the trace is read
+    uint8_t index = TRACE_TASK_OTHER;
+    portENTER_CRITICAL(&taskLock);
+    count = taskCount.load(std::memory_order_relaxed);
+    for (uint8_t i = 0; i < count; i++) {
+        if (tasks[i] == current) index = i;
+    }
+    if (index == TRACE_TASK_OTHER && count < TRACE_MAX_TASKS) {
+        index = count;
+        tasks[index] = current;
+        strlcpy(taskNames[index], pcTaskGetName(current), TRACE_NAME_LENGTH);
+        taskCount.store(count + 1, std::memory_order_release);
+    }
+    portEXIT_CRITICAL(&taskLock);
+    return index;
+}
+
+void Trace::record(TraceKind kind, uint16_t id) {
+    if (!recording.load(std::memory_order_relaxed)) return;
+
+    uint32_t slot = head.fetch_add(1, std::memory_order_relaxed) & (TRACE_BUFFER_EVENTS - 1);
+    TraceEvent& event = events[slot];
+    event.timeMicros = (uint32_t)esp_timer_get_time();
+    event.id = id;
+    event.kind = kind;
+    event.task = taskIndex();
+}
+
+void Trace::setRecording(bool enabled) {
+    recording = enabled;
+}
+
+bool Trace::isRecording() {
+    return recording;
+}
+
+// Little-endian layout, read by tools/trace_to_chrome.py:
+//   "WQTR", u16 version, u16 event count, u32 events recorded in total,
+//   u8 task count, u8 name count, u16 reserved
+//   task count x char[16] task names, by task index
+//   name count x {u16 id, char[16] name}
+//   event count x {u32 time, u16 id, u8 kind, u8 task}, oldest first
+size_t Trace::dump(uint8_t* out, size_t size) {
+    uint32_t total = head.load(std::memory_order_acquire);
+    uint16_t count = min(total, (uint32_t)TRACE_BUFFER_EVENTS);
+    uint8_t tasksKnown = taskCount.load(std::memory_order_acquire);
+
+    uint8_t nameCount = PROFILE_ZONE_COUNT;
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        if (scheduler.getJobName(i)) nameCount++;
+    }
+
+    size_t needed = 16 + tasksKnown * TRACE_NAME_LENGTH + nameCount * (2 + TRACE_NAME_LENGTH) +
+                    count * sizeof(TraceEvent);
+    if (size < needed) return 0;
+
+    uint8_t* p = out;
+    uint16_t version = TRACE_VERSION;
+    uint16_t reserved = 0;
+    memcpy(p, TRACE_MAGIC, 4); p += 4;
+    memcpy(p, &version, 2); p += 2;
+    memcpy(p, &count, 2); p += 2;
+    memcpy(p, &total, 4); p += 4;
+    *p++ = tasksKnown;
+    *p++ = nameCount;
+    memcpy(p, &reserved, 2); p += 2;
+
+    memcpy(p, taskNames, tasksKnown * TRACE_NAME_LENGTH);
+    p += tasksKnown * TRACE_NAME_LENGTH;
+
+    for (int i = 0; i < PROFILE_ZONE_COUNT + SCHEDULER_MAX_JOBS; i++) {
+        uint16_t id = i < PROFILE_ZONE_COUNT ? i : TRACE_JOB_BASE + (i - PROFILE_ZONE_COUNT);
+        const char* name = i < PROFILE_ZONE_COUNT ? getProfileZoneName((ProfileZone)i)
+                                                  : scheduler.getJobName(i - PROFILE_ZONE_COUNT);
+        if (!name) continue;
+        memcpy(p, &id, 2);
+        memset(p + 2, 0, TRACE_NAME_LENGTH);
+        strncpy((char*)p + 2, name, TRACE_NAME_LENGTH - 1);
+        p += 2 + TRACE_NAME_LENGTH;
+    }
+
+    // Oldest first: the slot after the newest once the buffer has wrapped
+    uint32_t first = total - count;
+    for (uint16_t i = 0; i < count; i++) {
+        memcpy(p, &events[(first + i) & (TRACE_BUFFER_EVENTS - 1)], sizeof(TraceEvent));
+        p += sizeof(TraceEvent);
+    }
+    return needed;
+}
+
+// ==================== HTTP ====================
+void Trace::handleTrace(AsyncWebServerRequest* request) {
+    struct Dump {
+        std::unique_ptr<uint8_t[]> data;
+        size_t length;
+    };
+
+    // Paused while copying so the ring doesn't move under the copy; an
+    // event that was mid-write on the other core may come out torn
+    bool wasRecording = recording.exchange(false);
+    std::shared_ptr<Dump> copy(new Dump);
+    copy->length = 0;
+    copy->data.reset(new (std::nothrow) uint8_t[TRACE_DUMP_MAX_SIZE]);
+    if (copy->data) {
+        copy->length = dump(copy->data.get(), TRACE_DUMP_MAX_SIZE);
+    }
+    recording = wasRecording;
+
+    if (!copy->data) {
+        request->send(503, "text/plain", "Out of memory");
+        return;
+    }
+
+    AsyncWebServerResponse* response = request->beginChunkedResponse("application/octet-stream",
+        [copy](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            size_t n = index < copy->length ? min(maxLen, copy->length - index) : 0;
+            memcpy(buffer, copy->data.get() + index, n);
+            return n;
+        });
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
+
+#endif
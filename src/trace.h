@@ -0,0 +1,87 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "config.h"
+
+class AsyncWebServerRequest;
+
+// Event ids: ProfileZone values, then one per scheduler job
+#define TRACE_JOB_BASE 0x100
+#define TRACE_NAME_LENGTH 16
+
+// Largest dump: header, full task and name tables, full buffer
+#define TRACE_DUMP_MAX_SIZE (16 + TRACE_MAX_TASKS * TRACE_NAME_LENGTH + \
+                             (PROFILE_ZONE_COUNT + SCHEDULER_MAX_JOBS) * (2 + TRACE_NAME_LENGTH) + \
+                             TRACE_BUFFER_EVENTS * sizeof(TraceEvent))
+
+enum TraceKind : uint8_t {
+    TRACE_BEGIN,
+    TRACE_END
+};
+
+struct TraceEvent {
+    uint32_t timeMicros;        // esp_timer, low 32 bits
+    uint16_t id;
+    uint8_t kind;
+    uint8_t task;               // Index into the task table, 0xFF if it was full
+};
+
+#if TRACE_ENABLED
+
+// Flight recorder of begin/end events, TRACE_BUFFER_EVENTS deep; the
+// oldest events are overwritten. Recording costs one atomic increment,
+// a timer read and a short task table lookup. GET /trace pauses
+// recording while it copies the buffer, then streams the copy; see
+// tools/trace_to_chrome.py for the format and the conversion.
+class Trace {
+private:
+    TraceEvent events[TRACE_BUFFER_EVENTS];
+    std::atomic<uint32_t> head;         // Events recorded since start
+    std::atomic<bool> recording;
+    TaskHandle_t tasks[TRACE_MAX_TASKS];
+    char taskNames[TRACE_MAX_TASKS][TRACE_NAME_LENGTH];
+    std::atomic<uint8_t> taskCount;
+    portMUX_TYPE taskLock;
+
+    static_assert((TRACE_BUFFER_EVENTS & (TRACE_BUFFER_EVENTS - 1)) == 0,
+                  "TRACE_BUFFER_EVENTS must be a power of two");
+
+    uint8_t taskIndex();
+    void handleTrace(AsyncWebServerRequest* request);
+
+public:
+    Trace();
+    void begin();
+    void record(TraceKind kind, uint16_t id);
+    void setRecording(bool enabled);
+    bool isRecording();
+    size_t dump(uint8_t* out, size_t size);     // Bytes written, 0 if out is too small
+};
+
+extern Trace trace;
+
+class TraceScope {
+private:
+    uint16_t id;
+
+public:
+    explicit TraceScope(uint16_t id) : id(id) {
+        trace.record(TRACE_BEGIN, id);
+    }
+
+    ~TraceScope() {
+        trace.record(TRACE_END, id);
+    }
+};
+
+#define TRACE_SCOPE(id) TraceScope traceScope(id)
+
+#else
+
+#define TRACE_SCOPE(id)
+
+#endif
+
+#endif
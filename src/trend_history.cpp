@@ -0,0 +1,131 @@
+#include "trend_history.h"
+
+TrendHistory trendHistory;
+
+TrendHistory::TrendHistory() :
+    newest(TREND_COLUMNS - 1),
+    revision(0),
+    bucketStart(0),
+    started(false) {
+
+    for (int ch = 0; ch < TREND_CHANNEL_COUNT; ch++) {
+        for (int i = 0; i < TREND_COLUMNS; i++) {
+            columns[ch][i] = {0, 0, false};
+        }
+        pending[ch] = {0, 0, false};
+        rangeMin[ch] = 0;
+        rangeMax[ch] = 0;
+        rangeValid[ch] = false;
+    }
+}
+
+void TrendHistory::record(const SensorData& data, unsigned long now) {
+    update(now);
+
+    if (!data.do_error) {
+        addSample(TREND_DO, data.do_value);
+    }
+    if (!data.ds18b20_error) {
+        addSample(TREND_TEMPERATURE, data.ds18b20_temp);
+    }
+}
+
+void TrendHistory::update(unsigned long now) {
+    if (!started) {
+        bucketStart = now;
+        started = true;
+        return;
+    }
+
+    // After a long stall every column is stale anyway; close at most one
+    // screen width of buckets and realign instead of looping per bucket.
+    if (now - bucketStart >= TREND_WINDOW_MS) {
+        for (int i = 0; i < TREND_COLUMNS; i++) {
+            closeBucket();
+        }
+        bucketStart = now;
+        return;
+    }
+
+    while (now - bucketStart >= TREND_BUCKET_MS) {
+        closeBucket();
+        bucketStart += TREND_BUCKET_MS;
+    }
+}
+
+void TrendHistory::addSample(TrendChannel channel, float value) {
+    TrendColumn& col = pending[channel];
+    if (!col.valid) {
+        col.minValue = value;
+        col.maxValue = value;
+        col.valid = true;
+    } else {
+        if (value < col.minValue) col.minValue = value;
+        if (value > col.maxValue) col.maxValue = value;
+    }
+}
+
+void TrendHistory::closeBucket() {
+    newest = (newest + 1) % TREND_COLUMNS;
+
+    for (int ch = 0; ch < TREND_CHANNEL_COUNT; ch++) {
+        TrendColumn evicted = columns[ch][newest];
+        TrendColumn& added = columns[ch][newest];
+        added = pending[ch];
+        pending[ch].valid = false;
+
+        // Only a column that held the current extreme can shrink the range
+        if (evicted.valid && rangeValid[ch] &&
+            (evicted.minValue <= rangeMin[ch] || evicted.maxValue >= rangeMax[ch])) {
+            rescanRange((TrendChannel)ch);
+        } else if (added.valid) {
+            if (!rangeValid[ch]) {
+                rangeMin[ch] = added.minValue;
+                rangeMax[ch] = added.maxValue;
+                rangeValid[ch] = true;
+            } else {
+                if (added.minValue < rangeMin[ch]) rangeMin[ch] = added.minValue;
+                if (added.maxValue > rangeMax[ch]) rangeMax[ch] = added.maxValue;
+            }
+        }
+    }
+
+    revision++;
+}
+
+void TrendHistory::rescanRange(TrendChannel channel) {
+    rangeValid[channel] = false;
+
+    for (int i = 0; i < TREND_COLUMNS; i++) {
+        const TrendColumn& col = columns[channel][i];
+        if (!col.valid) continue;
+
+        if (!rangeValid[channel]) {
+            rangeMin[channel] = col.minValue;
+            rangeMax[channel] = col.maxValue;
+            rangeValid[channel] = true;
+        } else {
+            if (col.minValue < rangeMin[channel]) rangeMin[channel] = col.minValue;
+            if (col.maxValue > rangeMax[channel]) rangeMax[channel] = col.maxValue;
+        }
+    }
+}
+
+const TrendColumn& TrendHistory::getColumn(TrendChannel channel, int index) const {
+    return columns[channel][(newest + 1 + index) % TREND_COLUMNS];
+}
+
+const TrendColumn& TrendHistory::getPending(TrendChannel channel) const {
+    return pending[channel];
+}
+
+bool TrendHistory::getRange(TrendChannel channel, float& minValue, float& maxValue) const {
+    if (!rangeValid[channel]) return false;
+    minValue = rangeMin[channel];
+    maxValue = rangeMax[channel];
+    return true;
+}
+
+uint32_t TrendHistory::getRevision() const {
+    return revision;
+}
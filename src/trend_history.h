@@ -0,0 +1,54 @@
+#ifndef TREND_HISTORY_H
+#define TREND_HISTORY_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "sensor_manager.h"
+
+enum TrendChannel {
+    TREND_DO = 0,
+    TREND_TEMPERATURE = 1,
+    TREND_CHANNEL_COUNT
+};
+
+// One screen column: the min/max of all samples that fell into its bucket.
+// Empty buckets (no valid sample) have valid == false and are drawn as gaps.
+struct TrendColumn {
+    float minValue;
+    float maxValue;
+    bool valid;
+};
+
+class TrendHistory {
+private:
+    TrendColumn columns[TREND_CHANNEL_COUNT][TREND_COLUMNS];
+    TrendColumn pending[TREND_CHANNEL_COUNT];
+    uint16_t newest;          // Ring index of the most recent closed column
+    uint32_t revision;        // Number of columns closed since boot
+    unsigned long bucketStart;
+    bool started;
+
+    // Visible range, maintained incrementally as columns enter and leave
+    float rangeMin[TREND_CHANNEL_COUNT];
+    float rangeMax[TREND_CHANNEL_COUNT];
+    bool rangeValid[TREND_CHANNEL_COUNT];
+
+    void addSample(TrendChannel channel, float value);
+    void closeBucket();
+    void rescanRange(TrendChannel channel);
+
+public:
+    TrendHistory();
+    void record(const SensorData& data, unsigned long now);
+    void update(unsigned long now);
+
+    // index 0 is the oldest visible column, TREND_COLUMNS - 1 the newest
+    const TrendColumn& getColumn(TrendChannel channel, int index) const;
+    const TrendColumn& getPending(TrendChannel channel) const;
+    bool getRange(TrendChannel channel, float& minValue, float& maxValue) const;
+    uint32_t getRevision() const;
+};
+
+extern TrendHistory trendHistory;
+
+#endif
@@ -3,21 +3,59 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "logger.h"
+
+// Where a chunked response stopped: the piece the last chunk ended in and
+// its position in the document. Kept with the response's own data so the
+// next chunk carries on from there.
+struct ChunkCursor {
+    int item;
+    int part;
+    size_t offset;          // Document position of the piece
+
+    ChunkCursor() : item(0), part(0), offset(0) {}
+};
 
 class Utils {
 public:
-    static void debug(const String& message) {
-        if (DEBUG_MODE) {
-            Serial.println("[DEBUG] " + message);
-        }
+    // Element count of a fixed-size array, usable in constant expressions
+    template <typename T, size_t N>
+    static constexpr int countOf(const T (&)[N]) {
+        return N;
     }
-    
-    static void error(const String& message, ErrorCode code = ERROR_NONE) {
-        Serial.println("[ERROR] " + message + " Code: " + String(code));
-    }
-    
-    static void info(const String& message) {
-        Serial.println("[INFO] " + message);
+
+    // Fills the chunk at document position index from a document made of
+    // items of one or more pieces. render(item, part, out, size) writes one
+    // piece and returns its length, 0 past the item's last piece. Each
+    // piece is rendered about once per response; a piece split across
+    // chunks is rendered again for the second half.
+    template <typename Render>
+    static size_t fillChunk(ChunkCursor& cursor, int items, size_t index, uint8_t* buffer, size_t maxLen,
+                            char* piece, size_t pieceSize, Render render) {
+        if (index < cursor.offset) {
+            cursor = ChunkCursor();         // Asked for again from the start
+        }
+        size_t written = 0;
+        while (cursor.item < items && written < maxLen) {
+            size_t length = render(cursor.item, cursor.part, piece, pieceSize);
+            if (length == 0) {
+                cursor.item++;
+                cursor.part = 0;
+                continue;
+            }
+
+            size_t position = index + written;
+            if (cursor.offset + length > position) {
+                size_t from = position - cursor.offset;
+                size_t n = min(length - from, maxLen - written);
+                memcpy(buffer + written, piece + from, n);
+                written += n;
+                if (from + n < length) break;   // The rest goes in the next chunk
+            }
+            cursor.offset += length;
+            cursor.part++;
+        }
+        return written;
     }
     
     static String formatFloat(float value, int decimals = 2) {
@@ -1,131 +1,650 @@
+#define LOG_MODULE LOG_WIFI
 #include "wifi_manager.h"
+#include "profiler.h"
+#include "time_manager.h"
 
 WiFiManager wifiManager;
 
+#define WIFI_BIT_CONNECTED (1 << 0)
+#define WIFI_BIT_SETTLED (1 << 1)   // Connected or fell back to AP at least once
+
+// Disconnect reason reported for our own WiFi.disconnect()
+#define DISCONNECT_REASON_ASSOC_LEAVE 8
+
+static const char* const STATE_NAMES[] = {
+    "Idle", "Scanning", "Connecting", "Connected", "Retrying", "AP Mode"
+};
+
+// ms, API_TIMEOUT lands in +Inf
+static const uint32_t POST_LATENCY_BOUNDS[] = {100, 250, 500, 1000, 2500, 5000};
+// ms, WIFI_CONNECT_TIMEOUT is the last bound
+static const uint32_t CONNECT_LATENCY_BOUNDS[] = {100, 250, 500, 1000, 2000, 4000, 8000, WIFI_CONNECT_TIMEOUT};
+
 WiFiManager::WiFiManager() : 
-    wifiConnected(false), 
+    currentNetwork(-1),
+    state(WIFI_IDLE),
     apMode(false),
-    lastReconnectAttempt(0),
-    lastStatusCheck(0) {
+    failedAttempts(0),
+    lastDisconnectReason(0),
+    timeoutJob(JOB_NONE),
+    retryJob(JOB_NONE),
+    stateBits(nullptr),
+    fastCacheValid(false),
+    fastAttempt(false),
+    leaseReused(false),
+    attemptStart(0),
+    scanCount(0),
+    scanMode(SCAN_IDLE),
+    scanChannel(0),
+    scanStart(0),
+    candidateCount(0),
+    nextCandidate(0),
+    linkLostAt(0),
+    roamJob(JOB_NONE),
+    listenerCount(0),
+    postLatency(POST_LATENCY_BOUNDS),
+    fastAssociation(CONNECT_LATENCY_BOUNDS),
+    scanAssociation(CONNECT_LATENCY_BOUNDS),
+    fastIp(CONNECT_LATENCY_BOUNDS),
+    scanIp(CONNECT_LATENCY_BOUNDS) {
+    
+    memset(&fastCache, 0, sizeof(fastCache));
+    memset(&attemptStats, 0, sizeof(attemptStats));
 }
 
 bool WiFiManager::begin() {
-    preferences.begin("wifi-config", false);
-    
     // Load saved credentials
-    ssid = preferences.getString("ssid", "");
-    password = preferences.getString("password", "");
-    serverURL = preferences.getString("serverURL", API_URL);
+    networks = configStore.getNetworks();
+    
+    LOG_I("WiFi Manager Started");
+    LOG_I("Saved networks: %d", networks.getCount());
+    for (int i = 0; i < networks.getCount(); i++) {
+        LOG_I("  %s (priority %u)", networks.get(i).ssid, networks.get(i).priority);
+    }
+    
+    fastCacheValid = configStore.getFastConnect(fastCache);
+    
+    stateBits = xEventGroupCreate();
+    timeoutJob = scheduler.once([](void* self) {
+        static_cast<WiFiManager*>(self)->connectionFailed("timeout");
+    }, this, "wifi-timeout");
+    retryJob = scheduler.once([](void* self) {
+        static_cast<WiFiManager*>(self)->connect();
+    }, this, "wifi-retry");
+    roamJob = scheduler.every(WIFI_ROAM_CHECK_INTERVAL, [](void* self) {
+        static_cast<WiFiManager*>(self)->checkRoaming();
+    }, this, "wifi-roam");
     
-    Utils::info("WiFi Manager Started");
-    Utils::info("Saved SSID: " + String(ssid.length() > 0 ? ssid : "None"));
+    // The state machine owns reconnects, not the driver
+    WiFi.persistent(false);
+    WiFi.setAutoReconnect(false);
+    WiFi.onEvent(onWiFiEvent);
+    addMetrics();
     
-    if (ssid.length() > 0) {
-        return connectToWiFi();
+    if (networks.getCount() > 0) {
+        connect();
     } else {
-        Utils::info("No WiFi credentials saved. Starting AP mode.");
+        LOG_I("No WiFi credentials saved. Starting AP mode.");
         startAPMode();
-        return false;
     }
+    return networks.getCount() > 0;
 }
 
-bool WiFiManager::connectToWiFi() {
-    if (ssid.length() == 0) {
-        Utils::error("No SSID configured");
-        return false;
+void WiFiManager::onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+    // Runs in the WiFi event task: copy the event and let the main task
+    // drive the state machine
+    WiFiEventRecord record = {(uint8_t)event, 0, (uint32_t)millis()};
+    if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+        record.reason = info.wifi_sta_disconnected.reason;
     }
+    wifiManager.events.push(record);
+    Scheduler::wake();
+}
+
+void WiFiManager::update() {
+    WiFiEventRecord record;
+    while (events.pop(record)) {
+        switch (record.event) {
+            case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+                if (state == WIFI_CONNECTING) {
+                    attemptStats.lastAssociationMs = record.timestamp - attemptStart;
+                }
+                break;
+                
+            case ARDUINO_EVENT_WIFI_SCAN_DONE:
+                onScanDone();
+                break;
+                
+            case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+                if (state != WIFI_CONNECTING) break;
+                scheduler.cancel(timeoutJob);
+                failedAttempts = 0;
+                candidateCount = 0;
+                attemptStats.lastIpMs = record.timestamp - attemptStart;
+                attemptStats.lastFast = fastAttempt;
+                if (fastAttempt) {
+                    attemptStats.fastSuccesses++;
+                }
+                (fastAttempt ? fastAssociation : scanAssociation).observe(attemptStats.lastAssociationMs);
+                (fastAttempt ? fastIp : scanIp).observe(attemptStats.lastIpMs);
+                if (linkLostAt != 0) {
+                    reconnects.inc();
+                    attemptStats.lastFailoverMs = record.timestamp - linkLostAt;
+                    linkLostAt = 0;
+                    LOG_I("Failover took %u ms", attemptStats.lastFailoverMs);
+                }
+                stopAPMode();
+                saveFastConnect();
+                setState(WIFI_CONNECTED);
+                LOG_I("✅ WiFi Connected to %s", networks.get(currentNetwork).ssid);
+                LOG_I("IP: %s", WiFi.localIP().toString());
+                LOG_I("RSSI: %d dBm", WiFi.RSSI());
+                LOG_I("Link up in %u ms (associated after %u ms, %s)", attemptStats.lastIpMs,
+                      attemptStats.lastAssociationMs, fastAttempt ? "fast connect" : "full scan");
+                break;
+                
+            case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+                lastDisconnectReason = record.reason;
+                if (state == WIFI_CONNECTING && record.reason == DISCONNECT_REASON_ASSOC_LEAVE) {
+                    // Late echo of tearing down the previous attempt
+                    break;
+                }
+                if (state == WIFI_CONNECTED) {
+                    LOG_I("WiFi connection lost, reason %u", record.reason);
+                    connectionFailed("link lost");
+                } else if (state == WIFI_CONNECTING) {
+                    connectionFailed("disconnected");
+                }
+                break;
+                
+            case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+                if (state == WIFI_CONNECTED) {
+                    connectionFailed("IP lost");
+                }
+                break;
+                
+            default:
+                break;
+        }
+    }
+}
+
+void WiFiManager::addMetrics() {
+    metrics.addCounter("wifi_reconnects_total", "Links re-established after a loss or roam", reconnects);
+    metrics.addGauge("wifi_rssi_dbm", "Signal of the current AP, 0 when not connected", [](const void*) -> uint32_t {
+        return WiFi.isConnected() ? (int32_t)WiFi.RSSI() : 0;
+    });
+    metrics.addCounter("http_posts_total", "Readings posted to the server", posts);
+    metrics.addCounter("http_post_failures_total", "Posts without a 200 response", postFailures);
+    metrics.addHistogram("http_post_duration_ms", "Post round trip", postLatency);
+    metrics.addQueue("queue=\"wifi_events\"", events);
     
-    Utils::info("Connecting to: " + ssid);
-    
-    // Stop AP mode if active
-    if (apMode) {
-        WiFi.softAPdisconnect(true);
-        apMode = false;
+    // Per-attempt timings; each histogram's _count is the successes on that path
+    metrics.addCounter("wifi_connect_attempts_total", "WiFi.begin() calls", [](const void* source) -> uint32_t {
+        const WiFiAttemptStats* stats = static_cast<const WiFiAttemptStats*>(source);
+        return stats->fastAttempts;
+    }, &attemptStats, "path=\"fast\"");
+    metrics.addCounter("wifi_connect_attempts_total", "WiFi.begin() calls", [](const void* source) -> uint32_t {
+        const WiFiAttemptStats* stats = static_cast<const WiFiAttemptStats*>(source);
+        return stats->attempts - stats->fastAttempts;
+    }, &attemptStats, "path=\"scan\"");
+    metrics.addHistogram("wifi_association_ms", "WiFi.begin() to association", fastAssociation, "path=\"fast\"");
+    metrics.addHistogram("wifi_association_ms", "WiFi.begin() to association", scanAssociation, "path=\"scan\"");
+    metrics.addHistogram("wifi_ip_ms", "WiFi.begin() to IP address", fastIp, "path=\"fast\"");
+    metrics.addHistogram("wifi_ip_ms", "WiFi.begin() to IP address", scanIp, "path=\"scan\"");
+    metrics.addGauge("wifi_last_scan_ms", "Scan start to candidate selection", [](const void* source) -> uint32_t {
+        return static_cast<const WiFiAttemptStats*>(source)->lastScanMs;
+    }, &attemptStats);
+    metrics.addGauge("wifi_last_failover_ms", "Link lost or roam started to new IP", [](const void* source) -> uint32_t {
+        return static_cast<const WiFiAttemptStats*>(source)->lastFailoverMs;
+    }, &attemptStats);
+    metrics.addCounter("wifi_roams_total", "Switches to a better AP while connected", [](const void* source) -> uint32_t {
+        return static_cast<const WiFiAttemptStats*>(source)->roams;
+    }, &attemptStats);
+}
+
+void WiFiManager::connect() {
+    if (networks.getCount() == 0) {
+        LOG_E("No SSID configured");
+        return;
     }
     
+    // Last good AP first; a scan only when that doesn't work
+    int cached = fastCacheValid ? networks.find(fastCache.ssid) : -1;
+    if (cached >= 0) {
+        LOG_I("Connecting to: %s (cached AP)", fastCache.ssid);
+        beginAttempt(cached, fastCache.bssid, fastCache.channel, true);
+    } else {
+        startScan(false);
+    }
+}
+
+void WiFiManager::restartConnection() {
+    scheduler.cancel(timeoutJob);
+    scheduler.cancel(retryJob);
+    failedAttempts = 0;
+    candidateCount = 0;
     WiFi.disconnect();
-    delay(100);
-    WiFi.begin(ssid.c_str(), password.c_str());
-    
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 30) {
-        delay(500);
-        Serial.print(".");
-        attempts++;
+    connect();
+}
+
+void WiFiManager::startScan(bool roam) {
+    if (!roam) {
+        setState(WIFI_SCANNING);
+        scheduler.start(timeoutJob, WIFI_SCAN_TIMEOUT);
+    }
+    
+    // A scan already in flight is reused; a channel sweep started from the
+    // menu also ends with the selection step below
+    if (scanMode != SCAN_IDLE) return;
+    
+    WiFi.mode(apMode ? WIFI_AP_STA : WIFI_STA);
+    WiFi.scanNetworks(true);
+    scanMode = roam ? SCAN_ROAM : SCAN_SELECT;
+    scanCount = 0;
+    scanStart = millis();
+}
+
+void WiFiManager::startNetworkScan() {
+    if (scanMode != SCAN_IDLE) return;
+    
+    // One channel at a time, so the list fills in while the sweep runs
+    WiFi.mode(apMode ? WIFI_AP_STA : WIFI_STA);
+    scanMode = SCAN_SWEEP;
+    scanChannel = 1;
+    scanCount = 0;
+    scanStart = millis();
+    WiFi.scanNetworks(true, false, false, WIFI_SCAN_DWELL_MS, scanChannel);
+}
+
+void WiFiManager::mergeScanResults() {
+    // One entry per SSID, keeping the strongest BSSID, strongest first
+    int found = WiFi.scanComplete();
+    for (int i = 0; i < found; i++) {
+        String name = WiFi.SSID(i);
+        int8_t rssi = WiFi.RSSI(i);
+        if (name.length() == 0) continue;
         
-        if (attempts % 10 == 0) {
-            Serial.println();
+        int slot = -1;
+        for (int j = 0; j < scanCount; j++) {
+            if (name == scanResults[j].ssid) {
+                slot = j;
+                break;
+            }
         }
+        if (slot >= 0 && scanResults[slot].rssi >= rssi) continue;
+        if (slot < 0) {
+            if (scanCount < WIFI_MAX_SCAN_RESULTS) {
+                slot = scanCount++;
+            } else if (scanResults[scanCount - 1].rssi < rssi) {
+                slot = scanCount - 1;
+            } else {
+                continue;
+            }
+        }
+        
+        WiFiScanEntry& entry = scanResults[slot];
+        strlcpy(entry.ssid, name.c_str(), sizeof(entry.ssid));
+        memcpy(entry.bssid, WiFi.BSSID(i), sizeof(entry.bssid));
+        entry.channel = WiFi.channel(i);
+        entry.rssi = rssi;
+        entry.encryption = WiFi.encryptionType(i);
         
-        if (attempts >= 30) {
-            break;
+        while (slot > 0 && scanResults[slot - 1].rssi < scanResults[slot].rssi) {
+            WiFiScanEntry swap = scanResults[slot - 1];
+            scanResults[slot - 1] = scanResults[slot];
+            scanResults[slot] = swap;
+            slot--;
         }
     }
+    WiFi.scanDelete();
+}
+
+void WiFiManager::onScanDone() {
+    if (scanMode == SCAN_IDLE) return;
+    mergeScanResults();
     
-    wifiConnected = (WiFi.status() == WL_CONNECTED);
+    if (scanMode == SCAN_SWEEP && scanChannel < WIFI_SCAN_CHANNELS) {
+        scanChannel++;
+        WiFi.scanNetworks(true, false, false, WIFI_SCAN_DWELL_MS, scanChannel);
+        return;
+    }
     
-    if (wifiConnected) {
-        Utils::info("✅ WiFi Connected!");
-        Utils::info("IP: " + WiFi.localIP().toString());
-        Utils::info("RSSI: " + String(WiFi.RSSI()) + " dBm");
+    ScanMode finished = scanMode;
+    scanMode = SCAN_IDLE;
+    scanChannel = 0;
+    
+    attemptStats.lastScanMs = millis() - scanStart;
+    candidateCount = networks.rank(scanResults, scanCount, candidates, WIFI_MAX_CANDIDATES);
+    nextCandidate = 0;
+    LOG_D("Scan: %u SSIDs, %u known, %u ms", scanCount, candidateCount, attemptStats.lastScanMs);
+    
+    if (finished == SCAN_ROAM) {
+        if (state == WIFI_CONNECTED) {
+            considerRoam();
+        }
+        return;
+    }
+    if (state != WIFI_SCANNING) return;
+    scheduler.cancel(timeoutJob);
+    
+    // Nothing known in sight (or a hidden SSID): let the driver search for
+    // each stored network itself, best priority first
+    if (candidateCount == 0) {
+        for (int p = 0; p <= 0xFF && candidateCount < WIFI_MAX_CANDIDATES; p++) {
+            for (int i = 0; i < networks.getCount() && candidateCount < WIFI_MAX_CANDIDATES; i++) {
+                if (networks.get(i).priority != p) continue;
+                WiFiCandidate& blind = candidates[candidateCount++];
+                memset(&blind, 0, sizeof(blind));
+                blind.network = i;
+            }
+        }
+    }
+    
+    tryNextCandidate();
+}
+
+bool WiFiManager::connectTo(const char* ssidToJoin) {
+    int network = networks.find(ssidToJoin);
+    if (network < 0) return false;
+    
+    // Directed at the AP seen in the last scan, else let the driver search
+    scheduler.cancel(timeoutJob);
+    scheduler.cancel(retryJob);
+    failedAttempts = 0;
+    candidateCount = 0;
+    for (int i = 0; i < scanCount && candidateCount == 0; i++) {
+        if (strcmp(scanResults[i].ssid, ssidToJoin) == 0) {
+            candidateCount = networks.rank(&scanResults[i], 1, candidates, 1);
+        }
+    }
+    if (candidateCount == 0) {
+        memset(&candidates[0], 0, sizeof(candidates[0]));
+        candidates[0].network = network;
+        candidateCount = 1;
+    }
+    nextCandidate = 0;
+    
+    WiFi.disconnect();
+    tryNextCandidate();
+    return true;
+}
+
+bool WiFiManager::tryNextCandidate() {
+    if (nextCandidate >= candidateCount) return false;
+    
+    const WiFiCandidate& candidate = candidates[nextCandidate++];
+    if (candidate.channel) {
+        LOG_I("Connecting to: %s (%d dBm, ch %u)", networks.get(candidate.network).ssid,
+              candidate.rssi, candidate.channel);
     } else {
-        Utils::error("❌ WiFi Connection Failed!");
-        Utils::error("Status: " + String(WiFi.status()));
-        
-        // Fallback to AP mode
-        startAPMode();
+        LOG_I("Connecting to: %s", networks.get(candidate.network).ssid);
     }
+    beginAttempt(candidate.network, candidate.channel ? candidate.bssid : nullptr, candidate.channel, false);
+    return true;
+}
+
+void WiFiManager::checkRoaming() {
+    if (state != WIFI_CONNECTED || scanMode != SCAN_IDLE || currentNetwork < 0) return;
     
-    lastReconnectAttempt = millis();
-    return wifiConnected;
+    // Scan when the link is weak, or when sitting on a backup network
+    bool weak = WiFi.RSSI() < WIFI_ROAM_RSSI_THRESHOLD;
+    bool onBackup = networks.get(currentNetwork).priority > networks.getBestPriority();
+    if (weak || onBackup) {
+        startScan(true);
+    }
 }
 
-void WiFiManager::startAPMode() {
+void WiFiManager::considerRoam() {
+    if (candidateCount == 0) return;
+    
+    const WiFiCandidate& best = candidates[0];
+    if (best.network == currentNetwork && memcmp(best.bssid, WiFi.BSSID(), sizeof(best.bssid)) == 0) return;
+    
+    int currentScore = networks.score(currentNetwork, WiFi.RSSI());
+    if (best.score < currentScore + WIFI_ROAM_HYSTERESIS_DB) return;
+    
+    LOG_I("Roaming to %s (score %d vs %d)", networks.get(best.network).ssid, best.score, currentScore);
+    attemptStats.roams++;
+    linkLostAt = millis();
     WiFi.disconnect();
-    delay(100);
+    tryNextCandidate();
+}
+
+void WiFiManager::beginAttempt(int network, const uint8_t* bssid, uint8_t channel, bool fast) {
+    const WiFiCredential& credential = networks.get(network);
+    
+    // Keep a fallback AP up while retrying so it stays reachable
+    WiFi.mode(apMode ? WIFI_AP_STA : WIFI_STA);
+    applyIPConfig(fast);
+    
+    if (bssid) {
+        // Directed join: known AP on a known channel, no scan
+        WiFi.begin(credential.ssid, credential.password, channel, bssid);
+    } else {
+        WiFi.begin(credential.ssid, credential.password);
+    }
+    if (fast) {
+        attemptStats.fastAttempts++;
+    }
+    
+    currentNetwork = network;
+    fastAttempt = fast;
+    attemptStart = millis();
+    attemptStats.attempts++;
+    attemptStats.lastAssociationMs = 0;
+    
+    setState(WIFI_CONNECTING);
+    scheduler.start(timeoutJob, fast ? WIFI_FAST_CONNECT_TIMEOUT : WIFI_CONNECT_TIMEOUT);
+}
+
+void WiFiManager::applyIPConfig(bool fast) {
+    IPAddress ip, gateway, subnet, dns;
+    leaseReused = false;
     
+    if (strlen(WIFI_STATIC_IP) > 0) {
+        ip.fromString(WIFI_STATIC_IP);
+        gateway.fromString(WIFI_STATIC_GATEWAY);
+        subnet.fromString(WIFI_STATIC_SUBNET);
+        dns.fromString(WIFI_STATIC_DNS);
+    } else if (fast && WIFI_REUSE_LEASE && leaseValid()) {
+        ip = IPAddress(fastCache.ip);
+        gateway = IPAddress(fastCache.gateway);
+        subnet = IPAddress(fastCache.subnet);
+        dns = IPAddress(fastCache.dns);
+        leaseReused = true;
+    }
+    
+    // All zeros puts the interface back on DHCP
+    WiFi.config(ip, gateway, subnet, dns);
+}
+
+bool WiFiManager::leaseValid() {
+    // Also rejects an expiry too far ahead, i.e. a clock that started over
+    int64_t now = timeManager.getEpoch();
+    return now < fastCache.leaseExpires && fastCache.leaseExpires - now <= WIFI_LEASE_REUSE_SECONDS;
+}
+
+void WiFiManager::connectionFailed(const char* why) {
+    scheduler.cancel(timeoutJob);
+    WiFi.disconnect();
+    if (scanMode != SCAN_IDLE) {
+        WiFi.scanDelete();
+        scanMode = SCAN_IDLE;
+        scanChannel = 0;
+    }
+    
+    if (state == WIFI_CONNECTED) {
+        // Fail over: look for the best remaining network right away
+        linkLostAt = millis();
+        startScan(false);
+        return;
+    }
+    
+    if (fastAttempt) {
+        // The AP may have moved channel or the lease expired: fall straight
+        // through to a scan + DHCP join, which doesn't count as a failure
+        LOG_I("Fast connect failed (%s), scanning", why);
+        fastAttempt = false;
+        fastCacheValid = false;
+        startScan(false);
+        return;
+    }
+    
+    // Next best visible AP before giving up on this round
+    if (state == WIFI_CONNECTING && tryNextCandidate()) return;
+    
+    // Saturates, so a long outage doesn't wrap back to the shortest delay
+    if (failedAttempts < UINT8_MAX) failedAttempts++;
+    
+    LOG_E("❌ WiFi connection failed (%s), attempt %u, reason %u", why, failedAttempts,
+          lastDisconnectReason);
+    
+    if (failedAttempts >= WIFI_AP_FALLBACK_ATTEMPTS && !apMode) {
+        startAPMode();
+    } else {
+        setState(apMode ? WIFI_AP_FALLBACK : WIFI_BACKOFF);
+    }
+    
+    uint32_t delayMs = backoffDelay();
+    LOG_I("Next WiFi attempt in %u s", delayMs / 1000);
+    scheduler.start(retryJob, delayMs);
+}
+
+void WiFiManager::saveFastConnect() {
+    WiFiFastConnect link;
+    memset(&link, 0, sizeof(link));
+    strlcpy(link.ssid, networks.get(currentNetwork).ssid, sizeof(link.ssid));
+    memcpy(link.bssid, WiFi.BSSID(), sizeof(link.bssid));
+    link.channel = WiFi.channel();
+    link.ip = WiFi.localIP();
+    link.gateway = WiFi.gatewayIP();
+    link.subnet = WiFi.subnetMask();
+    link.dns = WiFi.dnsIP(0);
+    if (WIFI_REUSE_LEASE) {
+        // Only a DHCP exchange starts a new lease; reusing one keeps its expiry
+        link.leaseExpires = leaseReused ? fastCache.leaseExpires : timeManager.getEpoch() + WIFI_LEASE_REUSE_SECONDS;
+    }
+    
+    // Only touch flash when the link actually changed
+    if (fastCacheValid && memcmp(&link, &fastCache, sizeof(link)) == 0) return;
+    
+    fastCache = link;
+    fastCacheValid = true;
+    configStore.setFastConnect(&fastCache);
+    LOG_D("Saved fast-connect data, channel %u", link.channel);
+}
+
+void WiFiManager::clearFastConnect() {
+    fastCacheValid = false;
+    configStore.setFastConnect(nullptr);
+}
+
+uint32_t WiFiManager::backoffDelay() {
+    // Exponential: min, 2x min, 4x min ... capped at max
+    uint8_t shift = min(failedAttempts > 0 ? failedAttempts - 1 : 0, 8);
+    return min((uint32_t)WIFI_BACKOFF_MIN_MS << shift, (uint32_t)WIFI_BACKOFF_MAX_MS);
+}
+
+void WiFiManager::startAPMode() {
     String apSSID = "WaterSensor-" + String(DEVICE_UID);
+    WiFi.mode(networks.getCount() > 0 ? WIFI_AP_STA : WIFI_AP);
     bool result = WiFi.softAP(apSSID.c_str());
     
-    apMode = true;
-    wifiConnected = false;
+    apMode = result;
+    setState(WIFI_AP_FALLBACK);
     
     if (result) {
-        Utils::info("AP Mode Started");
-        Utils::info("SSID: " + apSSID);
-        Utils::info("IP: " + WiFi.softAPIP().toString());
+        LOG_I("AP Mode Started");
+        LOG_I("SSID: %s", apSSID);
+        LOG_I("IP: %s", WiFi.softAPIP().toString());
+    } else {
+        LOG_E("Failed to start AP mode");
+    }
+}
+
+void WiFiManager::stopAPMode() {
+    if (!apMode) return;
+    
+    WiFi.softAPdisconnect(true);
+    WiFi.mode(WIFI_STA);
+    apMode = false;
+    LOG_I("AP Mode stopped");
+}
+
+void WiFiManager::setState(WiFiState newState) {
+    if (newState == state) return;
+    state = newState;
+    
+    if (state == WIFI_CONNECTED) {
+        xEventGroupSetBits(stateBits, WIFI_BIT_CONNECTED | WIFI_BIT_SETTLED);
     } else {
-        Utils::error("Failed to start AP mode");
+        xEventGroupClearBits(stateBits, WIFI_BIT_CONNECTED);
+        if (state == WIFI_AP_FALLBACK) {
+            xEventGroupSetBits(stateBits, WIFI_BIT_SETTLED);
+        }
+    }
+    
+    LOG_D("WiFi state: %s", STATE_NAMES[state]);
+    for (int i = 0; i < listenerCount; i++) {
+        listeners[i].callback(state, listeners[i].context);
+    }
+}
+
+void WiFiManager::addListener(WiFiStateListener callback, void* context) {
+    if (listenerCount >= WIFI_MAX_LISTENERS) {
+        LOG_E("Too many WiFi listeners");
+        return;
     }
+    listeners[listenerCount++] = {callback, context};
+}
+
+const WiFiAttemptStats& WiFiManager::getAttemptStats() {
+    return attemptStats;
+}
+
+bool WiFiManager::waitForConnection(uint32_t timeoutMs) {
+    // Safe from any task; returns early once the first attempt settles
+    EventBits_t bits = xEventGroupWaitBits(stateBits, WIFI_BIT_SETTLED, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeoutMs));
+    return bits & WIFI_BIT_CONNECTED;
 }
 
 bool WiFiManager::sendDataToServer(const String& jsonPayload) {
-    if (!wifiConnected) {
-        Utils::error("WiFi not connected, cannot send data");
+    PROFILE_SCOPE(PROFILE_POST);
+    if (!isConnected()) {
+        LOG_E("WiFi not connected, cannot send data");
         return false;
     }
     
     HTTPClient http;
+    String serverURL = configStore.getServerURL();
     http.begin(serverURL);
     http.addHeader("accept", "application/json");
     http.addHeader("Content-Type", "application/json");
     http.setTimeout(API_TIMEOUT);
     
-    Utils::debug("Sending data to: " + serverURL);
-    Utils::debug("Payload: " + jsonPayload);
+    LOG_D("Sending data to: %s", serverURL);
+    LOG_D("Payload: %s", jsonPayload);
     
+    uint32_t start = millis();
     int httpResponseCode = http.POST(jsonPayload);
     String response = http.getString();
     
     bool success = (httpResponseCode == 200);
+    posts.inc();
+    postLatency.observe(millis() - start);
+    if (!success) {
+        postFailures.inc();
+    }
     
     if (success) {
-        Utils::info("✅ Data sent successfully");
-        Utils::debug("Response: " + response);
+        LOG_I("✅ Data sent successfully");
+        LOG_D("Response: %s", response);
     } else {
-        Utils::error("❌ HTTP Error: " + String(httpResponseCode));
-        Utils::error("Error: " + http.errorToString(httpResponseCode));
-        Utils::debug("Response: " + response);
+        LOG_E("❌ HTTP Error: %d", httpResponseCode);
+        LOG_E("Error: %s", http.errorToString(httpResponseCode));
+        LOG_D("Response: %s", response);
     }
     
     http.end();
@@ -133,38 +652,50 @@ bool WiFiManager::sendDataToServer(const String& jsonPayload) {
 }
 
 void WiFiManager::setCredentials(const String& newSSID, const String& newPassword) {
-    ssid = newSSID;
-    password = newPassword;
-    
-    preferences.putString("ssid", ssid);
-    preferences.putString("password", password);
+    // Set from the UI: becomes the preferred network
+    if (!addNetwork(newSSID, newPassword, 0)) return;
     
-    Utils::info("WiFi credentials updated");
-    Utils::info("SSID: " + ssid);
-    Utils::info("Password: " + String(password.length() > 0 ? "***" : "None"));
+    LOG_I("WiFi credentials updated");
+    LOG_I("SSID: %s", newSSID);
+    LOG_I("Password: %s", newPassword.length() > 0 ? "***" : "None");
     
     // Reconnect with new credentials
-    connectToWiFi();
+    if (newSSID == fastCache.ssid) {
+        clearFastConnect();
+    }
+    restartConnection();
 }
 
-void WiFiManager::handleReconnection() {
-    if (!wifiConnected && millis() - lastReconnectAttempt > WIFI_RECONNECT_INTERVAL) {
-        Utils::info("Attempting WiFi reconnection...");
-        connectToWiFi();
+bool WiFiManager::addNetwork(const String& newSSID, const String& newPassword, uint8_t priority) {
+    if (!networks.add(newSSID.c_str(), newPassword.c_str(), priority)) {
+        LOG_E("WiFi credentials for %s invalid or list full", newSSID);
+        return false;
     }
-    
-    // Periodic status check
-    if (wifiConnected && millis() - lastStatusCheck > 10000) {
-        if (WiFi.status() != WL_CONNECTED) {
-            Utils::info("WiFi connection lost");
-            wifiConnected = false;
-        }
-        lastStatusCheck = millis();
+    configStore.setNetworks(networks);
+    return true;
+}
+
+void WiFiManager::setServerURL(const String& newURL) {
+    configStore.setServerURL(newURL.c_str());
+    LOG_I("Server URL: %s", newURL);
+}
+
+bool WiFiManager::removeNetwork(const String& oldSSID) {
+    if (!networks.remove(oldSSID.c_str())) return false;
+    configStore.setNetworks(networks);
+    if (oldSSID == fastCache.ssid) {
+        clearFastConnect();
     }
+    currentNetwork = -1;
+    return true;
+}
+
+int WiFiManager::getNetworkCount() {
+    return networks.getCount();
 }
 
 bool WiFiManager::testConnection() {
-    if (!wifiConnected) return false;
+    if (!isConnected()) return false;
     
     HTTPClient http;
     http.begin("http://www.google.com");
@@ -173,41 +704,58 @@ bool WiFiManager::testConnection() {
     http.end();
     
     bool connected = (responseCode == 200);
-    Utils::info("Internet connection test: " + String(connected ? "OK" : "FAILED"));
+    LOG_I("Internet connection test: %s", connected ? "OK" : "FAILED");
     return connected;
 }
 
 void WiFiManager::resetSettings() {
-    preferences.remove("ssid");
-    preferences.remove("password");
-    ssid = "";
-    password = "";
+    networks.clear();
+    configStore.setNetworks(networks);
+    currentNetwork = -1;
+    clearFastConnect();
     
-    Utils::info("WiFi settings reset");
+    LOG_I("WiFi settings reset");
+    scheduler.cancel(timeoutJob);
+    scheduler.cancel(retryJob);
+    WiFi.disconnect();
     startAPMode();
 }
 
-void WiFiManager::scanNetworks() {
-    if (wifiConnected) return;
-    
-    Utils::info("Scanning WiFi networks...");
-    int n = WiFi.scanNetworks();
-    
-    if (n == 0) {
-        Utils::info("No networks found");
-    } else {
-        Utils::info(String(n) + " networks found:");
-        for (int i = 0; i < n; ++i) {
-            Utils::info(String(i + 1) + ": " + WiFi.SSID(i) + " (" + String(WiFi.RSSI(i)) + " dBm)");
-        }
-    }
+bool WiFiManager::isScanning() {
+    return scanMode != SCAN_IDLE;
+}
+
+uint8_t WiFiManager::getScanChannel() {
+    return scanChannel;
+}
+
+int WiFiManager::getScanCount() {
+    return scanCount;
+}
+
+const WiFiScanEntry& WiFiManager::getScanResult(int index) {
+    return scanResults[index];
+}
+
+bool WiFiManager::isKnownNetwork(const char* ssidToCheck) {
+    return networks.find(ssidToCheck) >= 0;
 }
 
 // Getters
-bool WiFiManager::isConnected() { return wifiConnected && (WiFi.status() == WL_CONNECTED); }
-String WiFiManager::getSSID() { return ssid; }
-String WiFiManager::getIPAddress() { 
-    return wifiConnected ? WiFi.localIP().toString() : (apMode ? WiFi.softAPIP().toString() : "N/A"); 
+bool WiFiManager::isConnected() { return state == WIFI_CONNECTED; }
+WiFiState WiFiManager::getState() { return state; }
+const char* WiFiManager::getStateName() { return STATE_NAMES[state]; }
+const char* WiFiManager::getSSID() {
+    if (currentNetwork >= 0) return networks.get(currentNetwork).ssid;
+    return networks.getCount() > 0 ? networks.get(0).ssid : "";
+}
+void WiFiManager::getIPAddress(char* out) {
+    if (!isConnected() && !apMode) {
+        strcpy(out, "N/A");
+        return;
+    }
+    IPAddress ip = isConnected() ? WiFi.localIP() : WiFi.softAPIP();
+    snprintf(out, IP_ADDRESS_LENGTH + 1, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
 }
-int WiFiManager::getRSSI() { return wifiConnected ? WiFi.RSSI() : 0; }
+int WiFiManager::getRSSI() { return isConnected() ? WiFi.RSSI() : 0; }
 bool WiFiManager::isAPMode() { return apMode; }
\ No newline at end of file
@@ -5,41 +5,153 @@
 #include <WiFi.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
-#include <Preferences.h>
+#include <freertos/event_groups.h>
 #include "config.h"
 #include "utils.h"
+#include "scheduler.h"
+#include "spsc_queue.h"
+#include "wifi_networks.h"
+#include "config_store.h"
+#include "metrics.h"
+
+enum WiFiState {
+    WIFI_IDLE,          // No credentials and no AP yet
+    WIFI_SCANNING,      // Looking for the best known network
+    WIFI_CONNECTING,    // WiFi.begin() issued, waiting for an IP
+    WIFI_CONNECTED,     // Got an IP
+    WIFI_BACKOFF,       // Attempt failed, waiting before the next one
+    WIFI_AP_FALLBACK    // Own AP is up; STA retries continue if configured
+};
+
+typedef void (*WiFiStateListener)(WiFiState state, void* context);
+
+// Raw driver event, copied out of the WiFi event task
+struct WiFiEventRecord {
+    uint8_t event;
+    uint8_t reason;     // Disconnect reason, 0 otherwise
+    uint32_t timestamp;
+};
+
+struct WiFiAttemptStats {
+    uint32_t attempts;
+    uint32_t fastAttempts;
+    uint32_t fastSuccesses;
+    uint32_t lastAssociationMs; // WiFi.begin() to association
+    uint32_t lastIpMs;          // WiFi.begin() to IP address
+    bool lastFast;
+    uint32_t lastScanMs;        // Scan start to candidate selection
+    uint32_t lastFailoverMs;    // Link lost (or roam started) to new IP
+    uint32_t roams;
+};
 
 class WiFiManager {
 private:
-    Preferences preferences;
-    String ssid;
-    String password;
-    String serverURL;
-    bool wifiConnected;
+    WiFiNetworkList networks;   // Working copy; changes go to configStore
+    int8_t currentNetwork;      // Network of the current/last attempt
+    WiFiState state;
     bool apMode;
-    unsigned long lastReconnectAttempt;
-    unsigned long lastStatusCheck;
+    uint8_t failedAttempts;
+    uint8_t lastDisconnectReason;
+    JobId timeoutJob;
+    JobId retryJob;
+    SpscQueue<WiFiEventRecord, WIFI_EVENT_QUEUE_SIZE> events;
+    EventGroupHandle_t stateBits;
     
-    bool connectToWiFi();
-    void startAPMode();
+    WiFiFastConnect fastCache;
+    bool fastCacheValid;
+    bool fastAttempt;
+    bool leaseReused;           // Fast attempt runs on the cached address, no DHCP
+    uint32_t attemptStart;
+    WiFiAttemptStats attemptStats;
     
+    // Scan and selection. Results are kept after the scan for the UI.
+    enum ScanMode {
+        SCAN_IDLE,
+        SCAN_SELECT,            // Full scan to pick a network
+        SCAN_ROAM,              // Background scan while connected
+        SCAN_SWEEP              // Channel by channel, started from the menu
+    };
+    WiFiScanEntry scanResults[WIFI_MAX_SCAN_RESULTS];
+    uint8_t scanCount;
+    ScanMode scanMode;
+    uint8_t scanChannel;        // Channel being swept, 0 otherwise
+    uint32_t scanStart;
+    WiFiCandidate candidates[WIFI_MAX_CANDIDATES];
+    uint8_t candidateCount;
+    uint8_t nextCandidate;
+    uint32_t linkLostAt;
+    JobId roamJob;
+
+    struct Listener {
+        WiFiStateListener callback;
+        void* context;
+    };
+    Listener listeners[WIFI_MAX_LISTENERS];
+    uint8_t listenerCount;
+
+    Counter reconnects;
+    Counter posts;
+    Counter postFailures;
+    Histogram postLatency;
+    Histogram fastAssociation;  // WiFi.begin() to association, per path
+    Histogram scanAssociation;
+    Histogram fastIp;           // WiFi.begin() to IP address, per path
+    Histogram scanIp;
+
+    static void onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info);
+
+    void connect();
+    void restartConnection();
+    void startScan(bool roam);
+    void onScanDone();
+    void mergeScanResults();
+    bool tryNextCandidate();
+    void checkRoaming();
+    void considerRoam();
+    void beginAttempt(int network, const uint8_t* bssid, uint8_t channel, bool fast);
+    void applyIPConfig(bool fast);
+    bool leaseValid();
+    void connectionFailed(const char* why);
+    void saveFastConnect();
+    void clearFastConnect();
+    void startAPMode();
+    void stopAPMode();
+    void setState(WiFiState newState);
+    uint32_t backoffDelay();
+    void addMetrics();
+
 public:
     WiFiManager();
     bool begin();
+    void update();
     bool isConnected();
-    String getSSID();
-    String getIPAddress();
+    WiFiState getState();
+    const char* getStateName();
+    void addListener(WiFiStateListener callback, void* context = nullptr);
+    bool waitForConnection(uint32_t timeoutMs);
+    const WiFiAttemptStats& getAttemptStats();
+    const char* getSSID();
+    void getIPAddress(char* out);       // IP_ADDRESS_LENGTH + 1
     int getRSSI();
     void setCredentials(const String& newSSID, const String& newPassword);
+    bool addNetwork(const String& newSSID, const String& newPassword, uint8_t priority);
+    bool removeNetwork(const String& oldSSID);
+    int getNetworkCount();
+    void setServerURL(const String& newURL);
     bool testConnection();
     bool sendDataToServer(const String& jsonPayload);
-    void handleReconnection();
     void resetSettings();
     void startConfigurationMode();
     bool isAPMode();
-    void scanNetworks();
+    void startNetworkScan();
+    bool isScanning();
+    uint8_t getScanChannel();
+    int getScanCount();
+    const WiFiScanEntry& getScanResult(int index);
+    bool isKnownNetwork(const char* ssidToCheck);
+    bool connectTo(const char* ssidToJoin);
 };
 
 extern WiFiManager wifiManager;
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,123 @@
+#include "wifi_networks.h"
+#include "utils.h"
+
+WiFiNetworkList::WiFiNetworkList() : count(0) {
+    memset(networks, 0, sizeof(networks));
+}
+
+void WiFiNetworkList::loadLegacy(Preferences& preferences) {
+    size_t length = preferences.getBytesLength("networks");
+    if (length > 0 && length % sizeof(WiFiCredential) == 0 && length <= sizeof(networks)) {
+        preferences.getBytes("networks", networks, length);
+        count = length / sizeof(WiFiCredential);
+        return;
+    }
+
+    // Older firmware still kept a single ssid/password pair
+    String ssid = preferences.getString("ssid", "");
+    if (ssid.length() > 0) {
+        add(ssid.c_str(), preferences.getString("password", "").c_str(), 0);
+    }
+}
+
+bool WiFiNetworkList::add(const char* ssid, const char* password, uint8_t priority) {
+    if (strlen(ssid) == 0 || strlen(ssid) > MAX_SSID_LENGTH || strlen(password) > MAX_PASSWORD_LENGTH) {
+        return false;
+    }
+
+    int index = find(ssid);
+    if (index < 0) {
+        if (count < WIFI_MAX_NETWORKS) {
+            index = count++;
+        } else {
+            // Full: replace the least preferred entry, if this one beats it
+            index = 0;
+            for (int i = 1; i < count; i++) {
+                if (networks[i].priority >= networks[index].priority) index = i;
+            }
+            if (priority >= networks[index].priority) return false;
+        }
+    }
+
+    // The whole list is persisted, so no tail of an old password may stay
+    WiFiCredential& network = networks[index];
+    memset(network.ssid, 0, sizeof(network.ssid));
+    memset(network.password, 0, sizeof(network.password));
+    strlcpy(network.ssid, ssid, sizeof(network.ssid));
+    strlcpy(network.password, password, sizeof(network.password));
+    network.priority = priority;
+    return true;
+}
+
+bool WiFiNetworkList::remove(const char* ssid) {
+    int index = find(ssid);
+    if (index < 0) return false;
+
+    memmove(&networks[index], &networks[index + 1], (count - index - 1) * sizeof(WiFiCredential));
+    count--;
+    memset(&networks[count], 0, sizeof(WiFiCredential));
+    return true;
+}
+
+void WiFiNetworkList::clear() {
+    memset(networks, 0, sizeof(networks));
+    count = 0;
+}
+
+int WiFiNetworkList::find(const char* ssid) const {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(networks[i].ssid, ssid) == 0) return i;
+    }
+    return -1;
+}
+
+int WiFiNetworkList::getCount() const {
+    return count;
+}
+
+const WiFiCredential& WiFiNetworkList::get(int index) const {
+    return networks[index];
+}
+
+uint8_t WiFiNetworkList::getBestPriority() const {
+    uint8_t best = 0xFF;
+    for (int i = 0; i < count; i++) {
+        best = min(best, networks[i].priority);
+    }
+    return best;
+}
+
+int WiFiNetworkList::score(int network, int rssi) const {
+    return rssi - networks[network].priority * WIFI_PRIORITY_STEP_DB;
+}
+
+int WiFiNetworkList::rank(const WiFiScanEntry* results, int resultCount, WiFiCandidate* out, int maxOut) const {
+    int found = 0;
+
+    for (int r = 0; r < resultCount; r++) {
+        const WiFiScanEntry& entry = results[r];
+        int network = find(entry.ssid);
+        if (network < 0 || entry.rssi < WIFI_MIN_RSSI) continue;
+
+        WiFiCandidate candidate;
+        candidate.network = network;
+        memcpy(candidate.bssid, entry.bssid, sizeof(candidate.bssid));
+        candidate.channel = entry.channel;
+        candidate.rssi = entry.rssi;
+        candidate.score = score(network, entry.rssi);
+
+        // Insertion into a short sorted list; the weakest falls off the end
+        int pos = found;
+        while (pos > 0 && out[pos - 1].score < candidate.score) pos--;
+        if (pos >= maxOut) continue;
+
+        int last = min(found, maxOut - 1);
+        for (int i = last; i > pos; i--) {
+            out[i] = out[i - 1];
+        }
+        out[pos] = candidate;
+        if (found < maxOut) found++;
+    }
+
+    return found;
+}
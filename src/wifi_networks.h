@@ -0,0 +1,71 @@
+#ifndef WIFI_NETWORKS_H
+#define WIFI_NETWORKS_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+
+struct WiFiCredential {
+    char ssid[MAX_SSID_LENGTH + 1];
+    char password[MAX_PASSWORD_LENGTH + 1];
+    uint8_t priority;           // 0 is preferred, higher is a fallback
+};
+
+struct WiFiScanEntry {
+    char ssid[MAX_SSID_LENGTH + 1];
+    uint8_t bssid[6];
+    uint8_t channel;
+    int8_t rssi;
+    uint8_t encryption;
+};
+
+// Last good link, replayed to skip the channel scan and DHCP
+struct WiFiFastConnect {
+    char ssid[MAX_SSID_LENGTH + 1];
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    int64_t leaseExpires;       // UTC seconds the cached address may be reused until
+};
+
+// A visible AP that belongs to one of the stored networks
+struct WiFiCandidate {
+    uint8_t network;            // Index into the credential list
+    uint8_t bssid[6];
+    uint8_t channel;            // 0: not seen in a scan, let the driver search
+    int8_t rssi;
+    int16_t score;
+};
+
+// Stored credentials plus the ranking of scan results against them. No
+// WiFi calls in here, so the selection can be fed canned scan results.
+class WiFiNetworkList {
+private:
+    WiFiCredential networks[WIFI_MAX_NETWORKS];
+    uint8_t count;
+
+public:
+    WiFiNetworkList();
+    // Reads the pre-ConfigStore "wifi-config" namespace, once, on migration
+    void loadLegacy(Preferences& preferences);
+
+    bool add(const char* ssid, const char* password, uint8_t priority);
+    bool remove(const char* ssid);
+    void clear();
+    int find(const char* ssid) const;
+    int getCount() const;
+    const WiFiCredential& get(int index) const;
+    uint8_t getBestPriority() const;
+
+    // RSSI minus WIFI_PRIORITY_STEP_DB per priority level: a backup network
+    // wins only when it is that much stronger than the preferred one
+    int score(int network, int rssi) const;
+
+    // Fills out[] best first; returns the number of candidates
+    int rank(const WiFiScanEntry* results, int resultCount, WiFiCandidate* out, int maxOut) const;
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef HOST_ADAFRUIT_I2C_DEVICE_H
+#define HOST_ADAFRUIT_I2C_DEVICE_H
+
+#include "Wire.h"
+
+// Adafruit BusIO I2C device; every write lands in HostBoard::i2cWrite(),
+// which feeds the SH1106 emulator when the address matches
+class Adafruit_I2CDevice {
+private:
+    uint8_t deviceAddress;
+    TwoWire* wire;
+
+public:
+    Adafruit_I2CDevice(uint8_t addr, TwoWire* theWire = &Wire) : deviceAddress(addr), wire(theWire) {}
+    bool begin(bool addrDetect = true);
+    bool detected();
+    uint8_t address() { return deviceAddress; }
+    bool write(const uint8_t* buffer, size_t len, bool stop = true, const uint8_t* prefixBuffer = nullptr,
+               size_t prefixLen = 0);
+    bool setSpeed(uint32_t desiredClock) {
+        wire->setClock(desiredClock);
+        return true;
+    }
+    size_t maxBufferSize() { return 128; }   // ESP32 core I2C_BUFFER_LENGTH
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef HOST_ADAFRUIT_SPI_DEVICE_H
+#define HOST_ADAFRUIT_SPI_DEVICE_H
+
+#include "SPI.h"
+
+typedef enum { SPI_BITORDER_MSBFIRST, SPI_BITORDER_LSBFIRST } BusIOBitOrder;
+
+// The panel is wired over I2C; the SPI constructors only need to compile
+class Adafruit_SPIDevice {
+public:
+    Adafruit_SPIDevice(int8_t cs, uint32_t freq = 1000000, BusIOBitOrder order = SPI_BITORDER_MSBFIRST,
+                       uint8_t mode = SPI_MODE0, SPIClass* spi = &SPI) {}
+    Adafruit_SPIDevice(int8_t cs, int8_t sck, int8_t miso, int8_t mosi, uint32_t freq = 1000000,
+                       BusIOBitOrder order = SPI_BITORDER_MSBFIRST, uint8_t mode = SPI_MODE0) {}
+    bool begin() { return false; }
+    bool write(const uint8_t* buffer, size_t len, const uint8_t* prefixBuffer = nullptr, size_t prefixLen = 0) {
+        return false;
+    }
+};
+
+#endif
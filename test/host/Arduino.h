@@ -0,0 +1,114 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Arduino-ESP32 core API for the native test build. Only what the
+// firmware and the Adafruit drawing code use is declared; behaviour that
+// tests need to steer (clock, pins, heap figures, serial input) is driven
+// through HostBoard in host_board.h.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+#include <algorithm>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "esp_timer.h"
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+#include "IPAddress.h"
+
+using std::min;
+using std::max;
+
+#define IRAM_ATTR
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr) (*(void* const*)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define digitalPinToInterrupt(pin) (pin)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+long random(long max);
+long random(long min, long max);
+
+template <class T, class L, class H>
+auto constrain(T x, L low, H high) -> decltype(x < low ? low : (x > high ? high : x)) {
+    return x < low ? low : (x > high ? high : x);
+}
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+char* dtostrf(double value, signed char width, unsigned char precision, char* out);
+
+// glibc only has these since 2.38; macOS always had them
+#if defined(__GLIBC__)
+#if !__GLIBC_PREREQ(2, 38)
+#define HOST_NEEDS_STRLCPY 1
+size_t strlcpy(char* dst, const char* src, size_t size);
+size_t strlcat(char* dst, const char* src, size_t size);
+#endif
+#endif
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1,
+                const char* server2 = nullptr, const char* server3 = nullptr);
+bool getLocalTime(struct tm* info, uint32_t ms = 5000);
+
+class EspClass {
+public:
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint32_t getHeapSize();
+    uint32_t getPsramSize();
+    uint32_t getFreePsram();
+    uint32_t getCpuFreqMHz();
+    uint32_t getCycleCount();
+    uint64_t getEfuseMac();
+    void restart();
+};
+
+extern EspClass ESP;
+
+#endif
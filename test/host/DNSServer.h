@@ -0,0 +1,29 @@
+#ifndef HOST_DNS_SERVER_H
+#define HOST_DNS_SERVER_H
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+enum class DNSReplyCode { NoError = 0, ServerFailure = 2, NonExistentDomain = 3 };
+
+class DNSServer {
+private:
+    bool running;
+
+public:
+    uint32_t requestsProcessed;
+
+    DNSServer() : running(false), requestsProcessed(0) {}
+    void setErrorReplyCode(DNSReplyCode code) {}
+    bool start(uint16_t port, const String& domain, const IPAddress& ip) {
+        running = true;
+        return true;
+    }
+    void stop() { running = false; }
+    void processNextRequest() {
+        if (running) requestsProcessed++;
+    }
+    bool isRunning() const { return running; }
+};
+
+#endif
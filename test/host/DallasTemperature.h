@@ -0,0 +1,24 @@
+#ifndef HOST_DALLAS_TEMPERATURE_H
+#define HOST_DALLAS_TEMPERATURE_H
+
+#include "OneWire.h"
+
+#define DEVICE_DISCONNECTED_C -127
+
+// The probe reads board.temperature; requestTemperatures() takes
+// board.conversionMillis of host time, like a blocking 12-bit conversion
+class DallasTemperature {
+private:
+    bool waitForConversion;
+
+public:
+    explicit DallasTemperature(OneWire* wire) : waitForConversion(true) {}
+    void begin() {}
+    void setResolution(uint8_t bits) {}
+    void setWaitForConversion(bool wait) { waitForConversion = wait; }
+    bool isConversionComplete() { return true; }
+    void requestTemperatures();
+    float getTempCByIndex(uint8_t index);
+};
+
+#endif
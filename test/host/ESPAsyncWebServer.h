@@ -0,0 +1,197 @@
+#ifndef HOST_ESP_ASYNC_WEB_SERVER_H
+#define HOST_ESP_ASYNC_WEB_SERVER_H
+
+#include "Arduino.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ESPAsyncWebServer as the firmware uses it, plus AsyncWebServer::handle()
+// so a test can run a request through the registered routes and filters
+// and read back what a client would have received.
+
+typedef enum {
+    HTTP_GET = 0b00000001,
+    HTTP_POST = 0b00000010,
+    HTTP_DELETE = 0b00000100,
+    HTTP_PUT = 0b00001000,
+    HTTP_PATCH = 0b00010000,
+    HTTP_HEAD = 0b00100000,
+    HTTP_OPTIONS = 0b01000000,
+    HTTP_ANY = 0b01111111
+} WebRequestMethod;
+
+#define RESPONSE_TRY_AGAIN 0xFFFFFFFF
+
+typedef std::function<size_t(uint8_t* buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+
+class AsyncWebServerRequest;
+typedef std::function<void(AsyncWebServerRequest* request)> ArRequestHandlerFunction;
+typedef std::function<bool(AsyncWebServerRequest* request)> ArRequestFilterFunction;
+
+bool ON_AP_FILTER(AsyncWebServerRequest* request);
+bool ON_STA_FILTER(AsyncWebServerRequest* request);
+
+class AsyncWebParameter {
+private:
+    String paramName;
+    String paramValue;
+    bool post;
+
+public:
+    AsyncWebParameter(const char* name, const char* value, bool isPost)
+        : paramName(name), paramValue(value), post(isPost) {}
+    const String& name() const { return paramName; }
+    const String& value() const { return paramValue; }
+    bool isPost() const { return post; }
+};
+
+class AsyncWebServerResponse {
+public:
+    int code;
+    std::string contentType;
+    std::string content;
+    AwsResponseFiller filler;
+    std::vector<std::pair<std::string, std::string>> headers;
+
+    AsyncWebServerResponse(int status, const char* type) : code(status), contentType(type) {}
+    void addHeader(const char* name, const char* value) { headers.emplace_back(name, value); }
+    const char* getHeader(const char* name) const;
+};
+
+class AsyncWebServerRequest {
+private:
+    WebRequestMethod requestMethod;
+    std::string requestURL;
+    std::vector<AsyncWebParameter> params;
+    bool fromAP;
+
+public:
+    AsyncWebServerResponse* response;
+
+    AsyncWebServerRequest(WebRequestMethod method, const char* url, bool viaAP);
+    ~AsyncWebServerRequest();
+    void addParam(const char* name, const char* value, bool post) { params.emplace_back(name, value, post); }
+
+    WebRequestMethod method() const { return requestMethod; }
+    const char* url() const { return requestURL.c_str(); }
+    bool isFromAP() const { return fromAP; }
+
+    bool hasParam(const char* name, bool post = false) const;
+    const AsyncWebParameter* getParam(const char* name, bool post = false) const;
+
+    AsyncWebServerResponse* beginResponse(int code, const char* contentType, const uint8_t* content, size_t length);
+    AsyncWebServerResponse* beginResponse(int code, const char* contentType, const String& content);
+    AsyncWebServerResponse* beginChunkedResponse(const char* contentType, AwsResponseFiller filler);
+    void send(AsyncWebServerResponse* reply);
+    void send(int code, const char* contentType = "", const char* content = "");
+    void send(int code, const char* contentType, const String& content) { send(code, contentType, content.c_str()); }
+    void redirect(const char* url);
+};
+
+class AsyncWebHandler {
+protected:
+    ArRequestFilterFunction filter;
+
+public:
+    virtual ~AsyncWebHandler() {}
+    AsyncWebHandler& setFilter(ArRequestFilterFunction fn) {
+        filter = fn;
+        return *this;
+    }
+    bool filterAccepts(AsyncWebServerRequest* request) const { return !filter || filter(request); }
+};
+
+class AsyncCallbackWebHandler : public AsyncWebHandler {
+public:
+    std::string uri;
+    int methods;
+    ArRequestHandlerFunction handler;
+};
+
+// ==================== WEBSOCKET ====================
+typedef std::shared_ptr<std::vector<uint8_t>> AsyncWebSocketSharedBuffer;
+
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+
+class AsyncWebSocket;
+
+class AsyncWebSocketClient {
+private:
+    AsyncWebSocket* server;
+
+public:
+    bool open;
+    uint32_t framesReceived;
+    size_t bytesReceived;
+    bool queueFull;             // Host: next text() is refused
+
+    explicit AsyncWebSocketClient(AsyncWebSocket* owner)
+        : server(owner), open(true), framesReceived(0), bytesReceived(0), queueFull(false) {}
+    void close() { open = false; }
+    bool text(AsyncWebSocketSharedBuffer buffer);
+};
+
+typedef std::function<void(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type, void* arg,
+                           uint8_t* data, size_t length)> AwsEventHandler;
+
+class AsyncWebSocket : public AsyncWebHandler {
+private:
+    std::string uri;
+    AwsEventHandler handler;
+    std::vector<std::unique_ptr<AsyncWebSocketClient>> clients;
+
+public:
+    enum SendStatus { DISCARDED = 0, ENQUEUED = 1, PARTIALLY_ENQUEUED = 2 };
+
+    explicit AsyncWebSocket(const char* url) : uri(url) {}
+    void onEvent(AwsEventHandler callback) { handler = callback; }
+    size_t count() const;
+    void cleanupClients(uint16_t maxClients = 8);
+    SendStatus textAll(AsyncWebSocketSharedBuffer buffer);
+
+    // Host side
+    AsyncWebSocketClient* connect();
+    void disconnect(AsyncWebSocketClient* client);
+};
+
+// ==================== SERVER ====================
+struct HostResponse {
+    int code;
+    std::string contentType;
+    std::string body;
+    std::vector<std::pair<std::string, std::string>> headers;
+    uint32_t chunks;            // Filler calls for a chunked response
+
+    const char* header(const char* name) const;
+};
+
+struct HostParam {
+    const char* name;
+    const char* value;
+    bool post;
+};
+
+class AsyncWebServer {
+private:
+    std::vector<std::unique_ptr<AsyncCallbackWebHandler>> routes;
+    std::vector<AsyncWebHandler*> handlers;
+    ArRequestHandlerFunction notFound;
+    bool started;
+
+public:
+    explicit AsyncWebServer(uint16_t port) : started(false) {}
+    void begin() { started = true; }
+    void end() { started = false; }
+    AsyncWebHandler& on(const char* uri, int method, ArRequestHandlerFunction handler);
+    AsyncWebHandler& addHandler(AsyncWebHandler* handler);
+    void onNotFound(ArRequestHandlerFunction handler) { notFound = handler; }
+
+    // Host side: chunked fillers are drained chunkSize bytes at a time,
+    // like a TCP window that never fills up
+    HostResponse handle(WebRequestMethod method, const char* url, std::initializer_list<HostParam> params = {},
+                        bool fromAP = false, size_t chunkSize = 1436);
+};
+
+#endif
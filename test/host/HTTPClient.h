@@ -0,0 +1,37 @@
+#ifndef HOST_HTTP_CLIENT_H
+#define HOST_HTTP_CLIENT_H
+
+#include "Arduino.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+// Answers every request with HostHttp's scripted status and body
+struct HostHttp {
+    int status;
+    const char* body;
+    uint32_t latencyMs;         // Host time a request takes
+    uint32_t requests;
+    char lastURL[128];
+    String lastPayload;
+};
+
+extern HostHttp hostHttp;
+
+class HTTPClient {
+public:
+    bool begin(const String& url);
+    bool begin(const char* url);
+    void end() {}
+    void addHeader(const String& name, const String& value) {}
+    void setTimeout(uint16_t timeout) {}
+    void setConnectTimeout(int32_t timeout) {}
+    void setReuse(bool reuse) {}
+    int GET();
+    int POST(const String& payload);
+    int POST(uint8_t* payload, size_t size);
+    String getString();
+    static String errorToString(int error);
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef HOST_HARDWARE_SERIAL_H
+#define HOST_HARDWARE_SERIAL_H
+
+#include "Stream.h"
+
+#define SERIAL_8N1 0x800001c
+#define HOST_SERIAL_BUFFER 4096
+#define HOST_SERIAL_PORTS 3
+
+class HardwareSerial;
+
+// Called from flush() with everything written since the previous flush,
+// so a test can play the device on the other end of a half-duplex bus
+typedef void (*HostSerialResponder)(HardwareSerial& port, const uint8_t* sent, size_t length, void* context);
+
+// UART with fixed rings on both sides, so a test can feed input, collect
+// output and count allocations without the port adding any
+class HardwareSerial : public Stream {
+private:
+    uint8_t rx[HOST_SERIAL_BUFFER];
+    size_t rxHead;
+    size_t rxTail;
+    uint8_t tx[HOST_SERIAL_BUFFER];
+    size_t txLength;
+    size_t txFlushed;
+    HostSerialResponder responder;
+    void* responderContext;
+
+public:
+    explicit HardwareSerial(int uart);
+    ~HardwareSerial();
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+    void end() {}
+    void setRxFIFOFull(uint8_t bytes) {}
+    void setTxTimeoutMs(uint32_t ms) {}
+    operator bool() const { return true; }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    int availableForWrite() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    void flush() override;
+
+    // Host side
+    void inject(const uint8_t* data, size_t length);
+    void inject(const char* text);
+    const uint8_t* output() const { return tx; }
+    size_t outputLength() const { return txLength; }
+    void clearOutput();
+    void clearInput();
+    void setResponder(HostSerialResponder callback, void* context);
+};
+
+extern HardwareSerial Serial;
+
+// Port registered under a UART number, e.g. the RS485 bus on UART 1
+HardwareSerial* hostUart(int uart);
+
+#endif
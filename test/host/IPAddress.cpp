@@ -0,0 +1,53 @@
+#include "IPAddress.h"
+#include <stdio.h>
+#include <string.h>
+
+// Same byte order as the ESP32 core: first octet in the low byte
+IPAddress::IPAddress() {
+    memset(bytes, 0, sizeof(bytes));
+}
+
+IPAddress::IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    bytes[0] = a;
+    bytes[1] = b;
+    bytes[2] = c;
+    bytes[3] = d;
+}
+
+IPAddress::IPAddress(uint32_t address) {
+    memcpy(bytes, &address, sizeof(bytes));
+}
+
+IPAddress::operator uint32_t() const {
+    uint32_t address;
+    memcpy(&address, bytes, sizeof(address));
+    return address;
+}
+
+bool IPAddress::fromString(const char* text) {
+    unsigned int parts[4];
+    char tail;
+    if (!text || sscanf(text, "%u.%u.%u.%u%c", &parts[0], &parts[1], &parts[2], &parts[3], &tail) != 4) {
+        return false;
+    }
+    for (int i = 0; i < 4; i++) {
+        if (parts[i] > 255) return false;
+    }
+    for (int i = 0; i < 4; i++) bytes[i] = parts[i];
+    return true;
+}
+
+String IPAddress::toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+    return String(text);
+}
+
+size_t IPAddress::printTo(Print& p) const {
+    size_t n = 0;
+    for (int i = 0; i < 4; i++) {
+        if (i) n += p.print('.');
+        n += p.print(bytes[i], DEC);
+    }
+    return n;
+}
@@ -0,0 +1,28 @@
+#ifndef HOST_IP_ADDRESS_H
+#define HOST_IP_ADDRESS_H
+
+#include <stdint.h>
+#include "Print.h"
+
+class IPAddress : public Printable {
+private:
+    uint8_t bytes[4];
+
+public:
+    IPAddress();
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d);
+    IPAddress(uint32_t address);
+
+    operator uint32_t() const;
+    bool operator==(const IPAddress& other) const { return (uint32_t)*this == (uint32_t)other; }
+    bool operator!=(const IPAddress& other) const { return !(*this == other); }
+    uint8_t operator[](int index) const { return bytes[index]; }
+    uint8_t& operator[](int index) { return bytes[index]; }
+
+    bool fromString(const char* text);
+    bool fromString(const String& text) { return fromString(text.c_str()); }
+    String toString() const;
+    size_t printTo(Print& p) const override;
+};
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef HOST_ONE_WIRE_H
+#define HOST_ONE_WIRE_H
+
+#include "Arduino.h"
+
+class OneWire {
+private:
+    uint8_t pin;
+
+public:
+    explicit OneWire(uint8_t busPin) : pin(busPin) {}
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include "Arduino.h"
+#include "nvs.h"
+
+// Arduino Preferences over the host NVS, so legacy namespaces written by
+// a test are visible to the migration code and vice versa
+class Preferences {
+private:
+    nvs_handle_t handle;
+    bool open;
+    bool readOnly;
+
+public:
+    Preferences() : handle(0), open(false), readOnly(false) {}
+    ~Preferences() { end(); }
+
+    bool begin(const char* name, bool readOnly = false);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putBytes(const char* key, const void* value, size_t length);
+    size_t getBytes(const char* key, void* out, size_t maxLength);
+    size_t getBytesLength(const char* key);
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+    String getString(const char* key, const String& defaultValue = String());
+    size_t putInt(const char* key, int32_t value) { return putBytes(key, &value, sizeof(value)); }
+    int32_t getInt(const char* key, int32_t defaultValue = 0);
+    size_t putUInt(const char* key, uint32_t value) { return putBytes(key, &value, sizeof(value)); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+    size_t putFloat(const char* key, float value) { return putBytes(key, &value, sizeof(value)); }
+    float getFloat(const char* key, float defaultValue = 0);
+    size_t putBool(const char* key, bool value) { return putBytes(key, &value, sizeof(value)); }
+    bool getBool(const char* key, bool defaultValue = false);
+};
+
+#endif
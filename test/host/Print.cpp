@@ -0,0 +1,103 @@
+#include "Print.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (!write(*buffer++)) break;
+        n++;
+    }
+    return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char small[64];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(small, sizeof(small), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    if ((size_t)length < sizeof(small)) return write((const uint8_t*)small, length);
+
+    char* large = (char*)malloc(length + 1);
+    if (!large) return 0;
+    va_start(args, format);
+    vsnprintf(large, length + 1, format, args);
+    va_end(args);
+    size_t n = write((const uint8_t*)large, length);
+    free(large);
+    return n;
+}
+
+size_t Print::print(long value, int base) {
+    return print((long long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+    return print((unsigned long long)value, base);
+}
+
+size_t Print::print(long long value, int base) {
+    if (base == 0) return write((uint8_t)value);
+    if (base == 10 && value < 0) {
+        size_t n = print('-');
+        return n + printNumber(-(unsigned long long)value, 10);
+    }
+    return printNumber((unsigned long long)value, base);
+}
+
+size_t Print::print(unsigned long long value, int base) {
+    if (base == 0) return write((uint8_t)value);
+    return printNumber(value, base);
+}
+
+size_t Print::print(double value, int digits) {
+    return printFloat(value, digits);
+}
+
+size_t Print::printNumber(unsigned long long value, uint8_t base) {
+    char buffer[8 * sizeof(value) + 1];
+    char* p = &buffer[sizeof(buffer) - 1];
+    *p = '\0';
+    if (base < 2) base = 10;
+    do {
+        char digit = value % base;
+        *--p = digit < 10 ? digit + '0' : digit + 'A' - 10;
+        value /= base;
+    } while (value);
+    return write(p);
+}
+
+// Same rounding and digit loop as the Arduino core
+size_t Print::printFloat(double value, uint8_t digits) {
+    if (isnan(value)) return print("nan");
+    if (isinf(value)) return print("inf");
+    if (value > 4294967040.0) return print("ovf");
+    if (value < -4294967040.0) return print("ovf");
+
+    size_t n = 0;
+    if (value < 0.0) {
+        n += print('-');
+        value = -value;
+    }
+
+    double rounding = 0.5;
+    for (uint8_t i = 0; i < digits; ++i) rounding /= 10.0;
+    value += rounding;
+
+    unsigned long integer = (unsigned long)value;
+    double remainder = value - (double)integer;
+    n += print(integer);
+    if (digits > 0) n += print('.');
+
+    while (digits-- > 0) {
+        remainder *= 10.0;
+        unsigned int digit = (unsigned int)remainder;
+        n += print(digit);
+        remainder -= digit;
+    }
+    return n;
+}
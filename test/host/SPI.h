@@ -0,0 +1,15 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0
+
+class SPIClass {
+public:
+    void begin() {}
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef HOST_STREAM_H
+#define HOST_STREAM_H
+
+#include "Print.h"
+
+class Stream : public Print {
+protected:
+    unsigned long timeout;
+
+public:
+    Stream() : timeout(1000) {}
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    void setTimeout(unsigned long ms) { timeout = ms; }
+
+    // No waiting on the host: whatever is buffered is all there is
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length && available() > 0) buffer[count++] = (uint8_t)read();
+        return count;
+    }
+    size_t readBytes(char* buffer, size_t length) { return readBytes((uint8_t*)buffer, length); }
+};
+
+#endif
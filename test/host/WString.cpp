@@ -0,0 +1,320 @@
+#include "WString.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+static void formatInteger(char* out, size_t size, unsigned long long value, bool negative, unsigned char base) {
+    char digits[66];
+    int pos = sizeof(digits) - 1;
+    digits[pos] = '\0';
+    if (base < 2) base = 10;
+    do {
+        unsigned digit = value % base;
+        digits[--pos] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    } while (value);
+    if (negative) digits[--pos] = '-';
+    snprintf(out, size, "%s", digits + pos);
+}
+
+// ==================== STORAGE ====================
+bool String::grow(unsigned int size) {
+    if (buffer && capacity >= size) return true;
+    char* bigger = (char*)realloc(buffer, size + 1);
+    if (!bigger) return false;
+    if (!buffer) bigger[0] = '\0';
+    buffer = bigger;
+    capacity = size;
+    return true;
+}
+
+void String::assign(const char* text, unsigned int length) {
+    if (length == 0) {
+        if (buffer) buffer[0] = '\0';
+        len = 0;
+        return;
+    }
+    if (!grow(length)) return;
+    memmove(buffer, text, length);
+    buffer[length] = '\0';
+    len = length;
+}
+
+void String::setNumber(const char* text) {
+    assign(text, strlen(text));
+}
+
+String::String(const char* text) : buffer(nullptr), capacity(0), len(0) {
+    if (text) assign(text, strlen(text));
+}
+
+String::String(const char* text, unsigned int length) : buffer(nullptr), capacity(0), len(0) {
+    if (text) assign(text, length);
+}
+
+String::String(const __FlashStringHelper* text) : String(reinterpret_cast<const char*>(text)) {}
+
+String::String(const String& other) : buffer(nullptr), capacity(0), len(0) {
+    assign(other.c_str(), other.len);
+}
+
+String::String(String&& other) : buffer(other.buffer), capacity(other.capacity), len(other.len) {
+    other.buffer = nullptr;
+    other.capacity = 0;
+    other.len = 0;
+}
+
+String::String(char c) : buffer(nullptr), capacity(0), len(0) {
+    assign(&c, 1);
+}
+
+String::String(unsigned char value, unsigned char base) : String((unsigned long)value, base) {}
+String::String(int value, unsigned char base) : String((long)value, base) {}
+String::String(unsigned int value, unsigned char base) : String((unsigned long)value, base) {}
+
+String::String(long value, unsigned char base) : buffer(nullptr), capacity(0), len(0) {
+    char text[68];
+    bool negative = value < 0 && base == 10;
+    formatInteger(text, sizeof(text), negative ? -(unsigned long long)value : (unsigned long)value, negative, base);
+    setNumber(text);
+}
+
+String::String(unsigned long value, unsigned char base) : buffer(nullptr), capacity(0), len(0) {
+    char text[68];
+    formatInteger(text, sizeof(text), value, false, base);
+    setNumber(text);
+}
+
+String::String(long long value, unsigned char base) : buffer(nullptr), capacity(0), len(0) {
+    char text[68];
+    bool negative = value < 0 && base == 10;
+    formatInteger(text, sizeof(text), negative ? -(unsigned long long)value : (unsigned long long)value, negative, base);
+    setNumber(text);
+}
+
+String::String(unsigned long long value, unsigned char base) : buffer(nullptr), capacity(0), len(0) {
+    char text[68];
+    formatInteger(text, sizeof(text), value, false, base);
+    setNumber(text);
+}
+
+String::String(float value, unsigned int decimals) : String((double)value, decimals) {}
+
+String::String(double value, unsigned int decimals) : buffer(nullptr), capacity(0), len(0) {
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", (int)decimals, value);
+    setNumber(text);
+}
+
+String::~String() {
+    free(buffer);
+}
+
+String& String::operator=(const String& other) {
+    if (this != &other) assign(other.c_str(), other.len);
+    return *this;
+}
+
+String& String::operator=(String&& other) {
+    if (this != &other) {
+        free(buffer);
+        buffer = other.buffer;
+        capacity = other.capacity;
+        len = other.len;
+        other.buffer = nullptr;
+        other.capacity = 0;
+        other.len = 0;
+    }
+    return *this;
+}
+
+String& String::operator=(const char* text) {
+    if (text) assign(text, strlen(text)); else assign("", 0);
+    return *this;
+}
+
+bool String::reserve(unsigned int size) {
+    return grow(size);
+}
+
+// ==================== CONCATENATION ====================
+bool String::concat(const char* text, unsigned int length) {
+    if (!text) return false;
+    if (length == 0) return true;
+    if (!grow(len + length)) return false;
+    memmove(buffer + len, text, length);
+    len += length;
+    buffer[len] = '\0';
+    return true;
+}
+
+bool String::concat(const String& other) { return concat(other.c_str(), other.len); }
+bool String::concat(const char* text) { return text && concat(text, strlen(text)); }
+bool String::concat(char c) { return concat(&c, 1); }
+bool String::concat(int value) { return concat(String(value)); }
+bool String::concat(unsigned int value) { return concat(String(value)); }
+bool String::concat(long value) { return concat(String(value)); }
+bool String::concat(unsigned long value) { return concat(String(value)); }
+bool String::concat(float value) { return concat(String(value)); }
+bool String::concat(double value) { return concat(String(value)); }
+
+String operator+(const String& left, const String& right) {
+    String result(left);
+    result.concat(right);
+    return result;
+}
+
+String operator+(const String& left, const char* right) {
+    String result(left);
+    result.concat(right);
+    return result;
+}
+
+String operator+(const char* left, const String& right) {
+    String result(left);
+    result.concat(right);
+    return result;
+}
+
+String operator+(const String& left, char right) {
+    String result(left);
+    result.concat(right);
+    return result;
+}
+
+// ==================== COMPARISON ====================
+bool String::equals(const String& other) const {
+    return len == other.len && strcmp(c_str(), other.c_str()) == 0;
+}
+
+bool String::equals(const char* text) const {
+    return strcmp(c_str(), text ? text : "") == 0;
+}
+
+bool String::operator<(const String& other) const {
+    return compareTo(other) < 0;
+}
+
+int String::compareTo(const String& other) const {
+    return strcmp(c_str(), other.c_str());
+}
+
+bool String::startsWith(const String& prefix) const {
+    return prefix.len <= len && strncmp(c_str(), prefix.c_str(), prefix.len) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    return suffix.len <= len && strcmp(c_str() + len - suffix.len, suffix.c_str()) == 0;
+}
+
+// ==================== ACCESS ====================
+char String::charAt(unsigned int index) const {
+    return index < len ? buffer[index] : '\0';
+}
+
+char& String::operator[](unsigned int index) {
+    static char dummy;
+    if (index >= len) {
+        dummy = '\0';
+        return dummy;
+    }
+    return buffer[index];
+}
+
+void String::getBytes(unsigned char* out, unsigned int size, unsigned int index) const {
+    if (!size || !out) return;
+    if (index >= len) {
+        out[0] = '\0';
+        return;
+    }
+    unsigned int count = len - index < size - 1 ? len - index : size - 1;
+    memcpy(out, buffer + index, count);
+    out[count] = '\0';
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    if (from >= len) return -1;
+    const char* found = strchr(buffer + from, c);
+    return found ? found - buffer : -1;
+}
+
+int String::indexOf(const String& text, unsigned int from) const {
+    if (from >= len) return -1;
+    const char* found = strstr(buffer + from, text.c_str());
+    return found ? found - buffer : -1;
+}
+
+int String::lastIndexOf(char c) const {
+    if (!len) return -1;
+    const char* found = strrchr(buffer, c);
+    return found ? found - buffer : -1;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+        unsigned int swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from >= len) return String();
+    if (to > len) to = len;
+    return String(buffer + from, to - from);
+}
+
+// ==================== MODIFICATION ====================
+void String::remove(unsigned int index) {
+    remove(index, (unsigned int)-1);
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index >= len) return;
+    if (count > len - index) count = len - index;
+    memmove(buffer + index, buffer + index + count, len - index - count + 1);
+    len -= count;
+}
+
+void String::replace(const String& find, const String& with) {
+    if (!find.len || !len) return;
+    String result;
+    const char* start = buffer;
+    const char* found;
+    while ((found = strstr(start, find.c_str())) != nullptr) {
+        result.concat(start, found - start);
+        result.concat(with);
+        start = found + find.len;
+    }
+    result.concat(start);
+    *this = static_cast<String&&>(result);
+}
+
+void String::toLowerCase() {
+    for (unsigned int i = 0; i < len; i++) buffer[i] = tolower((unsigned char)buffer[i]);
+}
+
+void String::toUpperCase() {
+    for (unsigned int i = 0; i < len; i++) buffer[i] = toupper((unsigned char)buffer[i]);
+}
+
+void String::trim() {
+    if (!len) return;
+    unsigned int first = 0;
+    while (first < len && isspace((unsigned char)buffer[first])) first++;
+    unsigned int last = len;
+    while (last > first && isspace((unsigned char)buffer[last - 1])) last--;
+    memmove(buffer, buffer + first, last - first);
+    len = last - first;
+    buffer[len] = '\0';
+}
+
+long String::toInt() const {
+    return len ? atol(buffer) : 0;
+}
+
+float String::toFloat() const {
+    return (float)toDouble();
+}
+
+double String::toDouble() const {
+    return len ? atof(buffer) : 0;
+}
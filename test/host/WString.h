@@ -0,0 +1,110 @@
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+class __FlashStringHelper;
+
+// Arduino String without the small-string buffer of the ESP32 core: every
+// non-empty String lives on the heap, so allocation tests err on the
+// strict side.
+class String {
+private:
+    char* buffer;
+    unsigned int capacity;
+    unsigned int len;
+
+    bool grow(unsigned int size);
+    void assign(const char* text, unsigned int length);
+    void setNumber(const char* text);
+
+public:
+    String(const char* text = "");
+    String(const char* text, unsigned int length);
+    String(const __FlashStringHelper* text);
+    String(const String& other);
+    String(String&& other);
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimals = 2);
+    explicit String(double value, unsigned int decimals = 2);
+    ~String();
+
+    String& operator=(const String& other);
+    String& operator=(String&& other);
+    String& operator=(const char* text);
+
+    bool reserve(unsigned int size);
+    unsigned int length() const { return len; }
+    bool isEmpty() const { return len == 0; }
+    const char* c_str() const { return buffer ? buffer : ""; }
+    char* begin() { return buffer; }
+    char* end() { return buffer ? buffer + len : nullptr; }
+
+    bool concat(const String& other);
+    bool concat(const char* text);
+    bool concat(const char* text, unsigned int length);
+    bool concat(char c);
+    bool concat(int value);
+    bool concat(unsigned int value);
+    bool concat(long value);
+    bool concat(unsigned long value);
+    bool concat(float value);
+    bool concat(double value);
+
+    template <typename T>
+    String& operator+=(const T& value) {
+        concat(value);
+        return *this;
+    }
+
+    bool equals(const String& other) const;
+    bool equals(const char* text) const;
+    bool operator==(const String& other) const { return equals(other); }
+    bool operator==(const char* text) const { return equals(text); }
+    bool operator!=(const String& other) const { return !equals(other); }
+    bool operator!=(const char* text) const { return !equals(text); }
+    bool operator<(const String& other) const;
+    int compareTo(const String& other) const;
+    bool startsWith(const String& prefix) const;
+    bool endsWith(const String& suffix) const;
+
+    char charAt(unsigned int index) const;
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index);
+    void getBytes(unsigned char* out, unsigned int size, unsigned int index = 0) const;
+    void toCharArray(char* out, unsigned int size, unsigned int index = 0) const {
+        getBytes((unsigned char*)out, size, index);
+    }
+
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String& text, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    String substring(unsigned int from) const { return substring(from, len); }
+    String substring(unsigned int from, unsigned int to) const;
+
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void replace(const String& find, const String& with);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+};
+
+String operator+(const String& left, const String& right);
+String operator+(const String& left, const char* right);
+String operator+(const char* left, const String& right);
+String operator+(const String& left, char right);
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+typedef enum {
+    ARDUINO_EVENT_WIFI_READY = 0,
+    ARDUINO_EVENT_WIFI_SCAN_DONE,
+    ARDUINO_EVENT_WIFI_STA_START,
+    ARDUINO_EVENT_WIFI_STA_STOP,
+    ARDUINO_EVENT_WIFI_STA_CONNECTED,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+    ARDUINO_EVENT_WIFI_STA_AUTHMODE_CHANGE,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP6,
+    ARDUINO_EVENT_WIFI_STA_LOST_IP,
+    ARDUINO_EVENT_WIFI_AP_START,
+    ARDUINO_EVENT_WIFI_AP_STOP,
+    ARDUINO_EVENT_WIFI_AP_STACONNECTED,
+    ARDUINO_EVENT_WIFI_AP_STADISCONNECTED,
+    ARDUINO_EVENT_MAX
+} arduino_event_id_t;
+
+typedef arduino_event_id_t WiFiEvent_t;
+
+typedef struct {
+    uint8_t ssid[33];
+    uint8_t ssid_len;
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t authmode;
+} wifi_event_sta_connected_t;
+
+typedef struct {
+    uint8_t ssid[33];
+    uint8_t ssid_len;
+    uint8_t bssid[6];
+    uint8_t reason;
+    int8_t rssi;
+} wifi_event_sta_disconnected_t;
+
+typedef struct {
+    uint32_t addr;
+} esp_ip4_addr_t;
+
+typedef struct {
+    esp_ip4_addr_t ip;
+    esp_ip4_addr_t netmask;
+    esp_ip4_addr_t gw;
+} esp_netif_ip_info_t;
+
+typedef struct {
+    int if_index;
+    void* esp_netif;
+    esp_netif_ip_info_t ip_info;
+    bool ip_changed;
+} ip_event_got_ip_t;
+
+typedef union {
+    wifi_event_sta_connected_t wifi_sta_connected;
+    wifi_event_sta_disconnected_t wifi_sta_disconnected;
+    ip_event_got_ip_t got_ip;
+} arduino_event_info_t;
+
+typedef arduino_event_info_t WiFiEventInfo_t;
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+
+typedef enum {
+    WIFI_AUTH_OPEN = 0,
+    WIFI_AUTH_WEP,
+    WIFI_AUTH_WPA_PSK,
+    WIFI_AUTH_WPA2_PSK,
+    WIFI_AUTH_WPA_WPA2_PSK,
+    WIFI_AUTH_WPA2_ENTERPRISE,
+    WIFI_AUTH_WPA3_PSK,
+    WIFI_AUTH_WPA2_WPA3_PSK
+} wifi_auth_mode_t;
+
+typedef void (*WiFiEventFuncCb)(arduino_event_id_t event, arduino_event_info_t info);
+typedef size_t wifi_event_id_t;
+
+#define HOST_WIFI_MAX_SCAN 20
+#define HOST_WIFI_MAX_HANDLERS 4
+
+struct HostAccessPoint {
+    char ssid[33];
+    int8_t rssi;
+    uint8_t bssid[6];
+    int32_t channel;
+    wifi_auth_mode_t auth;
+};
+
+// Scriptable radio. Nothing happens by itself: begin() and scanNetworks()
+// only record the call, and a test answers with emit() / finishScan() at
+// the host time of its choosing, the way the driver's event task would.
+class WiFiClass {
+private:
+    WiFiEventFuncCb handlers[HOST_WIFI_MAX_HANDLERS];
+    uint8_t handlerCount;
+    int16_t scanState;          // WIFI_SCAN_RUNNING, WIFI_SCAN_FAILED or a result count
+    uint8_t bssid[6];
+
+public:
+    // Scripted environment
+    HostAccessPoint air[HOST_WIFI_MAX_SCAN];
+    uint8_t airCount;
+    IPAddress leaseIP;          // Handed out on GOT_IP by connect()
+    IPAddress leaseGateway;
+    IPAddress leaseSubnet;
+    IPAddress leaseDNS;
+    int8_t linkRSSI;
+
+    // What the firmware asked for
+    wifi_mode_t currentMode;
+    bool connected;
+    bool apRunning;
+    char apSSID[33];
+    char lastSSID[33];
+    char lastPassword[65];
+    int32_t lastChannel;
+    bool lastHadBSSID;
+    uint8_t lastBSSID[6];
+    uint32_t beginCount;
+    uint32_t disconnectCount;
+    uint32_t scanCount;
+    uint8_t lastScanChannel;    // 0 for all channels
+    bool staticConfig;
+    IPAddress staticIP;
+
+    WiFiClass();
+    void reset();
+
+    // Host side
+    void addAccessPoint(const char* ssid, int8_t rssi, int32_t channel, wifi_auth_mode_t auth = WIFI_AUTH_WPA2_PSK);
+    void emit(arduino_event_id_t event, const arduino_event_info_t* info = nullptr);
+    void emitDisconnected(uint8_t reason);
+    void connect();             // STA_CONNECTED then GOT_IP for the last begin()
+    void finishScan();          // Scan results become readable, SCAN_DONE fires
+
+    // Arduino API
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr, int32_t channel = 0,
+                      const uint8_t* bssid = nullptr, bool connect = true);
+    bool config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns1 = IPAddress(),
+                IPAddress dns2 = IPAddress());
+    bool disconnect(bool wifiOff = false, bool eraseAP = false);
+    wl_status_t status();
+    bool isConnected();
+    bool mode(wifi_mode_t mode);
+    wifi_mode_t getMode() { return currentMode; }
+    bool persistent(bool persistent) { return true; }
+    bool setAutoReconnect(bool autoReconnect) { return true; }
+    bool setSleep(bool enabled) { return true; }
+    bool setHostname(const char* hostname) { return true; }
+    wifi_event_id_t onEvent(WiFiEventFuncCb callback, arduino_event_id_t event = ARDUINO_EVENT_MAX);
+    void removeEvent(wifi_event_id_t id);
+
+    bool softAP(const char* ssid, const char* passphrase = nullptr, int channel = 1, int hidden = 0,
+                int maxConnections = 4);
+    bool softAPdisconnect(bool wifiOff = false);
+    IPAddress softAPIP();
+
+    IPAddress localIP();
+    IPAddress gatewayIP();
+    IPAddress subnetMask();
+    IPAddress dnsIP(uint8_t index = 0);
+    String SSID();
+    int8_t RSSI();
+    uint8_t* BSSID();
+    int32_t channel();
+
+    int16_t scanNetworks(bool async = false, bool showHidden = false, bool passive = false,
+                         uint32_t maxMsPerChannel = 300, uint8_t channel = 0, const char* ssid = nullptr,
+                         const uint8_t* bssid = nullptr);
+    int16_t scanComplete();
+    void scanDelete();
+    String SSID(uint8_t index);
+    int8_t RSSI(uint8_t index);
+    uint8_t* BSSID(uint8_t index);
+    int32_t channel(uint8_t index);
+    wifi_auth_mode_t encryptionType(uint8_t index);
+};
+
+extern WiFiClass WiFi;
+
+#endif
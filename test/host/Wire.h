@@ -0,0 +1,24 @@
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+
+// Only what the display path needs; transfers go through
+// Adafruit_I2CDevice, which talks to HostBoard directly
+class TwoWire {
+private:
+    uint32_t frequency;
+
+public:
+    TwoWire() : frequency(100000) {}
+    bool begin(int sda = -1, int scl = -1, uint32_t clock = 0) {
+        if (clock) frequency = clock;
+        return true;
+    }
+    void setClock(uint32_t clock) { frequency = clock; }
+    uint32_t getClock() const { return frequency; }
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,8 @@
+// The real Adafruit drawing and SH110X driver code, built for the host so
+// snapshot tests see exactly the bytes the panel would. Adafruit_SPITFT is
+// left out: it is all hardware SPI/parallel and the panel is on I2C.
+// Adafruit_SH1106G.cpp has its own translation unit, adafruit_sh1106g.cpp,
+// because both driver files define the splash bitmaps.
+#include "Adafruit_GFX.cpp"
+#include "Adafruit_GrayOLED.cpp"
+#include "Adafruit_SH110X.cpp"
@@ -0,0 +1,2 @@
+// See adafruit_display.cpp
+#include "Adafruit_SH1106G.cpp"
@@ -0,0 +1,42 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+// FreeRTOS types and macros for the native test build. Ticks are
+// milliseconds of the HostBoard clock; critical sections are no-ops
+// because host tests run on a single thread.
+
+#include <stdint.h>
+
+typedef void* TaskHandle_t;
+typedef void* QueueHandle_t;
+typedef void* EventGroupHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t EventBits_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xffffffffUL
+#define portTICK_PERIOD_MS 1
+#define configTICK_RATE_HZ 1000
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portYIELD_FROM_ISR(woken) (void)(woken)
+#define tskNO_AFFINITY 0x7fffffff
+
+typedef struct {
+    uint32_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0, 0}
+#define portENTER_CRITICAL(mux) (void)(mux)
+#define portEXIT_CRITICAL(mux) (void)(mux)
+#define portENTER_CRITICAL_ISR(mux) (void)(mux)
+#define portEXIT_CRITICAL_ISR(mux) (void)(mux)
+
+inline BaseType_t xPortGetCoreID() { return 0; }
+
+#endif
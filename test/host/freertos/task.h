@@ -0,0 +1,45 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void*);
+
+typedef enum { eRunning, eReady, eBlocked, eSuspended, eDeleted, eInvalid } eTaskState;
+
+typedef struct {
+    TaskHandle_t xHandle;
+    const char* pcTaskName;
+    UBaseType_t xTaskNumber;
+    eTaskState eCurrentState;
+    UBaseType_t uxCurrentPriority;
+    UBaseType_t uxBasePriority;
+    uint32_t ulRunTimeCounter;
+    void* pxStackBase;
+    uint32_t usStackHighWaterMark;
+    BaseType_t xCoreID;
+} TaskStatus_t;
+
+// Tasks are registered but never run: a test drives the work a task would
+// do by calling into the module directly
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth, void* params,
+                       UBaseType_t priority, TaskHandle_t* created);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth, void* params,
+                                   UBaseType_t priority, TaskHandle_t* created, BaseType_t core);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+TaskHandle_t xTaskGetHandle(const char* name);
+const char* pcTaskGetName(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+UBaseType_t uxTaskGetNumberOfTasks();
+UBaseType_t uxTaskGetSystemState(TaskStatus_t* status, UBaseType_t size, uint32_t* totalRunTime);
+
+// Notifications: taking one with none pending advances the host clock by
+// the timeout, which is how a sleeping loop moves virtual time forward
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken);
+
+#endif
@@ -0,0 +1,703 @@
+#include "host_board.h"
+#include <new>
+#include "Wire.h"
+#include "SPI.h"
+#include "Adafruit_I2CDevice.h"
+#include "DallasTemperature.h"
+#include "Preferences.h"
+#include "nvs.h"
+
+HostBoard board;
+EspClass ESP;
+HardwareSerial Serial(0);
+TwoWire Wire;
+SPIClass SPI;
+
+static HardwareSerial* uarts[HOST_SERIAL_PORTS];
+
+// ==================== BOARD ====================
+HostBoard::HostBoard() {
+    nvsFormat();
+    reset();
+}
+
+void HostBoard::reset() {
+    nowMicros = 0;
+    memset(pinLevel, HIGH, sizeof(pinLevel));   // Buttons idle high on their pull-ups
+    memset(isr, 0, sizeof(isr));
+    memset(isrArg, 0, sizeof(isrArg));
+    memset(plainIsr, 0, sizeof(plainIsr));
+    memset(isrMode, 0, sizeof(isrMode));
+
+    heapSize = 327680;
+    freeHeap = 262144;
+    minFreeHeap = freeHeap;
+    maxAllocHeap = 110592;
+
+    temperature = 25.0f;
+    conversionMillis = 750;
+    temperatureRequests = 0;
+    panel.reset();
+    panel.resetStats();
+    panelAddress = 0x3C;
+    panelPresent = true;
+    i2cWrites = 0;
+
+    wallOffsetMicros = 0;
+    wallClockSet = false;
+    sntpCallback = nullptr;
+    sntpRestarts = 0;
+
+    memset(tasks, 0, sizeof(tasks));
+    strcpy(tasks[0].name, "loopTask");
+    tasks[0].alive = true;
+    tasks[0].stackDepth = 8192;
+    taskCount = 1;
+    currentTask = 0;
+    restarts = 0;
+
+    nvsCommits = 0;
+    nvsFailWrites = false;
+}
+
+void HostBoard::setPin(uint8_t pin, uint8_t level) {
+    if (pin >= HOST_PINS) return;
+    uint8_t previous = pinLevel[pin];
+    pinLevel[pin] = level ? HIGH : LOW;
+    if (previous == pinLevel[pin]) return;
+
+    bool fire = isrMode[pin] == CHANGE ||
+                (isrMode[pin] == RISING && level) ||
+                (isrMode[pin] == FALLING && !level);
+    if (!fire) return;
+    if (isr[pin]) {
+        isr[pin](isrArg[pin]);
+    } else if (plainIsr[pin]) {
+        plainIsr[pin]();
+    }
+}
+
+void HostBoard::attach(uint8_t pin, void (*handler)(), HostIsr handlerArg, void* arg, uint8_t mode) {
+    if (pin >= HOST_PINS) return;
+    plainIsr[pin] = handler;
+    isr[pin] = handlerArg;
+    isrArg[pin] = arg;
+    isrMode[pin] = mode;
+}
+
+void HostBoard::detach(uint8_t pin) {
+    attach(pin, nullptr, nullptr, nullptr, 0);
+}
+
+void HostBoard::sntpSync(time_t epochSeconds, uint32_t fractionMicros) {
+    int64_t wall = (int64_t)epochSeconds * 1000000 + fractionMicros;
+    wallOffsetMicros = wall - (int64_t)nowMicros;
+    wallClockSet = true;
+    if (sntpCallback) {
+        struct timeval tv = {epochSeconds, (suseconds_t)fractionMicros};
+        sntpCallback(&tv);
+    }
+}
+
+HostTask* HostBoard::findTask(const char* name) {
+    for (uint8_t i = 0; i < taskCount; i++) {
+        if (tasks[i].alive && strcmp(tasks[i].name, name) == 0) return &tasks[i];
+    }
+    return nullptr;
+}
+
+HostTask* HostBoard::findTask(TaskHandle_t handle) {
+    HostTask* task = (HostTask*)handle;
+    if (task < tasks || task >= tasks + taskCount) return nullptr;
+    return task;
+}
+
+bool HostBoard::i2cWrite(uint8_t address, const uint8_t* buffer, size_t length, const uint8_t* prefix,
+                         size_t prefixLength) {
+    i2cWrites++;
+    if (address != panelAddress || !panelPresent) return false;
+    panel.write(buffer, length, prefix, prefixLength);
+    return true;
+}
+
+// ==================== FLASH ====================
+void HostBoard::nvsFormat() {
+    memset(nvs, 0, sizeof(nvs));
+    memset(nvsNamespaces, 0, sizeof(nvsNamespaces));
+    nvsNamespaceCount = 0;
+}
+
+int HostBoard::nvsNamespace(const char* name, bool create) {
+    for (uint8_t i = 0; i < nvsNamespaceCount; i++) {
+        if (strcmp(nvsNamespaces[i], name) == 0) return i;
+    }
+    if (!create || nvsNamespaceCount >= HOST_NVS_NAMESPACES || strlen(name) >= HOST_NVS_KEY) return -1;
+    strcpy(nvsNamespaces[nvsNamespaceCount], name);
+    return nvsNamespaceCount++;
+}
+
+HostNvsEntry* HostBoard::nvsFind(uint8_t space, const char* key) {
+    for (int i = 0; i < HOST_NVS_ENTRIES; i++) {
+        if (nvs[i].used && nvs[i].space == space && strcmp(nvs[i].key, key) == 0) return &nvs[i];
+    }
+    return nullptr;
+}
+
+HostNvsEntry* HostBoard::nvsPut(uint8_t space, const char* key, const void* value, size_t length) {
+    if (nvsFailWrites || length > HOST_NVS_VALUE || strlen(key) >= HOST_NVS_KEY) return nullptr;
+    HostNvsEntry* entry = nvsFind(space, key);
+    for (int i = 0; !entry && i < HOST_NVS_ENTRIES; i++) {
+        if (!nvs[i].used) entry = &nvs[i];
+    }
+    if (!entry) return nullptr;
+    entry->used = true;
+    entry->space = space;
+    strcpy(entry->key, key);
+    memcpy(entry->value, value, length);
+    entry->length = length;
+    return entry;
+}
+
+void HostBoard::nvsErase(uint8_t space) {
+    for (int i = 0; i < HOST_NVS_ENTRIES; i++) {
+        if (nvs[i].used && nvs[i].space == space) nvs[i].used = false;
+    }
+}
+
+uint32_t HostBoard::nvsUsedEntries() const {
+    uint32_t used = 0;
+    for (int i = 0; i < HOST_NVS_ENTRIES; i++) {
+        if (nvs[i].used) used++;
+    }
+    return used;
+}
+
+// ==================== ARDUINO CORE ====================
+unsigned long millis() {
+    return (unsigned long)(uint32_t)(board.micros() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)(uint32_t)board.micros();
+}
+
+void delay(uint32_t ms) {
+    board.advanceMillis(ms);
+}
+
+void delayMicroseconds(uint32_t us) {
+    board.advance(us);
+}
+
+void yield() {}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    board.setPin(pin, value);
+}
+
+int digitalRead(uint8_t pin) {
+    return board.getPin(pin);
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {
+    board.attach(pin, handler, nullptr, nullptr, mode);
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+    board.attach(pin, nullptr, handler, arg, mode);
+}
+
+void detachInterrupt(uint8_t pin) {
+    board.detach(pin);
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    if (inMax == inMin) return outMin;
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+long random(long max) {
+    return max > 0 ? rand() % max : 0;
+}
+
+long random(long min, long max) {
+    return max > min ? min + random(max - min) : min;
+}
+
+char* dtostrf(double value, signed char width, unsigned char precision, char* out) {
+    sprintf(out, "%*.*f", width, precision, value);
+    return out;
+}
+
+#ifdef HOST_NEEDS_STRLCPY
+size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t length = strlen(src);
+    if (size) {
+        size_t copy = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, copy);
+        dst[copy] = '\0';
+    }
+    return length;
+}
+
+size_t strlcat(char* dst, const char* src, size_t size) {
+    size_t used = strnlen(dst, size);
+    if (used == size) return size + strlen(src);
+    return used + strlcpy(dst + used, src, size - used);
+}
+#endif
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1, const char* server2,
+                const char* server3) {}
+
+bool getLocalTime(struct tm* info, uint32_t ms) {
+    if (!board.wallClockSet) {
+        board.advanceMillis(ms);
+        return false;
+    }
+    time_t now = (time_t)(((int64_t)board.micros() + board.wallOffsetMicros) / 1000000);
+    gmtime_r(&now, info);
+    return true;
+}
+
+uint32_t EspClass::getFreeHeap() { return board.freeHeap; }
+uint32_t EspClass::getMinFreeHeap() { return board.minFreeHeap; }
+uint32_t EspClass::getMaxAllocHeap() { return board.maxAllocHeap; }
+uint32_t EspClass::getHeapSize() { return board.heapSize; }
+uint32_t EspClass::getPsramSize() { return 0; }
+uint32_t EspClass::getFreePsram() { return 0; }
+uint32_t EspClass::getCpuFreqMHz() { return 240; }
+uint32_t EspClass::getCycleCount() { return (uint32_t)(board.micros() * 240); }
+uint64_t EspClass::getEfuseMac() { return 0x0000A1B2C3D4E5F6ULL; }
+void EspClass::restart() { board.restarts++; }
+
+// ==================== SERIAL ====================
+HardwareSerial::HardwareSerial(int uart)
+    : rxHead(0), rxTail(0), txLength(0), txFlushed(0), responder(nullptr), responderContext(nullptr) {
+    if (uart >= 0 && uart < HOST_SERIAL_PORTS) uarts[uart] = this;
+}
+
+HardwareSerial::~HardwareSerial() {
+    for (int i = 0; i < HOST_SERIAL_PORTS; i++) {
+        if (uarts[i] == this) uarts[i] = nullptr;
+    }
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin) {}
+
+int HardwareSerial::available() {
+    return (int)(rxHead - rxTail);
+}
+
+int HardwareSerial::read() {
+    if (rxTail == rxHead) return -1;
+    return rx[rxTail++ % HOST_SERIAL_BUFFER];
+}
+
+int HardwareSerial::peek() {
+    if (rxTail == rxHead) return -1;
+    return rx[rxTail % HOST_SERIAL_BUFFER];
+}
+
+int HardwareSerial::availableForWrite() {
+    return HOST_SERIAL_BUFFER - (int)txLength;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+// Output past the buffer is dropped; tests clear it between steps
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    size_t room = HOST_SERIAL_BUFFER - txLength;
+    if (size > room) size = room;
+    memcpy(tx + txLength, buffer, size);
+    txLength += size;
+    return size;
+}
+
+void HardwareSerial::flush() {
+    size_t pending = txLength - txFlushed;
+    txFlushed = txLength;
+    if (responder && pending) {
+        responder(*this, tx + txLength - pending, pending, responderContext);
+    }
+}
+
+void HardwareSerial::inject(const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length && rxHead - rxTail < HOST_SERIAL_BUFFER; i++) {
+        rx[rxHead++ % HOST_SERIAL_BUFFER] = data[i];
+    }
+}
+
+void HardwareSerial::inject(const char* text) {
+    inject((const uint8_t*)text, strlen(text));
+}
+
+void HardwareSerial::clearOutput() {
+    txLength = 0;
+    txFlushed = 0;
+}
+
+void HardwareSerial::clearInput() {
+    rxHead = rxTail = 0;
+}
+
+void HardwareSerial::setResponder(HostSerialResponder callback, void* context) {
+    responder = callback;
+    responderContext = context;
+}
+
+HardwareSerial* hostUart(int uart) {
+    return uart >= 0 && uart < HOST_SERIAL_PORTS ? uarts[uart] : nullptr;
+}
+
+// ==================== BUSES ====================
+bool Adafruit_I2CDevice::begin(bool addrDetect) {
+    return !addrDetect || detected();
+}
+
+bool Adafruit_I2CDevice::detected() {
+    return deviceAddress == board.panelAddress && board.panelPresent;
+}
+
+bool Adafruit_I2CDevice::write(const uint8_t* buffer, size_t len, bool stop, const uint8_t* prefixBuffer,
+                               size_t prefixLen) {
+    return board.i2cWrite(deviceAddress, buffer, len, prefixBuffer, prefixLen);
+}
+
+void DallasTemperature::requestTemperatures() {
+    board.temperatureRequests++;
+    if (waitForConversion) board.advanceMillis(board.conversionMillis);
+}
+
+float DallasTemperature::getTempCByIndex(uint8_t index) {
+    return index == 0 ? board.temperature : DEVICE_DISCONNECTED_C;
+}
+
+// ==================== FREERTOS ====================
+static uint32_t eventGroups[8];
+static uint8_t eventGroupCount;
+static uint8_t mutexes[16];
+static uint8_t mutexCount;
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth, void* params,
+                       UBaseType_t priority, TaskHandle_t* created) {
+    if (board.taskCount >= HOST_TASKS) return pdFAIL;
+    HostTask& task = board.tasks[board.taskCount++];
+    memset(&task, 0, sizeof(task));
+    strlcpy(task.name, name, sizeof(task.name));
+    task.code = code;
+    task.params = params;
+    task.stackDepth = stackDepth;
+    task.alive = true;
+    if (created) *created = &task;
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth, void* params,
+                                   UBaseType_t priority, TaskHandle_t* created, BaseType_t core) {
+    return xTaskCreate(code, name, stackDepth, params, priority, created);
+}
+
+void vTaskDelete(TaskHandle_t handle) {
+    HostTask* task = handle ? board.findTask(handle) : &board.tasks[board.currentTask];
+    if (task) task->alive = false;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    board.advanceMillis(ticks);
+}
+
+TickType_t xTaskGetTickCount() {
+    return millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return &board.tasks[board.currentTask];
+}
+
+TaskHandle_t xTaskGetHandle(const char* name) {
+    return board.findTask(name);
+}
+
+const char* pcTaskGetName(TaskHandle_t handle) {
+    HostTask* task = handle ? board.findTask(handle) : &board.tasks[board.currentTask];
+    return task ? task->name : "";
+}
+
+// Host stacks are not measured; report a quarter of each stack unused
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t handle) {
+    HostTask* task = handle ? board.findTask(handle) : &board.tasks[board.currentTask];
+    return task ? task->stackDepth / 4 : 0;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks() {
+    UBaseType_t count = 0;
+    for (uint8_t i = 0; i < board.taskCount; i++) {
+        if (board.tasks[i].alive) count++;
+    }
+    return count;
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t* status, UBaseType_t size, uint32_t* totalRunTime) {
+    if (uxTaskGetNumberOfTasks() > size) return 0;
+    UBaseType_t count = 0;
+    for (uint8_t i = 0; i < board.taskCount; i++) {
+        HostTask& task = board.tasks[i];
+        if (!task.alive) continue;
+        memset(&status[count], 0, sizeof(TaskStatus_t));
+        status[count].xHandle = &task;
+        status[count].pcTaskName = task.name;
+        status[count].xTaskNumber = i;
+        status[count].eCurrentState = i == board.currentTask ? eRunning : eBlocked;
+        status[count].usStackHighWaterMark = task.stackDepth / 4;
+        count++;
+    }
+    if (totalRunTime) *totalRunTime = (uint32_t)board.micros();
+    return count;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    HostTask& task = board.tasks[board.currentTask];
+    if (task.notifications == 0) {
+        if (ticks != portMAX_DELAY) board.advanceMillis(ticks);
+        return 0;
+    }
+    uint32_t value = task.notifications;
+    task.notifications = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t handle) {
+    HostTask* task = board.findTask(handle);
+    if (task) task->notifications++;
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t handle, BaseType_t* woken) {
+    xTaskNotifyGive(handle);
+    if (woken) *woken = pdTRUE;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return mutexCount < sizeof(mutexes) ? &mutexes[mutexCount++] : nullptr;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    return pdTRUE;
+}
+
+EventGroupHandle_t xEventGroupCreate() {
+    if (eventGroupCount >= sizeof(eventGroups) / sizeof(eventGroups[0])) return nullptr;
+    eventGroups[eventGroupCount] = 0;
+    return &eventGroups[eventGroupCount++];
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    return *(uint32_t*)group |= bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    EventBits_t previous = *(uint32_t*)group;
+    *(uint32_t*)group &= ~bits;
+    return previous;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    return *(uint32_t*)group;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t ticks) {
+    EventBits_t value = *(uint32_t*)group;
+    bool satisfied = waitForAll ? (value & bits) == bits : (value & bits) != 0;
+    if (!satisfied) {
+        if (ticks != portMAX_DELAY) board.advanceMillis(ticks);
+        return value;
+    }
+    if (clearOnExit) *(uint32_t*)group &= ~bits;
+    return value;
+}
+
+// ==================== ESP-IDF ====================
+int64_t esp_timer_get_time() {
+    return (int64_t)board.micros();
+}
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback) {
+    board.sntpCallback = callback;
+}
+
+bool sntp_restart() {
+    board.sntpRestarts++;
+    return true;
+}
+
+// Handle = namespace index + 1
+esp_err_t nvs_open(const char* name, nvs_open_mode_t mode, nvs_handle_t* handle) {
+    int space = board.nvsNamespace(name, mode == NVS_READWRITE);
+    if (space < 0) return ESP_ERR_NVS_NOT_FOUND;
+    *handle = space + 1;
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) {}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out, size_t* length) {
+    HostNvsEntry* entry = board.nvsFind(handle - 1, key);
+    if (!entry) return ESP_ERR_NVS_NOT_FOUND;
+    if (!out) {
+        *length = entry->length;
+        return ESP_OK;
+    }
+    if (*length < entry->length) return ESP_ERR_NVS_INVALID_LENGTH;
+    memcpy(out, entry->value, entry->length);
+    *length = entry->length;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length) {
+    return board.nvsPut(handle - 1, key, value, length) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t nvs_get_u16(nvs_handle_t handle, const char* key, uint16_t* out) {
+    size_t length = sizeof(*out);
+    return nvs_get_blob(handle, key, out, &length);
+}
+
+esp_err_t nvs_set_u16(nvs_handle_t handle, const char* key, uint16_t value) {
+    return nvs_set_blob(handle, key, &value, sizeof(value));
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key) {
+    HostNvsEntry* entry = board.nvsFind(handle - 1, key);
+    if (!entry) return ESP_ERR_NVS_NOT_FOUND;
+    entry->used = false;
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle) {
+    board.nvsErase(handle - 1);
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+    if (board.nvsFailWrites) return ESP_FAIL;
+    board.nvsCommits++;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_stats(const char* partition, nvs_stats_t* stats) {
+    stats->used_entries = board.nvsUsedEntries();
+    stats->total_entries = HOST_NVS_ENTRIES;
+    stats->free_entries = HOST_NVS_ENTRIES - stats->used_entries;
+    stats->namespace_count = board.nvsNamespaceCount;
+    return ESP_OK;
+}
+
+// ==================== PREFERENCES ====================
+bool Preferences::begin(const char* name, bool readOnlyMode) {
+    if (open) return false;
+    readOnly = readOnlyMode;
+    open = nvs_open(name, readOnly ? NVS_READONLY : NVS_READWRITE, &handle) == ESP_OK;
+    return open;
+}
+
+void Preferences::end() {
+    open = false;
+}
+
+bool Preferences::clear() {
+    if (!open || readOnly) return false;
+    return nvs_erase_all(handle) == ESP_OK && nvs_commit(handle) == ESP_OK;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!open || readOnly) return false;
+    return nvs_erase_key(handle, key) == ESP_OK;
+}
+
+bool Preferences::isKey(const char* key) {
+    return open && board.nvsFind(handle - 1, key) != nullptr;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+    if (!open || readOnly) return 0;
+    return nvs_set_blob(handle, key, value, length) == ESP_OK && nvs_commit(handle) == ESP_OK ? length : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* out, size_t maxLength) {
+    if (!open) return 0;
+    HostNvsEntry* entry = board.nvsFind(handle - 1, key);
+    if (!entry || entry->length > maxLength) return 0;
+    memcpy(out, entry->value, entry->length);
+    return entry->length;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    HostNvsEntry* entry = open ? board.nvsFind(handle - 1, key) : nullptr;
+    return entry ? entry->length : 0;
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    return putBytes(key, value, strlen(value) + 1);
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    HostNvsEntry* entry = open ? board.nvsFind(handle - 1, key) : nullptr;
+    if (!entry || entry->length == 0) return defaultValue;
+    return String((const char*)entry->value, entry->length - 1);
+}
+
+int32_t Preferences::getInt(const char* key, int32_t defaultValue) {
+    int32_t value;
+    return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : defaultValue;
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+    uint32_t value;
+    return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : defaultValue;
+}
+
+float Preferences::getFloat(const char* key, float defaultValue) {
+    float value;
+    return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : defaultValue;
+}
+
+bool Preferences::getBool(const char* key, bool defaultValue) {
+    bool value;
+    return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : defaultValue;
+}
+
+// ==================== ALLOCATOR ====================
+// Routed through malloc/free so the firmware's --wrap hooks count C++
+// allocations too, as newlib's operator new does on the device
+void* operator new(size_t size) {
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return malloc(size ? size : 1);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
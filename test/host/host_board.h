@@ -0,0 +1,113 @@
+#ifndef HOST_BOARD_H
+#define HOST_BOARD_H
+
+// The simulated ESP32-S3 behind the native test build. Time only moves
+// when a test (or a blocking call in the firmware) moves it, so every run
+// is deterministic; pins, heap figures, the panel and flash are plain
+// state a test can set and inspect.
+
+#include "Arduino.h"
+#include "sh1106_emulator.h"
+#include "esp_sntp.h"
+
+#define HOST_PINS 64
+#define HOST_TASKS 16
+#define HOST_NVS_ENTRIES 64
+#define HOST_NVS_NAMESPACES 16
+#define HOST_NVS_KEY 16
+#define HOST_NVS_VALUE 512
+
+typedef void (*HostIsr)(void* arg);
+
+struct HostTask {
+    char name[16];
+    TaskFunction_t code;
+    void* params;
+    uint32_t stackDepth;
+    uint32_t notifications;
+    bool alive;
+};
+
+struct HostNvsEntry {
+    uint8_t space;
+    char key[HOST_NVS_KEY];
+    uint8_t value[HOST_NVS_VALUE];
+    size_t length;
+    bool used;
+};
+
+class HostBoard {
+private:
+    uint64_t nowMicros;
+    uint8_t pinLevel[HOST_PINS];
+    HostIsr isr[HOST_PINS];
+    void* isrArg[HOST_PINS];
+    void (*plainIsr[HOST_PINS])();
+    uint8_t isrMode[HOST_PINS];
+
+public:
+    // Heap figures reported through ESP.*
+    uint32_t heapSize;
+    uint32_t freeHeap;
+    uint32_t minFreeHeap;
+    uint32_t maxAllocHeap;
+
+    // Sensors and buses
+    float temperature;              // DS18B20 reading, DEVICE_DISCONNECTED_C when absent
+    uint32_t conversionMillis;      // Blocking DS18B20 conversion time
+    uint32_t temperatureRequests;
+    Sh1106Emulator panel;
+    uint8_t panelAddress;
+    bool panelPresent;
+    uint32_t i2cWrites;
+
+    // Time
+    int64_t wallOffsetMicros;       // Wall clock = host clock + offset, once set
+    bool wallClockSet;
+    sntp_sync_time_cb_t sntpCallback;
+    uint32_t sntpRestarts;
+
+    HostTask tasks[HOST_TASKS];
+    uint8_t taskCount;
+    uint8_t currentTask;            // Index into tasks; 0 is the loop task
+    uint32_t restarts;
+
+    HostNvsEntry nvs[HOST_NVS_ENTRIES];
+    char nvsNamespaces[HOST_NVS_NAMESPACES][HOST_NVS_KEY];
+    uint8_t nvsNamespaceCount;
+    uint32_t nvsCommits;
+    bool nvsFailWrites;             // Host: every set/commit fails, like a worn sector
+
+    HostBoard();
+    void reset();                   // Power cycle: everything except NVS
+
+    uint64_t micros() const { return nowMicros; }
+    void advance(uint64_t micros) { nowMicros += micros; }
+    void advanceMillis(uint32_t ms) { nowMicros += (uint64_t)ms * 1000; }
+
+    // Pins; an edge on a pin with an attached interrupt runs the handler
+    void setPin(uint8_t pin, uint8_t level);
+    uint8_t getPin(uint8_t pin) const { return pin < HOST_PINS ? pinLevel[pin] : 0; }
+    void attach(uint8_t pin, void (*handler)(), HostIsr handlerArg, void* arg, uint8_t mode);
+    void detach(uint8_t pin);
+
+    // Wall clock, as SNTP would set it; runs the firmware's sync callback
+    void sntpSync(time_t epochSeconds, uint32_t fractionMicros = 0);
+
+    HostTask* findTask(const char* name);
+    HostTask* findTask(TaskHandle_t handle);
+
+    // Flash
+    int nvsNamespace(const char* name, bool create);
+    HostNvsEntry* nvsFind(uint8_t space, const char* key);
+    HostNvsEntry* nvsPut(uint8_t space, const char* key, const void* value, size_t length);
+    void nvsErase(uint8_t space);
+    void nvsFormat();
+    uint32_t nvsUsedEntries() const;
+
+    bool i2cWrite(uint8_t address, const uint8_t* buffer, size_t length, const uint8_t* prefix, size_t prefixLength);
+};
+
+extern HostBoard board;
+
+#endif
@@ -0,0 +1,428 @@
+#include "WiFi.h"
+#include "HTTPClient.h"
+#include "ESPAsyncWebServer.h"
+#include "host_board.h"
+
+WiFiClass WiFi;
+HostHttp hostHttp = {200, "", 0, 0, "", String()};
+
+// ==================== WIFI ====================
+WiFiClass::WiFiClass() {
+    reset();
+}
+
+void WiFiClass::reset() {
+    memset(handlers, 0, sizeof(handlers));
+    handlerCount = 0;
+    scanState = WIFI_SCAN_FAILED;
+    memset(bssid, 0, sizeof(bssid));
+    memset(air, 0, sizeof(air));
+    airCount = 0;
+    leaseIP = IPAddress(192, 168, 1, 50);
+    leaseGateway = IPAddress(192, 168, 1, 1);
+    leaseSubnet = IPAddress(255, 255, 255, 0);
+    leaseDNS = IPAddress(192, 168, 1, 1);
+    linkRSSI = -60;
+    currentMode = WIFI_OFF;
+    connected = false;
+    apRunning = false;
+    apSSID[0] = '\0';
+    lastSSID[0] = '\0';
+    lastPassword[0] = '\0';
+    lastChannel = 0;
+    lastHadBSSID = false;
+    memset(lastBSSID, 0, sizeof(lastBSSID));
+    beginCount = 0;
+    disconnectCount = 0;
+    scanCount = 0;
+    lastScanChannel = 0;
+    staticConfig = false;
+    staticIP = IPAddress();
+}
+
+void WiFiClass::addAccessPoint(const char* ssid, int8_t rssi, int32_t channel, wifi_auth_mode_t auth) {
+    if (airCount >= HOST_WIFI_MAX_SCAN) return;
+    HostAccessPoint& ap = air[airCount];
+    strlcpy(ap.ssid, ssid, sizeof(ap.ssid));
+    ap.rssi = rssi;
+    ap.channel = channel;
+    ap.auth = auth;
+    for (int i = 0; i < 6; i++) ap.bssid[i] = 0x10 * (airCount + 1) + i;
+    airCount++;
+}
+
+void WiFiClass::emit(arduino_event_id_t event, const arduino_event_info_t* info) {
+    arduino_event_info_t empty;
+    memset(&empty, 0, sizeof(empty));
+    for (uint8_t i = 0; i < handlerCount; i++) {
+        if (handlers[i]) handlers[i](event, info ? *info : empty);
+    }
+}
+
+void WiFiClass::emitDisconnected(uint8_t reason) {
+    connected = false;
+    arduino_event_info_t info;
+    memset(&info, 0, sizeof(info));
+    info.wifi_sta_disconnected.reason = reason;
+    emit(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, &info);
+}
+
+void WiFiClass::connect() {
+    emit(ARDUINO_EVENT_WIFI_STA_CONNECTED);
+    connected = true;
+    emit(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+}
+
+void WiFiClass::finishScan() {
+    scanState = airCount;
+    emit(ARDUINO_EVENT_WIFI_SCAN_DONE);
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase, int32_t channel, const uint8_t* target,
+                             bool connect) {
+    beginCount++;
+    connected = false;
+    strlcpy(lastSSID, ssid ? ssid : "", sizeof(lastSSID));
+    strlcpy(lastPassword, passphrase ? passphrase : "", sizeof(lastPassword));
+    lastChannel = channel;
+    lastHadBSSID = target != nullptr;
+    if (target) memcpy(lastBSSID, target, sizeof(lastBSSID));
+    return WL_DISCONNECTED;
+}
+
+bool WiFiClass::config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns1, IPAddress dns2) {
+    staticConfig = (uint32_t)local != 0;
+    staticIP = local;
+    return true;
+}
+
+bool WiFiClass::disconnect(bool wifiOff, bool eraseAP) {
+    disconnectCount++;
+    connected = false;
+    return true;
+}
+
+wl_status_t WiFiClass::status() {
+    return connected ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+bool WiFiClass::isConnected() {
+    return connected;
+}
+
+bool WiFiClass::mode(wifi_mode_t newMode) {
+    currentMode = newMode;
+    return true;
+}
+
+wifi_event_id_t WiFiClass::onEvent(WiFiEventFuncCb callback, arduino_event_id_t event) {
+    if (handlerCount >= HOST_WIFI_MAX_HANDLERS) return 0;
+    handlers[handlerCount++] = callback;
+    return handlerCount;
+}
+
+void WiFiClass::removeEvent(wifi_event_id_t id) {
+    if (id > 0 && id <= handlerCount) handlers[id - 1] = nullptr;
+}
+
+bool WiFiClass::softAP(const char* ssid, const char* passphrase, int channel, int hidden, int maxConnections) {
+    apRunning = true;
+    strlcpy(apSSID, ssid, sizeof(apSSID));
+    return true;
+}
+
+bool WiFiClass::softAPdisconnect(bool wifiOff) {
+    apRunning = false;
+    return true;
+}
+
+IPAddress WiFiClass::softAPIP() {
+    return apRunning ? IPAddress(192, 168, 4, 1) : IPAddress();
+}
+
+IPAddress WiFiClass::localIP() {
+    if (!connected) return IPAddress();
+    return staticConfig ? staticIP : leaseIP;
+}
+
+IPAddress WiFiClass::gatewayIP() { return connected ? leaseGateway : IPAddress(); }
+IPAddress WiFiClass::subnetMask() { return connected ? leaseSubnet : IPAddress(); }
+IPAddress WiFiClass::dnsIP(uint8_t index) { return connected ? leaseDNS : IPAddress(); }
+
+String WiFiClass::SSID() {
+    return String(connected ? lastSSID : "");
+}
+
+int8_t WiFiClass::RSSI() {
+    return connected ? linkRSSI : 0;
+}
+
+uint8_t* WiFiClass::BSSID() {
+    for (uint8_t i = 0; i < airCount; i++) {
+        if (strcmp(air[i].ssid, lastSSID) == 0) {
+            memcpy(bssid, air[i].bssid, sizeof(bssid));
+            return bssid;
+        }
+    }
+    return connected ? bssid : nullptr;
+}
+
+int32_t WiFiClass::channel() {
+    for (uint8_t i = 0; i < airCount; i++) {
+        if (strcmp(air[i].ssid, lastSSID) == 0) return air[i].channel;
+    }
+    return lastChannel;
+}
+
+int16_t WiFiClass::scanNetworks(bool async, bool showHidden, bool passive, uint32_t maxMsPerChannel,
+                                uint8_t channel, const char* ssid, const uint8_t* target) {
+    scanCount++;
+    lastScanChannel = channel;
+    if (async) {
+        scanState = WIFI_SCAN_RUNNING;
+        return WIFI_SCAN_RUNNING;
+    }
+    scanState = airCount;
+    return scanState;
+}
+
+int16_t WiFiClass::scanComplete() {
+    return scanState;
+}
+
+void WiFiClass::scanDelete() {
+    if (scanState >= 0) scanState = WIFI_SCAN_FAILED;
+}
+
+String WiFiClass::SSID(uint8_t index) {
+    return String(index < airCount ? air[index].ssid : "");
+}
+
+int8_t WiFiClass::RSSI(uint8_t index) {
+    return index < airCount ? air[index].rssi : 0;
+}
+
+uint8_t* WiFiClass::BSSID(uint8_t index) {
+    return index < airCount ? air[index].bssid : nullptr;
+}
+
+int32_t WiFiClass::channel(uint8_t index) {
+    return index < airCount ? air[index].channel : 0;
+}
+
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t index) {
+    return index < airCount ? air[index].auth : WIFI_AUTH_OPEN;
+}
+
+// ==================== HTTP CLIENT ====================
+bool HTTPClient::begin(const char* url) {
+    strlcpy(hostHttp.lastURL, url, sizeof(hostHttp.lastURL));
+    return true;
+}
+
+bool HTTPClient::begin(const String& url) {
+    return begin(url.c_str());
+}
+
+int HTTPClient::GET() {
+    hostHttp.requests++;
+    board.advanceMillis(hostHttp.latencyMs);
+    return hostHttp.status;
+}
+
+int HTTPClient::POST(const String& payload) {
+    hostHttp.lastPayload = payload;
+    return GET();
+}
+
+int HTTPClient::POST(uint8_t* payload, size_t size) {
+    hostHttp.lastPayload = String((const char*)payload, size);
+    return GET();
+}
+
+String HTTPClient::getString() {
+    return String(hostHttp.body);
+}
+
+String HTTPClient::errorToString(int error) {
+    switch (error) {
+        case HTTPC_ERROR_CONNECTION_REFUSED: return String("connection refused");
+        case HTTPC_ERROR_READ_TIMEOUT: return String("read Timeout");
+        default: return String();
+    }
+}
+
+// ==================== WEB SERVER ====================
+bool ON_AP_FILTER(AsyncWebServerRequest* request) {
+    return request->isFromAP();
+}
+
+bool ON_STA_FILTER(AsyncWebServerRequest* request) {
+    return !request->isFromAP();
+}
+
+const char* AsyncWebServerResponse::getHeader(const char* name) const {
+    for (const auto& header : headers) {
+        if (header.first == name) return header.second.c_str();
+    }
+    return nullptr;
+}
+
+AsyncWebServerRequest::AsyncWebServerRequest(WebRequestMethod method, const char* url, bool viaAP)
+    : requestMethod(method), requestURL(url), fromAP(viaAP), response(nullptr) {}
+
+AsyncWebServerRequest::~AsyncWebServerRequest() {
+    delete response;
+}
+
+bool AsyncWebServerRequest::hasParam(const char* name, bool post) const {
+    return getParam(name, post) != nullptr;
+}
+
+const AsyncWebParameter* AsyncWebServerRequest::getParam(const char* name, bool post) const {
+    for (const auto& param : params) {
+        if (param.isPost() == post && param.name() == name) return &param;
+    }
+    return nullptr;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const char* contentType,
+                                                             const uint8_t* content, size_t length) {
+    AsyncWebServerResponse* reply = new AsyncWebServerResponse(code, contentType);
+    reply->content.assign((const char*)content, length);
+    return reply;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const char* contentType,
+                                                             const String& content) {
+    return beginResponse(code, contentType, (const uint8_t*)content.c_str(), content.length());
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginChunkedResponse(const char* contentType,
+                                                                    AwsResponseFiller filler) {
+    AsyncWebServerResponse* reply = new AsyncWebServerResponse(200, contentType);
+    reply->filler = filler;
+    return reply;
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse* reply) {
+    delete response;
+    response = reply;
+}
+
+void AsyncWebServerRequest::send(int code, const char* contentType, const char* content) {
+    send(beginResponse(code, contentType, (const uint8_t*)content, strlen(content)));
+}
+
+void AsyncWebServerRequest::redirect(const char* url) {
+    AsyncWebServerResponse* reply = new AsyncWebServerResponse(302, "text/plain");
+    reply->addHeader("Location", url);
+    send(reply);
+}
+
+const char* HostResponse::header(const char* name) const {
+    for (const auto& entry : headers) {
+        if (entry.first == name) return entry.second.c_str();
+    }
+    return nullptr;
+}
+
+AsyncWebHandler& AsyncWebServer::on(const char* uri, int method, ArRequestHandlerFunction handler) {
+    AsyncCallbackWebHandler* route = new AsyncCallbackWebHandler();
+    route->uri = uri;
+    route->methods = method;
+    route->handler = handler;
+    routes.emplace_back(route);
+    return *route;
+}
+
+AsyncWebHandler& AsyncWebServer::addHandler(AsyncWebHandler* handler) {
+    handlers.push_back(handler);
+    return *handler;
+}
+
+HostResponse AsyncWebServer::handle(WebRequestMethod method, const char* url, std::initializer_list<HostParam> params,
+                                    bool fromAP, size_t chunkSize) {
+    AsyncWebServerRequest request(method, url, fromAP);
+    for (const HostParam& param : params) request.addParam(param.name, param.value, param.post);
+
+    bool handled = false;
+    for (auto& route : routes) {
+        if (route->uri == url && (route->methods & method) && route->filterAccepts(&request)) {
+            route->handler(&request);
+            handled = true;
+            break;
+        }
+    }
+    if (!handled && notFound) notFound(&request);
+
+    HostResponse result = {0, "", "", {}, 0};
+    AsyncWebServerResponse* reply = request.response;
+    if (!reply) return result;
+
+    result.code = reply->code;
+    result.contentType = reply->contentType;
+    result.headers = reply->headers;
+    result.body = reply->content;
+    if (reply->filler) {
+        std::vector<uint8_t> chunk(chunkSize);
+        for (;;) {
+            size_t length = reply->filler(chunk.data(), chunkSize, result.body.size());
+            result.chunks++;
+            if (length == 0 || length == RESPONSE_TRY_AGAIN) break;
+            result.body.append((const char*)chunk.data(), length);
+        }
+    }
+    return result;
+}
+
+// ==================== WEBSOCKET ====================
+bool AsyncWebSocketClient::text(AsyncWebSocketSharedBuffer buffer) {
+    if (!open || queueFull) return false;
+    framesReceived++;
+    bytesReceived += buffer->size();
+    return true;
+}
+
+size_t AsyncWebSocket::count() const {
+    size_t open = 0;
+    for (const auto& client : clients) {
+        if (client->open) open++;
+    }
+    return open;
+}
+
+void AsyncWebSocket::cleanupClients(uint16_t maxClients) {
+    while (count() > maxClients) {
+        for (auto& client : clients) {
+            if (client->open) {
+                client->close();
+                break;
+            }
+        }
+    }
+}
+
+AsyncWebSocket::SendStatus AsyncWebSocket::textAll(AsyncWebSocketSharedBuffer buffer) {
+    size_t sent = 0;
+    size_t open = 0;
+    for (auto& client : clients) {
+        if (!client->open) continue;
+        open++;
+        if (client->text(buffer)) sent++;
+    }
+    if (sent == 0) return DISCARDED;
+    return sent == open ? ENQUEUED : PARTIALLY_ENQUEUED;
+}
+
+AsyncWebSocketClient* AsyncWebSocket::connect() {
+    clients.emplace_back(new AsyncWebSocketClient(this));
+    AsyncWebSocketClient* client = clients.back().get();
+    if (handler) handler(this, client, WS_EVT_CONNECT, nullptr, nullptr, 0);
+    return client;
+}
+
+void AsyncWebSocket::disconnect(AsyncWebSocketClient* client) {
+    client->close();
+    if (handler) handler(this, client, WS_EVT_DISCONNECT, nullptr, nullptr, 0);
+}
@@ -0,0 +1,36 @@
+#ifndef HOST_NVS_H
+#define HOST_NVS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t nvs_handle_t;
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NVS_NOT_FOUND 0x1102
+#define ESP_ERR_NVS_INVALID_LENGTH 0x110c
+
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+typedef struct {
+    size_t used_entries;
+    size_t free_entries;
+    size_t total_entries;
+    size_t namespace_count;
+} nvs_stats_t;
+
+// In-memory flash kept by HostBoard, shared with Preferences
+esp_err_t nvs_open(const char* name, nvs_open_mode_t mode, nvs_handle_t* handle);
+void nvs_close(nvs_handle_t handle);
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out, size_t* length);
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length);
+esp_err_t nvs_get_u16(nvs_handle_t handle, const char* key, uint16_t* out);
+esp_err_t nvs_set_u16(nvs_handle_t handle, const char* key, uint16_t value);
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key);
+esp_err_t nvs_erase_all(nvs_handle_t handle);
+esp_err_t nvs_commit(nvs_handle_t handle);
+esp_err_t nvs_get_stats(const char* partition, nvs_stats_t* stats);
+
+#endif
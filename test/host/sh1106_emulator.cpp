@@ -0,0 +1,269 @@
+#include "sh1106_emulator.h"
+#include <string.h>
+
+// Control byte bits (SH1106 datasheet, I2C interface)
+#define SH1106_CTRL_CONTINUATION 0x80
+#define SH1106_CTRL_DATA 0x40
+
+#define PNG_ROW_BYTES (SH1106_PANEL_WIDTH / 8)
+#define PNG_RAW_SIZE ((PNG_ROW_BYTES + 1) * SH1106_PANEL_HEIGHT)
+
+Sh1106Emulator::Sh1106Emulator() {
+    reset();
+    resetStats();
+}
+
+void Sh1106Emulator::reset() {
+    memset(ram, 0, sizeof(ram));
+    page = 0;
+    column = 0;
+    startLine = 0;
+    contrast = 0x80;
+    displayOn = false;
+    inverted = false;
+    synced = false;
+    pendingCommand = 0;
+}
+
+void Sh1106Emulator::write(const uint8_t* buffer, size_t length, const uint8_t* prefix, size_t prefixLength) {
+    stats.transactions++;
+    stats.bytes += prefixLength + length;
+
+    bool expectControl = true;
+    bool dataMode = false;
+    bool continuation = false;
+
+    for (size_t i = 0; i < prefixLength + length; i++) {
+        uint8_t b = i < prefixLength ? prefix[i] : buffer[i - prefixLength];
+
+        if (expectControl) {
+            stats.controlBytes++;
+            continuation = b & SH1106_CTRL_CONTINUATION;
+            dataMode = b & SH1106_CTRL_DATA;
+            expectControl = false;
+            continue;
+        }
+
+        if (dataMode) {
+            data(b);
+        } else {
+            command(b);
+        }
+
+        // Co = 1 means exactly one byte follows before the next control byte
+        if (continuation) {
+            expectControl = true;
+        }
+    }
+}
+
+void Sh1106Emulator::command(uint8_t c) {
+    stats.commandBytes++;
+
+    if (pendingCommand) {
+        switch (pendingCommand) {
+            case 0x81: contrast = c; break;
+            case 0xDC: startLine = c & 0x3F; break;
+            default: break;  // Mux ratio, offset, clocks, charge pump...
+        }
+        pendingCommand = 0;
+        return;
+    }
+
+    if (c <= 0x0F) {
+        column = (column & 0xF0) | c;
+    } else if (c <= 0x1F) {
+        column = (column & 0x0F) | ((c & 0x0F) << 4);
+    } else if (c >= 0x40 && c <= 0x7F) {
+        startLine = c & 0x3F;
+    } else if (c >= 0xB0 && c <= 0xB7) {
+        page = c & 0x07;
+    } else {
+        switch (c) {
+            case 0xAE: displayOn = false; break;
+            case 0xAF: displayOn = true; break;
+            case 0xA6: inverted = false; break;
+            case 0xA7: inverted = true; break;
+            // Commands with one argument byte
+            case 0x20: case 0x81: case 0xA8: case 0xAD: case 0xD3: case 0xD5:
+            case 0xD9: case 0xDA: case 0xDB: case 0xDC:
+                pendingCommand = c;
+                break;
+            default:
+                // Segment remap and COM scan direction describe how the glass
+                // is mounted; the library pairs them with its buffer layout,
+                // so the emulated image is kept in buffer orientation.
+                break;
+        }
+    }
+}
+
+void Sh1106Emulator::data(uint8_t d) {
+    stats.dataBytes++;
+
+    if (column < SH1106_RAM_COLUMNS) {
+        ram[page][column] = d;
+        column++;
+    }
+}
+
+bool Sh1106Emulator::getPixel(int x, int y) const {
+    if (x < 0 || x >= SH1106_PANEL_WIDTH || y < 0 || y >= SH1106_PANEL_HEIGHT) return false;
+    if (!displayOn) return false;
+
+    int line = (y + startLine) % SH1106_PANEL_HEIGHT;
+    bool lit = ram[line / 8][x + SH1106_COLUMN_OFFSET] & (1 << (line % 8));
+    return lit != inverted;
+}
+
+const uint8_t* Sh1106Emulator::getPage(int p) const {
+    return &ram[p][SH1106_COLUMN_OFFSET];
+}
+
+bool Sh1106Emulator::isSynced() const {
+    return synced;
+}
+
+void Sh1106Emulator::markSynced() {
+    synced = true;
+}
+
+void Sh1106Emulator::invalidate() {
+    synced = false;
+}
+
+void Sh1106Emulator::recordFrame(uint32_t micros, uint32_t bytes) {
+    stats.frames++;
+    stats.lastFrameMicros = micros;
+    stats.lastFrameBytes = bytes;
+    if (micros > stats.maxFrameMicros) {
+        stats.maxFrameMicros = micros;
+    }
+}
+
+const Sh1106Stats& Sh1106Emulator::getStats() const {
+    return stats;
+}
+
+void Sh1106Emulator::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void Sh1106Emulator::writePBM(Sh1106Writer writer, void* context) const {
+    static const char header[] = "P4\n128 64\n";
+    writer((const uint8_t*)header, sizeof(header) - 1, context);
+
+    // PBM: 1 = black, so lit OLED pixels are written as 0 (white)
+    uint8_t row[PNG_ROW_BYTES];
+    for (int y = 0; y < SH1106_PANEL_HEIGHT; y++) {
+        memset(row, 0, sizeof(row));
+        for (int x = 0; x < SH1106_PANEL_WIDTH; x++) {
+            if (!getPixel(x, y)) {
+                row[x / 8] |= 0x80 >> (x % 8);
+            }
+        }
+        writer(row, sizeof(row), context);
+    }
+}
+
+// ==================== PNG OUTPUT ====================
+// 1-bit grayscale PNG with a single stored (uncompressed) deflate block.
+// The image is tiny, so skipping compression keeps the encoder a few lines.
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t length) {
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static void putBE32(uint8_t* out, uint32_t v) {
+    out[0] = v >> 24;
+    out[1] = v >> 16;
+    out[2] = v >> 8;
+    out[3] = v;
+}
+
+struct PngChunkWriter {
+    Sh1106Writer writer;
+    void* context;
+    uint32_t crc;
+
+    void begin(const char* type, uint32_t length) {
+        uint8_t header[8];
+        putBE32(header, length);
+        memcpy(header + 4, type, 4);
+        writer(header, 8, context);
+        crc = crc32Update(0, header + 4, 4);
+    }
+
+    void put(const uint8_t* data, size_t length) {
+        writer(data, length, context);
+        crc = crc32Update(crc, data, length);
+    }
+
+    void end() {
+        uint8_t trailer[4];
+        putBE32(trailer, crc);
+        writer(trailer, 4, context);
+    }
+};
+
+void Sh1106Emulator::writePNG(Sh1106Writer writer, void* context) const {
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+    writer(signature, sizeof(signature), context);
+
+    PngChunkWriter chunk = {writer, context, 0};
+
+    uint8_t ihdr[13];
+    putBE32(ihdr, SH1106_PANEL_WIDTH);
+    putBE32(ihdr + 4, SH1106_PANEL_HEIGHT);
+    ihdr[8] = 1;   // Bit depth
+    ihdr[9] = 0;   // Grayscale
+    ihdr[10] = 0;  // Deflate
+    ihdr[11] = 0;  // Adaptive filtering
+    ihdr[12] = 0;  // No interlace
+    chunk.begin("IHDR", sizeof(ihdr));
+    chunk.put(ihdr, sizeof(ihdr));
+    chunk.end();
+
+    // zlib header + stored block header + raw rows + adler32
+    const uint16_t rawSize = PNG_RAW_SIZE;
+    chunk.begin("IDAT", 2 + 5 + rawSize + 4);
+
+    const uint8_t zlibHeader[7] = {
+        0x78, 0x01,
+        0x01,  // BFINAL = 1, BTYPE = stored
+        (uint8_t)(rawSize & 0xFF), (uint8_t)(rawSize >> 8),
+        (uint8_t)(~rawSize & 0xFF), (uint8_t)((uint16_t)~rawSize >> 8)
+    };
+    chunk.put(zlibHeader, sizeof(zlibHeader));
+
+    uint32_t adlerA = 1, adlerB = 0;
+    uint8_t row[PNG_ROW_BYTES + 1];
+    for (int y = 0; y < SH1106_PANEL_HEIGHT; y++) {
+        memset(row, 0, sizeof(row));  // row[0] = filter type None
+        for (int x = 0; x < SH1106_PANEL_WIDTH; x++) {
+            if (getPixel(x, y)) {
+                row[1 + x / 8] |= 0x80 >> (x % 8);
+            }
+        }
+        for (size_t i = 0; i < sizeof(row); i++) {
+            adlerA = (adlerA + row[i]) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+        chunk.put(row, sizeof(row));
+    }
+
+    uint8_t adler[4];
+    putBE32(adler, (adlerB << 16) | adlerA);
+    chunk.put(adler, sizeof(adler));
+    chunk.end();
+
+    chunk.begin("IEND", 0);
+    chunk.end();
+}
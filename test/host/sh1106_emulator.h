@@ -0,0 +1,74 @@
+#ifndef SH1106_EMULATOR_H
+#define SH1106_EMULATOR_H
+
+// Plain C++ model of the SH1106 controller as seen from the I2C bus.
+// It decodes the control/command/data byte stream, keeps the resulting
+// display RAM and counts the traffic. Nothing here depends on Arduino, so
+// the same class can sit behind a host-side I2C shim.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SH1106_RAM_COLUMNS 132
+#define SH1106_PAGES 8
+#define SH1106_PANEL_WIDTH 128
+#define SH1106_PANEL_HEIGHT 64
+#define SH1106_COLUMN_OFFSET 2   // 128 px glass sits in the middle of 132 columns
+
+struct Sh1106Stats {
+    uint32_t transactions;
+    uint32_t bytes;          // Everything after the address byte
+    uint32_t controlBytes;
+    uint32_t commandBytes;
+    uint32_t dataBytes;
+    uint32_t frames;
+    uint32_t lastFrameMicros;
+    uint32_t maxFrameMicros;
+    uint32_t lastFrameBytes;
+};
+
+typedef void (*Sh1106Writer)(const uint8_t* data, size_t length, void* context);
+
+class Sh1106Emulator {
+private:
+    uint8_t ram[SH1106_PAGES][SH1106_RAM_COLUMNS];
+    uint8_t page;
+    uint8_t column;
+    uint8_t startLine;
+    uint8_t contrast;
+    bool displayOn;
+    bool inverted;
+    bool synced;
+    uint8_t pendingCommand;  // Multi-byte command waiting for its argument
+    Sh1106Stats stats;
+
+    void command(uint8_t c);
+    void data(uint8_t d);
+
+public:
+    Sh1106Emulator();
+    void reset();   // Power-on controller state; counters are kept
+
+    // One I2C write transaction, same shape as Adafruit_I2CDevice::write():
+    // optional prefix (usually the control byte) followed by the payload.
+    void write(const uint8_t* buffer, size_t length, const uint8_t* prefix = nullptr, size_t prefixLength = 0);
+
+    // Panel pixel as the viewer sees it (start line, inversion, on/off applied)
+    bool getPixel(int x, int y) const;
+    // Raw RAM for the 128 visible columns of a page
+    const uint8_t* getPage(int p) const;
+
+    // RAM content is only meaningful after one complete frame was written
+    bool isSynced() const;
+    void markSynced();
+    void invalidate();
+
+    void recordFrame(uint32_t micros, uint32_t bytes);
+    const Sh1106Stats& getStats() const;
+    void resetStats();
+
+    void writePBM(Sh1106Writer writer, void* context) const;
+    void writePNG(Sh1106Writer writer, void* context) const;
+};
+
+#endif
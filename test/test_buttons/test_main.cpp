@@ -0,0 +1,156 @@
+// Button gestures from timestamped edges, with the main loop stalled for
+// seconds at a time the way a Modbus read or an HTTP post stalls it. The
+// edges come in through the real GPIO interrupt handler; poll() only runs
+// after the stall, and every press must still come out.
+
+#include <unity.h>
+#include "host_board.h"
+#include "input_manager.h"
+
+static uint32_t base;
+
+// Moves the clock to base + ms, then sets the pin level there
+static void edge(uint8_t pin, bool pressed, uint32_t ms) {
+    board.advanceMillis(base + ms - millis());
+    board.setPin(pin, pressed ? LOW : HIGH);
+}
+
+static void stallUntil(uint32_t ms) {
+    board.advanceMillis(base + ms - millis());
+    inputManager.poll();
+}
+
+static bool next(InputEvent& event) {
+    bool got = inputManager.getEvent(event);
+    if (got) event.timestamp -= base;
+    return got;
+}
+
+static void expectEvent(InputEventType type, ButtonId button, uint32_t timestamp) {
+    InputEvent event;
+    TEST_ASSERT_TRUE_MESSAGE(next(event), "event missing");
+    TEST_ASSERT_EQUAL(type, event.type);
+    TEST_ASSERT_EQUAL(button, event.button);
+    TEST_ASSERT_EQUAL_UINT32(timestamp, event.timestamp);
+}
+
+static void expectNoEvent() {
+    InputEvent event;
+    TEST_ASSERT_FALSE(next(event));
+}
+
+void setUp() {
+    static bool started = false;
+    if (!started) {
+        inputManager.begin();
+        started = true;
+    }
+    // Leave any earlier gesture well behind
+    board.advanceMillis(10000);
+    inputManager.poll();
+    InputEvent drain;
+    while (inputManager.getEvent(drain)) {}
+    base = millis();
+}
+
+void tearDown() {}
+
+void test_bouncy_click_then_other_button_during_stall() {
+    // B bounces on the way down, A is pressed 50 ms after B is released
+    edge(BUTTON_B, true, 100);
+    edge(BUTTON_B, false, 102);
+    edge(BUTTON_B, true, 104);
+    edge(BUTTON_B, false, 180);
+    edge(BUTTON_A, true, 230);
+    edge(BUTTON_A, false, 300);
+    stallUntil(5000);
+
+    // B waits out its double-click window, so A's click is ready first;
+    // both carry the time they actually happened
+    expectEvent(EVENT_CLICK, BUTTON_ID_A, 300);
+    expectEvent(EVENT_CLICK, BUTTON_ID_B, 180);
+    expectNoEvent();
+}
+
+void test_long_press_inside_stall() {
+    edge(BUTTON_A, true, 100);
+    edge(BUTTON_A, false, 1100);
+    stallUntil(4000);
+
+    expectEvent(EVENT_LONG_PRESS, BUTTON_ID_A, 1100);
+    expectNoEvent();
+}
+
+void test_long_press_fires_while_held() {
+    edge(BUTTON_A, true, 100);
+    stallUntil(100 + BUTTON_LONG_PRESS_MS + 5);
+    expectEvent(EVENT_LONG_PRESS, BUTTON_ID_A, 100 + BUTTON_LONG_PRESS_MS);
+
+    // Releasing afterwards adds nothing
+    edge(BUTTON_A, false, 2000);
+    stallUntil(3000);
+    expectNoEvent();
+}
+
+void test_double_click_inside_stall() {
+    edge(BUTTON_B, true, 100);
+    edge(BUTTON_B, false, 150);
+    edge(BUTTON_B, true, 200);
+    edge(BUTTON_B, false, 250);
+    stallUntil(3000);
+
+    expectEvent(EVENT_DOUBLE_CLICK, BUTTON_ID_B, 250);
+    expectNoEvent();
+}
+
+void test_every_press_of_a_burst_survives() {
+    // Five short encoder presses inside one 2 s stall
+    for (int i = 0; i < 5; i++) {
+        edge(ENCODER_SW, true, 100 + i * 80);
+        edge(ENCODER_SW, false, 140 + i * 80);
+    }
+    stallUntil(2000);
+
+    for (int i = 0; i < 5; i++) {
+        expectEvent(EVENT_CLICK, BUTTON_ID_ENCODER, 140 + i * 80);
+    }
+    expectNoEvent();
+    TEST_ASSERT_EQUAL_UINT32(0, inputManager.getDroppedEdges());
+    TEST_ASSERT_EQUAL_UINT32(0, inputManager.getDroppedEvents());
+}
+
+void test_glitch_shorter_than_debounce_is_ignored() {
+    edge(BUTTON_A, true, 100);
+    edge(BUTTON_A, false, 100 + BUTTON_DEBOUNCE_MS / 2);
+    stallUntil(2000);
+    expectNoEvent();
+}
+
+void test_sleep_ends_at_the_next_gesture_deadline() {
+    edge(BUTTON_B, true, 100);
+    stallUntil(105);
+    TEST_ASSERT_EQUAL_UINT32(BUTTON_DEBOUNCE_MS - 5, inputManager.timeUntilNextTimer(millis(), 1000));
+
+    stallUntil(130);
+    TEST_ASSERT_EQUAL_UINT32(100 + BUTTON_LONG_PRESS_MS - 130, inputManager.timeUntilNextTimer(millis(), 1000));
+
+    edge(BUTTON_B, false, 200);
+    stallUntil(230);
+    TEST_ASSERT_EQUAL_UINT32(200 + BUTTON_DOUBLE_CLICK_MS + 1 - 230, inputManager.timeUntilNextTimer(millis(), 1000));
+
+    stallUntil(1000);
+    expectEvent(EVENT_CLICK, BUTTON_ID_B, 200);
+    TEST_ASSERT_EQUAL_UINT32(1000, inputManager.timeUntilNextTimer(millis(), 1000));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bouncy_click_then_other_button_during_stall);
+    RUN_TEST(test_long_press_inside_stall);
+    RUN_TEST(test_long_press_fires_while_held);
+    RUN_TEST(test_double_click_inside_stall);
+    RUN_TEST(test_every_press_of_a_burst_survives);
+    RUN_TEST(test_glitch_shorter_than_debounce_is_ignored);
+    RUN_TEST(test_sleep_ends_at_the_next_gesture_deadline);
+    return UNITY_END();
+}
@@ -0,0 +1,184 @@
+// DisciplinedClock against a simulated crystal with a known error and NTP
+// replies with jitter, then TimeManager's checkpoints against the flash
+// contents a reset would leave behind.
+
+#include <unity.h>
+#include "host_board.h"
+#include "time_manager.h"
+#include <nvs.h>
+
+#define EPOCH_2025 1735689600LL
+#define HOUR_MICROS 3600000000LL
+
+static const ClockTuning TUNING = {
+    CLOCK_SLEW_PPM,
+    CLOCK_STEP_THRESHOLD_MS * 1000LL,
+    CLOCK_MAX_DRIFT_PPM,
+    CLOCK_DRIFT_MIN_SPAN_MS * 1000LL,
+    CLOCK_DRIFT_WINDOW_MS * 1000LL
+};
+
+// Crystal running slowPpm slow against true time
+struct Crystal {
+    int64_t trueMicros;
+    int32_t slowPpm;
+
+    int64_t local() const { return trueMicros - trueMicros * slowPpm / 1000000; }
+    int64_t epoch() const { return EPOCH_2025 * 1000000 + trueMicros; }
+};
+
+// NTP replies off by up to +-25 ms, deterministic
+static int64_t jitter() {
+    static uint32_t state = 12345;
+    state = state * 1103515245 + 12345;
+    return ((int64_t)(state >> 16) % 50001) - 25000;
+}
+
+static int64_t absolute(int64_t value) {
+    return value < 0 ? -value : value;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_drift_is_measured_from_hourly_syncs() {
+    DisciplinedClock clock(TUNING);
+    Crystal crystal = {0, 35};
+    clock.start(crystal.local(), CLOCK_FALLBACK_EPOCH * 1000000LL, 0, false);
+
+    for (int hour = 0; hour <= 48; hour++) {
+        clock.sync(crystal.local(), crystal.epoch() + jitter());
+        crystal.trueMicros += HOUR_MICROS;
+    }
+    TEST_ASSERT_TRUE(clock.isDriftValid());
+    TEST_ASSERT_EQUAL(1, clock.getStats().steps);          // Only the first reply
+    TEST_ASSERT_INT32_WITHIN(500, 35001, clock.getDriftPpb());
+
+    // A day offline: the estimate holds to well under the uncorrected 3 s
+    crystal.trueMicros += 24 * HOUR_MICROS;
+    int64_t error = clock.now(crystal.local()) - crystal.epoch();
+    TEST_ASSERT_TRUE_MESSAGE(absolute(error) < 100000, "more than 100 ms off after a day offline");
+}
+
+void test_saved_drift_applies_from_the_start() {
+    DisciplinedClock clock(TUNING);
+    Crystal crystal = {0, -20};
+    clock.start(crystal.local(), crystal.epoch(), -20000, true);
+
+    crystal.trueMicros += 12 * HOUR_MICROS;
+    TEST_ASSERT_TRUE(absolute(clock.now(crystal.local()) - crystal.epoch()) < 1000);
+}
+
+void test_corrections_slew_and_never_step_back() {
+    DisciplinedClock clock(TUNING);
+    Crystal crystal = {0, 0};
+    clock.start(crystal.local(), crystal.epoch(), 0, false);
+    crystal.trueMicros += HOUR_MICROS;
+
+    // NTP says we are 200 ms ahead: time slows down instead of jumping back
+    int64_t offset = -200000;
+    clock.sync(crystal.local(), crystal.epoch() + offset);
+    int64_t last = clock.now(crystal.local());
+    for (int second = 1; second <= 400; second++) {
+        crystal.trueMicros += 1000000;
+        int64_t now = clock.now(crystal.local());
+        TEST_ASSERT_TRUE(now >= last);
+        TEST_ASSERT_TRUE(now - last >= 1000000 - 1000000 * CLOCK_SLEW_PPM / 1000000);
+        last = now;
+    }
+    // 200 ms at CLOCK_SLEW_PPM (500 ppm) is done after 400 s
+    TEST_ASSERT_TRUE(absolute(last - (crystal.epoch() + offset)) <= 1);
+    TEST_ASSERT_EQUAL(0, clock.getStats().steps);
+}
+
+void test_far_behind_steps_forward() {
+    DisciplinedClock clock(TUNING);
+    Crystal crystal = {0, 0};
+    clock.start(crystal.local(), CLOCK_FALLBACK_EPOCH * 1000000LL, 0, false);
+
+    clock.sync(crystal.local(), crystal.epoch());
+    TEST_ASSERT_EQUAL(1, clock.getStats().steps);
+    TEST_ASSERT_EQUAL_INT64(crystal.epoch(), clock.now(crystal.local()));
+}
+
+static bool flashCheckpoint(ClockCheckpoint& out) {
+    nvs_handle_t handle;
+    if (nvs_open(CONFIG_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) return false;
+    size_t length = sizeof(out);
+    bool found = nvs_get_blob(handle, "clock", &out, &length) == ESP_OK && length == sizeof(out);
+    nvs_close(handle);
+    return found;
+}
+
+void test_flash_checkpoint_stays_ahead_of_the_clock() {
+    scheduler.begin();
+    configStore.begin();
+    timeManager.begin();
+    board.sntpSync(EPOCH_2025);
+    timeManager.update();
+
+    // A reset at any moment resumes from what is in flash; that must not
+    // be earlier than anything the clock has handed out
+    uint32_t saves = 0;
+    int64_t lastSaved = 0;
+    for (int second = 0; second < 2 * 3600; second++) {
+        scheduler.run();
+        scheduler.idle(1000);
+        int64_t now = timeManager.getEpoch();
+
+        ClockCheckpoint saved;
+        TEST_ASSERT_TRUE(flashCheckpoint(saved));
+        int64_t floor = (saved.epochMicros + CLOCK_CHECKPOINT_LEAD_MS * 1000LL) / 1000000;
+        TEST_ASSERT_TRUE_MESSAGE(floor >= now, "resume floor behind the clock");
+        TEST_ASSERT_TRUE_MESSAGE(saved.epochMicros / 1000000 <= now, "saved time ahead of the clock");
+        if (saved.epochMicros != lastSaved) {
+            saves++;
+            lastSaved = saved.epochMicros;
+        }
+    }
+    // One flash write per checkpoint interval, not per reading
+    TEST_ASSERT_INT_WITHIN(2, 2 * 3600000 / CLOCK_CHECKPOINT_INTERVAL, saves);
+}
+
+// Resumes the way TimeManager::begin() does from the flash contents the
+// previous test left, as if the reset came soon after that checkpoint
+// and took a few seconds: behind by less than a step, which a slew
+// would take hours over
+void test_reboot_resumes_at_the_saved_time_then_syncs() {
+    int64_t handedOut = (timeManager.getEpoch() + 1) * 1000000 - 1;
+    ClockCheckpoint saved;
+    TEST_ASSERT_TRUE(flashCheckpoint(saved));
+    int64_t trueEpoch = saved.epochMicros + 5000000;
+
+    DisciplinedClock clock(TUNING);
+    Crystal crystal = {0, 0};
+    clock.start(crystal.local(), saved.epochMicros, saved.driftPpb, saved.driftValid,
+                saved.epochMicros + CLOCK_CHECKPOINT_LEAD_MS * 1000LL);
+
+    // Nothing handed out before the reset comes again, and the estimate
+    // underneath is not ahead of the true time
+    TEST_ASSERT_TRUE(clock.now(crystal.local()) >= handedOut);
+    TEST_ASSERT_TRUE(clock.peek(crystal.local()) <= trueEpoch);
+
+    // Reply a few seconds in: the estimate is on time at once, now()
+    // holds at the floor at most until the lead has passed
+    crystal.trueMicros += 8000000;
+    int64_t before = clock.now(crystal.local());
+    clock.sync(crystal.local(), trueEpoch + crystal.trueMicros);
+    TEST_ASSERT_TRUE(absolute(clock.peek(crystal.local()) - (trueEpoch + crystal.trueMicros)) < 1000);
+    TEST_ASSERT_TRUE(clock.now(crystal.local()) >= before);
+
+    crystal.trueMicros += CLOCK_CHECKPOINT_LEAD_MS * 1000LL;
+    TEST_ASSERT_TRUE(absolute(clock.now(crystal.local()) - (trueEpoch + crystal.trueMicros)) < 1000);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_drift_is_measured_from_hourly_syncs);
+    RUN_TEST(test_saved_drift_applies_from_the_start);
+    RUN_TEST(test_corrections_slew_and_never_step_back);
+    RUN_TEST(test_far_behind_steps_forward);
+    RUN_TEST(test_flash_checkpoint_stays_ahead_of_the_clock);
+    RUN_TEST(test_reboot_resumes_at_the_saved_time_then_syncs);
+    return UNITY_END();
+}
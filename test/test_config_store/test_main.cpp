@@ -0,0 +1,139 @@
+// Migration from the pre-ConfigStore namespaces with flash writes failing
+// part of the way, the way a brown-out or worn sector would leave it.
+// Each ConfigStore instance is one boot reading the same simulated flash.
+
+#include <unity.h>
+#include "host_board.h"
+#include "config_store.h"
+#include <Preferences.h>
+
+static void writeLegacy() {
+    Preferences legacy;
+    legacy.begin("wifi-config", false);
+    legacy.putString("ssid", "Tambak-Utara");
+    legacy.putString("password", "secret-pass");
+    legacy.putString("serverURL", "http://old.example.com/api");
+    legacy.end();
+    legacy.begin("time-config", false);
+    legacy.putInt("timezone", 8);
+    legacy.end();
+}
+
+static bool legacyPresent() {
+    Preferences legacy;
+    bool found = legacy.begin("wifi-config", true) && legacy.isKey("ssid");
+    legacy.end();
+    return found;
+}
+
+static void runFor(uint32_t ms) {
+    uint32_t end = millis() + ms;
+    while ((int32_t)(millis() - end) < 0) {
+        scheduler.run();
+        scheduler.idle(end - millis());
+    }
+    scheduler.run();
+}
+
+void setUp() {
+    static bool started = false;
+    if (!started) {
+        scheduler.begin();
+        started = true;
+    }
+    board.nvsFormat();
+    board.nvsFailWrites = false;
+}
+
+void tearDown() {}
+
+void test_migration_keeps_legacy_until_committed() {
+    writeLegacy();
+
+    // First boot: the copy can't be written, so nothing may be erased
+    board.nvsFailWrites = true;
+    ConfigStore failed;
+    failed.begin();
+    TEST_ASSERT_TRUE(failed.isDirty());
+    TEST_ASSERT_EQUAL(1, failed.getNetworks().getCount());
+    board.nvsFailWrites = false;
+    TEST_ASSERT_TRUE(legacyPresent());
+
+    // Next boot migrates again and only then drops the old namespaces
+    ConfigStore retried;
+    retried.begin();
+    TEST_ASSERT_FALSE(retried.isDirty());
+    TEST_ASSERT_FALSE(legacyPresent());
+
+    ConfigStore after;
+    after.begin();
+    TEST_ASSERT_EQUAL(1, after.getNetworks().getCount());
+    TEST_ASSERT_EQUAL_STRING("Tambak-Utara", after.getNetworks().get(0).ssid);
+    TEST_ASSERT_EQUAL_STRING("http://old.example.com/api", after.getServerURL());
+    TEST_ASSERT_EQUAL(8, after.getTimezone());
+}
+
+void test_legacy_erased_by_a_later_successful_commit() {
+    writeLegacy();
+    board.nvsFailWrites = true;
+    ConfigStore store;
+    store.begin();
+    board.nvsFailWrites = false;
+
+    // A later change retries the whole dirty set, migration included
+    store.setTimezone(7);
+    runFor(CONFIG_COMMIT_DELAY);
+    TEST_ASSERT_FALSE(store.isDirty());
+    TEST_ASSERT_FALSE(legacyPresent());
+
+    ConfigStore after;
+    after.begin();
+    TEST_ASSERT_EQUAL(1, after.getNetworks().getCount());
+    TEST_ASSERT_EQUAL(7, after.getTimezone());
+}
+
+void test_field_saved_at_another_size_keeps_its_default() {
+    ConfigStore first;
+    first.begin();
+    first.setTimezone(9);
+    first.commit();
+
+    // A cached link from a layout without leaseExpires
+    WiFiFastConnect old;
+    memset(&old, 0, sizeof(old));
+    strlcpy(old.ssid, "Tambak-Utara", sizeof(old.ssid));
+    nvs_handle_t handle;
+    nvs_open(CONFIG_NAMESPACE, NVS_READWRITE, &handle);
+    nvs_set_blob(handle, "fast", &old, sizeof(old) - sizeof(old.leaseExpires));
+    nvs_close(handle);
+
+    ConfigStore store;
+    store.begin();
+    WiFiFastConnect link;
+    TEST_ASSERT_FALSE(store.getFastConnect(link));
+    TEST_ASSERT_EQUAL(9, store.getTimezone());
+
+    // Rewritten at the current size straight away
+    size_t length = 0;
+    nvs_open(CONFIG_NAMESPACE, NVS_READONLY, &handle);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_get_blob(handle, "fast", nullptr, &length));
+    nvs_close(handle);
+    TEST_ASSERT_EQUAL(sizeof(WiFiFastConnect), length);
+}
+
+void test_fresh_flash_migrates_nothing() {
+    ConfigStore store;
+    store.begin();
+    TEST_ASSERT_FALSE(store.isDirty());
+    TEST_ASSERT_EQUAL(0, store.getNetworks().getCount());
+    TEST_ASSERT_EQUAL_STRING(API_URL, store.getServerURL());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_migration_keeps_legacy_until_committed);
+    RUN_TEST(test_legacy_erased_by_a_later_successful_commit);
+    RUN_TEST(test_field_saved_at_another_size_keeps_its_default);
+    RUN_TEST(test_fresh_flash_migrates_nothing);
+    return UNITY_END();
+}
@@ -0,0 +1,228 @@
+// Every DisplayManager screen rendered through the real Adafruit_SH110X
+// driver into the emulated SH1106 and compared with a reference PBM in
+// snapshots/. Run with UPDATE_SNAPSHOTS=1 to rewrite the references after
+// an intended change; a mismatch leaves <name>.actual.pbm next to them.
+
+#include <unity.h>
+#include <chrono>
+#include <string>
+#include "host_board.h"
+#include "display_manager.h"
+#include "trend_history.h"
+
+static std::string snapshotDir() {
+    std::string file = __FILE__;
+    return file.substr(0, file.find_last_of('/') + 1) + "snapshots/";
+}
+
+static void appendBytes(const uint8_t* data, size_t length, void* context) {
+    static_cast<std::string*>(context)->append((const char*)data, length);
+}
+
+static bool readFile(const std::string& path, std::string& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    char buffer[512];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) out.append(buffer, n);
+    fclose(f);
+    return true;
+}
+
+static void writeFile(const std::string& path, const std::string& data) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return;
+    fwrite(data.data(), 1, data.size(), f);
+    fclose(f);
+}
+
+static void checkSnapshot(const char* name) {
+    std::string actual;
+    board.panel.writePBM(appendBytes, &actual);
+
+    std::string path = snapshotDir() + name + ".pbm";
+    std::string expected;
+    if (getenv("UPDATE_SNAPSHOTS") || !readFile(path, expected)) {
+        writeFile(path, actual);
+        return;
+    }
+    if (expected != actual) {
+        writeFile(snapshotDir() + name + ".actual.pbm", actual);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(expected == actual, name);
+}
+
+static SensorData sampleData() {
+    SensorData data;
+    memset(&data, 0, sizeof(data));
+    data.ds18b20_temp = 27.4f;
+    data.ph_value = 7.12f;
+    data.do_value = 6.85f;
+    data.tds_value = 412.0f;
+    data.ammonia_value = 0.18f;
+    data.salinitas_value = 1.0f;
+    data.ec_value = 824.0f;
+    strcpy(data.timestamp, "2026-10-18 12:34:56");
+    return data;
+}
+
+static const MenuItem MAIN_ITEMS[] = {
+    {"Sensor Data", MENU_SENSOR_DISPLAY, ACTION_NONE},
+    {"Sensor Detail", MENU_SENSOR_DETAIL, ACTION_NONE},
+    {"Trend", MENU_TREND, ACTION_NONE},
+    {"WiFi Config", MENU_WIFI_CONFIG, ACTION_NONE},
+    {"Calibration", MENU_CALIBRATION, ACTION_NONE},
+    {"Time Config", MENU_TIME_CONFIG, ACTION_NONE},
+    {"System Info", MENU_SYSTEM_INFO, ACTION_NONE},
+};
+
+void setUp() {
+    board.panel.resetStats();
+}
+
+void tearDown() {}
+
+void test_splash() {
+    displayManager.showSplashScreen();
+    checkSnapshot("splash");
+}
+
+void test_sensor_data() {
+    displayManager.showSensorData(sampleData());
+    checkSnapshot("sensor_data");
+}
+
+void test_sensor_data_errors() {
+    SensorData data = sampleData();
+    data.ph_error = true;
+    data.ec_error = true;
+    displayManager.showSensorData(data);
+    checkSnapshot("sensor_data_errors");
+}
+
+void test_menu_list() {
+    displayManager.showMenuList("MAIN MENU", MAIN_ITEMS, 7, 4, 2, "OK:Select");
+    checkSnapshot("menu_list");
+}
+
+void test_sensor_detail() {
+    for (int sensor = 0; sensor < 3; sensor++) {
+        char name[24];
+        snprintf(name, sizeof(name), "sensor_detail_%d", sensor);
+        displayManager.showSensorDetail(sampleData(), sensor);
+        checkSnapshot(name);
+    }
+}
+
+void test_wifi_config() {
+    WiFiScanEntry results[3];
+    memset(results, 0, sizeof(results));
+    strcpy(results[0].ssid, "Tambak-Utara");
+    results[0].rssi = -48;
+    results[0].channel = 6;
+    strcpy(results[1].ssid, "a-network-name-longer-than-sixteen");
+    results[1].rssi = -71;
+    results[1].channel = 11;
+    strcpy(results[2].ssid, "Gudang");
+    results[2].rssi = -85;
+    results[2].channel = 1;
+    displayManager.showWiFiConfig("Tambak-Utara", "Connected", "192.168.1.50", -48, false, results, 3, 1, 0, 0);
+    checkSnapshot("wifi_config");
+}
+
+void test_wifi_config_scanning() {
+    displayManager.showWiFiConfig("", "Scanning", "", 0, true, nullptr, 0, 0, 0, 6);
+    checkSnapshot("wifi_config_scanning");
+}
+
+void test_calibration_progress() {
+    displayManager.showCalibrationProgress("pH Sensor", "Buffer pH 7.0", 7.03f, 40);
+    checkSnapshot("calibration_progress");
+}
+
+void test_time_config() {
+    displayManager.showTimeConfig(7, "2026-10-18 12:34:56", true);
+    checkSnapshot("time_config");
+}
+
+void test_system_info() {
+    displayManager.showSystemInfo(sampleData(), "0d 01:02:03", 5);
+    checkSnapshot("system_info");
+}
+
+void test_message() {
+    displayManager.showMessage("Calibration", "pH stored", true);
+    checkSnapshot("message");
+}
+
+void test_error() {
+    displayManager.showError("Sensor", "No response");
+    checkSnapshot("error");
+}
+
+void test_scanning() {
+    displayManager.showScanningAnimation("Scanning WiFi");
+    checkSnapshot("scanning");
+}
+
+void test_trend() {
+    TrendHistory history;
+    SensorData data = sampleData();
+    for (int i = 0; i < 40; i++) {
+        data.do_value = 6.0f + 1.5f * sinf(i * 0.3f);
+        data.ds18b20_temp = 26.0f + 0.05f * i;
+        history.record(data, (unsigned long)i * TREND_BUCKET_MS);
+    }
+    history.update(40UL * TREND_BUCKET_MS);
+    displayManager.clear();
+    displayManager.showTrendGraph(history, data);
+    checkSnapshot("trend");
+}
+
+// Traffic and host render time per screen; the stock flush sends every
+// page of the dirty window, so a full-screen redraw is 8 x 128 data bytes
+void test_flush_benchmark() {
+    const int frames = 50;
+    SensorData data = sampleData();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        uint32_t before = board.panel.getStats().bytes;
+        displayManager.showSensorData(data);
+        board.panel.recordFrame(0, board.panel.getStats().bytes - before);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    const Sh1106Stats& stats = board.panel.getStats();
+    char line[128];
+    snprintf(line, sizeof(line), "sensor screen: %lu bytes, %lu transactions per frame, %lld us host render",
+             (unsigned long)stats.lastFrameBytes, (unsigned long)(stats.transactions / frames),
+             (long long)(elapsed.count() / frames));
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_EQUAL(frames, stats.frames);
+    TEST_ASSERT_EQUAL(frames * SH1106_PAGES * SH1106_PANEL_WIDTH, stats.dataBytes);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    if (!displayManager.begin()) {
+        printf("display did not start\n");
+        return 1;
+    }
+    RUN_TEST(test_splash);
+    RUN_TEST(test_sensor_data);
+    RUN_TEST(test_sensor_data_errors);
+    RUN_TEST(test_menu_list);
+    RUN_TEST(test_sensor_detail);
+    RUN_TEST(test_wifi_config);
+    RUN_TEST(test_wifi_config_scanning);
+    RUN_TEST(test_calibration_progress);
+    RUN_TEST(test_time_config);
+    RUN_TEST(test_system_info);
+    RUN_TEST(test_message);
+    RUN_TEST(test_error);
+    RUN_TEST(test_scanning);
+    RUN_TEST(test_trend);
+    RUN_TEST(test_flush_benchmark);
+    return UNITY_END();
+}
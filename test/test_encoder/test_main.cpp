@@ -0,0 +1,132 @@
+// Replays EC11 timing traces through the quadrature interrupt and checks
+// the accelerated step count. A trace is the time between detents of one
+// hand gesture, negative for counter-clockwise; the four quadrature edges
+// of a detent land in its last 3 ms. Add a trace here for any gesture
+// that feels wrong on the device.
+
+#include <unity.h>
+#include "host_board.h"
+#include "input_manager.h"
+#include "utils.h"
+
+struct EncoderTrace {
+    const char* name;
+    const int16_t* intervals;
+    int count;
+    int expectedSteps;
+};
+
+// Browsing a list one entry at a time
+static const int16_t SLOW_SCROLL[] = {400, 310, 280, 350, 300, 260};
+// Flick across a long list: speeds up, then coasts to a stop
+static const int16_t FLICK[] = {400, 40, 22, 18, 20, 24, 35, 60, 120};
+// Fast spin, overshoot, then single steps back
+static const int16_t OVERSHOOT[] = {500, 20, 20, 20, -300, -250, -280};
+// Quick back-and-forth jiggle: every reversal is a single step
+static const int16_t JIGGLE[] = {500, -20, 20, -20, 20, -20};
+
+#define TRACE(name, steps) {#name, name, Utils::countOf(name), steps}
+
+static const EncoderTrace TRACES[] = {
+    TRACE(SLOW_SCROLL, 6),
+    TRACE(FLICK, 1 + 5 + 10 + 10 + 10 + 10 + 5 + 2 + 1),
+    TRACE(OVERSHOOT, 1 + 10 + 10 + 10 - 1 - 1 - 1),
+    TRACE(JIGGLE, 1 - 1 + 1 - 1 + 1 - 1)
+};
+
+// CLK/DT Gray code from the detent rest position (both high)
+static const uint8_t CLOCKWISE[4][2] = {{1, 0}, {0, 0}, {0, 1}, {1, 1}};
+static const uint8_t COUNTER_CLOCKWISE[4][2] = {{0, 1}, {0, 0}, {1, 0}, {1, 1}};
+
+// One detent completing interval ms after the previous one
+static void detent(int direction, uint32_t interval) {
+    board.advanceMillis(interval - 3);
+    for (int i = 0; i < 4; i++) {
+        const uint8_t* levels = direction > 0 ? CLOCKWISE[i] : COUNTER_CLOCKWISE[i];
+        if (i > 0) board.advanceMillis(1);
+        board.setPin(ENCODER_CLK, levels[0]);
+        board.setPin(ENCODER_DT, levels[1]);
+    }
+}
+
+// Replays a trace, polling after every detent or only once at the end
+static int replay(const EncoderTrace& trace, bool pollEachDetent) {
+    int steps = 0;
+    for (int i = 0; i < trace.count; i++) {
+        int16_t interval = trace.intervals[i];
+        detent(interval > 0 ? 1 : -1, interval > 0 ? interval : -interval);
+        if (pollEachDetent) {
+            inputManager.poll();
+            steps += inputManager.takeRotation();
+        }
+    }
+    board.advanceMillis(2000);
+    inputManager.poll();
+    return steps + inputManager.takeRotation();
+}
+
+void setUp() {
+    static bool started = false;
+    if (!started) {
+        inputManager.begin();
+        started = true;
+    }
+    board.advanceMillis(5000);
+    inputManager.poll();
+    inputManager.takeRotation();
+}
+
+void tearDown() {}
+
+void test_traces_with_responsive_loop() {
+    for (const EncoderTrace& trace : TRACES) {
+        TEST_ASSERT_EQUAL_MESSAGE(trace.expectedSteps, replay(trace, true), trace.name);
+    }
+}
+
+void test_traces_with_stalled_loop() {
+    // Speed comes from the ISR timestamps, so one late poll sees the same turn
+    for (const EncoderTrace& trace : TRACES) {
+        TEST_ASSERT_EQUAL_MESSAGE(trace.expectedSteps, replay(trace, false), trace.name);
+    }
+}
+
+void test_slow_turns_keep_single_steps() {
+    for (int i = 0; i < 10; i++) {
+        detent(i < 5 ? 1 : -1, 150);
+        inputManager.poll();
+        TEST_ASSERT_EQUAL(i < 5 ? 1 : -1, inputManager.takeRotation());
+    }
+}
+
+void test_curve_boundaries() {
+    TEST_ASSERT_EQUAL(10, InputManager::accelerate(24));
+    TEST_ASSERT_EQUAL(5, InputManager::accelerate(25));
+    TEST_ASSERT_EQUAL(5, InputManager::accelerate(49));
+    TEST_ASSERT_EQUAL(2, InputManager::accelerate(50));
+    TEST_ASSERT_EQUAL(2, InputManager::accelerate(99));
+    TEST_ASSERT_EQUAL(1, InputManager::accelerate(100));
+}
+
+void test_no_detent_dropped_while_the_loop_is_stalled() {
+    // A full queue's worth of fast detents with nobody polling
+    detent(1, 500);
+    for (int i = 1; i < ENCODER_DETENT_QUEUE_SIZE; i++) {
+        detent(1, 5);
+    }
+    board.advanceMillis(3000);
+    inputManager.poll();
+
+    TEST_ASSERT_EQUAL(1 + (ENCODER_DETENT_QUEUE_SIZE - 1) * 10, inputManager.takeRotation());
+    TEST_ASSERT_EQUAL_UINT32(0, inputManager.getDroppedDetents());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_traces_with_responsive_loop);
+    RUN_TEST(test_traces_with_stalled_loop);
+    RUN_TEST(test_slow_turns_keep_single_steps);
+    RUN_TEST(test_curve_boundaries);
+    RUN_TEST(test_no_detent_dropped_while_the_loop_is_stalled);
+    return UNITY_END();
+}
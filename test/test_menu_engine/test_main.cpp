@@ -0,0 +1,228 @@
+// MenuSystem navigation driven by synthetic MenuInput events, plus the
+// redraw gating and per-screen render stats.
+
+#include <unity.h>
+#include "host_board.h"
+#include "menu_system.h"
+#include "calibration_manager.h"
+#include "metrics.h"
+#include <string>
+
+static void press(MenuInputType type, int delta = 0) {
+    menuSystem.handleInput({type, delta});
+}
+
+static uint32_t frames(MenuState state) {
+    return menuSystem.getRenderStats(state).frames;
+}
+
+void setUp() {
+    static bool started = false;
+    if (!started) {
+        scheduler.begin();
+        displayManager.begin();
+        calibrationManager.begin();
+        menuSystem.begin();
+        started = true;
+    }
+    // The main menu keeps its cursor across visits, start each test at the top
+    press(INPUT_HOME);
+    press(INPUT_ROTATE, -MENU_ITEMS);
+}
+
+void tearDown() {}
+
+void test_select_descends_into_the_item_target() {
+    press(INPUT_ROTATE, 2);
+    press(INPUT_SELECT);
+    TEST_ASSERT_EQUAL(MENU_TREND, menuSystem.getCurrentState());
+}
+
+void test_back_restores_the_parent_cursor() {
+    press(INPUT_ROTATE, 7);                 // Settings
+    press(INPUT_ACTION);
+    TEST_ASSERT_EQUAL(MENU_SETTINGS, menuSystem.getCurrentState());
+    press(INPUT_BACK);
+    TEST_ASSERT_EQUAL(MENU_MAIN, menuSystem.getCurrentState());
+
+    // Same item is selected again, so one more select re-enters it
+    press(INPUT_SELECT);
+    TEST_ASSERT_EQUAL(MENU_SETTINGS, menuSystem.getCurrentState());
+}
+
+void test_cursor_is_clamped_to_the_list() {
+    press(INPUT_ROTATE, -3);
+    press(INPUT_SELECT);
+    TEST_ASSERT_EQUAL(MENU_SENSOR_DISPLAY, menuSystem.getCurrentState());
+
+    press(INPUT_HOME);
+    press(INPUT_ROTATE, 50);                // Last item is an action, not a screen
+    press(INPUT_ROTATE, -1);
+    press(INPUT_SELECT);
+    TEST_ASSERT_EQUAL(MENU_SETTINGS, menuSystem.getCurrentState());
+}
+
+void test_home_unwinds_every_level() {
+    press(INPUT_ROTATE, 4);
+    press(INPUT_SELECT);                    // Calibration list
+    TEST_ASSERT_EQUAL(MENU_CALIBRATION, menuSystem.getCurrentState());
+    menuSystem.showMessage("Test", "Nested message", true);
+    TEST_ASSERT_EQUAL(MENU_MESSAGE, menuSystem.getCurrentState());
+
+    press(INPUT_HOME);
+    TEST_ASSERT_EQUAL(MENU_MAIN, menuSystem.getCurrentState());
+    press(INPUT_BACK);                      // Nothing below the main menu
+    TEST_ASSERT_EQUAL(MENU_MAIN, menuSystem.getCurrentState());
+}
+
+void test_any_button_dismisses_a_message() {
+    press(INPUT_ROTATE, 7);
+    press(INPUT_SELECT);
+    press(INPUT_ROTATE, 2);
+    press(INPUT_ACTION);                    // Data Interval shows a message
+    TEST_ASSERT_EQUAL(MENU_MESSAGE, menuSystem.getCurrentState());
+    press(INPUT_SELECT);
+    TEST_ASSERT_EQUAL(MENU_SETTINGS, menuSystem.getCurrentState());
+}
+
+void test_stack_overflow_replaces_the_top_level() {
+    for (int i = 0; i < MENU_STACK_DEPTH + 2; i++) {
+        menuSystem.openScreen(i % 2 ? MENU_SYSTEM_INFO : MENU_TIME_CONFIG);
+    }
+    for (int i = 0; i < MENU_STACK_DEPTH - 1; i++) {
+        press(INPUT_BACK);
+    }
+    TEST_ASSERT_EQUAL(MENU_MAIN, menuSystem.getCurrentState());
+}
+
+void test_sensor_actions_wait_for_the_sensors_stage() {
+    // Nothing runs the boot stage tasks on the host, so BOOT_SENSORS is
+    // still pending and nothing may touch the buses
+    uint32_t requests = board.temperatureRequests;
+
+    press(INPUT_SELECT);                    // Sensor overview
+    press(INPUT_ACTION);                    // Refresh
+    TEST_ASSERT_EQUAL(MENU_MESSAGE, menuSystem.getCurrentState());
+    press(INPUT_SELECT);
+    TEST_ASSERT_EQUAL(MENU_SENSOR_DISPLAY, menuSystem.getCurrentState());
+
+    press(INPUT_HOME);
+    press(INPUT_ROTATE, 4);
+    press(INPUT_SELECT);                    // Calibration list
+    press(INPUT_ACTION);                    // pH 4.01
+    TEST_ASSERT_EQUAL(MENU_MESSAGE, menuSystem.getCurrentState());
+    TEST_ASSERT_FALSE(calibrationManager.isCalibrating());
+    press(INPUT_SELECT);
+    TEST_ASSERT_EQUAL(MENU_CALIBRATION, menuSystem.getCurrentState());
+
+    press(INPUT_HOME);
+    press(INPUT_ROTATE, MENU_ITEMS);        // Refresh Data
+    press(INPUT_SELECT);
+    TEST_ASSERT_EQUAL(MENU_MESSAGE, menuSystem.getCurrentState());
+
+    TEST_ASSERT_EQUAL_UINT32(requests, board.temperatureRequests);
+}
+
+void test_calibration_result_is_shown_before_leaving() {
+    // Nothing answers on the bus, so the sampler gives up on its own
+    calibrationManager.beginCalibration(CALIB_PH_7_00);
+    menuSystem.openScreen(MENU_CALIBRATION_PROGRESS);
+    menuSystem.update();
+    TEST_ASSERT_EQUAL(MENU_CALIBRATION_PROGRESS, menuSystem.getCurrentState());
+
+    uint32_t end = millis() + CALIBRATION_TIMEOUT_MS;
+    while (calibrationManager.isCalibrating() && (int32_t)(millis() - end) < 0) {
+        scheduler.run();
+        scheduler.idle(CALIBRATION_SAMPLE_INTERVAL);
+    }
+    TEST_ASSERT_EQUAL(CALIB_RESULT_NO_REPLY, calibrationManager.getResult());
+
+    board.advanceMillis(DISPLAY_UPDATE_INTERVAL);
+    menuSystem.update();
+    TEST_ASSERT_EQUAL(MENU_MESSAGE, menuSystem.getCurrentState());
+    press(INPUT_SELECT);
+    TEST_ASSERT_EQUAL(MENU_MAIN, menuSystem.getCurrentState());
+
+    // Leaving by hand cancels without a message
+    calibrationManager.beginCalibration(CALIB_PH_7_00);
+    menuSystem.openScreen(MENU_CALIBRATION_PROGRESS);
+    press(INPUT_BACK);
+    menuSystem.update();
+    TEST_ASSERT_FALSE(calibrationManager.isCalibrating());
+    TEST_ASSERT_EQUAL(MENU_MAIN, menuSystem.getCurrentState());
+}
+
+void test_redraws_only_after_a_change_or_the_interval() {
+    menuSystem.openScreen(MENU_SYSTEM_INFO);
+    menuSystem.update();
+    uint32_t drawn = frames(MENU_SYSTEM_INFO);
+    TEST_ASSERT_EQUAL_UINT32(DISPLAY_UPDATE_INTERVAL, menuSystem.timeUntilRedraw(millis()));
+
+    // Wake-ups for other work do not redraw
+    for (int i = 0; i < 5; i++) {
+        board.advanceMillis(50);
+        menuSystem.update();
+    }
+    TEST_ASSERT_EQUAL_UINT32(drawn, frames(MENU_SYSTEM_INFO));
+
+    // Input does, at once
+    press(INPUT_ROTATE, 1);
+    TEST_ASSERT_EQUAL_UINT32(0, menuSystem.timeUntilRedraw(millis()));
+    menuSystem.update();
+    TEST_ASSERT_EQUAL_UINT32(drawn + 1, frames(MENU_SYSTEM_INFO));
+
+    // And so does the refresh interval
+    board.advanceMillis(DISPLAY_UPDATE_INTERVAL - 1);
+    menuSystem.update();
+    TEST_ASSERT_EQUAL_UINT32(drawn + 1, frames(MENU_SYSTEM_INFO));
+    board.advanceMillis(1);
+    menuSystem.update();
+    TEST_ASSERT_EQUAL_UINT32(drawn + 2, frames(MENU_SYSTEM_INFO));
+}
+
+void test_render_time_is_charged_to_the_screen() {
+    menuSystem.openScreen(MENU_TREND);
+    uint32_t before = frames(MENU_TREND);
+    uint32_t mainBefore = frames(MENU_MAIN);
+    menuSystem.update();
+
+    const MenuRenderStats& stats = menuSystem.getRenderStats(MENU_TREND);
+    TEST_ASSERT_EQUAL_UINT32(before + 1, stats.frames);
+    TEST_ASSERT_TRUE(stats.maxMicros >= stats.lastMicros);
+    TEST_ASSERT_TRUE(stats.totalMicros >= stats.lastMicros);
+    TEST_ASSERT_EQUAL_UINT32(mainBefore, frames(MENU_MAIN));
+}
+
+void test_render_stats_are_exported() {
+    menuSystem.openScreen(MENU_TREND);
+    menuSystem.update();
+
+    std::string text;
+    auto fill = metrics.textFiller();
+    uint8_t chunk[256];
+    size_t length;
+    while ((length = fill(chunk, sizeof(chunk), text.size())) > 0) {
+        text.append((const char*)chunk, length);
+    }
+
+    char expected[64];
+    snprintf(expected, sizeof(expected), "menu_frames_total{screen=\"trend\"} %u\n", frames(MENU_TREND));
+    TEST_ASSERT_TRUE_MESSAGE(text.find(expected) != std::string::npos, expected);
+    TEST_ASSERT_TRUE(text.find("menu_render_us_total{screen=\"trend\"}") != std::string::npos);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_select_descends_into_the_item_target);
+    RUN_TEST(test_back_restores_the_parent_cursor);
+    RUN_TEST(test_cursor_is_clamped_to_the_list);
+    RUN_TEST(test_home_unwinds_every_level);
+    RUN_TEST(test_any_button_dismisses_a_message);
+    RUN_TEST(test_stack_overflow_replaces_the_top_level);
+    RUN_TEST(test_sensor_actions_wait_for_the_sensors_stage);
+    RUN_TEST(test_calibration_result_is_shown_before_leaving);
+    RUN_TEST(test_redraws_only_after_a_change_or_the_interval);
+    RUN_TEST(test_render_time_is_charged_to_the_screen);
+    RUN_TEST(test_render_stats_are_exported);
+    return UNITY_END();
+}
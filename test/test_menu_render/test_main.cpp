@@ -0,0 +1,130 @@
+// Steady-state menu frames must not touch the heap: every screen is
+// rendered through MenuSystem with the real display driver and the
+// wrapped malloc counters are compared before and after.
+
+#include <unity.h>
+#include "host_board.h"
+#include "heap_monitor.h"
+#include "menu_system.h"
+#include "calibration_manager.h"
+
+#define FRAMES 10
+
+static uint32_t totalAllocations() {
+    uint32_t total = 0;
+    for (int i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+        total += heapMonitor.getAllocations(static_cast<AllocSubsystem>(i));
+    }
+    return total;
+}
+
+static void openScreen(MenuState state) {
+    menuSystem.handleInput({INPUT_HOME, 0});
+    menuSystem.openScreen(state);
+}
+
+// First frame may size lazily built state (scan list, trend buffer);
+// the ones after it are what the loop repeats
+static void checkFrames(MenuState state) {
+    menuSystem.update();
+    TEST_ASSERT_EQUAL(state, menuSystem.getCurrentState());
+
+    uint32_t before = totalAllocations();
+    for (int i = 0; i < FRAMES; i++) {
+        board.advanceMillis(DISPLAY_UPDATE_INTERVAL);
+        menuSystem.update();
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, totalAllocations() - before);
+}
+
+static void checkRender(MenuState state) {
+    openScreen(state);
+    checkFrames(state);
+}
+
+void setUp() {
+    static bool started = false;
+    if (!started) {
+        displayManager.begin();
+        calibrationManager.begin();
+        menuSystem.begin();
+        wifiManager.begin();
+        wifiManager.addNetwork("Tambak-Utara", "secret-pass", 1);
+        started = true;
+    }
+}
+
+void tearDown() {
+    if (calibrationManager.isCalibrating()) calibrationManager.cancelCalibration();
+}
+
+void test_main_menu() {
+    checkRender(MENU_MAIN);
+}
+
+void test_sensor_display() {
+    checkRender(MENU_SENSOR_DISPLAY);
+}
+
+void test_sensor_detail() {
+    checkRender(MENU_SENSOR_DETAIL);
+}
+
+void test_trend() {
+    checkRender(MENU_TREND);
+}
+
+void test_wifi_config() {
+    checkRender(MENU_WIFI_CONFIG);
+}
+
+void test_wifi_config_with_scan_results() {
+    // Entering the screen starts the sweep; let it find three networks
+    WiFi.addAccessPoint("Tambak-Utara", -48, 6);
+    WiFi.addAccessPoint("a-network-name-longer-than-sixteen", -71, 11);
+    WiFi.addAccessPoint("Gudang", -80, 1);
+    openScreen(MENU_WIFI_CONFIG);
+    for (int channel = 1; channel <= WIFI_SCAN_CHANNELS; channel++) {
+        WiFi.finishScan();
+        wifiManager.update();
+    }
+    TEST_ASSERT_EQUAL(3, wifiManager.getScanCount());
+    checkFrames(MENU_WIFI_CONFIG);
+}
+
+void test_calibration_list() {
+    checkRender(MENU_CALIBRATION);
+}
+
+void test_calibration_progress() {
+    calibrationManager.beginCalibration(CALIB_PH_7_00);
+    checkRender(MENU_CALIBRATION_PROGRESS);
+}
+
+void test_time_config() {
+    checkRender(MENU_TIME_CONFIG);
+}
+
+void test_system_info() {
+    checkRender(MENU_SYSTEM_INFO);
+}
+
+void test_settings() {
+    checkRender(MENU_SETTINGS);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_main_menu);
+    RUN_TEST(test_sensor_display);
+    RUN_TEST(test_sensor_detail);
+    RUN_TEST(test_trend);
+    RUN_TEST(test_wifi_config);
+    RUN_TEST(test_wifi_config_with_scan_results);
+    RUN_TEST(test_calibration_list);
+    RUN_TEST(test_calibration_progress);
+    RUN_TEST(test_time_config);
+    RUN_TEST(test_system_info);
+    RUN_TEST(test_settings);
+    return UNITY_END();
+}
@@ -0,0 +1,189 @@
+// Setup portal: form checks and the scan list renderer on their own, then
+// the registered routes through the host web server with the WiFi manager
+// in AP mode. Requests run where AsyncTCP would run them; poll() is the
+// main task picking up what they queued.
+
+#include <unity.h>
+#include "host_board.h"
+#include "captive_portal.h"
+#include <string>
+
+#define PORTAL_URL "http://192.168.4.1/"
+
+static AsyncWebServer& server() {
+    return httpServer.getServer();
+}
+
+static void runFor(uint32_t ms) {
+    uint32_t end = millis() + ms;
+    while (true) {
+        wifiManager.update();
+        scheduler.run();
+        uint32_t left = end - millis();
+        if ((int32_t)left <= 0) break;
+        scheduler.idle(left);
+    }
+}
+
+// The menu sweep, answered on every channel from the simulated air
+static void finishSweep() {
+    for (int channel = 1; channel <= WIFI_SCAN_CHANNELS; channel++) {
+        WiFi.finishScan();
+        wifiManager.update();
+    }
+}
+
+void setUp() {
+    static bool started = false;
+    if (!started) {
+        scheduler.begin();
+        wifiManager.begin();
+        captivePortal.begin();
+        started = true;
+    }
+    wifiManager.resetSettings();
+    WiFi.airCount = 0;
+    runFor(PORTAL_POLL_INTERVAL);
+}
+
+void tearDown() {}
+
+void test_form_validation() {
+    ProvisioningForm form;
+    TEST_ASSERT_EQUAL(PROVISION_OK, Provisioning::parseForm("Tambak-Utara", "secret-pass", "https://api.example.com/", form));
+    TEST_ASSERT_EQUAL_STRING("Tambak-Utara", form.ssid);
+    TEST_ASSERT_EQUAL_STRING("https://api.example.com/", form.serverUrl);
+
+    TEST_ASSERT_EQUAL(PROVISION_OK, Provisioning::parseForm("Open", nullptr, nullptr, form));
+    TEST_ASSERT_EQUAL(PROVISION_MISSING_SSID, Provisioning::parseForm("", "secret-pass", nullptr, form));
+    TEST_ASSERT_EQUAL(PROVISION_SSID_TOO_LONG,
+                      Provisioning::parseForm("a-network-name-longer-than-thirty-two", "", nullptr, form));
+    TEST_ASSERT_EQUAL(PROVISION_BAD_PASSWORD, Provisioning::parseForm("n", "short", nullptr, form));
+    TEST_ASSERT_EQUAL(PROVISION_BAD_URL, Provisioning::parseForm("n", "", "ftp://example.com", form));
+
+    // 64 characters only as a hex key
+    std::string key(PROVISIONING_MAX_PASSWORD, 'a');
+    TEST_ASSERT_EQUAL(PROVISION_OK, Provisioning::parseForm("n", key.c_str(), nullptr, form));
+    key[3] = 'z';
+    TEST_ASSERT_EQUAL(PROVISION_BAD_PASSWORD, Provisioning::parseForm("n", key.c_str(), nullptr, form));
+}
+
+void test_scan_json_is_the_same_in_any_chunk_size() {
+    ProvisioningNetwork networks[] = {
+        {"Tambak-Utara", -50, true, true},
+        {"quote\"back\\ctl\x01", -70, false, false},
+        {"Gudang", -80, true, false}
+    };
+    const char* expected =
+        "[{\"ssid\":\"Tambak-Utara\",\"rssi\":-50,\"secure\":true,\"known\":true},"
+        "{\"ssid\":\"quote\\\"back\\\\ctl\\u0001\",\"rssi\":-70,\"secure\":false,\"known\":false},"
+        "{\"ssid\":\"Gudang\",\"rssi\":-80,\"secure\":true,\"known\":false}]";
+
+    for (size_t chunk = 1; chunk <= strlen(expected) + 1; chunk++) {
+        std::string text;
+        ChunkCursor cursor;
+        uint8_t buffer[256];
+        size_t length;
+        while ((length = Provisioning::renderScanJson(networks, 3, cursor, text.size(), buffer, chunk)) > 0) {
+            text.append((const char*)buffer, length);
+        }
+        TEST_ASSERT_EQUAL_STRING(expected, text.c_str());
+
+        // A response asked for again from the top starts over
+        length = Provisioning::renderScanJson(networks, 3, cursor, 0, buffer, chunk);
+        TEST_ASSERT_EQUAL(0, memcmp(expected, buffer, length));
+    }
+
+    ChunkCursor cursor;
+    uint8_t buffer[8];
+    TEST_ASSERT_EQUAL(2, Provisioning::renderScanJson(networks, 0, cursor, 0, buffer, sizeof(buffer)));
+}
+
+void test_setup_page_only_on_the_ap_side() {
+    TEST_ASSERT_TRUE(captivePortal.isRunning());
+
+    HostResponse page = server().handle(HTTP_GET, "/", {}, true);
+    TEST_ASSERT_EQUAL(200, page.code);
+    TEST_ASSERT_EQUAL_STRING("gzip", page.header("Content-Encoding"));
+    TEST_ASSERT_TRUE(page.body.size() > 0);
+
+    HostResponse station = server().handle(HTTP_GET, "/generate_204", {}, false);
+    TEST_ASSERT_EQUAL(404, station.code);
+}
+
+void test_os_probes_and_unknown_urls_redirect() {
+    const char* urls[] = {"/generate_204", "/hotspot-detect.html", "/connecttest.txt", "/some/other/page"};
+    for (const char* url : urls) {
+        HostResponse reply = server().handle(HTTP_GET, url, {}, true);
+        TEST_ASSERT_EQUAL_MESSAGE(302, reply.code, url);
+        TEST_ASSERT_EQUAL_STRING(PORTAL_URL, reply.header("Location"));
+    }
+}
+
+void test_scan_is_queued_and_results_follow() {
+    WiFi.addAccessPoint("Tambak-Utara", -52, 6);
+    WiFi.addAccessPoint("Warung", -77, 1, WIFI_AUTH_OPEN);
+
+    // Nothing known yet: the request starts a sweep and says so
+    HostResponse first = server().handle(HTTP_GET, "/scan", {}, true);
+    TEST_ASSERT_EQUAL(200, first.code);
+    TEST_ASSERT_EQUAL_STRING("[]", first.body.c_str());
+    TEST_ASSERT_EQUAL_STRING("1", first.header("X-Scanning"));
+    TEST_ASSERT_FALSE(wifiManager.isScanning());
+
+    runFor(PORTAL_POLL_INTERVAL);
+    TEST_ASSERT_TRUE(wifiManager.isScanning());
+    finishSweep();
+    runFor(PORTAL_POLL_INTERVAL);
+
+    HostResponse second = server().handle(HTTP_GET, "/scan", {}, true, 16);
+    TEST_ASSERT_EQUAL_STRING("0", second.header("X-Scanning"));
+    TEST_ASSERT_EQUAL_STRING(
+        "[{\"ssid\":\"Tambak-Utara\",\"rssi\":-52,\"secure\":true,\"known\":false},"
+        "{\"ssid\":\"Warung\",\"rssi\":-77,\"secure\":false,\"known\":false}]", second.body.c_str());
+    TEST_ASSERT_TRUE(second.chunks > 2);
+}
+
+void test_rejected_form_changes_nothing() {
+    HostResponse reply = server().handle(HTTP_POST, "/save",
+                                         {{"ssid", "Tambak-Utara", true}, {"password", "short", true}}, true);
+    TEST_ASSERT_EQUAL(400, reply.code);
+    TEST_ASSERT_EQUAL_STRING(Provisioning::describe(PROVISION_BAD_PASSWORD), reply.body.c_str());
+
+    runFor(PORTAL_POLL_INTERVAL);
+    TEST_ASSERT_EQUAL(0, wifiManager.getNetworkCount());
+}
+
+void test_save_connects_and_closes_the_portal() {
+    WiFi.addAccessPoint("Tambak-Utara", -52, 6);
+    HostResponse reply = server().handle(HTTP_POST, "/save",
+                                         {{"ssid", "Tambak-Utara", true}, {"password", "secret-pass", true}}, true);
+    TEST_ASSERT_EQUAL(200, reply.code);
+
+    // Applied by the main task, not in the request
+    TEST_ASSERT_EQUAL(0, wifiManager.getNetworkCount());
+    runFor(PORTAL_POLL_INTERVAL);
+    TEST_ASSERT_EQUAL(1, wifiManager.getNetworkCount());
+    TEST_ASSERT_EQUAL(WIFI_SCANNING, wifiManager.getState());
+    TEST_ASSERT_TRUE(captivePortal.isRunning());
+
+    WiFi.finishScan();
+    wifiManager.update();
+    WiFi.connect();
+    wifiManager.update();
+    TEST_ASSERT_EQUAL(WIFI_CONNECTED, wifiManager.getState());
+    TEST_ASSERT_FALSE(captivePortal.isRunning());
+    TEST_ASSERT_EQUAL(404, server().handle(HTTP_GET, "/generate_204", {}, true).code);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_form_validation);
+    RUN_TEST(test_scan_json_is_the_same_in_any_chunk_size);
+    RUN_TEST(test_setup_page_only_on_the_ap_side);
+    RUN_TEST(test_os_probes_and_unknown_urls_redirect);
+    RUN_TEST(test_scan_is_queued_and_results_follow);
+    RUN_TEST(test_rejected_form_changes_nothing);
+    RUN_TEST(test_save_connects_and_closes_the_portal);
+    return UNITY_END();
+}
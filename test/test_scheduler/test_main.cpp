@@ -0,0 +1,180 @@
+// Timer wheel on the virtual clock of the simulated board. idle() sleeps
+// by moving that clock, so a run of minutes takes microseconds and every
+// deadline, jitter and idle figure is exact.
+
+#include <unity.h>
+#include "host_board.h"
+#include "scheduler.h"
+
+static void count(void* context) {
+    (*static_cast<int*>(context))++;
+}
+
+// The loop() of main.cpp without the rest of the firmware
+static void runFor(Scheduler& s, uint32_t ms, uint32_t maxWait = 1000) {
+    uint32_t end = millis() + ms;
+    while ((int32_t)(millis() - end) < 0) {
+        s.run();
+        s.idle(min(maxWait, (uint32_t)(end - millis())));
+    }
+    s.run();
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_periodic_jobs_fire_on_time() {
+    Scheduler s;
+    s.begin();
+    int fast = 0, slow = 0;
+    s.every(100, count, &fast, "fast");
+    s.every(256, count, &slow, "slow");
+
+    runFor(s, 10000);
+
+    TEST_ASSERT_EQUAL(100, fast);
+    TEST_ASSERT_EQUAL(10000 / 256, slow);
+    TEST_ASSERT_EQUAL_UINT32(0, s.getStats().maxJitter);
+    TEST_ASSERT_EQUAL_UINT32(0, s.getStats().overruns);
+}
+
+void test_deadlines_beyond_one_wheel_turn() {
+    // 1000 ms hashes into the same slot as 232 ms on a 256-slot wheel
+    Scheduler s;
+    s.begin();
+    int fired = 0;
+    s.every(1000, count, &fired, "long");
+
+    runFor(s, 999, 50);
+    TEST_ASSERT_EQUAL(0, fired);
+    runFor(s, 1);
+    TEST_ASSERT_EQUAL(1, fired);
+    runFor(s, 3000, 50);
+    TEST_ASSERT_EQUAL(4, fired);
+}
+
+static Scheduler* armingScheduler;
+static JobId followUp;
+
+void test_one_shot_armed_from_a_callback() {
+    Scheduler s;
+    s.begin();
+    armingScheduler = &s;
+    int shots = 0;
+    followUp = s.once(count, &shots, "follow-up");
+    s.every(300, [](void*) {
+        if (!armingScheduler->isArmed(followUp)) armingScheduler->start(followUp, 50);
+    }, nullptr, "arm");
+
+    runFor(s, 349);
+    TEST_ASSERT_EQUAL(0, shots);
+    TEST_ASSERT_TRUE(s.isArmed(followUp));
+    runFor(s, 1);
+    TEST_ASSERT_EQUAL(1, shots);
+    TEST_ASSERT_FALSE(s.isArmed(followUp));
+}
+
+void test_stall_skips_missed_periods_and_keeps_phase() {
+    Scheduler s;
+    s.begin();
+    int fired = 0;
+    JobId id = s.every(100, count, &fired, "periodic");
+    runFor(s, 100);
+    TEST_ASSERT_EQUAL(1, fired);
+
+    // A blocking call holds the loop past the deadlines at 200..1100 ms:
+    // the first one fires late, the other nine are skipped
+    board.advanceMillis(1050);
+    s.run();
+    TEST_ASSERT_EQUAL(2, fired);
+    TEST_ASSERT_EQUAL_UINT32(9, s.getStats().overruns);
+    TEST_ASSERT_EQUAL_UINT32(950, s.getStats().lastJitter);
+
+    // Next run is back on the original 100 ms grid
+    TEST_ASSERT_EQUAL_UINT32(50, s.timeUntilNext(1000));
+    TEST_ASSERT_TRUE(s.isArmed(id));
+}
+
+void test_cancel_and_restart() {
+    Scheduler s;
+    s.begin();
+    int fired = 0;
+    JobId id = s.every(100, count, &fired, "periodic");
+    runFor(s, 50);
+    s.cancel(id);
+    TEST_ASSERT_FALSE(s.isArmed(id));
+    runFor(s, 500);
+    TEST_ASSERT_EQUAL(0, fired);
+
+    s.start(id, 10);
+    runFor(s, 10);
+    TEST_ASSERT_EQUAL(1, fired);
+    runFor(s, 100);
+    TEST_ASSERT_EQUAL(2, fired);
+}
+
+void test_idle_sleeps_until_the_next_deadline() {
+    Scheduler s;
+    s.begin();
+    int fired = 0;
+    s.every(70, count, &fired, "job");
+
+    uint32_t start = millis();
+    s.idle(1000);
+    TEST_ASSERT_EQUAL_UINT32(70, millis() - start);
+    s.run();
+    TEST_ASSERT_EQUAL(1, fired);
+
+    // maxWait caps the sleep, e.g. for the next display refresh
+    start = millis();
+    s.idle(30);
+    TEST_ASSERT_EQUAL_UINT32(30, millis() - start);
+}
+
+void test_interrupt_cuts_the_sleep_short() {
+    scheduler.begin();
+    Scheduler::wakeFromISR();
+
+    uint32_t start = millis();
+    scheduler.idle(1000);
+    TEST_ASSERT_EQUAL_UINT32(0, millis() - start);
+
+    // Consumed: the next idle sleeps again
+    scheduler.idle(1000);
+    TEST_ASSERT_EQUAL_UINT32(1000, millis() - start);
+}
+
+void test_idle_percentage() {
+    Scheduler s;
+    s.begin();
+    s.every(100, [](void*) {
+        board.advanceMillis(25);        // Each run works for a quarter period
+    }, nullptr, "busy");
+
+    runFor(s, SCHEDULER_STATS_WINDOW_MS + 100, 1000);
+    TEST_ASSERT_INT_WITHIN(1, 75, s.getStats().idlePercent);
+}
+
+void test_full_table_refuses_new_jobs() {
+    Scheduler s;
+    s.begin();
+    int fired = 0;
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        TEST_ASSERT_NOT_EQUAL(JOB_NONE, s.once(count, &fired, "filler"));
+    }
+    TEST_ASSERT_EQUAL(JOB_NONE, s.every(100, count, &fired, "extra"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_periodic_jobs_fire_on_time);
+    RUN_TEST(test_deadlines_beyond_one_wheel_turn);
+    RUN_TEST(test_one_shot_armed_from_a_callback);
+    RUN_TEST(test_stall_skips_missed_periods_and_keeps_phase);
+    RUN_TEST(test_cancel_and_restart);
+    RUN_TEST(test_idle_sleeps_until_the_next_deadline);
+    RUN_TEST(test_interrupt_cuts_the_sleep_short);
+    RUN_TEST(test_idle_percentage);
+    RUN_TEST(test_full_table_refuses_new_jobs);
+    return UNITY_END();
+}
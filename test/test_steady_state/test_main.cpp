@@ -0,0 +1,91 @@
+// The firmware's own setup() and loop(), with the sensors read, WiFi up
+// and the screen refreshing. Once warmed up, loop() must not touch the
+// heap: the wrapped malloc counters of every subsystem but the POST job
+// (HTTP client and payload String) stay where they were. The serial
+// stream then runs on top of it without adding DS18B20 conversions.
+
+#include <unity.h>
+#include "host_board.h"
+#include "../../src/main.cpp"
+
+#define WARM_UP_MS (2 * SCHEDULER_REPORT_INTERVAL)
+#define STEADY_MS (10 * 60000)
+
+static const char* const SUBSYSTEM_NAMES[ALLOC_SUBSYSTEM_COUNT] = {
+    "loop", "sensors", "post", "ui", "wifi", "web", "other"
+};
+
+static void runLoop(uint32_t ms) {
+    uint32_t end = millis() + ms;
+    while ((int32_t)(millis() - end) < 0) {
+        loop();
+    }
+}
+
+// Boot stage tasks aren't scheduled on the host; run one the way its
+// task would
+static void runStageTask(const char* name) {
+    HostTask* task = board.findTask(name);
+    TEST_ASSERT_NOT_NULL(task);
+    board.currentTask = task - board.tasks;
+    task->code(task->params);
+    board.currentTask = 0;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_loop_does_not_allocate_once_warmed_up() {
+    setup();
+    TEST_ASSERT_TRUE_MESSAGE(scheduler.getJobCount() + SCHEDULER_SPARE_JOBS <= SCHEDULER_MAX_JOBS,
+                             "scheduler job table nearly full");
+    runStageTask("sensors");
+
+    WiFi.addAccessPoint("Tambak-Utara", -55, 6);
+    wifiManager.setCredentials("Tambak-Utara", "secret-pass");
+    WiFi.finishScan();
+    loop();
+    WiFi.connect();
+    loop();
+    TEST_ASSERT_TRUE(wifiManager.isConnected());
+
+    runLoop(WARM_UP_MS);
+    TEST_ASSERT_TRUE(bootSequence.isDone(BOOT_SENSORS));
+    uint32_t before[ALLOC_SUBSYSTEM_COUNT];
+    for (int i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+        before[i] = heapMonitor.getAllocations(static_cast<AllocSubsystem>(i));
+    }
+
+    // Every job runs several times in here: sensors, trend, post, report,
+    // heap sampling, clock checkpoints, roam checks
+    runLoop(STEADY_MS);
+
+    for (int i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+        uint32_t allocations = heapMonitor.getAllocations(static_cast<AllocSubsystem>(i)) - before[i];
+        if (i == ALLOC_POST) {
+            TEST_ASSERT_TRUE(allocations > 0);      // Posts did go out
+            continue;
+        }
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, allocations, SUBSYSTEM_NAMES[i]);
+    }
+}
+
+void test_stream_leaves_the_ds18b20_to_the_sensors_job() {
+    Serial.inject("stream 250\n");
+    runLoop(CONSOLE_POLL_INTERVAL);
+    uint32_t requests = board.temperatureRequests;
+
+    // About 40 stream ticks; only the sensors job's reads convert
+    runLoop(10 * SENSOR_READ_INTERVAL);
+    TEST_ASSERT_UINT32_WITHIN(1, 10, board.temperatureRequests - requests);
+
+    Serial.inject("stream off\n");
+    runLoop(CONSOLE_POLL_INTERVAL);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_loop_does_not_allocate_once_warmed_up);
+    RUN_TEST(test_stream_leaves_the_ds18b20_to_the_sensors_job);
+    return UNITY_END();
+}
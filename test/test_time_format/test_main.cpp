@@ -0,0 +1,145 @@
+// TimeFormat against the C library's gmtime_r + strftime over 1968..2100:
+// a sweep through the whole range, every leap day and year end, and the
+// local-time shift TimeManager applies for each timezone. Then the cost
+// of one timestamp both ways, printed for comparison.
+
+#include <unity.h>
+#include "time_format.h"
+#include <time.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#define EPOCH_1968 (-63158400LL)
+#define EPOCH_2101 4133980800LL
+#define BENCH_CALLS 200000
+
+static void expectSame(int64_t epoch) {
+    time_t seconds = (time_t)epoch;
+    struct tm t;
+    TEST_ASSERT_NOT_NULL(gmtime_r(&seconds, &t));
+
+    char expected[32];
+    char actual[32];
+    char message[48];
+    snprintf(message, sizeof(message), "epoch %lld", (long long)epoch);
+
+    strftime(expected, sizeof(expected), "%Y-%m-%d %H:%M:%S", &t);
+    memset(actual, 'x', sizeof(actual));
+    TimeFormat::iso(epoch, actual);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, actual, message);
+    TEST_ASSERT_EQUAL(TIMESTAMP_LENGTH, strlen(actual));
+
+    strftime(expected, sizeof(expected), "%a %b %d %H:%M:%S %Y", &t);
+    memset(actual, 'x', sizeof(actual));
+    TimeFormat::longForm(epoch, actual);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, actual, message);
+    TEST_ASSERT_EQUAL(LONG_TIME_LENGTH, strlen(actual));
+}
+
+// Midnight UTC of a date, from the library so the test doesn't lean on
+// the code under test
+static int64_t midnight(int year, int month, int day) {
+    struct tm t;
+    memset(&t, 0, sizeof(t));
+    t.tm_year = year - 1900;
+    t.tm_mon = month - 1;
+    t.tm_mday = day;
+    return (int64_t)timegm(&t);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_sweep_1968_to_2100() {
+    // Odd step so the seconds, minutes and weekdays all come round
+    for (int64_t epoch = EPOCH_1968; epoch < EPOCH_2101; epoch += 86400 * 5 + 3607) {
+        expectSame(epoch);
+    }
+    expectSame(EPOCH_1968);
+    expectSame(EPOCH_2101 - 1);
+}
+
+void test_leap_days_and_year_ends() {
+    for (int year = 1968; year <= 2100; year++) {
+        // 2000 is a leap year, 2100 is not
+        bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        int64_t march = midnight(year, 3, 1);
+        TEST_ASSERT_EQUAL_INT64(leap ? 29 * 86400 : 28 * 86400, march - midnight(year, 2, 1));
+
+        const int64_t edges[] = {march, midnight(year, 2, 28), midnight(year, 1, 1), midnight(year + 1, 1, 1)};
+        for (int64_t edge : edges) {
+            expectSame(edge - 1);
+            expectSame(edge);
+            expectSame(edge + 1);
+            expectSame(edge + 86399);
+        }
+    }
+}
+
+void test_timezone_shift_across_midnight_and_year_end() {
+    // TimeManager formats epoch + timezone hours; the shifted value must
+    // land on the right local date however far it moves
+    const int64_t instants[] = {
+        midnight(1999, 12, 31) + 23 * 3600 + 30 * 60,
+        midnight(2000, 1, 1) + 30 * 60,
+        midnight(2024, 2, 29) + 12 * 3600,
+        midnight(2024, 12, 31) + 14 * 3600,
+        midnight(2099, 12, 31) + 23 * 3600 + 59 * 60 + 59
+    };
+    for (int64_t instant : instants) {
+        for (int zone = -12; zone <= 14; zone++) {
+            expectSame(instant + zone * 3600);
+        }
+    }
+}
+
+void test_uptime() {
+    char out[UPTIME_LENGTH + 1];
+    TimeFormat::uptime(0, out);
+    TEST_ASSERT_EQUAL_STRING("0d 00:00:00", out);
+    TimeFormat::uptime(86400 + 3 * 3600 + 4 * 60 + 5, out);
+    TEST_ASSERT_EQUAL_STRING("1d 03:04:05", out);
+    TimeFormat::uptime(0xFFFFFFFF, out);
+    TEST_ASSERT_EQUAL_STRING("49710d 06:28:15", out);
+    TEST_ASSERT_EQUAL(UPTIME_LENGTH, strlen(out));
+}
+
+// Host nanoseconds per timestamp, both ways; printed rather than asserted,
+// a build machine's timing isn't something to fail on
+void test_timestamp_cost() {
+    char out[32];
+    volatile char sink = 0;
+    int64_t start = midnight(2025, 1, 1);
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_CALLS; i++) {
+        TimeFormat::iso(start + i * 37, out);
+        sink = sink + out[18];
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_CALLS; i++) {
+        time_t seconds = (time_t)(start + i * 37);
+        struct tm t;
+        gmtime_r(&seconds, &t);
+        strftime(out, sizeof(out), "%Y-%m-%d %H:%M:%S", &t);
+        sink = sink + out[18];
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double ours = std::chrono::duration<double, std::nano>(middle - begin).count() / BENCH_CALLS;
+    double libc = std::chrono::duration<double, std::nano>(end - middle).count() / BENCH_CALLS;
+    char line[96];
+    snprintf(line, sizeof(line), "TimeFormat::iso %.0f ns, gmtime_r+strftime %.0f ns per timestamp", ours, libc);
+    TEST_MESSAGE(line);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sweep_1968_to_2100);
+    RUN_TEST(test_leap_days_and_year_ends);
+    RUN_TEST(test_timezone_shift_across_midnight_and_year_end);
+    RUN_TEST(test_uptime);
+    RUN_TEST(test_timestamp_cost);
+    return UNITY_END();
+}
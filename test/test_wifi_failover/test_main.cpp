@@ -0,0 +1,249 @@
+// Network selection from canned scan results, then failover and roaming
+// through WiFiManager on the virtual clock. Scan and join times are the
+// test's choice, so each failover latency comes out exact.
+
+#include <unity.h>
+#include "host_board.h"
+#include "wifi_manager.h"
+
+#define PRIMARY "Tambak-Utara"
+#define BACKUP "Gudang-LTE"
+
+static WiFiScanEntry entry(const char* ssid, uint8_t id, uint8_t channel, int8_t rssi) {
+    WiFiScanEntry result;
+    memset(&result, 0, sizeof(result));
+    strlcpy(result.ssid, ssid, sizeof(result.ssid));
+    memset(result.bssid, id, sizeof(result.bssid));
+    result.channel = channel;
+    result.rssi = rssi;
+    return result;
+}
+
+static void runFor(uint32_t ms) {
+    uint32_t end = millis() + ms;
+    while (true) {
+        wifiManager.update();
+        scheduler.run();
+        wifiManager.update();
+        uint32_t left = end - millis();
+        if ((int32_t)left <= 0) break;
+        scheduler.idle(left);
+    }
+}
+
+static void driverEvent() {
+    wifiManager.update();
+}
+
+// Both networks stored, primary on the air, connected to it
+static void connectPrimary() {
+    WiFi.addAccessPoint(PRIMARY, -60, 6);
+    wifiManager.setCredentials(PRIMARY, "secret-pass");
+    WiFi.finishScan();
+    driverEvent();
+    WiFi.connect();
+    driverEvent();
+}
+
+void setUp() {
+    static bool started = false;
+    if (!started) {
+        scheduler.begin();
+        wifiManager.begin();
+        started = true;
+    }
+    wifiManager.resetSettings();
+    wifiManager.addNetwork(BACKUP, "backup-pass", 1);
+    WiFi.airCount = 0;
+    WiFi.linkRSSI = -60;
+    runFor(10);
+}
+
+void tearDown() {}
+
+void test_rank_prefers_priority_until_the_backup_is_much_stronger() {
+    WiFiNetworkList list;
+    list.add(PRIMARY, "pw", 0);
+    list.add(BACKUP, "pw", 1);
+    WiFiCandidate out[WIFI_MAX_CANDIDATES];
+
+    WiFiScanEntry close[] = {entry(BACKUP, 1, 11, -50), entry(PRIMARY, 2, 6, -65)};
+    TEST_ASSERT_EQUAL(2, list.rank(close, 2, out, WIFI_MAX_CANDIDATES));
+    TEST_ASSERT_EQUAL_STRING(PRIMARY, list.get(out[0].network).ssid);
+    TEST_ASSERT_EQUAL(-65, out[0].score);
+    TEST_ASSERT_EQUAL(-50 - WIFI_PRIORITY_STEP_DB, out[1].score);
+
+    WiFiScanEntry weak[] = {entry(BACKUP, 1, 11, -50), entry(PRIMARY, 2, 6, -75)};
+    list.rank(weak, 2, out, WIFI_MAX_CANDIDATES);
+    TEST_ASSERT_EQUAL_STRING(BACKUP, list.get(out[0].network).ssid);
+    TEST_ASSERT_EQUAL(11, out[0].channel);
+    TEST_ASSERT_EQUAL(1, out[0].bssid[0]);
+}
+
+void test_rank_skips_unknown_and_unusable_aps() {
+    WiFiNetworkList list;
+    list.add(PRIMARY, "pw", 0);
+    WiFiCandidate out[WIFI_MAX_CANDIDATES];
+
+    WiFiScanEntry results[] = {
+        entry("Warung-Kopi", 1, 1, -40),
+        entry(PRIMARY, 2, 6, WIFI_MIN_RSSI - 1),
+        entry(PRIMARY, 3, 1, WIFI_MIN_RSSI)
+    };
+    TEST_ASSERT_EQUAL(1, list.rank(results, 3, out, WIFI_MAX_CANDIDATES));
+    TEST_ASSERT_EQUAL(3, out[0].bssid[0]);
+}
+
+void test_rank_keeps_the_best_when_capped() {
+    WiFiNetworkList list;
+    list.add(PRIMARY, "pw", 0);
+    WiFiCandidate out[2];
+
+    WiFiScanEntry results[] = {
+        entry(PRIMARY, 1, 1, -80), entry(PRIMARY, 2, 6, -55), entry(PRIMARY, 3, 11, -70), entry(PRIMARY, 4, 3, -60)
+    };
+    TEST_ASSERT_EQUAL(2, list.rank(results, 4, out, 2));
+    TEST_ASSERT_EQUAL(2, out[0].bssid[0]);
+    TEST_ASSERT_EQUAL(4, out[1].bssid[0]);
+}
+
+void test_full_list_only_evicts_for_a_better_network() {
+    WiFiNetworkList list;
+    list.add(PRIMARY, "pw", 0);
+    list.add(BACKUP, "pw", 1);
+    list.add("Kantor", "pw", 2);
+    list.add("Gudang-2", "pw", 3);
+    TEST_ASSERT_EQUAL(WIFI_MAX_NETWORKS, list.getCount());
+
+    TEST_ASSERT_FALSE(list.add("Warung-Kopi", "pw", 3));
+    TEST_ASSERT_FALSE(list.add("Warung-Kopi", "pw", 5));
+    TEST_ASSERT_TRUE(list.find("Gudang-2") >= 0);
+
+    TEST_ASSERT_TRUE(list.add("Warung-Kopi", "pw", 2));
+    TEST_ASSERT_TRUE(list.find("Gudang-2") < 0);
+    TEST_ASSERT_TRUE(list.find("Warung-Kopi") >= 0);
+}
+
+void test_stored_slots_keep_no_old_bytes() {
+    const WiFiCredential empty = {};
+    WiFiNetworkList list;
+    list.add(PRIMARY, "a-long-old-password", 0);
+    list.add(PRIMARY, "short", 0);
+    const WiFiCredential& network = list.get(0);
+    TEST_ASSERT_EQUAL_MEMORY(empty.password + 6, network.password + 6, sizeof(network.password) - 6);
+
+    list.add(BACKUP, "backup-pass", 1);
+    list.remove(PRIMARY);
+    TEST_ASSERT_EQUAL(1, list.getCount());
+    TEST_ASSERT_EQUAL_MEMORY(&empty, &list.get(1), sizeof(WiFiCredential));
+}
+
+void test_failover_to_the_backup_when_the_primary_vanishes() {
+    connectPrimary();
+    TEST_ASSERT_EQUAL_STRING(PRIMARY, WiFi.lastSSID);
+
+    WiFi.airCount = 0;
+    WiFi.addAccessPoint(BACKUP, -55, 11);
+    WiFi.emitDisconnected(200);             // Beacon timeout
+    driverEvent();
+
+    runFor(1200);
+    WiFi.finishScan();
+    driverEvent();
+    TEST_ASSERT_EQUAL_STRING(BACKUP, WiFi.lastSSID);
+    TEST_ASSERT_EQUAL(11, WiFi.lastChannel);
+    runFor(400);
+    WiFi.connect();
+    driverEvent();
+
+    const WiFiAttemptStats& stats = wifiManager.getAttemptStats();
+    TEST_ASSERT_EQUAL(WIFI_CONNECTED, wifiManager.getState());
+    TEST_ASSERT_EQUAL_UINT32(1200, stats.lastScanMs);
+    TEST_ASSERT_EQUAL_UINT32(1600, stats.lastFailoverMs);
+}
+
+void test_rejected_join_moves_to_the_next_candidate_without_backoff() {
+    WiFi.addAccessPoint(BACKUP, -50, 11);
+    WiFi.addAccessPoint(PRIMARY, -62, 6);
+    wifiManager.setCredentials(PRIMARY, "secret-pass");
+    WiFi.finishScan();
+    driverEvent();
+    TEST_ASSERT_EQUAL_STRING(PRIMARY, WiFi.lastSSID);
+    uint32_t begins = WiFi.beginCount;
+
+    runFor(300);
+    WiFi.emitDisconnected(15);              // 4-way handshake timeout
+    driverEvent();
+    TEST_ASSERT_EQUAL(WIFI_CONNECTING, wifiManager.getState());
+    TEST_ASSERT_EQUAL_STRING(BACKUP, WiFi.lastSSID);
+    TEST_ASSERT_EQUAL_UINT32(begins + 1, WiFi.beginCount);
+
+    runFor(500);
+    WiFi.connect();
+    driverEvent();
+    TEST_ASSERT_EQUAL(WIFI_CONNECTED, wifiManager.getState());
+    TEST_ASSERT_EQUAL_UINT32(500, wifiManager.getAttemptStats().lastIpMs);
+}
+
+void test_roams_back_to_the_primary_when_it_returns() {
+    WiFi.addAccessPoint(BACKUP, -60, 11);
+    wifiManager.setCredentials(PRIMARY, "secret-pass");
+    WiFi.finishScan();
+    driverEvent();
+    WiFi.connect();
+    driverEvent();
+    TEST_ASSERT_EQUAL_STRING(BACKUP, WiFi.lastSSID);
+    uint32_t roams = wifiManager.getAttemptStats().roams;
+
+    // Sitting on a backup: the periodic check scans in the background
+    WiFi.addAccessPoint(PRIMARY, -65, 6);
+    uint32_t scans = WiFi.scanCount;
+    runFor(WIFI_ROAM_CHECK_INTERVAL);
+    TEST_ASSERT_EQUAL_UINT32(scans + 1, WiFi.scanCount);
+    TEST_ASSERT_EQUAL(WIFI_CONNECTED, wifiManager.getState());
+
+    runFor(1500);
+    WiFi.finishScan();
+    driverEvent();
+    TEST_ASSERT_EQUAL(WIFI_CONNECTING, wifiManager.getState());
+    TEST_ASSERT_EQUAL_STRING(PRIMARY, WiFi.lastSSID);
+    runFor(250);
+    WiFi.connect();
+    driverEvent();
+
+    const WiFiAttemptStats& stats = wifiManager.getAttemptStats();
+    TEST_ASSERT_EQUAL_UINT32(roams + 1, stats.roams);
+    TEST_ASSERT_EQUAL_UINT32(250, stats.lastFailoverMs);
+}
+
+void test_no_roam_inside_the_hysteresis() {
+    WiFi.addAccessPoint(BACKUP, -60, 11);
+    wifiManager.setCredentials(PRIMARY, "secret-pass");
+    WiFi.finishScan();
+    driverEvent();
+    WiFi.connect();
+    driverEvent();
+    uint32_t begins = WiFi.beginCount;
+
+    // Primary scores -75 against the backup's -80: not worth a drop
+    WiFi.addAccessPoint(PRIMARY, -80 + WIFI_ROAM_HYSTERESIS_DB - 3, 6);
+    runFor(WIFI_ROAM_CHECK_INTERVAL);
+    WiFi.finishScan();
+    driverEvent();
+    TEST_ASSERT_EQUAL(WIFI_CONNECTED, wifiManager.getState());
+    TEST_ASSERT_EQUAL_UINT32(begins, WiFi.beginCount);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_rank_prefers_priority_until_the_backup_is_much_stronger);
+    RUN_TEST(test_rank_skips_unknown_and_unusable_aps);
+    RUN_TEST(test_rank_keeps_the_best_when_capped);
+    RUN_TEST(test_full_list_only_evicts_for_a_better_network);
+    RUN_TEST(test_stored_slots_keep_no_old_bytes);
+    RUN_TEST(test_failover_to_the_backup_when_the_primary_vanishes);
+    RUN_TEST(test_rejected_join_moves_to_the_next_candidate_without_backoff);
+    RUN_TEST(test_roams_back_to_the_primary_when_it_returns);
+    RUN_TEST(test_no_roam_inside_the_hysteresis);
+    return UNITY_END();
+}
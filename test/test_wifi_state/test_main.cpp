@@ -0,0 +1,274 @@
+// WiFiManager state machine against the scripted WiFi stub: the test plays
+// the driver, answering begin() and scans with events at host times of its
+// choosing, and runs the scheduler the way loop() does in between.
+
+#include <unity.h>
+#include "host_board.h"
+#include "wifi_manager.h"
+#include "metrics.h"
+#include <string>
+
+#define MAX_TRANSITIONS 32
+
+static WiFiState transitions[MAX_TRANSITIONS];
+static int transitionCount;
+
+static void recordState(WiFiState state, void*) {
+    if (transitionCount < MAX_TRANSITIONS) {
+        transitions[transitionCount++] = state;
+    }
+}
+
+// loop(): handle events, run due jobs, sleep until the next deadline
+static void runFor(uint32_t ms) {
+    uint32_t end = millis() + ms;
+    do {
+        wifiManager.update();
+        scheduler.run();
+        wifiManager.update();
+        uint32_t left = end - millis();
+        if ((int32_t)left <= 0) break;
+        scheduler.idle(left);
+    } while (true);
+}
+
+static void driverEvent() {
+    // The event task hands over through the queue; the main task picks it up
+    wifiManager.update();
+}
+
+void setUp() {
+    static bool started = false;
+    if (!started) {
+        scheduler.begin();
+        wifiManager.addListener(recordState);
+        wifiManager.begin();
+        started = true;
+    }
+    // No stored networks, no cached link, nothing on the air
+    wifiManager.resetSettings();
+    WiFi.airCount = 0;
+    WiFi.linkRSSI = -60;
+    runFor(10);
+    transitionCount = 0;
+}
+
+void tearDown() {}
+
+void test_no_credentials_starts_the_setup_ap() {
+    TEST_ASSERT_EQUAL(WIFI_AP_FALLBACK, wifiManager.getState());
+    TEST_ASSERT_TRUE(WiFi.apRunning);
+    TEST_ASSERT_TRUE(wifiManager.isAPMode());
+}
+
+void test_scan_select_connect_without_blocking() {
+    WiFi.addAccessPoint("Tambak-Utara", -55, 6);
+    uint32_t start = millis();
+    wifiManager.setCredentials("Tambak-Utara", "secret-pass");
+    TEST_ASSERT_EQUAL_UINT32(start, millis());              // Nothing waited
+    TEST_ASSERT_EQUAL(WIFI_SCANNING, wifiManager.getState());
+
+    runFor(1500);
+    WiFi.finishScan();
+    driverEvent();
+    TEST_ASSERT_EQUAL(WIFI_CONNECTING, wifiManager.getState());
+    TEST_ASSERT_EQUAL_STRING("Tambak-Utara", WiFi.lastSSID);
+    TEST_ASSERT_TRUE(WiFi.lastHadBSSID);                    // Directed at the scanned AP
+    TEST_ASSERT_EQUAL(6, WiFi.lastChannel);
+
+    runFor(800);
+    WiFi.connect();
+    driverEvent();
+    TEST_ASSERT_EQUAL(WIFI_CONNECTED, wifiManager.getState());
+    TEST_ASSERT_FALSE(WiFi.apRunning);                      // Setup AP goes away
+    TEST_ASSERT_TRUE(wifiManager.waitForConnection(0));
+
+    TEST_ASSERT_EQUAL(3, transitionCount);
+    TEST_ASSERT_EQUAL(WIFI_SCANNING, transitions[0]);
+    TEST_ASSERT_EQUAL(WIFI_CONNECTING, transitions[1]);
+    TEST_ASSERT_EQUAL(WIFI_CONNECTED, transitions[2]);
+    TEST_ASSERT_EQUAL_UINT32(800, wifiManager.getAttemptStats().lastIpMs);
+}
+
+void test_lost_link_rescans_and_reconnects() {
+    WiFi.addAccessPoint("Tambak-Utara", -55, 6);
+    wifiManager.setCredentials("Tambak-Utara", "secret-pass");
+    WiFi.finishScan();
+    driverEvent();
+    WiFi.connect();
+    driverEvent();
+    transitionCount = 0;
+
+    runFor(5000);
+    WiFi.emitDisconnected(200);                             // Beacon timeout
+    driverEvent();
+    TEST_ASSERT_EQUAL(WIFI_SCANNING, wifiManager.getState());
+
+    runFor(1200);
+    WiFi.finishScan();
+    driverEvent();
+    runFor(600);
+    WiFi.connect();
+    driverEvent();
+    TEST_ASSERT_EQUAL(WIFI_CONNECTED, wifiManager.getState());
+    TEST_ASSERT_EQUAL_UINT32(1800, wifiManager.getAttemptStats().lastFailoverMs);
+}
+
+void test_failures_back_off_exponentially_then_fall_back_to_ap() {
+    // Connected once, so the setup AP is down; then the network vanishes
+    WiFi.addAccessPoint("Gudang", -70, 11);
+    wifiManager.setCredentials("Gudang", "secret-pass");
+    WiFi.finishScan();
+    driverEvent();
+    WiFi.connect();
+    driverEvent();
+    TEST_ASSERT_FALSE(WiFi.apRunning);
+    WiFi.airCount = 0;
+    WiFi.emitDisconnected(201);                             // No AP found
+    driverEvent();
+    TEST_ASSERT_EQUAL(WIFI_SCANNING, wifiManager.getState());
+    uint32_t begins = WiFi.beginCount;
+
+    uint32_t failedAt[WIFI_AP_FALLBACK_ATTEMPTS + 1];
+    uint32_t retryAt[WIFI_AP_FALLBACK_ATTEMPTS + 1];
+    for (int round = 0; round <= WIFI_AP_FALLBACK_ATTEMPTS; round++) {
+        // Scan comes back empty, the blind attempt then times out;
+        // the setup AP comes up after the third failure and stays up
+        WiFi.finishScan();
+        driverEvent();
+        TEST_ASSERT_EQUAL(WIFI_CONNECTING, wifiManager.getState());
+        runFor(WIFI_CONNECT_TIMEOUT);
+        failedAt[round] = millis();
+
+        WiFiState expected = round + 1 >= WIFI_AP_FALLBACK_ATTEMPTS ? WIFI_AP_FALLBACK : WIFI_BACKOFF;
+        TEST_ASSERT_EQUAL(expected, wifiManager.getState());
+
+        // Next attempt once the backoff expires
+        while (wifiManager.getState() == expected) {
+            runFor(100);
+        }
+        retryAt[round] = millis();
+        if (round == 0) {
+            // The cached AP is tried first; its short timeout drops the cache
+            TEST_ASSERT_EQUAL(WIFI_CONNECTING, wifiManager.getState());
+            runFor(WIFI_FAST_CONNECT_TIMEOUT);
+        }
+        TEST_ASSERT_EQUAL(WIFI_SCANNING, wifiManager.getState());
+    }
+
+    for (int round = 0; round <= WIFI_AP_FALLBACK_ATTEMPTS; round++) {
+        uint32_t expected = min((uint32_t)WIFI_BACKOFF_MIN_MS << round, (uint32_t)WIFI_BACKOFF_MAX_MS);
+        TEST_ASSERT_UINT32_WITHIN(100, expected, retryAt[round] - failedAt[round]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(begins + WIFI_AP_FALLBACK_ATTEMPTS + 2, WiFi.beginCount);
+
+    // STA keeps trying behind the AP; success takes the AP down again
+    TEST_ASSERT_TRUE(WiFi.apRunning);
+    TEST_ASSERT_EQUAL(WIFI_AP_STA, WiFi.currentMode);
+    WiFi.addAccessPoint("Gudang", -70, 11);
+    WiFi.finishScan();
+    driverEvent();
+    WiFi.connect();
+    driverEvent();
+    TEST_ASSERT_EQUAL(WIFI_CONNECTED, wifiManager.getState());
+    TEST_ASSERT_FALSE(WiFi.apRunning);
+}
+
+void test_backoff_stays_at_the_ceiling_through_a_long_outage() {
+    // Never seen, so every round is a scan and a blind attempt; runs well
+    // past the 255 failures the counter can hold
+    wifiManager.setCredentials("Gudang", "secret-pass");
+    for (int round = 0; round < 300; round++) {
+        WiFi.finishScan();
+        driverEvent();
+        TEST_ASSERT_EQUAL(WIFI_CONNECTING, wifiManager.getState());
+        runFor(WIFI_CONNECT_TIMEOUT);
+        uint32_t failedAt = millis();
+
+        while (wifiManager.getState() != WIFI_SCANNING) {
+            runFor(1000);
+        }
+        if (round >= 8) {
+            TEST_ASSERT_UINT32_WITHIN(1000, WIFI_BACKOFF_MAX_MS, millis() - failedAt);
+        }
+    }
+}
+
+void test_listeners_see_every_transition_once() {
+    WiFi.addAccessPoint("Tambak-Utara", -55, 6);
+    wifiManager.setCredentials("Tambak-Utara", "secret-pass");
+    WiFi.finishScan();
+    driverEvent();
+    WiFi.emitDisconnected(15);                              // Wrong password
+    driverEvent();
+
+    for (int i = 1; i < transitionCount; i++) {
+        TEST_ASSERT_NOT_EQUAL(transitions[i - 1], transitions[i]);
+    }
+    TEST_ASSERT_EQUAL(WIFI_AP_FALLBACK, transitions[transitionCount - 1]);
+}
+
+static std::string scrape(size_t chunkSize = 256) {
+    std::string text;
+    auto fill = metrics.textFiller();
+    uint8_t chunk[256];
+    size_t length;
+    while ((length = fill(chunk, chunkSize, text.size())) > 0) {
+        text.append((const char*)chunk, length);
+    }
+    return text;
+}
+
+static void expectSeries(const std::string& text, const char* series, uint32_t value) {
+    char line[96];
+    snprintf(line, sizeof(line), "%s %u\n", series, value);
+    TEST_ASSERT_TRUE_MESSAGE(text.find(line) != std::string::npos, line);
+}
+
+void test_fast_connect_keeps_dhcp_and_is_measured() {
+    WiFi.addAccessPoint("Tambak-Utara", -55, 6);
+    wifiManager.setCredentials("Tambak-Utara", "secret-pass");
+    WiFi.finishScan();
+    driverEvent();
+    WiFi.connect();
+    driverEvent();
+
+    // Link lost and the scan never answers: the retry goes straight to the
+    // cached AP, but the address still comes from DHCP unless
+    // WIFI_REUSE_LEASE is set
+    WiFi.emitDisconnected(200);
+    driverEvent();
+    runFor(WIFI_SCAN_TIMEOUT + WIFI_BACKOFF_MIN_MS);
+    TEST_ASSERT_EQUAL(WIFI_CONNECTING, wifiManager.getState());
+    TEST_ASSERT_TRUE(WiFi.lastHadBSSID);
+    TEST_ASSERT_FALSE(WiFi.staticConfig);
+    runFor(300);
+    WiFi.connect();
+    driverEvent();
+
+    const WiFiAttemptStats& stats = wifiManager.getAttemptStats();
+    TEST_ASSERT_TRUE(stats.lastFast);
+    TEST_ASSERT_EQUAL_UINT32(300, stats.lastIpMs);
+
+    std::string text = scrape();
+    expectSeries(text, "wifi_connect_attempts_total{path=\"fast\"}", stats.fastAttempts);
+    expectSeries(text, "wifi_connect_attempts_total{path=\"scan\"}", stats.attempts - stats.fastAttempts);
+    expectSeries(text, "wifi_ip_ms_count{path=\"fast\"}", stats.fastSuccesses);
+    expectSeries(text, "wifi_last_failover_ms", stats.lastFailoverMs);
+    TEST_ASSERT_TRUE(text.find("wifi_association_ms_bucket{path=\"scan\",le=\"250\"}") != std::string::npos);
+
+    // Chunks that split lines carry on where the last one stopped
+    TEST_ASSERT_EQUAL_STRING(text.c_str(), scrape(7).c_str());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_no_credentials_starts_the_setup_ap);
+    RUN_TEST(test_scan_select_connect_without_blocking);
+    RUN_TEST(test_lost_link_rescans_and_reconnects);
+    RUN_TEST(test_failures_back_off_exponentially_then_fall_back_to_ap);
+    RUN_TEST(test_backoff_stays_at_the_ceiling_through_a_long_outage);
+    RUN_TEST(test_listeners_see_every_transition_once);
+    RUN_TEST(test_fast_connect_keeps_dhcp_and_is_measured);
+    return UNITY_END();
+}
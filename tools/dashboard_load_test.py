@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Load test for the live dashboard WebSocket.
+
+Opens N clients against ws://<host>/ws, counts frames and bytes per client
+for a while, then prints per-client rates, the gap between frames and the
+device's own /live/stats (fan-out time, partial deliveries, free heap).
+Standard library only, so it runs from any laptop on the same network.
+
+    python3 tools/dashboard_load_test.py 192.168.1.50 --clients 6 --seconds 60
+"""
+
+import argparse
+import base64
+import json
+import os
+import socket
+import struct
+import threading
+import time
+import urllib.request
+
+
+def connect(host, port, path):
+    sock = socket.create_connection((host, port), timeout=10)
+    key = base64.b64encode(os.urandom(16)).decode()
+    sock.sendall((
+        f"GET {path} HTTP/1.1\r\nHost: {host}\r\nUpgrade: websocket\r\n"
+        f"Connection: Upgrade\r\nSec-WebSocket-Key: {key}\r\n"
+        "Sec-WebSocket-Version: 13\r\n\r\n").encode())
+    response = b""
+    while b"\r\n\r\n" not in response:
+        chunk = sock.recv(1024)
+        if not chunk:
+            raise ConnectionError("closed during handshake")
+        response += chunk
+    if b" 101 " not in response.split(b"\r\n", 1)[0]:
+        raise ConnectionError(response.split(b"\r\n", 1)[0].decode())
+    return sock, response.split(b"\r\n\r\n", 1)[1]
+
+
+def read_exact(sock, buffered, count):
+    while len(buffered) < count:
+        chunk = sock.recv(4096)
+        if not chunk:
+            raise ConnectionError("closed")
+        buffered += chunk
+    return buffered[:count], buffered[count:]
+
+
+def client(index, args, results, stop):
+    stats = {"frames": 0, "bytes": 0, "gaps": [], "error": None}
+    results[index] = stats
+    try:
+        sock, buffered = connect(args.host, args.port, "/ws")
+        sock.settimeout(1)
+        last = None
+        while not stop.is_set():
+            try:
+                header, buffered = read_exact(sock, buffered, 2)
+            except socket.timeout:
+                continue
+            opcode, length = header[0] & 0x0F, header[1] & 0x7F
+            if length == 126:
+                raw, buffered = read_exact(sock, buffered, 2)
+                length = struct.unpack(">H", raw)[0]
+            elif length == 127:
+                raw, buffered = read_exact(sock, buffered, 8)
+                length = struct.unpack(">Q", raw)[0]
+            payload, buffered = read_exact(sock, buffered, length)
+            if opcode == 0x8:
+                stats["error"] = "closed by device"
+                break
+            if opcode != 0x1:
+                continue
+            json.loads(payload)
+            now = time.monotonic()
+            if last is not None:
+                stats["gaps"].append(now - last)
+            last = now
+            stats["frames"] += 1
+            stats["bytes"] += length
+        sock.close()
+    except (OSError, ConnectionError, ValueError) as error:
+        stats["error"] = str(error)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--clients", type=int, default=4)
+    parser.add_argument("--seconds", type=float, default=30)
+    args = parser.parse_args()
+
+    results = [None] * args.clients
+    stop = threading.Event()
+    threads = [threading.Thread(target=client, args=(i, args, results, stop))
+               for i in range(args.clients)]
+    for thread in threads:
+        thread.start()
+        time.sleep(0.05)
+    time.sleep(args.seconds)
+    stop.set()
+    for thread in threads:
+        thread.join()
+
+    for i, stats in enumerate(results):
+        gaps = stats["gaps"]
+        gap = f"gap avg {sum(gaps) / len(gaps):.2f} s max {max(gaps):.2f} s" if gaps else "no gaps"
+        print(f"client {i}: {stats['frames']} frames, {stats['bytes']} bytes, "
+              f"{stats['bytes'] / args.seconds:.0f} B/s, {gap}"
+              + (f", error: {stats['error']}" if stats["error"] else ""))
+
+    with urllib.request.urlopen(f"http://{args.host}:{args.port}/live/stats", timeout=5) as reply:
+        print("device:", json.dumps(json.load(reply)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Convert a firmware trace dump to Chrome/Perfetto trace JSON.
+
+Reads the binary buffer served at http://<host>/trace (or a file saved from
+it) and writes Trace Event Format JSON with one row per FreeRTOS task.
+Open the result in chrome://tracing or https://ui.perfetto.dev.
+Standard library only.
+
+    python3 tools/trace_to_chrome.py --host 192.168.1.50 -o trace.json
+    curl -o trace.bin http://192.168.1.50/trace
+    python3 tools/trace_to_chrome.py trace.bin -o trace.json
+"""
+
+import argparse
+import json
+import struct
+import sys
+import urllib.request
+
+MAGIC = b"WQTR"
+VERSION = 1
+NAME_LENGTH = 16
+TASK_OTHER = 0xFF
+KIND_BEGIN = 0
+KIND_END = 1
+
+
+def cstring(raw):
+    return raw.split(b"\0", 1)[0].decode("utf-8", "replace")
+
+
+def parse(data):
+    """Returns (tasks, names, events, total) from a dump; see trace.cpp."""
+    magic, version, count, total, task_count, name_count, _ = struct.unpack_from("<4sHHIBBH", data, 0)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError(f"not a version {VERSION} trace dump")
+    offset = 16
+
+    tasks = []
+    for _ in range(task_count):
+        tasks.append(cstring(data[offset:offset + NAME_LENGTH]))
+        offset += NAME_LENGTH
+
+    names = {}
+    for _ in range(name_count):
+        (event_id,) = struct.unpack_from("<H", data, offset)
+        names[event_id] = cstring(data[offset + 2:offset + 2 + NAME_LENGTH])
+        offset += 2 + NAME_LENGTH
+
+    events = []
+    for _ in range(count):
+        events.append(struct.unpack_from("<IHBB", data, offset))
+        offset += 8
+    return tasks, names, events, total
+
+
+def convert(tasks, names, events):
+    """Trace Event Format list. Timestamps are unwrapped from the 32-bit
+    microsecond counter and made relative to the first event."""
+    out = [{"ph": "M", "pid": 1, "name": "process_name", "args": {"name": "firmware"}}]
+    for index, name in enumerate(tasks):
+        out.append({"ph": "M", "pid": 1, "tid": index, "name": "thread_name", "args": {"name": name}})
+    if any(task == TASK_OTHER for _, _, _, task in events):
+        out.append({"ph": "M", "pid": 1, "tid": TASK_OTHER, "name": "thread_name",
+                    "args": {"name": "other tasks"}})
+
+    open_spans = {}     # tid -> stack of event ids
+    previous = None
+    now = 0
+    for time, event_id, kind, task in events:
+        # Signed delta: tolerates the wrap and slightly out-of-order events
+        # from the other core
+        if previous is not None:
+            now += ((time - previous + 2**31) % 2**32) - 2**31
+        previous = time
+        name = names.get(event_id, f"event {event_id:#x}")
+        stack = open_spans.setdefault(task, [])
+
+        if kind == KIND_BEGIN:
+            stack.append(event_id)
+            out.append({"ph": "B", "pid": 1, "tid": task, "ts": now, "name": name})
+        elif kind == KIND_END and event_id in stack:
+            # Ends whose begin was overwritten are dropped
+            while stack and stack.pop() != event_id:
+                pass
+            out.append({"ph": "E", "pid": 1, "tid": task, "ts": now, "name": name})
+
+    # Spans still running when the dump was taken end at the last event
+    for task, stack in open_spans.items():
+        for event_id in reversed(stack):
+            out.append({"ph": "E", "pid": 1, "tid": task, "ts": now,
+                        "name": names.get(event_id, f"event {event_id:#x}")})
+
+    start = min((e["ts"] for e in out if "ts" in e), default=0)
+    for e in out:
+        if "ts" in e:
+            e["ts"] -= start
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("dump", nargs="?", help="binary dump file (default: fetch from --host)")
+    parser.add_argument("--host", help="device address to fetch /trace from")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("-o", "--output", default="-", help="JSON output file (default: stdout)")
+    args = parser.parse_args()
+
+    if args.dump:
+        with open(args.dump, "rb") as f:
+            data = f.read()
+    elif args.host:
+        with urllib.request.urlopen(f"http://{args.host}:{args.port}/trace", timeout=10) as reply:
+            data = reply.read()
+    else:
+        parser.error("give a dump file or --host")
+
+    tasks, names, events, total = parse(data)
+    trace = {"traceEvents": convert(tasks, names, events), "displayTimeUnit": "ms"}
+
+    if args.output == "-":
+        json.dump(trace, sys.stdout)
+    else:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    print(f"{len(events)} events from {len(tasks)} tasks"
+          + (f", {total - len(events)} older events overwritten" if total > len(events) else ""),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()